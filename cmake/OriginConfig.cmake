@@ -67,7 +67,7 @@ list(APPEND ORIGIN_LIBRARIES origin)
 set(ORIGIN_WARNINGS "-Wall -Wno-unused-variable -Wno-unused-value")
 
 # Build the entire set of flags
-set(ORIGIN_CXX_FLAGS "${ORIGIN_DEFINES} ${ORIGIN_WARNINGS} -std=c++11")
+set(ORIGIN_CXX_FLAGS "${ORIGIN_DEFINES} ${ORIGIN_WARNINGS} -std=c++11 -pthread")
 
 # Compile using these settings
 set(CMAKE_CXX_FLAGS ${ORIGIN_CXX_FLAGS})
@@ -157,7 +157,7 @@ macro(build_component)
   
   # And link our dependencies.
   foreach(i ${ORIGIN_CURRENT_IMPORTS})
-    target_link_libraries(${target} ${i})
+    target_link_libraries(${ORIGIN_CURRENT_LIBRARY_TARGET} ${i})
   endforeach()
 endmacro()
 
@@ -0,0 +1,952 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_FACTOR_HPP
+#define ORIGIN_MATH_MATRIX_FACTOR_HPP
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <origin/math/matrix/matrix.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                          Matrix Factorizations
+  //
+  // This module provides the LU, Cholesky, and QR factorizations of 2D
+  // matrices. Each factorization is computed once, when the factorization
+  // object is constructed, and can be reused to solve any number of systems
+  // with the same coefficient matrix. For example:
+  //
+  //    lu_factorization<double> f(a);
+  //    matrix<double, 1> x = f.solve(b);
+  //    matrix<double, 1> y = f.solve(c);
+  //
+  // The factorizations are blocked. A panel of columns is factored by an
+  // unblocked algorithm, and the remainder of the matrix is updated by the
+  // cache-blocked matrix product kernel (see gemm_blocked). Most of the work
+  // of a large factorization is done in the matrix product.
+  //
+  // The right-hand sides of a system may be vectors (matrix<T, 1>) or
+  // matrices (matrix<T, 2>) having one column per system. The solve_in_place
+  // functions accept matrix_refs, so the solution can be written into a
+  // submatrix of a larger matrix.
+
+
+  // The singular matrix error is thrown when solving a system whose
+  // coefficient matrix is singular, or when computing the Cholesky
+  // factorization of a matrix that is not positive definite.
+  struct singular_matrix : std::runtime_error
+  {
+    explicit singular_matrix(const char* what)
+      : std::runtime_error(what)
+    { }
+  };
+
+
+  namespace matrix_impl
+  {
+    // The number of columns in the panels of a blocked factorization.
+    constexpr std::size_t factor_block = 64;
+
+    // A dense matrix stored in row-major order with an arbitrary row and
+    // column stride. The right-hand sides of a system are accessed through
+    // a dense view. A vector is viewed as a matrix with one column.
+    template <typename T>
+      struct dense_view
+      {
+        T& operator()(std::size_t i, std::size_t j) const
+        {
+          return data[i * rs + j * cs];
+        }
+
+        T* data;
+        std::size_t rows;
+        std::size_t cols;
+        std::size_t rs;
+        std::size_t cs;
+      };
+
+    template <typename T>
+      inline dense_view<T>
+      make_dense_view(matrix_ref<T, 1> m)
+      {
+        const auto& d = m.descriptor();
+        return {m.data() + d.start, d.extents[0], 1, d.strides[0], 1};
+      }
+
+    template <typename T>
+      inline dense_view<T>
+      make_dense_view(matrix_ref<T, 2> m)
+      {
+        const auto& d = m.descriptor();
+        return {m.data() + d.start, d.extents[0], d.extents[1],
+                d.strides[0], d.strides[1]};
+      }
+
+    // Compute b(i, :) -= x * b(k, :).
+    template <typename T>
+      inline void
+      row_axpy(const dense_view<T>& b, std::size_t i, std::size_t k, T x)
+      {
+        T* p = &b(i, 0);
+        const T* q = &b(k, 0);
+        for (std::size_t j = 0; j < b.cols; ++j)
+          p[j * b.cs] -= x * q[j * b.cs];
+      }
+
+    // Compute b(i, :) /= x.
+    template <typename T>
+      inline void
+      row_divide(const dense_view<T>& b, std::size_t i, T x)
+      {
+        T* p = &b(i, 0);
+        for (std::size_t j = 0; j < b.cols; ++j)
+          p[j * b.cs] /= x;
+      }
+
+
+    // ---------------------------------------------------------------------- //
+    //                            Triangular Solvers
+    //
+    // Each solver overwrites the right-hand sides b with the solution of a
+    // triangular system whose coefficients are stored in the n x n array a
+    // with leading dimension lda. The systems are solved a row at a time, so
+    // that the inner loops run over the (usually contiguous) rows of b.
+
+    // Solve L x = b where L is the lower triangle of a. If unit is true, the
+    // diagonal of L is taken to be 1.
+    template <typename T>
+      void
+      lower_solve(std::size_t n, const T* a, std::size_t lda,
+                  const dense_view<T>& b, bool unit)
+      {
+        for (std::size_t i = 0; i < n; ++i) {
+          for (std::size_t k = 0; k < i; ++k)
+            if (a[i * lda + k] != T(0))
+              row_axpy(b, i, k, a[i * lda + k]);
+          if (!unit)
+            row_divide(b, i, a[i * lda + i]);
+        }
+      }
+
+    // Solve U x = b where U is the upper triangle of a.
+    template <typename T>
+      void
+      upper_solve(std::size_t n, const T* a, std::size_t lda,
+                  const dense_view<T>& b)
+      {
+        for (std::size_t i = n; i-- != 0; ) {
+          for (std::size_t k = i + 1; k < n; ++k)
+            if (a[i * lda + k] != T(0))
+              row_axpy(b, i, k, a[i * lda + k]);
+          row_divide(b, i, a[i * lda + i]);
+        }
+      }
+
+    // Solve L^T x = b where L is the lower triangle of a.
+    template <typename T>
+      void
+      lower_transpose_solve(std::size_t n, const T* a, std::size_t lda,
+                            const dense_view<T>& b)
+      {
+        for (std::size_t i = n; i-- != 0; ) {
+          row_divide(b, i, a[i * lda + i]);
+          for (std::size_t k = 0; k < i; ++k)
+            if (a[i * lda + k] != T(0))
+              row_axpy(b, k, i, a[i * lda + k]);
+        }
+      }
+
+
+    // ---------------------------------------------------------------------- //
+    //                               LU Factorization
+    //
+    // Factor the n x n array a (with leading dimension lda) into P A = L U
+    // by Gaussian elimination with partial pivoting. L is unit lower
+    // triangular and U is upper triangular; both are stored in a. The row
+    // interchanges are recorded in piv: row i was exchanged with row piv[i].
+    // Returns false if a zero pivot was found (i.e., the matrix is singular).
+    //
+    // The algorithm is the right-looking blocked algorithm. For each panel
+    // of columns [k, k + b):
+    //
+    //    1. Factor the panel, exchanging entire rows of a.
+    //    2. Compute the block row of U: U12 = L11^-1 A12.
+    //    3. Update the trailing submatrix: A22 -= L21 U12.
+    template <typename T>
+      bool
+      lu_factor(std::size_t n, T* a, std::size_t lda, std::size_t* piv)
+      {
+        using std::abs;
+        bool nonsingular = true;
+        std::vector<T> tmp;
+        for (std::size_t k = 0; k < n; k += factor_block) {
+          const std::size_t b = std::min(factor_block, n - k);
+          const std::size_t e = k + b;
+
+          // 1. Factor the panel.
+          for (std::size_t j = k; j < e; ++j) {
+            std::size_t p = j;
+            for (std::size_t i = j + 1; i < n; ++i)
+              if (abs(a[i * lda + j]) > abs(a[p * lda + j]))
+                p = i;
+            piv[j] = p;
+            if (p != j)
+              std::swap_ranges(a + j * lda, a + j * lda + n, a + p * lda);
+
+            const T d = a[j * lda + j];
+            if (d == T(0)) {
+              nonsingular = false;
+              continue;
+            }
+            for (std::size_t i = j + 1; i < n; ++i) {
+              T* row = a + i * lda;
+              const T l = row[j] /= d;
+              if (l != T(0))
+                for (std::size_t c = j + 1; c < e; ++c)
+                  row[c] -= l * a[j * lda + c];
+            }
+          }
+
+          const std::size_t r = n - e;
+          if (r == 0)
+            break;
+
+          // 2. U12 = L11^-1 A12.
+          for (std::size_t i = k + 1; i < e; ++i) {
+            T* row = a + i * lda;
+            for (std::size_t p = k; p < i; ++p) {
+              const T l = row[p];
+              const T* u = a + p * lda;
+              for (std::size_t c = e; c < n; ++c)
+                row[c] -= l * u[c];
+            }
+          }
+
+          // 3. A22 -= L21 U12. The product kernel accumulates, so U12 is
+          // negated into a temporary buffer.
+          tmp.resize(b * r);
+          for (std::size_t i = 0; i < b; ++i)
+            for (std::size_t c = 0; c < r; ++c)
+              tmp[i * r + c] = -a[(k + i) * lda + e + c];
+          gemm_blocked(r, r, b,
+                       a + e * lda + k, lda,
+                       tmp.data(), r,
+                       a + e * lda + e, lda);
+        }
+        return nonsingular;
+      }
+
+
+    // ---------------------------------------------------------------------- //
+    //                           Cholesky Factorization
+    //
+    // Factor the symmetric positive definite n x n array a (with leading
+    // dimension lda) into A = L L^T. Only the lower triangle of a is read,
+    // and L overwrites it. The strict upper triangle is set to 0. Returns
+    // false if the matrix is not positive definite.
+    //
+    // The algorithm is the right-looking blocked algorithm. For each panel
+    // of columns [k, k + b):
+    //
+    //    1. Factor the diagonal block: A11 = L11 L11^T.
+    //    2. Compute the panel below it: L21 = A21 L11^-T.
+    //    3. Update the trailing submatrix: A22 -= L21 L21^T.
+    template <typename T>
+      bool
+      cholesky_factor(std::size_t n, T* a, std::size_t lda)
+      {
+        using std::sqrt;
+        std::vector<T> tmp;
+        for (std::size_t k = 0; k < n; k += factor_block) {
+          const std::size_t b = std::min(factor_block, n - k);
+          const std::size_t e = k + b;
+
+          // 1. Factor the diagonal block.
+          for (std::size_t j = k; j < e; ++j) {
+            T* rj = a + j * lda;
+            T s = rj[j];
+            for (std::size_t p = k; p < j; ++p)
+              s -= rj[p] * rj[p];
+            if (!(s > T(0)))
+              return false;
+            rj[j] = sqrt(s);
+            for (std::size_t i = j + 1; i < e; ++i) {
+              T* ri = a + i * lda;
+              T t = ri[j];
+              for (std::size_t p = k; p < j; ++p)
+                t -= ri[p] * rj[p];
+              ri[j] = t / rj[j];
+            }
+          }
+
+          const std::size_t r = n - e;
+          if (r == 0)
+            break;
+
+          // 2. L21 = A21 L11^-T.
+          for (std::size_t i = e; i < n; ++i) {
+            T* ri = a + i * lda;
+            for (std::size_t j = k; j < e; ++j) {
+              const T* rj = a + j * lda;
+              T t = ri[j];
+              for (std::size_t p = k; p < j; ++p)
+                t -= ri[p] * rj[p];
+              ri[j] = t / rj[j];
+            }
+          }
+
+          // 3. A22 -= L21 L21^T. The transpose of L21 is negated into a
+          // temporary buffer. The entire trailing block is updated, but only
+          // its lower triangle is used.
+          tmp.resize(b * r);
+          for (std::size_t i = 0; i < r; ++i)
+            for (std::size_t p = 0; p < b; ++p)
+              tmp[p * r + i] = -a[(e + i) * lda + k + p];
+          gemm_blocked(r, r, b,
+                       a + e * lda + k, lda,
+                       tmp.data(), r,
+                       a + e * lda + e, lda);
+        }
+
+        for (std::size_t i = 0; i < n; ++i)
+          std::fill(a + i * lda + i + 1, a + i * lda + n, T(0));
+        return true;
+      }
+
+
+    // ---------------------------------------------------------------------- //
+    //                              QR Factorization
+    //
+    // Factor the m x n array a (m >= n, with leading dimension lda) into
+    // A = Q R using Householder reflections. On return, R is stored in the
+    // upper triangle of a, and the reflectors are stored below the diagonal.
+    // The jth reflector is H(j) = I - tau[j] v v^T where v(j) = 1 and the
+    // elements of v below j are stored in column j of a. Q is the product
+    // H(0) H(1) ... H(n-1).
+    //
+    // The algorithm uses the compact WY representation of a block of
+    // reflectors, H(k) ... H(k+b-1) = I - V T V^T, where T is upper
+    // triangular. For each panel of columns [k, k + b):
+    //
+    //    1. Factor the panel using unblocked Householder reflections.
+    //    2. Form the triangular factor, T.
+    //    3. Update the trailing columns: A2 -= V (T^T (V^T A2)).
+
+    // Returns the Householder reflection that annihilates the elements of
+    // x below x[0] (with stride s). The reflected value of x[0] (which
+    // becomes an element of R) is stored in x[0], and the remaining elements
+    // are overwritten by the reflector. Returns tau.
+    template <typename T>
+      T
+      householder(std::size_t n, T* x, std::size_t s)
+      {
+        using std::sqrt;
+        T sigma = T(0);
+        for (std::size_t i = 1; i < n; ++i)
+          sigma += x[i * s] * x[i * s];
+        if (sigma == T(0))
+          return T(0);
+
+        const T alpha = x[0];
+        const T norm = sqrt(alpha * alpha + sigma);
+        const T beta = alpha > T(0) ? -norm : norm;
+        const T scale = T(1) / (alpha - beta);
+        for (std::size_t i = 1; i < n; ++i)
+          x[i * s] *= scale;
+        x[0] = beta;
+        return (beta - alpha) / beta;
+      }
+
+    // Apply the reflector stored in column j of a (rows j to m) to the
+    // columns [first, last) of the rows j to m of b (with leading dimension
+    // ldb). The vector w is used as scratch.
+    template <typename T>
+      void
+      apply_householder(std::size_t m, std::size_t j, T tau,
+                        const T* a, std::size_t lda,
+                        T* b, std::size_t ldb,
+                        std::size_t first, std::size_t last,
+                        std::vector<T>& w)
+      {
+        if (tau == T(0) || first == last)
+          return;
+        const std::size_t n = last - first;
+        w.assign(b + j * ldb + first, b + j * ldb + last);
+        for (std::size_t i = j + 1; i < m; ++i) {
+          const T v = a[i * lda + j];
+          const T* row = b + i * ldb + first;
+          for (std::size_t c = 0; c < n; ++c)
+            w[c] += v * row[c];
+        }
+        for (std::size_t c = 0; c < n; ++c)
+          w[c] *= tau;
+        T* rj = b + j * ldb + first;
+        for (std::size_t c = 0; c < n; ++c)
+          rj[c] -= w[c];
+        for (std::size_t i = j + 1; i < m; ++i) {
+          const T v = a[i * lda + j];
+          T* row = b + i * ldb + first;
+          for (std::size_t c = 0; c < n; ++c)
+            row[c] -= v * w[c];
+        }
+      }
+
+    template <typename T>
+      void
+      qr_factor(std::size_t m, std::size_t n, T* a, std::size_t lda, T* tau)
+      {
+        assert(m >= n);
+        std::vector<T> w, t, vt, vn, wy;
+        for (std::size_t k = 0; k < n; k += factor_block) {
+          const std::size_t b = std::min(factor_block, n - k);
+          const std::size_t e = k + b;
+
+          // 1. Factor the panel.
+          for (std::size_t j = k; j < e; ++j) {
+            tau[j] = householder(m - j, a + j * lda + j, lda);
+            apply_householder(m, j, tau[j], a, lda, a, lda, j + 1, e, w);
+          }
+
+          const std::size_t r = n - e;
+          if (r == 0)
+            break;
+
+          // Copy V^T (b x h) and -V (h x b) where h = m - k is the number of
+          // rows of the panel.
+          const std::size_t h = m - k;
+          vt.assign(b * h, T(0));
+          vn.assign(h * b, T(0));
+          for (std::size_t j = 0; j < b; ++j) {
+            vt[j * h + j] = T(1);
+            vn[j * b + j] = T(-1);
+            for (std::size_t i = j + 1; i < h; ++i) {
+              const T v = a[(k + i) * lda + k + j];
+              vt[j * h + i] = v;
+              vn[i * b + j] = -v;
+            }
+          }
+
+          // 2. Form T a column at a time:
+          //
+          //    T(0:j, j) = -tau[j] T(0:j, 0:j) V(:, 0:j)^T v(j)
+          t.assign(b * b, T(0));
+          for (std::size_t j = 0; j < b; ++j) {
+            const T tj = tau[k + j];
+            t[j * b + j] = tj;
+            if (tj == T(0))
+              continue;
+            w.resize(j);
+            for (std::size_t p = 0; p < j; ++p) {
+              T s = T(0);
+              for (std::size_t i = j; i < h; ++i)
+                s += vt[p * h + i] * vt[j * h + i];
+              w[p] = -tj * s;
+            }
+            for (std::size_t p = 0; p < j; ++p) {
+              T s = T(0);
+              for (std::size_t q = p; q < j; ++q)
+                s += t[p * b + q] * w[q];
+              t[p * b + j] = s;
+            }
+          }
+
+          // 3. A2 -= V (T^T (V^T A2)).
+          T* a2 = a + k * lda + e;
+          wy.assign(b * r, T(0));
+          gemm_blocked(b, r, h, vt.data(), h, a2, lda, wy.data(), r);
+          for (std::size_t i = b; i-- != 0; ) {
+            T* wi = wy.data() + i * r;
+            for (std::size_t c = 0; c < r; ++c)
+              wi[c] *= t[i * b + i];
+            for (std::size_t p = 0; p < i; ++p) {
+              const T x = t[p * b + i];
+              const T* wp = wy.data() + p * r;
+              for (std::size_t c = 0; c < r; ++c)
+                wi[c] += x * wp[c];
+            }
+          }
+          gemm_blocked(h, r, b, vn.data(), b, wy.data(), r, a2, lda);
+        }
+      }
+
+    // Compute Q^T b, where the reflectors of Q are stored in the m x n array
+    // a. The right-hand sides b have m rows.
+    template <typename T>
+      void
+      qr_apply_transpose(std::size_t m, std::size_t n,
+                         const T* a, std::size_t lda, const T* tau,
+                         const dense_view<T>& b)
+      {
+        for (std::size_t j = 0; j < n; ++j) {
+          if (tau[j] == T(0))
+            continue;
+          for (std::size_t c = 0; c < b.cols; ++c) {
+            T w = b(j, c);
+            for (std::size_t i = j + 1; i < m; ++i)
+              w += a[i * lda + j] * b(i, c);
+            w *= tau[j];
+            b(j, c) -= w;
+            for (std::size_t i = j + 1; i < m; ++i)
+              b(i, c) -= a[i * lda + j] * w;
+          }
+        }
+      }
+
+    // Returns a copy of the 2D matrix m with contiguous storage.
+    template <typename T, typename M>
+      inline matrix<T, 2>
+      factor_copy(const M& m)
+      {
+        static_assert(M::order == 2, "factorization requires a 2D matrix");
+        return matrix<T, 2>(m);
+      }
+
+    // Returns a copy of the first n rows of the matrix m.
+    template <typename T, std::size_t N>
+      inline matrix<T, N>
+      leading_rows(matrix<T, N>&& m, std::size_t n)
+      {
+        matrix_slice<N> s = m.descriptor();
+        s.extents[0] = n;
+        m.resize(matrix_slice<N>(0, s.extents));
+        return std::move(m);
+      }
+
+  } // namespace matrix_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                             LU Factorization
+  //
+  // The LU factorization of a square matrix A is P A = L U where P is a
+  // permutation matrix, L is unit lower triangular and U is upper
+  // triangular. The factorization is computed with partial pivoting.
+  //
+  // A singular matrix can be factored, but systems involving it cannot be
+  // solved; solve throws singular_matrix.
+  template <typename T>
+    class lu_factorization
+    {
+    public:
+      using value_type = T;
+
+      template <typename M, typename = Requires<Matrix<M>()>>
+        explicit lu_factorization(const M& a);
+
+      // Returns the order of the factored matrix.
+      std::size_t size() const { return lu.rows(); }
+
+      // Returns true if the factored matrix is singular.
+      bool singular() const { return !nonsingular; }
+
+      // Returns the packed factors. L is stored below the diagonal, and U
+      // is stored on and above the diagonal.
+      const matrix<T, 2>& factors() const { return lu; }
+
+      // Returns the row interchanges. Row i was exchanged with pivots()[i].
+      const std::vector<std::size_t>& pivots() const { return piv; }
+
+      matrix<T, 2> lower() const;
+      matrix<T, 2> upper() const;
+
+      T determinant() const;
+
+      // Solving
+      void solve_in_place(matrix_ref<T, 1> b) const;
+      void solve_in_place(matrix_ref<T, 2> b) const;
+
+      template <typename M>
+        matrix<T, M::order> solve(const M& b) const;
+
+    private:
+      template <typename V>
+        void solve_view(const V& b) const;
+
+      matrix<T, 2> lu;
+      std::vector<std::size_t> piv;
+      bool nonsingular;
+    };
+
+  template <typename T>
+    template <typename M, typename X>
+      lu_factorization<T>::lu_factorization(const M& a)
+        : lu(matrix_impl::factor_copy<T>(a)), piv(lu.rows())
+      {
+        if (lu.rows() != lu.cols())
+          throw std::invalid_argument("LU factorization of a non-square matrix");
+        nonsingular = matrix_impl::lu_factor(size(), lu.data(), lu.cols(), piv.data());
+      }
+
+  template <typename T>
+    matrix<T, 2>
+    lu_factorization<T>::lower() const
+    {
+      const std::size_t n = size();
+      matrix<T, 2> l(n, n);
+      for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < i; ++j)
+          l(i, j) = lu(i, j);
+        l(i, i) = T(1);
+      }
+      return l;
+    }
+
+  template <typename T>
+    matrix<T, 2>
+    lu_factorization<T>::upper() const
+    {
+      const std::size_t n = size();
+      matrix<T, 2> u(n, n);
+      for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = i; j < n; ++j)
+          u(i, j) = lu(i, j);
+      return u;
+    }
+
+  // The determinant is the product of the diagonal of U, negated for each
+  // row interchange.
+  template <typename T>
+    T
+    lu_factorization<T>::determinant() const
+    {
+      T d = T(1);
+      for (std::size_t i = 0; i < size(); ++i) {
+        d *= lu(i, i);
+        if (piv[i] != i)
+          d = -d;
+      }
+      return d;
+    }
+
+  template <typename T>
+    template <typename V>
+      void
+      lu_factorization<T>::solve_view(const V& b) const
+      {
+        if (!nonsingular)
+          throw singular_matrix("LU solve with a singular matrix");
+        assert(b.rows == size());
+        const std::size_t n = size();
+        for (std::size_t i = 0; i < n; ++i)
+          if (piv[i] != i)
+            for (std::size_t c = 0; c < b.cols; ++c)
+              std::swap(b(i, c), b(piv[i], c));
+        matrix_impl::lower_solve(n, lu.data(), n, b, true);
+        matrix_impl::upper_solve(n, lu.data(), n, b);
+      }
+
+  template <typename T>
+    inline void
+    lu_factorization<T>::solve_in_place(matrix_ref<T, 1> b) const
+    {
+      solve_view(matrix_impl::make_dense_view(b));
+    }
+
+  template <typename T>
+    inline void
+    lu_factorization<T>::solve_in_place(matrix_ref<T, 2> b) const
+    {
+      solve_view(matrix_impl::make_dense_view(b));
+    }
+
+  // Returns the solution of A x = b.
+  template <typename T>
+    template <typename M>
+      inline matrix<T, M::order>
+      lu_factorization<T>::solve(const M& b) const
+      {
+        matrix<T, M::order> x = b;
+        solve_in_place(x);
+        return x;
+      }
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Cholesky Factorization
+  //
+  // The Cholesky factorization of a symmetric positive definite matrix A is
+  // A = L L^T where L is lower triangular with a positive diagonal. Only the
+  // lower triangle of A is used. If A is not positive definite, the
+  // constructor throws singular_matrix.
+  //
+  // The Cholesky factorization requires about half the work of the LU
+  // factorization.
+  template <typename T>
+    class cholesky_factorization
+    {
+    public:
+      using value_type = T;
+
+      template <typename M, typename = Requires<Matrix<M>()>>
+        explicit cholesky_factorization(const M& a);
+
+      // Returns the order of the factored matrix.
+      std::size_t size() const { return l.rows(); }
+
+      // Returns the lower triangular factor, L.
+      const matrix<T, 2>& lower() const { return l; }
+
+      T determinant() const;
+
+      // Solving
+      void solve_in_place(matrix_ref<T, 1> b) const;
+      void solve_in_place(matrix_ref<T, 2> b) const;
+
+      template <typename M>
+        matrix<T, M::order> solve(const M& b) const;
+
+    private:
+      template <typename V>
+        void solve_view(const V& b) const;
+
+      matrix<T, 2> l;
+    };
+
+  template <typename T>
+    template <typename M, typename X>
+      cholesky_factorization<T>::cholesky_factorization(const M& a)
+        : l(matrix_impl::factor_copy<T>(a))
+      {
+        if (l.rows() != l.cols())
+          throw std::invalid_argument("Cholesky factorization of a non-square matrix");
+        if (!matrix_impl::cholesky_factor(size(), l.data(), l.cols()))
+          throw singular_matrix("Cholesky factorization of a matrix that is not positive definite");
+      }
+
+  template <typename T>
+    T
+    cholesky_factorization<T>::determinant() const
+    {
+      T d = T(1);
+      for (std::size_t i = 0; i < size(); ++i)
+        d *= l(i, i);
+      return d * d;
+    }
+
+  template <typename T>
+    template <typename V>
+      void
+      cholesky_factorization<T>::solve_view(const V& b) const
+      {
+        assert(b.rows == size());
+        matrix_impl::lower_solve(size(), l.data(), size(), b, false);
+        matrix_impl::lower_transpose_solve(size(), l.data(), size(), b);
+      }
+
+  template <typename T>
+    inline void
+    cholesky_factorization<T>::solve_in_place(matrix_ref<T, 1> b) const
+    {
+      solve_view(matrix_impl::make_dense_view(b));
+    }
+
+  template <typename T>
+    inline void
+    cholesky_factorization<T>::solve_in_place(matrix_ref<T, 2> b) const
+    {
+      solve_view(matrix_impl::make_dense_view(b));
+    }
+
+  // Returns the solution of A x = b.
+  template <typename T>
+    template <typename M>
+      inline matrix<T, M::order>
+      cholesky_factorization<T>::solve(const M& b) const
+      {
+        matrix<T, M::order> x = b;
+        solve_in_place(x);
+        return x;
+      }
+
+
+  // ------------------------------------------------------------------------ //
+  //                             QR Factorization
+  //
+  // The QR factorization of an m x n matrix A (m >= n) is A = Q R where Q is
+  // an m x n matrix with orthonormal columns and R is an n x n upper
+  // triangular matrix. Q is stored implicitly as a sequence of Householder
+  // reflections.
+  //
+  // When m > n, solve computes the least squares solution of A x = b, which
+  // has n rows. The right-hand sides passed to solve_in_place have m rows;
+  // the solution is written into the first n of them. If R is singular
+  // (i.e., A does not have full column rank, up to rounding), solve throws
+  // singular_matrix.
+  template <typename T>
+    class qr_factorization
+    {
+    public:
+      using value_type = T;
+
+      template <typename M, typename = Requires<Matrix<M>()>>
+        explicit qr_factorization(const M& a);
+
+      std::size_t rows() const { return qr.rows(); }
+      std::size_t cols() const { return qr.cols(); }
+
+      // Returns the packed factors. R is stored on and above the diagonal,
+      // and the Householder vectors are stored below it.
+      const matrix<T, 2>& factors() const { return qr; }
+
+      // Returns the scaling factors of the Householder reflections.
+      const std::vector<T>& coefficients() const { return tau; }
+
+      matrix<T, 2> q() const;
+      matrix<T, 2> r() const;
+
+      // Solving
+      void solve_in_place(matrix_ref<T, 1> b) const;
+      void solve_in_place(matrix_ref<T, 2> b) const;
+
+      template <typename M>
+        matrix<T, M::order> solve(const M& b) const;
+
+    private:
+      template <typename V>
+        void solve_view(const V& b) const;
+
+      matrix<T, 2> qr;
+      std::vector<T> tau;
+    };
+
+  template <typename T>
+    template <typename M, typename X>
+      qr_factorization<T>::qr_factorization(const M& a)
+        : qr(matrix_impl::factor_copy<T>(a)), tau(qr.cols())
+      {
+        if (rows() < cols())
+          throw std::invalid_argument("QR factorization of a matrix with more columns than rows");
+        matrix_impl::qr_factor(rows(), cols(), qr.data(), cols(), tau.data());
+      }
+
+  // Returns the m x n matrix Q. Q is computed by applying the reflections
+  // to the first n columns of the identity matrix.
+  template <typename T>
+    matrix<T, 2>
+    qr_factorization<T>::q() const
+    {
+      const std::size_t m = rows();
+      const std::size_t n = cols();
+      matrix<T, 2> x(m, n);
+      for (std::size_t i = 0; i < n; ++i)
+        x(i, i) = T(1);
+      std::vector<T> w;
+      for (std::size_t j = n; j-- != 0; )
+        matrix_impl::apply_householder(m, j, tau[j], qr.data(), n,
+                                       x.data(), n, j, n, w);
+      return x;
+    }
+
+  // Returns the n x n upper triangular matrix R.
+  template <typename T>
+    matrix<T, 2>
+    qr_factorization<T>::r() const
+    {
+      const std::size_t n = cols();
+      matrix<T, 2> x(n, n);
+      for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = i; j < n; ++j)
+          x(i, j) = qr(i, j);
+      return x;
+    }
+
+  template <typename T>
+    template <typename V>
+      void
+      qr_factorization<T>::solve_view(const V& b) const
+      {
+        using std::abs;
+        assert(b.rows == rows());
+
+        // A is taken to be rank deficient if a diagonal element of R is
+        // negligible compared to the largest one.
+        const std::size_t n = cols();
+        T big = T(0);
+        for (std::size_t i = 0; i < n; ++i)
+          big = std::max(big, abs(qr(i, i)));
+        const T tol = big * T(rows()) * std::numeric_limits<T>::epsilon();
+        for (std::size_t i = 0; i < n; ++i)
+          if (abs(qr(i, i)) <= tol)
+            throw singular_matrix("QR solve with a rank deficient matrix");
+        matrix_impl::qr_apply_transpose(rows(), n, qr.data(), n, tau.data(), b);
+        matrix_impl::upper_solve(n, qr.data(), n, b);
+      }
+
+  template <typename T>
+    inline void
+    qr_factorization<T>::solve_in_place(matrix_ref<T, 1> b) const
+    {
+      solve_view(matrix_impl::make_dense_view(b));
+    }
+
+  template <typename T>
+    inline void
+    qr_factorization<T>::solve_in_place(matrix_ref<T, 2> b) const
+    {
+      solve_view(matrix_impl::make_dense_view(b));
+    }
+
+  // Returns the (least squares) solution of A x = b.
+  template <typename T>
+    template <typename M>
+      inline matrix<T, M::order>
+      qr_factorization<T>::solve(const M& b) const
+      {
+        matrix<T, M::order> x = b;
+        solve_in_place(x);
+        return matrix_impl::leading_rows(std::move(x), cols());
+      }
+
+
+  // ------------------------------------------------------------------------ //
+  //                               Factorizing
+  //
+  // The following functions return the factorization of a matrix:
+  //
+  //    lu(a)       -- The LU factorization of a
+  //    cholesky(a) -- The Cholesky factorization of a
+  //    qr(a)       -- The QR factorization of a
+  //
+  // The solve function returns the solution of the linear system a x = b
+  // using the LU factorization. To solve several systems with the same
+  // matrix, factor it once and use the factorization's solve function.
+  template <typename M>
+    inline lu_factorization<Value_type<M>>
+    lu(const M& a)
+    {
+      return lu_factorization<Value_type<M>>(a);
+    }
+
+  template <typename M>
+    inline cholesky_factorization<Value_type<M>>
+    cholesky(const M& a)
+    {
+      return cholesky_factorization<Value_type<M>>(a);
+    }
+
+  template <typename M>
+    inline qr_factorization<Value_type<M>>
+    qr(const M& a)
+    {
+      return qr_factorization<Value_type<M>>(a);
+    }
+
+  template <typename M1, typename M2>
+    inline matrix<Value_type<M1>, M2::order>
+    solve(const M1& a, const M2& b)
+    {
+      return lu(a).solve(b);
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,92 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+
+#include <origin/math/matrix/factor.hpp>
+
+#include "../matrix.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+// Returns a random symmetric positive definite matrix: B B^T + n I.
+Mat random_spd(size_t n)
+{
+  Mat b = random_matrix(n, n);
+  Mat a(n, n);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j)
+      a(i, j) = inner_product(b[i].begin(), b[i].end(), b[j].begin(), 0.0);
+  for (size_t i = 0; i < n; ++i)
+    a(i, i) += n;
+  return a;
+}
+
+void test_small()
+{
+  Mat a {
+    {4, 12, -16},
+    {12, 37, -43},
+    {-16, -43, 98}
+  };
+  cholesky_factorization<double> f(a);
+  Mat l {
+    {2, 0, 0},
+    {6, 1, 0},
+    {-8, 5, 3}
+  };
+  assert(max_error(f.lower(), l) < 1e-12);
+  assert(abs(f.determinant() - 36) < 1e-9);
+  Vec x = f.solve(Vec {-28.0, -74.0, 180.0});
+  assert(max_error(x, Vec {1.0, 0.0, 2.0}) < 1e-12);
+}
+
+void test_sizes()
+{
+  for (size_t n : {1, 5, 64, 65, 150}) {
+    Mat a = random_spd(n);
+    cholesky_factorization<double> f = cholesky(a);
+
+    // L L^T = A
+    Mat l = f.lower();
+    Mat lt(n, n);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        lt(i, j) = l(j, i);
+    assert(max_error(l * lt, a) < 1e-9);
+
+    Mat x = random_matrix(n, 3);
+    Mat b = a * x;
+    assert(max_error(f.solve(b), x) < 1e-9);
+  }
+}
+
+void test_not_positive_definite()
+{
+  Mat a {
+    {1, 2},
+    {2, 1}
+  };
+  try {
+    cholesky(a);
+    assert(false);
+  } catch (singular_matrix&) {
+  }
+}
+
+int main()
+{
+  test_small();
+  test_sizes();
+  test_not_positive_definite();
+}
@@ -0,0 +1,175 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <origin/math/matrix/factor.hpp>
+
+#include "../matrix.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for the LU factorization. For each order n given on the command
+// line, the benchmark compares the blocked factorization with the naive
+// Gaussian elimination solver of matrix.test/solver.cpp.
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+// Returns the product of a and the vector x.
+Vec multiply(const Mat& a, const Vec& x)
+{
+  Vec r(a.rows());
+  for (size_t i = 0; i < a.rows(); ++i)
+    r(i) = inner_product(a[i].begin(), a[i].end(), x.begin(), 0.0);
+  return r;
+}
+
+
+// The naive solver: Gaussian elimination with partial pivoting, operating
+// on one row at a time.
+Vec naive_solve(Mat a, Vec b)
+{
+  const size_t n = a.rows();
+  for (size_t j = 0; j < n; ++j) {
+    size_t r = j;
+    for (size_t k = j + 1; k < n; ++k)
+      if (abs(a(k, j)) > abs(a(r, j)))
+        r = k;
+    if (r != j) {
+      a.swap_rows(j, r);
+      swap(b(j), b(r));
+    }
+    for (size_t i = j + 1; i < n; ++i) {
+      double m = a(i, j) / a(j, j);
+      for (size_t k = j; k < n; ++k)
+        a(i, k) -= m * a(j, k);
+      b(i) -= m * b(j);
+    }
+  }
+  Vec x(n);
+  for (size_t i = n; i-- != 0; ) {
+    double s = b(i);
+    for (size_t k = i + 1; k < n; ++k)
+      s -= a(i, k) * x(k);
+    x(i) = s / a(i, i);
+  }
+  return x;
+}
+
+
+void test_small()
+{
+  Mat a {
+    {2, 1, 1},
+    {4, -6, 0},
+    {-2, 7, 2}
+  };
+  Vec b {5.0, -2.0, 9.0};
+
+  lu_factorization<double> f(a);
+  assert(!f.singular());
+  assert(f.pivots()[0] == 1);
+  assert(abs(f.determinant() - (-16)) < 1e-12);
+
+  Vec x = f.solve(b);
+  assert(max_error(x, Vec {1.0, 1.0, 2.0}) < 1e-12);
+
+  // P A = L U
+  Mat l = f.lower();
+  Mat u = f.upper();
+  Mat pa = a;
+  for (size_t i = 0; i < 3; ++i)
+    if (f.pivots()[i] != i)
+      pa.swap_rows(i, f.pivots()[i]);
+  assert(max_error(l * u, pa) < 1e-12);
+}
+
+// Sizes straddling the panel width.
+void test_sizes()
+{
+  for (size_t n : {1, 2, 17, 63, 64, 65, 130, 200}) {
+    Mat a = random_matrix(n, n);
+    Vec x = random_vector(n);
+    Vec b = multiply(a, x);
+    assert(max_error(solve(a, b), x) < 1e-8);
+    assert(max_error(naive_solve(a, b), x) < 1e-8);
+  }
+}
+
+// Reusing the factorization for several right-hand sides.
+void test_reuse()
+{
+  const size_t n = 90;
+  Mat a = random_matrix(n, n);
+  lu_factorization<double> f = lu(a);
+
+  Mat x = random_matrix(n, 4);
+  Mat b = a * x;
+  assert(max_error(f.solve(b), x) < 1e-8);
+
+  // Solve into a column of a larger matrix.
+  Mat c(n, 3);
+  Vec y = random_vector(n);
+  Vec by = multiply(a, y);
+  for (size_t i = 0; i < n; ++i)
+    c(i, 1) = by(i);
+  f.solve_in_place(c.col(1));
+  for (size_t i = 0; i < n; ++i)
+    assert(abs(c(i, 1) - y(i)) < 1e-8 && c(i, 0) == 0);
+
+  // Factor a submatrix.
+  matrix_ref<double, 2> r = a(slice(0, 50), slice(10, 50));
+  Vec z = random_vector(50);
+  Mat ar = r;
+  assert(max_error(lu(r).solve(multiply(ar, z)), z) < 1e-8);
+}
+
+void test_singular()
+{
+  Mat a {
+    {1, 2},
+    {2, 4}
+  };
+  lu_factorization<double> f(a);
+  assert(f.singular());
+  assert(f.determinant() == 0);
+  try {
+    f.solve(Vec {1.0, 1.0});
+    assert(false);
+  } catch (singular_matrix&) {
+  }
+}
+
+
+void bench(size_t n)
+{
+  Mat a = random_matrix(n, n);
+  Vec b = random_vector(n);
+  Vec x1, x2;
+  double naive = time_it([&]() { x1 = naive_solve(a, b); });
+  double blocked = time_it([&]() { x2 = solve(a, b); });
+  cout << "solve " << n << ": naive " << naive << "ms"
+       << ", blocked " << blocked << "ms"
+       << " (" << naive / blocked << "x)"
+       << ", difference " << max_error(x1, x2) << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+  test_small();
+  test_sizes();
+  test_reuse();
+  test_singular();
+
+  run_benchmarks(argc, argv, bench);
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+
+#include <origin/math/matrix/factor.hpp>
+
+#include "../matrix.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+Mat transpose(const Mat& a)
+{
+  Mat r(a.cols(), a.rows());
+  for (size_t i = 0; i < a.rows(); ++i)
+    for (size_t j = 0; j < a.cols(); ++j)
+      r(j, i) = a(i, j);
+  return r;
+}
+
+// Check that A = Q R, Q^T Q = I, and R is upper triangular.
+void test_factors(size_t m, size_t n)
+{
+  Mat a = random_matrix(m, n);
+  qr_factorization<double> f = qr(a);
+  Mat q = f.q();
+  Mat r = f.r();
+  assert(q.rows() == m && q.cols() == n);
+  assert(max_error(q * r, a) < 1e-10);
+
+  Mat id(n, n);
+  for (size_t i = 0; i < n; ++i)
+    id(i, i) = 1;
+  assert(max_error(transpose(q) * q, id) < 1e-10);
+
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < i; ++j)
+      assert(r(i, j) == 0);
+}
+
+void test_solve()
+{
+  // A square system.
+  Mat a = random_matrix(80, 80);
+  Mat x = random_matrix(80, 2);
+  assert(max_error(qr(a).solve(a * x), x) < 1e-8);
+
+  // A least squares problem: fit a line to points lying on y = 2t + 1.
+  Mat v {
+    {1, 0},
+    {1, 1},
+    {1, 2},
+    {1, 3}
+  };
+  Vec y {1.0, 3.0, 5.0, 7.0};
+  Vec c = qr(v).solve(y);
+  assert(c.size() == 2);
+  assert(abs(c(0) - 1) < 1e-12 && abs(c(1) - 2) < 1e-12);
+
+  // The residual of a least squares solution is orthogonal to the columns
+  // of A.
+  Mat b = random_matrix(150, 70);
+  Mat r = random_matrix(150, 1);
+  Mat z = qr(b).solve(r);
+  Mat res = r - b * z;
+  assert(max_error(transpose(b) * res, Mat(70, 1)) < 1e-10);
+}
+
+void test_rank_deficient()
+{
+  Mat a {
+    {1, 2},
+    {2, 4},
+    {3, 6}
+  };
+  try {
+    qr(a).solve(Vec {1.0, 2.0, 3.0});
+    assert(false);
+  } catch (singular_matrix&) {
+  }
+}
+
+int main()
+{
+  for (size_t n : {1, 3, 64, 65, 130})
+    test_factors(n + 7, n);
+  test_factors(100, 100);
+  test_solve();
+  test_rank_deficient();
+}
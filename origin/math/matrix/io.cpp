@@ -0,0 +1,214 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cerrno>
+#include <limits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "io.hpp"
+
+namespace origin
+{
+  namespace matrix_impl
+  {
+    namespace
+    {
+      constexpr char magic[8] = {'O', 'R', 'I', 'G', 'M', 'A', 'T', 0};
+      constexpr std::uint32_t byte_order = 0x01020304;
+      constexpr std::uint32_t version = 1;
+      constexpr std::size_t alignment = 64;
+
+      // The fixed portion of the header.
+      struct header
+      {
+        char magic[8];
+        std::uint32_t byte_order;
+        std::uint32_t version;
+        std::uint32_t type;
+        std::uint32_t element_size;
+        std::uint32_t order;
+        std::uint32_t reserved;
+        std::uint64_t offset;
+        std::uint64_t count;
+      };
+
+      static_assert(sizeof(header) == 48, "unexpected header layout");
+
+      // Returns the offset of the elements of a matrix of the given order.
+      std::uint64_t
+      element_offset(std::uint32_t order)
+      {
+        std::uint64_t n = sizeof(header) + 2 * order * sizeof(std::uint64_t);
+        return (n + alignment - 1) / alignment * alignment;
+      }
+
+      std::string
+      system_error(const std::string& what, const std::string& path)
+      {
+        return what + " " + path + ": " + std::strerror(errno);
+      }
+    } // namespace
+
+
+    void
+    write_matrix_header(std::ostream& os, const matrix_file_info& info)
+    {
+      header h {};
+      std::memcpy(h.magic, magic, sizeof(magic));
+      h.byte_order = byte_order;
+      h.version = version;
+      h.type = info.type;
+      h.element_size = info.element_size;
+      h.order = info.order;
+      h.offset = element_offset(info.order);
+      h.count = info.count;
+
+      std::vector<std::uint64_t> dims(2 * info.order);
+      std::copy_n(info.extents, info.order, dims.begin());
+      std::copy_n(info.strides, info.order, dims.begin() + info.order);
+
+      os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+      os.write(reinterpret_cast<const char*>(dims.data()),
+               dims.size() * sizeof(std::uint64_t));
+
+      std::size_t pad = h.offset - sizeof(h) - dims.size() * sizeof(std::uint64_t);
+      const char zeros[alignment] = {};
+      os.write(zeros, pad);
+    }
+
+
+    mapped_file::mapped_file(const std::string& path)
+      : addr(nullptr), len(0)
+    {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0)
+        throw matrix_file_error(system_error("cannot open", path));
+
+      struct stat st;
+      if (::fstat(fd, &st) < 0) {
+        std::string msg = system_error("cannot stat", path);
+        ::close(fd);
+        throw matrix_file_error(msg);
+      }
+
+      len = st.st_size;
+      if (len != 0) {
+        void* p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+          std::string msg = system_error("cannot map", path);
+          ::close(fd);
+          throw matrix_file_error(msg);
+        }
+        addr = static_cast<const char*>(p);
+      }
+
+      // The mapping remains valid after the file is closed.
+      ::close(fd);
+    }
+
+    mapped_file::~mapped_file()
+    {
+      if (addr)
+        ::munmap(const_cast<char*>(addr), len);
+    }
+
+    mapped_file::mapped_file(mapped_file&& x)
+      : addr(x.addr), len(x.len)
+    {
+      x.addr = nullptr;
+      x.len = 0;
+    }
+
+    mapped_file&
+    mapped_file::operator=(mapped_file&& x)
+    {
+      std::swap(addr, x.addr);
+      std::swap(len, x.len);
+      return *this;
+    }
+
+
+    const void*
+    read_matrix_header(const mapped_file& file,
+                       const std::string& path,
+                       std::uint32_t type,
+                       std::uint32_t element_size,
+                       std::uint32_t order,
+                       std::size_t* extents,
+                       std::size_t* strides)
+    {
+      auto fail = [&](const char* why) {
+        return matrix_file_error(path + ": " + why);
+      };
+
+      header h;
+      if (file.size() < sizeof(h))
+        throw fail("not a matrix file");
+      std::memcpy(&h, file.data(), sizeof(h));
+      if (std::memcmp(h.magic, magic, sizeof(magic)) != 0)
+        throw fail("not a matrix file");
+      if (h.byte_order != byte_order)
+        throw fail("byte order does not match the host");
+      if (h.version != version)
+        throw fail("unsupported version");
+      if (h.type != type || h.element_size != element_size)
+        throw fail("element type does not match");
+      if (h.order != order)
+        throw fail("order does not match");
+      if (h.offset % alignment != 0 || h.offset < element_offset(order))
+        throw fail("invalid element offset");
+      if (h.offset > file.size()
+          || h.count > (file.size() - h.offset) / element_size)
+        throw fail("file is truncated");
+
+      std::vector<std::uint64_t> dims(2 * order);
+      std::memcpy(dims.data(), file.data() + sizeof(h),
+                  dims.size() * sizeof(std::uint64_t));
+
+      // The number of elements must be representable.
+      const std::uint64_t max_size = std::numeric_limits<std::size_t>::max();
+      std::uint64_t size = 1;
+      for (std::uint32_t i = 0; i < order; ++i) {
+        if (dims[order + i] > max_size)
+          throw fail("invalid strides");
+        if (dims[i] != 0 && size > max_size / dims[i])
+          throw fail("extents are too large");
+        size *= dims[i];
+      }
+
+      // Every element of the matrix must lie within the stored elements:
+      // the offset of the last element, the sum of (extents[i] - 1) *
+      // strides[i], must be less than the count. Each term is checked
+      // against the remaining room so that the sum cannot overflow.
+      if (size != 0) {
+        if (h.count == 0)
+          throw fail("extents exceed the stored elements");
+        std::uint64_t room = h.count - 1;
+        for (std::uint32_t i = 0; i < order; ++i) {
+          std::uint64_t n = dims[i] - 1;
+          std::uint64_t s = dims[order + i];
+          if (n != 0 && s > room / n)
+            throw fail("extents exceed the stored elements");
+          room -= n * s;
+        }
+      }
+
+      for (std::uint32_t i = 0; i < order; ++i) {
+        extents[i] = dims[i];
+        strides[i] = dims[order + i];
+      }
+
+      return file.data() + h.offset;
+    }
+
+  } // namespace matrix_impl
+} // namespace origin
@@ -0,0 +1,253 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_IO_HPP
+#define ORIGIN_MATH_MATRIX_IO_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <origin/math/matrix/matrix.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                           Binary Matrix Files
+  //
+  // A binary matrix file stores the elements of a matrix in the native
+  // representation of the host, preceded by a header describing them. A file
+  // can be memory mapped and its elements accessed in place, without parsing
+  // or copying. For example:
+  //
+  //    save_matrix("a.mat", a);
+  //
+  //    mapped_matrix<double, 2> m("a.mat");  // Maps the file
+  //    matrix_ref<const double, 2> r = m;    // Refers to the mapped elements
+  //
+  //    matrix<double, 2> c = load_matrix<double, 2>("a.mat");  // A copy
+  //
+  // The file begins with the following header. All fields are in the byte
+  // order of the host that wrote the file.
+  //
+  //    magic        char[8]     "ORIGMAT" followed by a 0 byte
+  //    byte order   uint32      0x01020304, as written by the host
+  //    version      uint32      The format version (currently 1)
+  //    type         uint32      The element type (see matrix_file_type)
+  //    element size uint32      The size of an element in bytes
+  //    order        uint32      The order of the matrix, N
+  //    reserved     uint32      0
+  //    offset       uint64      The offset of the elements in the file
+  //    count        uint64      The number of elements stored
+  //    extents      uint64[N]   The extents of the matrix
+  //    strides      uint64[N]   The strides of the matrix
+  //
+  // The elements start at offset, which is a multiple of 64 so that the
+  // mapped elements are suitably aligned for vector instructions. A matrix
+  // with the given extents and strides is laid over the count elements
+  // stored there. Files written by save_matrix are always stored in
+  // row-major order, but readers accept any strides that lie within the
+  // stored elements.
+  //
+  // Memory mapping requires a POSIX system.
+
+
+  // The matrix file error is thrown when a matrix file cannot be read or
+  // written, or when its contents do not describe a matrix of the requested
+  // type.
+  struct matrix_file_error : std::runtime_error
+  {
+    explicit matrix_file_error(const std::string& what)
+      : std::runtime_error(what)
+    { }
+  };
+
+
+  // Matrix file type
+  //
+  // The matrix file type trait associates a type code with each element type
+  // that can be stored in a matrix file.
+  template <typename T>
+    struct matrix_file_type;
+
+#define ORIGIN_MATRIX_FILE_TYPE(T, N)                                         \
+  template <>                                                                 \
+    struct matrix_file_type<T>                                                \
+      : std::integral_constant<std::uint32_t, N>                             \
+    { };
+
+  ORIGIN_MATRIX_FILE_TYPE(std::int8_t, 1)
+  ORIGIN_MATRIX_FILE_TYPE(std::uint8_t, 2)
+  ORIGIN_MATRIX_FILE_TYPE(std::int16_t, 3)
+  ORIGIN_MATRIX_FILE_TYPE(std::uint16_t, 4)
+  ORIGIN_MATRIX_FILE_TYPE(std::int32_t, 5)
+  ORIGIN_MATRIX_FILE_TYPE(std::uint32_t, 6)
+  ORIGIN_MATRIX_FILE_TYPE(std::int64_t, 7)
+  ORIGIN_MATRIX_FILE_TYPE(std::uint64_t, 8)
+  ORIGIN_MATRIX_FILE_TYPE(float, 9)
+  ORIGIN_MATRIX_FILE_TYPE(double, 10)
+
+#undef ORIGIN_MATRIX_FILE_TYPE
+
+
+  namespace matrix_impl
+  {
+    // The description of the elements in a matrix file.
+    struct matrix_file_info
+    {
+      std::uint32_t type;
+      std::uint32_t element_size;
+      std::uint32_t order;
+      std::uint64_t count;
+      const std::size_t* extents;
+      const std::size_t* strides;
+    };
+
+    // Write the header described by info to the stream. The stream is
+    // positioned at the start of the elements.
+    void write_matrix_header(std::ostream& os, const matrix_file_info& info);
+
+    // A mapped file is a read-only memory mapping of an entire file. The
+    // mapping is released when the object is destroyed.
+    class mapped_file
+    {
+    public:
+      explicit mapped_file(const std::string& path);
+      ~mapped_file();
+
+      mapped_file(mapped_file&& x);
+      mapped_file& operator=(mapped_file&& x);
+
+      mapped_file(const mapped_file&) = delete;
+      mapped_file& operator=(const mapped_file&) = delete;
+
+      const char* data() const { return addr; }
+      std::size_t size() const { return len; }
+
+    private:
+      const char* addr;
+      std::size_t len;
+    };
+
+    // Validate the header of the mapped file against the given element type,
+    // element size and order, and store its extents and strides in the
+    // arrays extents and strides, each having order elements. Returns a
+    // pointer to the mapped elements. Throws matrix_file_error if the file
+    // is not a valid matrix file or does not match.
+    const void* read_matrix_header(const mapped_file& file,
+                                   const std::string& path,
+                                   std::uint32_t type,
+                                   std::uint32_t element_size,
+                                   std::uint32_t order,
+                                   std::size_t* extents,
+                                   std::size_t* strides);
+
+  } // namespace matrix_impl
+
+
+  // Save matrix
+  //
+  // Write the matrix m to the file at path, replacing its contents. The
+  // elements are written in row-major order. Throws matrix_file_error if the
+  // file cannot be written.
+  template <typename M>
+    void
+    save_matrix(const std::string& path, const M& m)
+    {
+      using T = Value_type<M>;
+      constexpr std::size_t N = M::order;
+      static_assert(matrix_impl::Strided_matrix<M>(), "");
+
+      std::ofstream os(path, std::ios::binary | std::ios::trunc);
+      if (!os)
+        throw matrix_file_error("cannot open " + path + " for writing");
+
+      const auto& d = m.descriptor();
+      matrix_slice<N> s(0, d.extents);
+      matrix_impl::matrix_file_info info {
+        matrix_file_type<T>::value, sizeof(T), N, d.size,
+        s.extents, s.strides
+      };
+      matrix_impl::write_matrix_header(os, info);
+      for (auto c : row_chunks(m))
+        os.write(reinterpret_cast<const char*>(c.first), c.size() * sizeof(T));
+      if (!os.flush())
+        throw matrix_file_error("cannot write " + path);
+    }
+
+
+  // Mapped matrix
+  //
+  // A mapped matrix maps a matrix file into memory. The elements of the
+  // matrix are accessed through a matrix_ref that refers directly to the
+  // mapped pages; nothing is copied, and pages are read from the file on
+  // first access. The mapping is read-only. The matrix_ref is valid for the
+  // lifetime of the mapped matrix.
+  template <typename T, std::size_t N>
+    class mapped_matrix
+    {
+    public:
+      using value_type = T;
+      static constexpr std::size_t order = N;
+
+      // Map the matrix file at path. Throws matrix_file_error if the file
+      // cannot be mapped or does not contain an N-dimensional matrix of T.
+      explicit mapped_matrix(const std::string& path);
+
+      const matrix_slice<N>& descriptor() const { return desc; }
+
+      std::size_t extent(std::size_t n) const { return desc.extents[n]; }
+      std::size_t size() const { return desc.size; }
+
+      // Returns a matrix_ref referring to the mapped elements.
+      matrix_ref<const T, N> ref() const { return {desc, elems}; }
+      operator matrix_ref<const T, N>() const { return ref(); }
+
+    private:
+      matrix_impl::mapped_file file;
+      matrix_slice<N> desc;
+      const T* elems;
+    };
+
+  template <typename T, std::size_t N>
+    mapped_matrix<T, N>::mapped_matrix(const std::string& path)
+      : file(path), desc()
+    {
+      std::size_t ext[N], str[N];
+      const void* p = matrix_impl::read_matrix_header(
+        file, path, matrix_file_type<T>::value, sizeof(T), N, ext, str);
+      desc = matrix_slice<N>(0, ext);
+      std::copy_n(str, N, desc.strides);
+      elems = static_cast<const T*>(p);
+    }
+
+
+  // Load matrix
+  //
+  // Returns a matrix containing a copy of the elements of the matrix file at
+  // path. The file is mapped and its elements copied into the matrix, so
+  // there is no parsing. Throws matrix_file_error if the file does not
+  // contain an N-dimensional matrix of T.
+  template <typename T, std::size_t N>
+    matrix<T, N>
+    load_matrix(const std::string& path)
+    {
+      mapped_matrix<T, N> m(path);
+      const auto& d = m.descriptor();
+      matrix<T, N> r(uninitialized, matrix_slice<N>(0, d.extents));
+      if (matrix_impl::is_contiguous(d))
+        std::memcpy(r.data(), m.ref().data() + d.start, d.size * sizeof(T));
+      else
+        r = m.ref();
+      return r;
+    }
+
+} // namespace origin
+
+#endif
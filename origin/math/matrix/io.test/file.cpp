@@ -0,0 +1,148 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include <origin/math/matrix/io.hpp>
+
+using namespace std;
+using namespace origin;
+
+const char* path = "io_test.mat";
+
+template <typename T, size_t N>
+  void round_trip(const matrix<T, N>& m)
+  {
+    save_matrix(path, m);
+
+    mapped_matrix<T, N> mm(path);
+    matrix_ref<const T, N> r = mm;
+    assert(r == m);
+    assert(reinterpret_cast<uintptr_t>(r.data()) % 64 == 0);
+
+    matrix<T, N> c = load_matrix<T, N>(path);
+    assert(c == m);
+  }
+
+// Returns true if loading the file throws a matrix_file_error.
+template <typename T, size_t N>
+  bool load_fails()
+  {
+    try {
+      load_matrix<T, N>(path);
+    } catch (matrix_file_error&) {
+      return true;
+    }
+    return false;
+  }
+
+void test_round_trip()
+{
+  round_trip(matrix<double, 1> {1.0, 2.0, 3.0});
+  round_trip(matrix<int, 2> {{1, 2, 3}, {4, 5, 6}});
+  round_trip(matrix<float, 3> {{{1, 2}, {3, 4}}, {{5, 6}, {7, 8}}});
+  round_trip(matrix<int64_t, 2>(0, 5));
+
+  matrix<double, 2> big(300, 200);
+  iota(big.begin(), big.end(), 0.0);
+  round_trip(big);
+}
+
+// Saving a strided view writes its elements in row-major order.
+void test_view()
+{
+  matrix<int, 2> m(6, 8);
+  iota(m.begin(), m.end(), 0);
+  matrix_ref<int, 2> r = m(slice(1, 2, 2), slice(2, 3));
+  save_matrix(path, r);
+
+  mapped_matrix<int, 2> mm(path);
+  assert(mm.extent(0) == 2 && mm.extent(1) == 3);
+  assert(mm.ref() == r);
+  assert(mm.ref()(1, 2) == m(3, 4));
+}
+
+// Files whose type or order do not match the request are rejected.
+void test_errors()
+{
+  save_matrix(path, matrix<int, 2> {{1, 2}, {3, 4}});
+  assert((load_fails<float, 2>()));
+  assert((load_fails<int, 1>()));
+  assert((!load_fails<int, 2>()));
+
+  // A truncated file.
+  {
+    ofstream os(path, ios::binary | ios::trunc);
+    os << "ORIGMAT";
+  }
+  assert((load_fails<int, 2>()));
+
+  remove(path);
+  assert((load_fails<int, 2>()));
+}
+
+// Overwrite the extents and strides stored in the header of the file.
+void write_dims(const vector<uint64_t>& dims)
+{
+  fstream fs(path, ios::binary | ios::in | ios::out);
+  fs.seekp(48);
+  fs.write(reinterpret_cast<const char*>(dims.data()), dims.size() * 8);
+}
+
+// Returns true if mapping the file throws a matrix_file_error.
+template <typename T, size_t N>
+  bool map_fails()
+  {
+    try {
+      mapped_matrix<T, N> m(path);
+    } catch (matrix_file_error&) {
+      return true;
+    }
+    return false;
+  }
+
+// Headers whose extents and strides reach past the stored elements are
+// rejected, even when computing the last element would overflow.
+void test_corrupt_header()
+{
+  save_matrix(path, matrix<double, 1> {1.0, 2.0, 3.0, 4.0});
+  write_dims({4, 1});
+  assert((!map_fails<double, 1>()));
+  write_dims({5, 1});
+  assert((map_fails<double, 1>()));
+  write_dims({2, 3});
+  assert((!map_fails<double, 1>()));
+  write_dims({2, 4});
+  assert((map_fails<double, 1>()));
+
+  // The offset of the last element wraps to 0.
+  write_dims({(uint64_t(1) << 63) + 1, 2});
+  assert((map_fails<double, 1>()));
+  assert((load_fails<double, 1>()));
+  write_dims({uint64_t(-1), uint64_t(-1)});
+  assert((map_fails<double, 1>()));
+
+  // The number of elements wraps to 0.
+  save_matrix(path, matrix<double, 2> {{1.0, 2.0}, {3.0, 4.0}});
+  write_dims({uint64_t(1) << 32, uint64_t(1) << 32, 0, 0});
+  assert((map_fails<double, 2>()));
+  write_dims({2, 2, 2, 1});
+  assert((!map_fails<double, 2>()));
+}
+
+int main()
+{
+  test_round_trip();
+  test_view();
+  test_errors();
+  test_corrupt_header();
+  remove(path);
+}
@@ -7,8 +7,512 @@
 
 #include "matrix.hpp"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define ORIGIN_MATRIX_X86 1
+#  include <immintrin.h>
+#endif
+
 namespace origin
 {
   slice slice::all {0, std::size_t(-1), 1};
-}
 
+
+  namespace matrix_impl
+  {
+    namespace
+    {
+      // ---------------------------------------------------------------------- //
+      //                            Scalar Kernels
+      //
+      // The scalar kernels are used when no vector instructions are available,
+      // or when an instruction set does not support an operation.
+
+      template <typename T>
+        inline T
+        compute(elementwise_op op, T a, T b)
+        {
+          switch (op) {
+          case elementwise_op::add: return a + b;
+          case elementwise_op::sub: return a - b;
+          case elementwise_op::mul: return a * b;
+          default: return a / b;
+          }
+        }
+
+      template <typename T>
+        void
+        scalar_kernel(elementwise_op op,
+                      const T* a, const T* b, T* out, std::size_t n)
+        {
+          switch (op) {
+          case elementwise_op::add:
+            for (std::size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+            break;
+          case elementwise_op::sub:
+            for (std::size_t i = 0; i < n; ++i) out[i] = a[i] - b[i];
+            break;
+          case elementwise_op::mul:
+            for (std::size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+            break;
+          case elementwise_op::div:
+            for (std::size_t i = 0; i < n; ++i) out[i] = a[i] / b[i];
+            break;
+          }
+        }
+
+      template <typename T>
+        void
+        scalar_kernel(elementwise_op op,
+                      const T* a, T x, T* out, std::size_t n)
+        {
+          switch (op) {
+          case elementwise_op::add:
+            for (std::size_t i = 0; i < n; ++i) out[i] = a[i] + x;
+            break;
+          case elementwise_op::sub:
+            for (std::size_t i = 0; i < n; ++i) out[i] = a[i] - x;
+            break;
+          case elementwise_op::mul:
+            for (std::size_t i = 0; i < n; ++i) out[i] = a[i] * x;
+            break;
+          case elementwise_op::div:
+            for (std::size_t i = 0; i < n; ++i) out[i] = a[i] / x;
+            break;
+          }
+        }
+
+
+#if ORIGIN_MATRIX_X86
+      // ---------------------------------------------------------------------- //
+      //                            Vector Kernels
+      //
+      // Each vector traits class describes the vector registers of an
+      // instruction set for a value type. The traits provide load, store, and
+      // broadcast (set) operations and an overload of compute for each
+      // supported operation code. The supports function returns true when
+      // an operation code is supported.
+      //
+      // The kernels process as many whole vectors as possible and finish the
+      // remaining elements with scalar code.
+
+#  define ORIGIN_SSE2 __attribute__((target("sse2")))
+#  define ORIGIN_AVX2 __attribute__((target("avx2")))
+
+      struct sse2_f32
+      {
+        using value_type = float;
+        using vector = __m128;
+        static constexpr std::size_t width = 4;
+
+        static bool supports(elementwise_op) { return true; }
+
+        ORIGIN_SSE2 static vector load(const float* p) { return _mm_loadu_ps(p); }
+        ORIGIN_SSE2 static void store(float* p, vector v) { _mm_storeu_ps(p, v); }
+        ORIGIN_SSE2 static vector set(float x) { return _mm_set1_ps(x); }
+
+        ORIGIN_SSE2 static vector
+        compute(elementwise_op op, vector a, vector b)
+        {
+          switch (op) {
+          case elementwise_op::add: return _mm_add_ps(a, b);
+          case elementwise_op::sub: return _mm_sub_ps(a, b);
+          case elementwise_op::mul: return _mm_mul_ps(a, b);
+          default: return _mm_div_ps(a, b);
+          }
+        }
+      };
+
+      struct sse2_f64
+      {
+        using value_type = double;
+        using vector = __m128d;
+        static constexpr std::size_t width = 2;
+
+        static bool supports(elementwise_op) { return true; }
+
+        ORIGIN_SSE2 static vector load(const double* p) { return _mm_loadu_pd(p); }
+        ORIGIN_SSE2 static void store(double* p, vector v) { _mm_storeu_pd(p, v); }
+        ORIGIN_SSE2 static vector set(double x) { return _mm_set1_pd(x); }
+
+        ORIGIN_SSE2 static vector
+        compute(elementwise_op op, vector a, vector b)
+        {
+          switch (op) {
+          case elementwise_op::add: return _mm_add_pd(a, b);
+          case elementwise_op::sub: return _mm_sub_pd(a, b);
+          case elementwise_op::mul: return _mm_mul_pd(a, b);
+          default: return _mm_div_pd(a, b);
+          }
+        }
+      };
+
+      // SSE2 has no packed 32-bit multiply (that requires SSE4.1).
+      struct sse2_i32
+      {
+        using value_type = std::int32_t;
+        using vector = __m128i;
+        static constexpr std::size_t width = 4;
+
+        static bool
+        supports(elementwise_op op)
+        {
+          return op == elementwise_op::add || op == elementwise_op::sub;
+        }
+
+        ORIGIN_SSE2 static vector
+        load(const std::int32_t* p)
+        {
+          return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        ORIGIN_SSE2 static void
+        store(std::int32_t* p, vector v)
+        {
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+        }
+
+        ORIGIN_SSE2 static vector set(std::int32_t x) { return _mm_set1_epi32(x); }
+
+        ORIGIN_SSE2 static vector
+        compute(elementwise_op op, vector a, vector b)
+        {
+          if (op == elementwise_op::add)
+            return _mm_add_epi32(a, b);
+          else
+            return _mm_sub_epi32(a, b);
+        }
+      };
+
+      struct sse2_i64
+      {
+        using value_type = std::int64_t;
+        using vector = __m128i;
+        static constexpr std::size_t width = 2;
+
+        static bool
+        supports(elementwise_op op)
+        {
+          return op == elementwise_op::add || op == elementwise_op::sub;
+        }
+
+        ORIGIN_SSE2 static vector
+        load(const std::int64_t* p)
+        {
+          return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        ORIGIN_SSE2 static void
+        store(std::int64_t* p, vector v)
+        {
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+        }
+
+        ORIGIN_SSE2 static vector set(std::int64_t x) { return _mm_set1_epi64x(x); }
+
+        ORIGIN_SSE2 static vector
+        compute(elementwise_op op, vector a, vector b)
+        {
+          if (op == elementwise_op::add)
+            return _mm_add_epi64(a, b);
+          else
+            return _mm_sub_epi64(a, b);
+        }
+      };
+
+      struct avx2_f32
+      {
+        using value_type = float;
+        using vector = __m256;
+        static constexpr std::size_t width = 8;
+
+        static bool supports(elementwise_op) { return true; }
+
+        ORIGIN_AVX2 static vector load(const float* p) { return _mm256_loadu_ps(p); }
+        ORIGIN_AVX2 static void store(float* p, vector v) { _mm256_storeu_ps(p, v); }
+        ORIGIN_AVX2 static vector set(float x) { return _mm256_set1_ps(x); }
+
+        ORIGIN_AVX2 static vector
+        compute(elementwise_op op, vector a, vector b)
+        {
+          switch (op) {
+          case elementwise_op::add: return _mm256_add_ps(a, b);
+          case elementwise_op::sub: return _mm256_sub_ps(a, b);
+          case elementwise_op::mul: return _mm256_mul_ps(a, b);
+          default: return _mm256_div_ps(a, b);
+          }
+        }
+      };
+
+      struct avx2_f64
+      {
+        using value_type = double;
+        using vector = __m256d;
+        static constexpr std::size_t width = 4;
+
+        static bool supports(elementwise_op) { return true; }
+
+        ORIGIN_AVX2 static vector load(const double* p) { return _mm256_loadu_pd(p); }
+        ORIGIN_AVX2 static void store(double* p, vector v) { _mm256_storeu_pd(p, v); }
+        ORIGIN_AVX2 static vector set(double x) { return _mm256_set1_pd(x); }
+
+        ORIGIN_AVX2 static vector
+        compute(elementwise_op op, vector a, vector b)
+        {
+          switch (op) {
+          case elementwise_op::add: return _mm256_add_pd(a, b);
+          case elementwise_op::sub: return _mm256_sub_pd(a, b);
+          case elementwise_op::mul: return _mm256_mul_pd(a, b);
+          default: return _mm256_div_pd(a, b);
+          }
+        }
+      };
+
+      struct avx2_i32
+      {
+        using value_type = std::int32_t;
+        using vector = __m256i;
+        static constexpr std::size_t width = 8;
+
+        static bool
+        supports(elementwise_op op)
+        {
+          return op != elementwise_op::div;
+        }
+
+        ORIGIN_AVX2 static vector
+        load(const std::int32_t* p)
+        {
+          return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        ORIGIN_AVX2 static void
+        store(std::int32_t* p, vector v)
+        {
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+        }
+
+        ORIGIN_AVX2 static vector set(std::int32_t x) { return _mm256_set1_epi32(x); }
+
+        ORIGIN_AVX2 static vector
+        compute(elementwise_op op, vector a, vector b)
+        {
+          switch (op) {
+          case elementwise_op::add: return _mm256_add_epi32(a, b);
+          case elementwise_op::sub: return _mm256_sub_epi32(a, b);
+          default: return _mm256_mullo_epi32(a, b);
+          }
+        }
+      };
+
+      // AVX2 has no packed 64-bit multiply (that requires AVX-512).
+      struct avx2_i64
+      {
+        using value_type = std::int64_t;
+        using vector = __m256i;
+        static constexpr std::size_t width = 4;
+
+        static bool
+        supports(elementwise_op op)
+        {
+          return op == elementwise_op::add || op == elementwise_op::sub;
+        }
+
+        ORIGIN_AVX2 static vector
+        load(const std::int64_t* p)
+        {
+          return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        ORIGIN_AVX2 static void
+        store(std::int64_t* p, vector v)
+        {
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+        }
+
+        ORIGIN_AVX2 static vector set(std::int64_t x) { return _mm256_set1_epi64x(x); }
+
+        ORIGIN_AVX2 static vector
+        compute(elementwise_op op, vector a, vector b)
+        {
+          if (op == elementwise_op::add)
+            return _mm256_add_epi64(a, b);
+          else
+            return _mm256_sub_epi64(a, b);
+        }
+      };
+
+
+      // The vector kernels. Because the target attribute cannot depend on a
+      // template parameter, there is one kernel template per instruction set.
+      // The loops are unrolled by two vectors.
+      //
+      // NOTE: The operation is a template argument of the loops. The kernel
+      // switches on it once, and each loop is instantiated for a single
+      // operation, so the compute calls in the inner loops are inlined
+      // without a test of the operation.
+#  define ORIGIN_VECTOR_KERNELS(ISA, TARGET)                                   \
+      template <elementwise_op Op, typename V, typename T>                    \
+        TARGET void                                                           \
+        ISA##_loop(const T* a, const T* b, T* out, std::size_t n)             \
+        {                                                                     \
+          constexpr std::size_t W = V::width;                                 \
+          std::size_t i = 0;                                                  \
+          for ( ; i + 2 * W <= n; i += 2 * W) {                               \
+            auto x0 = V::compute(Op, V::load(a + i), V::load(b + i));         \
+            auto x1 = V::compute(Op, V::load(a + i + W), V::load(b + i + W)); \
+            V::store(out + i, x0);                                            \
+            V::store(out + i + W, x1);                                        \
+          }                                                                   \
+          for ( ; i + W <= n; i += W)                                         \
+            V::store(out + i, V::compute(Op, V::load(a + i), V::load(b + i)));\
+          for ( ; i < n; ++i)                                                 \
+            out[i] = compute(Op, a[i], b[i]);                                 \
+        }                                                                     \
+                                                                              \
+      template <elementwise_op Op, typename V, typename T>                    \
+        TARGET void                                                           \
+        ISA##_loop(const T* a, T x, T* out, std::size_t n)                    \
+        {                                                                     \
+          constexpr std::size_t W = V::width;                                 \
+          const auto v = V::set(x);                                           \
+          std::size_t i = 0;                                                  \
+          for ( ; i + 2 * W <= n; i += 2 * W) {                               \
+            auto x0 = V::compute(Op, V::load(a + i), v);                      \
+            auto x1 = V::compute(Op, V::load(a + i + W), v);                  \
+            V::store(out + i, x0);                                            \
+            V::store(out + i + W, x1);                                        \
+          }                                                                   \
+          for ( ; i + W <= n; i += W)                                         \
+            V::store(out + i, V::compute(Op, V::load(a + i), v));             \
+          for ( ; i < n; ++i)                                                 \
+            out[i] = compute(Op, a[i], x);                                    \
+        }                                                                     \
+                                                                              \
+      template <typename V, typename T, typename U>                           \
+        TARGET void                                                           \
+        ISA##_kernel(elementwise_op op,                                       \
+                     const T* a, U b, T* out, std::size_t n)                  \
+        {                                                                     \
+          switch (op) {                                                       \
+          case elementwise_op::add:                                           \
+            return ISA##_loop<elementwise_op::add, V>(a, b, out, n);          \
+          case elementwise_op::sub:                                           \
+            return ISA##_loop<elementwise_op::sub, V>(a, b, out, n);          \
+          case elementwise_op::mul:                                           \
+            return ISA##_loop<elementwise_op::mul, V>(a, b, out, n);          \
+          case elementwise_op::div:                                           \
+            return ISA##_loop<elementwise_op::div, V>(a, b, out, n);          \
+          }                                                                   \
+        }
+
+      ORIGIN_VECTOR_KERNELS(sse2, ORIGIN_SSE2)
+      ORIGIN_VECTOR_KERNELS(avx2, ORIGIN_AVX2)
+
+#  undef ORIGIN_VECTOR_KERNELS
+#  undef ORIGIN_SSE2
+#  undef ORIGIN_AVX2
+#endif
+
+
+      // ---------------------------------------------------------------------- //
+      //                              Dispatch
+      //
+      // The instruction set is selected by the dispatch layer of the
+      // sequence algorithms (see algorithm_impl::simd_level).
+
+      // Dispatch the operation to the kernel for the selected instruction
+      // set. SSE and AVX vector traits are given by S and A, respectively.
+      template <typename S, typename A, typename T, typename U>
+        inline void
+        dispatch(elementwise_op op, const T* a, U b, T* out, std::size_t n)
+        {
+#if ORIGIN_MATRIX_X86
+          switch (simd_level()) {
+          case simd_isa::avx2:
+            if (A::supports(op))
+              return avx2_kernel<A>(op, a, b, out, n);
+            // Fall through
+          case simd_isa::sse2:
+            if (S::supports(op))
+              return sse2_kernel<S>(op, a, b, out, n);
+            // Fall through
+          default:
+            break;
+          }
+#endif
+          scalar_kernel(op, a, b, out, n);
+        }
+
+    } // namespace
+
+
+#if ORIGIN_MATRIX_X86
+#  define ORIGIN_DISPATCH(S, A) dispatch<S, A>
+#else
+#  define ORIGIN_DISPATCH(S, A) dispatch<void, void>
+#endif
+
+    void
+    simd_elementwise(elementwise_op op,
+                     const float* a, const float* b, float* out, std::size_t n)
+    {
+      ORIGIN_DISPATCH(sse2_f32, avx2_f32)(op, a, b, out, n);
+    }
+
+    void
+    simd_elementwise(elementwise_op op,
+                     const double* a, const double* b, double* out, std::size_t n)
+    {
+      ORIGIN_DISPATCH(sse2_f64, avx2_f64)(op, a, b, out, n);
+    }
+
+    void
+    simd_elementwise(elementwise_op op,
+                     const std::int32_t* a, const std::int32_t* b,
+                     std::int32_t* out, std::size_t n)
+    {
+      ORIGIN_DISPATCH(sse2_i32, avx2_i32)(op, a, b, out, n);
+    }
+
+    void
+    simd_elementwise(elementwise_op op,
+                     const std::int64_t* a, const std::int64_t* b,
+                     std::int64_t* out, std::size_t n)
+    {
+      ORIGIN_DISPATCH(sse2_i64, avx2_i64)(op, a, b, out, n);
+    }
+
+    void
+    simd_elementwise(elementwise_op op,
+                     const float* a, float x, float* out, std::size_t n)
+    {
+      ORIGIN_DISPATCH(sse2_f32, avx2_f32)(op, a, x, out, n);
+    }
+
+    void
+    simd_elementwise(elementwise_op op,
+                     const double* a, double x, double* out, std::size_t n)
+    {
+      ORIGIN_DISPATCH(sse2_f64, avx2_f64)(op, a, x, out, n);
+    }
+
+    void
+    simd_elementwise(elementwise_op op,
+                     const std::int32_t* a, std::int32_t x,
+                     std::int32_t* out, std::size_t n)
+    {
+      ORIGIN_DISPATCH(sse2_i32, avx2_i32)(op, a, x, out, n);
+    }
+
+    void
+    simd_elementwise(elementwise_op op,
+                     const std::int64_t* a, std::int64_t x,
+                     std::int64_t* out, std::size_t n)
+    {
+      ORIGIN_DISPATCH(sse2_i64, avx2_i64)(op, a, x, out, n);
+    }
+
+#undef ORIGIN_DISPATCH
+
+  } // namespace matrix_impl
+} // namespace origin
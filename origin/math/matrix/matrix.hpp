@@ -10,21 +10,30 @@
 
 
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <algorithm>
 #include <array>
+#include <functional>
 #include <numeric>
+#include <vector>
 
 #include <origin/type/concepts.hpp>
 #include <origin/type/typestr.hpp>
 #include <origin/sequence/algorithm.hpp>
+#include <origin/sequence/execution.hpp>
+#include <origin/memory/allocator.hpp>
 
 namespace origin
 {
   // Declarations
   struct slice;
   template <std::size_t N> class matrix_slice;
-  template <typename T, std::size_t N> class matrix;
+  template <typename T, std::size_t N, typename A = aligned_allocator<T>> 
+    class matrix;
   template <typename T, std::size_t N> class matrix_ref;
+  template <typename T, std::size_t... Extents> class fixed_matrix;
+  template <typename Op, typename E1, typename E2> class matrix_expr;
 
 
 // Type traits implementations
@@ -62,13 +71,22 @@ namespace origin
 #include "matrix.impl/slice.hpp"
 #include "matrix.impl/iterator.hpp"
 #include "matrix.impl/support.hpp"
+#include "matrix.impl/buffer.hpp"
+#include "matrix.impl/kernel.hpp"
+#include "matrix.impl/simd.hpp"
+#include "matrix.impl/expression.hpp"
 
 // Matrix classes
 #include "matrix.impl/matrix.hpp"
 #include "matrix.impl/matrix_ref.hpp"
+#include "matrix.impl/fixed.hpp"
 
 // Arithmetic and linear operations
 #include "matrix.impl/operations.hpp"
+#include "matrix.impl/parallel.hpp"
+#include "matrix.impl/batch.hpp"
+#include "matrix.impl/reduce.hpp"
+#include "matrix.impl/blas.hpp"
 
 
 } // namespace origin
@@ -0,0 +1,286 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Batched Product                                                 [matrix.batch]
+//
+// A batched product computes many independent products of small matrices in
+// a single call. The batch is given either as 3D matrices, where the kth
+// matrix of the batch is the kth row (i.e., a[k] is a 2D matrix_ref), or as
+// random access ranges of 2D matrices (e.g., vectors of matrix_refs):
+//
+//    batch_product(a, b, out)      -- Compute out[k] += a[k] * b[k]
+//    batch_product(p, a, b, out)   -- The same, using execution policy p
+//
+// As with matrix_product, the products are accumulated into out, which must
+// be allocated (and typically zero-initialized) by the caller.
+//
+// Each product is computed directly by a small kernel instead of the cache
+// blocked gemm kernel, whose packing overhead dominates for small matrices.
+// Square products of order 4, 8, 16 and 32 use kernels with constant
+// bounds. Products whose rows are not contiguous (e.g., transposed views)
+// are computed by gemm_kernel with the strides of each item. Nothing is
+// allocated by the batched product, except that large strided items may
+// grow the per-thread gemm workspace (see gemm_workspace) the first time they
+// are packed. With the parallel policy, blocks of the batch are computed in
+// parallel.
+
+namespace matrix_impl
+{
+  // Compute c += a * b, where a is m x p, b is p x n and c is m x n. Each
+  // matrix is stored in row-major order with the given leading dimension.
+  template <typename T>
+    inline void
+    batch_kernel(std::size_t m, std::size_t p, std::size_t n,
+                 const T* a, std::size_t lda,
+                 const T* b, std::size_t ldb,
+                 T* c, std::size_t ldc)
+    {
+      for (std::size_t i = 0; i < m; ++i) {
+        const T* ai = a + i * lda;
+        T* ci = c + i * ldc;
+        for (std::size_t k = 0; k < p; ++k) {
+          const T aik = ai[k];
+          const T* bk = b + k * ldb;
+          for (std::size_t j = 0; j < n; ++j)
+            ci[j] += aik * bk[j];
+        }
+      }
+    }
+
+  // Compute c += a * b for square matrices of order N. Each row of c is
+  // accumulated in a local array.
+  template <std::size_t N, typename T>
+    inline void
+    batch_kernel(const T* a, std::size_t lda,
+                 const T* b, std::size_t ldb,
+                 T* c, std::size_t ldc)
+    {
+      for (std::size_t i = 0; i < N; ++i) {
+        const T* ai = a + i * lda;
+        T* ci = c + i * ldc;
+        T acc[N];
+        for (std::size_t j = 0; j < N; ++j)
+          acc[j] = ci[j];
+        for (std::size_t k = 0; k < N; ++k) {
+          const T aik = ai[k];
+          const T* bk = b + k * ldb;
+          for (std::size_t j = 0; j < N; ++j)
+            acc[j] += aik * bk[j];
+        }
+        for (std::size_t j = 0; j < N; ++j)
+          ci[j] = acc[j];
+      }
+    }
+
+  // Select a kernel for the product of the given extents.
+  template <typename T>
+    inline void
+    batch_item(std::size_t m, std::size_t p, std::size_t n,
+               const T* a, std::size_t lda,
+               const T* b, std::size_t ldb,
+               T* c, std::size_t ldc)
+    {
+      if (m == p && p == n) {
+        switch (n) {
+        case 4: batch_kernel<4>(a, lda, b, ldb, c, ldc); return;
+        case 8: batch_kernel<8>(a, lda, b, ldb, c, ldc); return;
+        case 16: batch_kernel<16>(a, lda, b, ldb, c, ldc); return;
+        case 32: batch_kernel<32>(a, lda, b, ldb, c, ldc); return;
+        default: break;
+        }
+      }
+      batch_kernel(m, p, n, a, lda, b, ldb, c, ldc);
+    }
+
+  // Compute out += a * b for 2D strided matrices using the batch kernels if
+  // the operands have contiguous rows, and gemm_kernel otherwise.
+  template <typename M1, typename M2, typename M3>
+    inline void
+    batch_item(const M1& a, const M2& b, M3& out, std::true_type)
+    {
+      const auto& da = a.descriptor();
+      const auto& db = b.descriptor();
+      const auto& dc = out.descriptor();
+      if (da.strides[1] == 1 && db.strides[1] == 1 && dc.strides[1] == 1)
+        batch_item(rows(a), cols(a), cols(b),
+                   a.data() + da.start, da.strides[0],
+                   b.data() + db.start, db.strides[0],
+                   out.data() + dc.start, dc.strides[0]);
+      else
+        gemm_kernel(rows(a), cols(b), cols(a), Value_type<M3>(1),
+                    a.data() + da.start, da.strides[0], da.strides[1],
+                    b.data() + db.start, db.strides[0], db.strides[1],
+                    out.data() + dc.start, dc.strides[0], dc.strides[1]);
+    }
+
+  template <typename M1, typename M2, typename M3>
+    inline void
+    batch_item(const M1& a, const M2& b, M3& out, std::false_type)
+    {
+      matrix_product(a, b, out);
+    }
+
+  template <typename M1, typename M2, typename M3>
+    inline void
+    batch_item(const M1& a, const M2& b, M3& out)
+    {
+      using Fast = std::integral_constant<bool, Blocked_product<M1, M2, M3>()>;
+      assert(cols(a) == rows(b));
+      assert(rows(a) == rows(out));
+      assert(cols(b) == cols(out));
+      batch_item(a, b, out, Fast());
+    }
+
+
+  // Compute products [first, last) of a batch of 3D matrices.
+  template <typename M1, typename M2, typename M3>
+    void
+    batch_block(const M1& a, const M2& b, M3& out,
+                std::size_t first, std::size_t last, std::true_type)
+    {
+      const auto& da = a.descriptor();
+      const auto& db = b.descriptor();
+      const auto& dc = out.descriptor();
+      if (da.strides[2] == 1 && db.strides[2] == 1 && dc.strides[2] == 1) {
+        const std::size_t m = da.extents[1];
+        const std::size_t p = da.extents[2];
+        const std::size_t n = db.extents[2];
+        for (std::size_t k = first; k != last; ++k)
+          batch_item(m, p, n,
+                     a.data() + da.start + k * da.strides[0], da.strides[1],
+                     b.data() + db.start + k * db.strides[0], db.strides[1],
+                     out.data() + dc.start + k * dc.strides[0], dc.strides[1]);
+      } else {
+        for (std::size_t k = first; k != last; ++k)
+          gemm_kernel(da.extents[1], db.extents[2], da.extents[2],
+                      Value_type<M3>(1),
+                      a.data() + da.start + k * da.strides[0],
+                      da.strides[1], da.strides[2],
+                      b.data() + db.start + k * db.strides[0],
+                      db.strides[1], db.strides[2],
+                      out.data() + dc.start + k * dc.strides[0],
+                      dc.strides[1], dc.strides[2]);
+      }
+    }
+
+  // Compute products [first, last) of a batch of ranges.
+  template <typename R1, typename R2, typename R3>
+    void
+    batch_block(const R1& a, const R2& b, R3& out,
+                std::size_t first, std::size_t last, std::false_type)
+    {
+      auto i = std::begin(a) + first;
+      auto j = std::begin(b) + first;
+      auto k = std::begin(out) + first;
+      for (std::size_t n = first; n != last; ++n, ++i, ++j, ++k)
+        batch_item(*i, *j, *k);
+    }
+
+  // Returns the number of multiply-adds in the products of the batch.
+  template <typename M1, typename M2>
+    inline std::size_t
+    batch_work(const M1& a, const M2& b, std::true_type)
+    {
+      return a.size() * b.extent(2);
+    }
+
+  template <typename R1, typename R2>
+    inline std::size_t
+    batch_work(const R1& a, const R2& b, std::false_type)
+    {
+      auto n = std::end(a) - std::begin(a);
+      if (n == 0)
+        return 0;
+      const auto& a0 = *std::begin(a);
+      const auto& b0 = *std::begin(b);
+      return n * rows(a0) * cols(a0) * cols(b0);
+    }
+
+  // Returns the number of products in the batch.
+  template <typename M>
+    inline std::size_t
+    batch_size(const M& m, std::true_type) { return m.extent(0); }
+
+  template <typename R>
+    inline std::size_t
+    batch_size(const R& r, std::false_type) { return std::end(r) - std::begin(r); }
+
+  // Returns true if the batch is given as 3D matrices.
+  template <typename M>
+    constexpr bool Matrix_batch()
+    {
+      return Strided_matrix<M>();
+    }
+
+  template <typename M>
+    using Batch_kind = std::integral_constant<bool, Matrix_batch<M>()>;
+
+  template <typename M1, typename M2, typename M3>
+    void
+    check_batch(const M1& a, const M2& b, const M3& out, std::true_type)
+    {
+      static_assert(M1::order == 3, "");
+      static_assert(M2::order == 3, "");
+      static_assert(M3::order == 3, "");
+      assert(a.extent(0) == b.extent(0) && a.extent(0) == out.extent(0));
+      assert(a.extent(2) == b.extent(1));
+      assert(a.extent(1) == out.extent(1));
+      assert(b.extent(2) == out.extent(2));
+    }
+
+  template <typename R1, typename R2, typename R3>
+    void
+    check_batch(const R1& a, const R2& b, const R3& out, std::false_type)
+    {
+      assert(std::end(a) - std::begin(a) == std::end(b) - std::begin(b));
+      assert(std::end(a) - std::begin(a) == std::end(out) - std::begin(out));
+    }
+} // namespace matrix_impl
+
+
+template <typename M1, typename M2, typename M3>
+  inline void
+  batch_product(const M1& a, const M2& b, M3& out)
+  {
+    using Kind = matrix_impl::Batch_kind<M1>;
+    matrix_impl::check_batch(a, b, out, Kind());
+    matrix_impl::batch_block(a, b, out, 0, matrix_impl::batch_size(a, Kind()), Kind());
+  }
+
+template <typename M1, typename M2, typename M3>
+  inline void
+  batch_product(sequential_policy, const M1& a, const M2& b, M3& out)
+  {
+    batch_product(a, b, out);
+  }
+
+template <typename M1, typename M2, typename M3>
+  void
+  batch_product(const parallel_policy& p, const M1& a, const M2& b, M3& out)
+  {
+    using Kind = matrix_impl::Batch_kind<M1>;
+    matrix_impl::check_batch(a, b, out, Kind());
+    const std::size_t n = matrix_impl::batch_size(a, Kind());
+    const std::size_t work = matrix_impl::batch_work(a, b, Kind());
+    if (!p.parallel(work, matrix_impl::parallel_product_threshold)) {
+      matrix_impl::batch_block(a, b, out, 0, n, Kind());
+      return;
+    }
+
+    // Each block should have enough work to amortize scheduling.
+    const std::size_t per = work / n + 1;
+    std::size_t grain = p.grain(n, matrix_impl::parallel_product_threshold / per / 4 + 1);
+    p.pool().parallel_for(0, n, grain, [&](std::size_t i, std::size_t j) {
+      matrix_impl::batch_block(a, b, out, i, j, Kind());
+    });
+  }
@@ -0,0 +1,218 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// In-place Linear Algebra                                          [matrix.blas]
+//
+// The following operations update their last argument in place, following
+// the conventions of the BLAS:
+//
+//    scal(alpha, x)              -- x = alpha * x
+//    axpy(alpha, x, y)           -- y = alpha * x + y
+//    gemv(alpha, a, x, beta, y)  -- y = alpha * a * x + beta * y
+//    gemm(alpha, a, b, beta, c)  -- c = alpha * a * b + beta * c
+//
+// The operands are strided matrices (matrix, matrix_ref or fixed_matrix)
+// having the same arithmetic value type. In gemv, a is a 2D matrix and x and
+// y are vectors. In gemm, each operand is a 2D matrix. Any operand may be a
+// view with arbitrary strides (e.g., a column or a transposed view). As in
+// the BLAS, when beta is 0, the elements of the result are not read, so the
+// result need not be initialized. The result of gemv and gemm must not
+// overlap an input operand, since its elements are written while the
+// inputs are still being read.
+//
+// None of these operations allocate memory. The exception is that large
+// gemm products pack blocks of their operands into a per-thread workspace
+// (see gemm_workspace). The workspace grows to the largest block size used
+// by the thread and is then reused, so repeated products allocate nothing.
+// This makes the operations suitable for the inner loops of iterative
+// solvers, which would otherwise create a temporary for each expression like
+// x + alpha * y.
+
+namespace matrix_impl
+{
+  // Requires that the strided matrices M1 and M2 have the same arithmetic
+  // value type.
+  template <typename M1, typename M2>
+    constexpr bool Blas_operands()
+    {
+      return Strided_matrix<M1>()
+          && Strided_matrix<M2>()
+          && Arithmetic<Value_type<M2>>()
+          && Same<Remove_const<Value_type<M1>>, Value_type<M2>>();
+    }
+
+
+  // Returns the dot product of the vectors x and y having n elements with
+  // the strides incx and incy.
+  template <typename T>
+    inline T
+    dot_kernel(std::size_t n, const T* x, std::size_t incx,
+               const T* y, std::size_t incy)
+    {
+      T s = T(0);
+      if (incx == 1 && incy == 1) {
+        for (std::size_t i = 0; i < n; ++i)
+          s += x[i] * y[i];
+      } else {
+        for (std::size_t i = 0; i < n; ++i)
+          s += x[i * incx] * y[i * incy];
+      }
+      return s;
+    }
+
+  // Compute c = beta * c for the m x n block c with the row and column
+  // strides rs and cs. When beta is 0, c is filled with zeros.
+  template <typename T>
+    void
+    scale_block(std::size_t m, std::size_t n, T beta,
+                T* c, std::size_t rs, std::size_t cs)
+    {
+      if (beta == T(1))
+        return;
+      for (std::size_t i = 0; i < m; ++i) {
+        T* ci = c + i * rs;
+        if (beta == T(0)) {
+          for (std::size_t j = 0; j < n; ++j)
+            ci[j * cs] = T(0);
+        } else {
+          for (std::size_t j = 0; j < n; ++j)
+            ci[j * cs] *= beta;
+        }
+      }
+    }
+} // namespace matrix_impl
+
+
+// Scal
+//
+// Compute x = alpha * x.
+template <typename M, typename T>
+  inline void
+  scal(const T& alpha, M& x)
+  {
+    static_assert(matrix_impl::Strided_matrix<M>(), "");
+    x *= Value_type<M>(alpha);
+  }
+
+
+// Axpy
+//
+// Compute y = alpha * x + y, where x and y have the same extents.
+template <typename T, typename M1, typename M2>
+  void
+  axpy(const T& alpha, const M1& x, M2& y)
+  {
+    static_assert(matrix_impl::Blas_operands<M1, M2>(), "");
+    assert(same_extents(x.descriptor(), y.descriptor()));
+
+    using V = Value_type<M2>;
+    const auto& dx = x.descriptor();
+    const auto& dy = y.descriptor();
+    const V a = alpha;
+    if (matrix_impl::is_contiguous(dx) && matrix_impl::is_contiguous(dy)) {
+      matrix_impl::axpy_kernel(y.size(), a,
+                               x.data() + dx.start, 1,
+                               y.data() + dy.start, 1);
+    } else if (M2::order == 1) {
+      matrix_impl::axpy_kernel(y.size(), a,
+                               x.data() + dx.start, dx.strides[0],
+                               y.data() + dy.start, dy.strides[0]);
+    } else {
+      auto i = x.begin();
+      for (V& e : y)
+        e += a * *i++;
+    }
+  }
+
+
+// Gemv
+//
+// Compute y = alpha * a * x + beta * y, where a is an m x n matrix, x is a
+// vector of n elements and y is a vector of m elements. When beta is 0, y
+// need not be initialized. y must not alias a or x.
+//
+// When the rows of a are contiguous, each element of y is updated by a dot
+// product. Otherwise, y is updated by an axpy for each column of a.
+template <typename T, typename M1, typename M2, typename M3>
+  void
+  gemv(const T& alpha, const M1& a, const M2& x, const T& beta, M3& y)
+  {
+    static_assert(matrix_impl::Blas_operands<M1, M3>(), "");
+    static_assert(matrix_impl::Blas_operands<M2, M3>(), "");
+    static_assert(M1::order == 2, "");
+    static_assert(M2::order == 1, "");
+    static_assert(M3::order == 1, "");
+    assert(cols(a) == x.size());
+    assert(rows(a) == y.size());
+
+    using V = Value_type<M3>;
+    const auto& da = a.descriptor();
+    const auto& dx = x.descriptor();
+    const auto& dy = y.descriptor();
+    const std::size_t m = rows(a);
+    const std::size_t n = cols(a);
+    const V* pa = a.data() + da.start;
+    const V* px = x.data() + dx.start;
+    V* py = y.data() + dy.start;
+
+    matrix_impl::scale_block(std::size_t(1), m, V(beta), py, 0, dy.strides[0]);
+    if (alpha == T(0))
+      return;
+    if (da.strides[1] <= da.strides[0]) {
+      for (std::size_t i = 0; i < m; ++i)
+        py[i * dy.strides[0]] += V(alpha) * matrix_impl::dot_kernel(
+          n, pa + i * da.strides[0], da.strides[1], px, dx.strides[0]
+        );
+    } else {
+      for (std::size_t j = 0; j < n; ++j)
+        matrix_impl::axpy_kernel(m, V(alpha) * px[j * dx.strides[0]],
+                                 pa + j * da.strides[1], da.strides[0],
+                                 py, dy.strides[0]);
+    }
+  }
+
+
+// Gemm
+//
+// Compute c = alpha * a * b + beta * c, where a is m x k, b is k x n and c
+// is m x n. When beta is 0, c need not be initialized. c must not alias a
+// or b.
+//
+// Small products are computed directly. Larger products are computed by the
+// cache-blocked kernel, which reads the operands with their own strides, so
+// transposed and strided views are not copied.
+template <typename T, typename M1, typename M2, typename M3>
+  void
+  gemm(const T& alpha, const M1& a, const M2& b, const T& beta, M3& c)
+  {
+    static_assert(matrix_impl::Blas_operands<M1, M3>(), "");
+    static_assert(matrix_impl::Blas_operands<M2, M3>(), "");
+    static_assert(M1::order == 2, "");
+    static_assert(M2::order == 2, "");
+    static_assert(M3::order == 2, "");
+    assert(cols(a) == rows(b));
+    assert(rows(a) == rows(c));
+    assert(cols(b) == cols(c));
+
+    using V = Value_type<M3>;
+    const auto& da = a.descriptor();
+    const auto& db = b.descriptor();
+    const auto& dc = c.descriptor();
+    V* pc = c.data() + dc.start;
+    matrix_impl::scale_block(rows(c), cols(c), V(beta),
+                             pc, dc.strides[0], dc.strides[1]);
+    matrix_impl::gemm_kernel(rows(a), cols(b), cols(a), V(alpha),
+                             a.data() + da.start, da.strides[0], da.strides[1],
+                             b.data() + db.start, db.strides[0], db.strides[1],
+                             pc, dc.strides[0], dc.strides[1]);
+  }
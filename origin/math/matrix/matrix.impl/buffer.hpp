@@ -0,0 +1,283 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Uninitialized construction                               [matrix.uninitialized]
+//
+// The uninitialized tag selects constructors and operations that default
+// initialize (rather than value initialize) the elements of a matrix. For
+// trivial types like int or double, the elements have indeterminate values.
+// This avoids the cost of zeroing memory that will be overwritten. For
+// example:
+//
+//    matrix<double, 2> m(uninitialized, 1000, 1000);
+struct uninitialized_t { };
+
+constexpr uninitialized_t uninitialized { };
+
+
+namespace matrix_impl
+{
+  // ------------------------------------------------------------------------ //
+  //                              Matrix Buffer
+  //
+  // The matrix buffer is the underlying store of a matrix: a dynamically
+  // allocated array of elements obtained from the allocator A. The buffer
+  // distinguishes its size (the number of constructed elements) from its
+  // capacity (the number of elements for which storage is allocated).
+  //
+  // The buffer is like a minimal vector, except that it can be default
+  // initialized and it does not grow geometrically; a matrix is usually
+  // resized to an exact size.
+  template <typename T, typename A>
+    class matrix_buffer : private A
+    {
+      using Traits = std::allocator_traits<A>;
+    public:
+      using value_type = T;
+      using allocator_type = A;
+      using iterator = T*;
+      using const_iterator = const T*;
+
+      explicit matrix_buffer(const A& a = A())
+        : A(a), first(nullptr), last(nullptr), limit(nullptr)
+      { }
+
+      // Initialize the buffer with n value-initialized elements.
+      matrix_buffer(std::size_t n, const A& a)
+        : matrix_buffer(a)
+      {
+        resize(n);
+      }
+
+      // Initialize the buffer with n default-initialized elements.
+      matrix_buffer(std::size_t n, uninitialized_t, const A& a)
+        : matrix_buffer(a)
+      {
+        resize(n, uninitialized);
+      }
+
+      // Initialize the buffer with n elements copied from the range starting
+      // at iter. The iterator need only be an input iterator.
+      template <typename I>
+        matrix_buffer(std::size_t n, I iter, const A& a)
+          : matrix_buffer(a)
+        {
+          reserve(n);
+          append(n, iter);
+        }
+
+      matrix_buffer(const matrix_buffer& x)
+        : matrix_buffer(x.size(), x.begin(),
+                        Traits::select_on_container_copy_construction(x.get_allocator()))
+      { }
+
+      // Moving a buffer never throws, so a matrix can be moved (rather than
+      // copied) when a vector of matrices grows.
+      matrix_buffer(matrix_buffer&& x) noexcept
+        : A(std::move(x.get_allocator())),
+          first(x.first), last(x.last), limit(x.limit)
+      {
+        static_assert(std::is_nothrow_move_constructible<A>::value,
+                      "moving the allocator must not throw");
+        x.first = x.last = x.limit = nullptr;
+      }
+
+      matrix_buffer&
+      operator=(const matrix_buffer& x)
+      {
+        using Propagate = typename Traits::propagate_on_container_copy_assignment;
+        matrix_buffer tmp(x.size(), x.begin(),
+                          Propagate::value ? x.get_allocator() : get_allocator());
+        swap(tmp);
+        return *this;
+      }
+
+      // Move assignment only moves elements one at a time when the
+      // allocators differ and x's allocator does not propagate. As with
+      // std::vector, it cannot throw when the allocator propagates.
+      matrix_buffer&
+      operator=(matrix_buffer&& x)
+        noexcept(Traits::propagate_on_container_move_assignment::value)
+      {
+        using Propagate = typename Traits::propagate_on_container_move_assignment;
+        if (Propagate::value || get_allocator() == x.get_allocator()) {
+          matrix_buffer tmp(std::move(x));
+          swap(tmp);
+        } else {
+          matrix_buffer tmp(x.size(), std::make_move_iterator(x.begin()),
+                            get_allocator());
+          swap(tmp);
+        }
+        return *this;
+      }
+
+      ~matrix_buffer()
+      {
+        clear();
+        if (first)
+          Traits::deallocate(alloc(), first, capacity());
+      }
+
+      // Returns a copy of the allocator.
+      A get_allocator() const { return *this; }
+
+      // Returns the number of elements in the buffer.
+      std::size_t size() const { return last - first; }
+
+      // Returns the number of elements for which storage is allocated.
+      std::size_t capacity() const { return limit - first; }
+
+      T*       data()       { return first; }
+      const T* data() const { return first; }
+
+      iterator begin() { return first; }
+      iterator end()   { return last; }
+
+      const_iterator begin() const { return first; }
+      const_iterator end() const   { return last; }
+
+
+      // Ensure that the buffer has capacity for at least n elements. If
+      // storage is reallocated, the elements are moved into the new storage.
+      void
+      reserve(std::size_t n)
+      {
+        if (n <= capacity())
+          return;
+
+        T* p = Traits::allocate(alloc(), n);
+        T* q = p;
+        try {
+          for (T* i = first; i != last; ++i, ++q)
+            Traits::construct(alloc(), q, std::move_if_noexcept(*i));
+        } catch (...) {
+          while (q != p)
+            Traits::destroy(alloc(), --q);
+          Traits::deallocate(alloc(), p, n);
+          throw;
+        }
+
+        std::size_t k = size();
+        clear();
+        if (first)
+          Traits::deallocate(alloc(), first, capacity());
+        first = p;
+        last = p + k;
+        limit = p + n;
+      }
+
+      // Change the number of elements to n. New elements are value
+      // initialized.
+      void
+      resize(std::size_t n)
+      {
+        shrink(n);
+        reserve(n);
+        while (size() < n) {
+          Traits::construct(alloc(), last);
+          ++last;
+        }
+      }
+
+      // Change the number of elements to n. New elements are default
+      // initialized.
+      void
+      resize(std::size_t n, uninitialized_t)
+      {
+        shrink(n);
+        reserve(n);
+        while (size() < n) {
+          ::new (static_cast<void*>(last)) T;
+          ++last;
+        }
+      }
+
+      // Append n elements copied from the range starting at iter. The
+      // buffer must have sufficient capacity.
+      template <typename I>
+        void
+        append(std::size_t n, I iter)
+        {
+          assert(size() + n <= capacity());
+          for (std::size_t i = 0; i < n; ++i, ++iter) {
+            Traits::construct(alloc(), last, *iter);
+            ++last;
+          }
+        }
+
+      // Append the elements in [first, last).
+      template <typename I>
+        void
+        append(I f, I l)
+        {
+          std::size_t n = std::distance(f, l);
+          reserve(size() + n);
+          append(n, f);
+        }
+
+      // Destroy all elements. The capacity is unchanged.
+      void clear() { shrink(0); }
+
+      void
+      swap(matrix_buffer& x)
+      {
+        using std::swap;
+        swap(alloc(), x.alloc());
+        swap(first, x.first);
+        swap(last, x.last);
+        swap(limit, x.limit);
+      }
+
+    private:
+      A&       alloc()       { return *this; }
+      const A& alloc() const { return *this; }
+
+      // Destroy elements past the first n.
+      void
+      shrink(std::size_t n)
+      {
+        while (size() > n)
+          Traits::destroy(alloc(), --last);
+      }
+
+      T* first;
+      T* last;
+      T* limit;
+    };
+
+
+
+  // Move intersection
+  //
+  // Move the elements of the n-dimensional array src (with strides ss) whose
+  // indexes are within the extents ext to the elements with the same indexes
+  // in dst (with strides ds). This is used to preserve the elements of a
+  // matrix whose extents change.
+  template <typename T>
+    void
+    move_intersection(std::size_t n, const std::size_t* ext,
+                      T* src, const std::size_t* ss,
+                      T* dst, const std::size_t* ds)
+    {
+      if (n == 1) {
+        for (std::size_t i = 0; i < ext[0]; ++i)
+          dst[i * ds[0]] = std::move(src[i * ss[0]]);
+        return;
+      }
+      for (std::size_t i = 0; i < ext[0]; ++i)
+        move_intersection(n - 1, ext + 1,
+                          src + i * ss[0], ss + 1,
+                          dst + i * ds[0], ds + 1);
+    }
+
+} // namespace matrix_impl
@@ -0,0 +1,909 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Matrix expressions                                               [matrix.expr]
+//
+// The elementwise arithmetic operators do not compute their results
+// immediately. Instead, they return a matrix expression: a lazily evaluated
+// operation on its operands. The elements of an expression are computed in a
+// single pass when it is assigned to a matrix or matrix_ref. For example:
+//
+//    matrix<double, 2> r = a + b * 2.0 - c;
+//
+// computes each element of r as a(i, j) + b(i, j) * 2.0 - c(i, j) without
+// creating any temporary matrices.
+//
+// An expression refers to the matrices used as its operands, except that
+// temporary matrices (rvalues) are moved into the expression. Like a
+// matrix_ref, an expression must not outlive the matrices it refers to, and
+// modifying an operand before the expression is evaluated changes the
+// result.
+//
+// Matrix expressions are Matrix types. They can be indexed, compared, and
+// iterated over, but each access computes the corresponding element. Use
+// eval() to compute a matrix from an expression.
+
+namespace matrix_impl
+{
+  // The expr scalar class wraps a scalar operand of an expression. It
+  // presents the scalar as a matrix of order 0 whose every element is the
+  // scalar value.
+  template <typename T>
+    struct expr_scalar
+    {
+      static constexpr std::size_t order = 0;
+
+      using value_type = T;
+
+      // The iterator over a scalar returns the same value for every element.
+      struct iterator
+      {
+        using value_type = T;
+        using reference = const T&;
+        using pointer = const T*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+
+        const T& operator*() const { return *ptr; }
+        iterator& operator++() { return *this; }
+
+        bool operator==(const iterator&) const { return true; }
+        bool operator!=(const iterator&) const { return false; }
+
+        const T* ptr;
+      };
+
+      expr_scalar(const T& x) : value(x) { }
+
+      const T& element(std::size_t) const { return value; }
+      bool contiguous() const { return true; }
+
+      template <typename... Args>
+        const T& operator()(Args...) const { return value; }
+
+      iterator begin() const { return {&value}; }
+      iterator end() const { return {&value}; }
+
+      T value;
+    };
+
+
+  // The expr operand trait determines how an operand of type M is stored in
+  // an expression. Lvalue matrices are stored by reference. Temporary
+  // matrices, matrix_refs and expressions are stored by value.
+  template <typename M>
+    struct expr_operand
+    {
+      using type = Decay<M>;
+    };
+
+  template <typename T, std::size_t N, typename A>
+    struct expr_operand<matrix<T, N, A>&>
+    {
+      using type = const matrix<T, N, A>&;
+    };
+
+  template <typename T, std::size_t N, typename A>
+    struct expr_operand<const matrix<T, N, A>&>
+    {
+      using type = const matrix<T, N, A>&;
+    };
+
+  template <typename M>
+    using Expr_operand = typename expr_operand<M>::type;
+
+
+  // Element access
+  //
+  // Return the ith element of the underlying (contiguous) elements of an
+  // operand.
+  template <typename E>
+    inline auto
+    expr_element(const E& e, std::size_t i) -> decltype(e.element(i))
+    {
+      return e.element(i);
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline const T&
+    expr_element(const matrix<T, N, A>& m, std::size_t i)
+    {
+      return m.data()[i];
+    }
+
+  template <typename T, std::size_t N>
+    inline const T&
+    expr_element(const matrix_ref<T, N>& m, std::size_t i)
+    {
+      return m.data()[m.descriptor().start + i];
+    }
+
+
+  // Contiguity
+  //
+  // Returns true if the elements of the operand can be accessed by
+  // expr_element.
+  template <typename E>
+    inline auto
+    expr_contiguous(const E& e) -> decltype(e.contiguous())
+    {
+      return e.contiguous();
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline bool
+    expr_contiguous(const matrix<T, N, A>&)
+    {
+      return true;
+    }
+
+  template <typename T, std::size_t N>
+    inline bool
+    expr_contiguous(const matrix_ref<T, N>& m)
+    {
+      return is_contiguous(m.descriptor());
+    }
+
+
+  // Expression extents
+  //
+  // Returns a row-major slice with the extents of the result of a binary
+  // expression on the operands a and b. If both operands are matrices, their
+  // extents are broadcast against each other.
+  template <std::size_t N, typename T, typename M>
+    inline matrix_slice<N>
+    expr_extents(const expr_scalar<T>&, const M& m)
+    {
+      return matrix_slice<N>(0, m.descriptor().extents);
+    }
+
+  template <std::size_t N, typename M, typename T>
+    inline matrix_slice<N>
+    expr_extents(const M& m, const expr_scalar<T>&)
+    {
+      return matrix_slice<N>(0, m.descriptor().extents);
+    }
+
+  template <std::size_t N, typename M1, typename M2>
+    inline matrix_slice<N>
+    expr_extents(const M1& a, const M2& b)
+    {
+      return broadcast_extents<N>(a.descriptor(), b.descriptor());
+    }
+
+
+  // Operand access
+  //
+  // The elements of an operand are accessed through a slice computed from
+  // the extents d of the expression. For a strided matrix, that is the slice
+  // broadcasting its elements to d. Scalars and subexpressions are accessed
+  // through d itself; a subexpression has the order of d, and each of its
+  // extents is either the extent of d or 1.
+  template <typename T, std::size_t N>
+    inline const matrix_slice<N>&
+    expr_slice(const expr_scalar<T>&, const matrix_slice<N>& d)
+    {
+      return d;
+    }
+
+  template <typename Op, typename E1, typename E2, std::size_t N>
+    inline const matrix_slice<N>&
+    expr_slice(const matrix_expr<Op, E1, E2>& e, const matrix_slice<N>& d)
+    {
+      assert(is_broadcastable(e.descriptor(), d.extents));
+      return d;
+    }
+
+  template <typename M, std::size_t N>
+    inline matrix_slice<N>
+    expr_slice(const M& m, const matrix_slice<N>& d)
+    {
+      return broadcast_slice(m.descriptor(), d.extents);
+    }
+
+  // Returns a view of the operand m broadcast to the extents d. Only strided
+  // matrices can be broadcast; other operands are returned unchanged and
+  // must have the extents d.
+  template <typename M, std::size_t N>
+    inline matrix_ref<const Value_type<M>, N>
+    broadcast_operand(const M& m, const matrix_slice<N>& d, std::true_type)
+    {
+      return {broadcast_slice(m.descriptor(), d.extents), m.data()};
+    }
+
+  template <typename M, std::size_t N>
+    inline const M&
+    broadcast_operand(const M& m, const matrix_slice<N>& d, std::false_type)
+    {
+      assert(same_extents(m.descriptor(), d));
+      return m;
+    }
+
+  template <typename M, std::size_t N>
+    inline auto
+    broadcast_operand(const M& m, const matrix_slice<N>& d)
+      -> decltype(broadcast_operand(m, d, std::integral_constant<bool, Strided_matrix<M>()>()))
+    {
+      using Strided = std::integral_constant<bool, Strided_matrix<M>()>;
+      return broadcast_operand(m, d, Strided());
+    }
+
+  // Returns true if the operand has the extents d, so that its ith element
+  // is the ith element of the result.
+  template <typename T, std::size_t N>
+    inline bool
+    expr_conforms(const expr_scalar<T>&, const matrix_slice<N>&)
+    {
+      return true;
+    }
+
+  template <typename Op, typename E1, typename E2, std::size_t N>
+    inline bool
+    expr_conforms(const matrix_expr<Op, E1, E2>& e, const matrix_slice<N>& d)
+    {
+      return same_extents(e.descriptor(), d);
+    }
+
+  template <typename M, std::size_t N>
+    inline bool
+    expr_conforms(const M& m, const matrix_slice<N>& d)
+    {
+      return same_extents(m.descriptor(), d);
+    }
+
+  template <typename E>
+    struct expr_broadcast_iterator;
+
+  // Returns an iterator to the first element of the operand, visiting the
+  // elements of the slice s in row-major order. The slice must outlive the
+  // iterator.
+  template <typename T, std::size_t N>
+    inline typename expr_scalar<T>::iterator
+    expr_begin(const expr_scalar<T>& x, const matrix_slice<N>&, bool = false)
+    {
+      return x.begin();
+    }
+
+  template <typename Op, typename E1, typename E2, std::size_t N>
+    inline expr_broadcast_iterator<matrix_expr<Op, E1, E2>>
+    expr_begin(const matrix_expr<Op, E1, E2>& e, const matrix_slice<N>& d,
+               bool limit = false)
+    {
+      return {e, d, limit};
+    }
+
+  template <typename M, std::size_t N>
+    inline slice_iterator<Remove_reference<decltype(*std::declval<const M&>().data())>, N>
+    expr_begin(const M& m, const matrix_slice<N>& s, bool limit = false)
+    {
+      return {s, m.data(), limit};
+    }
+
+  // Returns the element of the operand at the array of indexes into the
+  // result of the expression. The indexes of a subexpression are 0 in the
+  // dimensions it is broadcast along.
+  template <typename T, std::size_t N>
+    inline const T&
+    expr_index(const expr_scalar<T>& x, const matrix_slice<N>&,
+               const std::size_t (&)[N])
+    {
+      return x.value;
+    }
+
+  template <typename Op, typename E1, typename E2, std::size_t N>
+    inline Value_type<matrix_expr<Op, E1, E2>>
+    expr_index(const matrix_expr<Op, E1, E2>& e, const matrix_slice<N>&,
+               const std::size_t (&indexes)[N])
+    {
+      std::size_t sub[N];
+      for (std::size_t i = 0; i < N; ++i)
+        sub[i] = e.extent(i) == 1 ? 0 : indexes[i];
+      return e.at(sub);
+    }
+
+  template <typename M, std::size_t N>
+    inline const Value_type<M>&
+    expr_index(const M& m, const matrix_slice<N>& s,
+               const std::size_t (&indexes)[N])
+    {
+      return m.data()[s.offset(indexes)];
+    }
+
+  // Returns the element of the operand at the index given by args.
+  template <typename T, std::size_t N, typename... Args>
+    inline const T&
+    expr_at(const expr_scalar<T>& x, const matrix_slice<N>&, Args...)
+    {
+      return x.value;
+    }
+
+  template <typename Op, typename E1, typename E2, std::size_t N,
+            typename... Args>
+    inline Value_type<matrix_expr<Op, E1, E2>>
+    expr_at(const matrix_expr<Op, E1, E2>& e, const matrix_slice<N>& d,
+            Args... args)
+    {
+      const std::size_t indexes[N] {std::size_t(args)...};
+      return expr_index(e, d, indexes);
+    }
+
+  template <typename M, std::size_t N, typename... Args>
+    inline const Value_type<M>&
+    expr_at(const M& m, const matrix_slice<N>& s, Args... args)
+    {
+      return m.data()[s(args...)];
+    }
+
+  // The expression broadcast iterator visits the elements of the
+  // subexpression E broadcast to the extents d of the enclosing expression.
+  // If E has the extents d, it steps the iterator of E. Otherwise, it counts
+  // the indexes of d in row-major order and computes the element of E at
+  // each of them.
+  template <typename E>
+    struct expr_broadcast_iterator
+    {
+      static constexpr std::size_t N = E::order;
+
+      using value_type = Value_type<E>;
+      using reference = value_type;
+      using pointer = const value_type*;
+      using difference_type = std::ptrdiff_t;
+      using iterator_category = std::input_iterator_tag;
+
+      expr_broadcast_iterator(const E& e, const matrix_slice<N>& d, bool limit)
+        : expr(&e), desc(&d), iter(limit ? e.end() : e.begin()),
+          broadcast(!same_extents(e.descriptor(), d))
+      {
+        std::fill(indexes, indexes + N, 0);
+        if (limit)
+          indexes[0] = d.extents[0];
+      }
+
+      value_type
+      operator*() const
+      {
+        if (broadcast)
+          return expr_index(*expr, *desc, indexes);
+        return *iter;
+      }
+
+      expr_broadcast_iterator&
+      operator++()
+      {
+        if (!broadcast) {
+          ++iter;
+          return *this;
+        }
+        std::size_t d = N - 1;
+        while (d != 0 && ++indexes[d] == desc->extents[d])
+          indexes[d--] = 0;
+        if (d == 0)
+          ++indexes[0];
+        return *this;
+      }
+
+      expr_broadcast_iterator
+      operator++(int)
+      {
+        expr_broadcast_iterator tmp = *this;
+        ++*this;
+        return tmp;
+      }
+
+      bool
+      operator==(const expr_broadcast_iterator& x) const
+      {
+        if (broadcast)
+          return std::equal(indexes, indexes + N, x.indexes);
+        return iter == x.iter;
+      }
+
+      bool
+      operator!=(const expr_broadcast_iterator& x) const
+      {
+        return !(*this == x);
+      }
+
+      const E* expr;
+      const matrix_slice<N>* desc;
+      typename E::iterator iter;
+      bool broadcast;
+      std::size_t indexes[N];
+    };
+
+
+
+  // Aliasing
+  //
+  // Returns true if storing the elements of the result in the slice d of the
+  // array p could overwrite elements of the operand before they are read.
+  // The operand is accessed through the slice s. An element of a strided
+  // operand that is accessed through the slice d itself only contributes to
+  // the corresponding element of the result, so it is read before it is
+  // written. Any other overlap (e.g., a shifted, transposed, or broadcast
+  // view of the result) is unsafe. The elements of a broadcast operand are
+  // read more than once, so if broadcast is true, any overlap is unsafe.
+  template <typename T, std::size_t N, typename U>
+    inline bool
+    expr_aliases(const expr_scalar<T>&, const matrix_slice<N>&,
+                 const U*, const matrix_slice<N>&, bool)
+    {
+      return false;
+    }
+
+  template <typename Op, typename E1, typename E2, std::size_t N, typename U>
+    inline bool
+    expr_aliases(const matrix_expr<Op, E1, E2>& e, const matrix_slice<N>& s,
+                 const U* p, const matrix_slice<N>& d, bool broadcast)
+    {
+      return e.aliases(p, d, broadcast || !same_extents(e.descriptor(), s));
+    }
+
+  template <typename M, std::size_t N, typename U>
+    inline bool
+    expr_aliases(const M& m, const matrix_slice<N>& s,
+                 const U* p, const matrix_slice<N>& d, bool broadcast)
+    {
+      if (!overlapping(m.data(), s, p, d))
+        return false;
+      const void* q = m.data();
+      return broadcast || q != static_cast<const void*>(p) || s != d;
+    }
+
+
+  // Returns true if the operand m of a compound assignment to the slice d
+  // of the array p, broadcast to the extents of d, aliases those elements
+  // (see expr_aliases). Such an operand is copied before any element is
+  // assigned. A broadcast operand that aliases the elements is at most a
+  // row or column of them, so the copy is small.
+  template <typename M, typename T, std::size_t N>
+    inline bool
+    operand_aliases(const M& m, const T* p, const matrix_slice<N>& d,
+                    std::true_type)
+    {
+      auto s = broadcast_slice(m.descriptor(), d.extents);
+      return expr_aliases(m, s, p, d, false);
+    }
+
+  template <typename M, typename T, std::size_t N>
+    inline bool
+    operand_aliases(const M& m, const T* p, const matrix_slice<N>& d,
+                    std::false_type)
+    {
+      return m.aliases(p, d);
+    }
+
+  template <typename M, typename T, std::size_t N>
+    inline bool
+    operand_aliases(const M& m, const T* p, const matrix_slice<N>& d)
+    {
+      using Strided = std::integral_constant<bool, Strided_matrix<M>()>;
+      return operand_aliases(m, p, d, Strided());
+    }
+
+
+  // Temporary storage
+  //
+  // Returns a pointer to a temporary matrix of type M that is stored by
+  // value in the operand e (or is e itself), or nullptr if there is none.
+  // Lvalue matrices are stored by reference and are never returned.
+  template <typename M, typename E>
+    inline M*
+    expr_temporary(E&, std::false_type)
+    {
+      return nullptr;
+    }
+
+  template <typename M>
+    inline M*
+    expr_temporary(M& m, std::true_type)
+    {
+      return &m;
+    }
+
+  template <typename M, typename E>
+    inline M*
+    expr_temporary(E& e)
+    {
+      return expr_temporary<M>(e, std::is_same<M, E>());
+    }
+
+  template <typename M, typename Op, typename E1, typename E2>
+    inline M*
+    expr_temporary(matrix_expr<Op, E1, E2>& e)
+    {
+      return e.template temporary<M>();
+    }
+
+
+  // The expression iterator computes the elements of an expression by
+  // applying its operation to the elements referred to by the iterators over
+  // its operands.
+  template <typename Op, typename I1, typename I2>
+    struct expr_iterator
+    {
+      using value_type = Decay<decltype(std::declval<Op>()(*std::declval<I1>(),
+                                                          *std::declval<I2>()))>;
+      using reference = value_type;
+      using pointer = const value_type*;
+      using difference_type = std::ptrdiff_t;
+      using iterator_category = std::input_iterator_tag;
+
+      expr_iterator(Op op, I1 i, I2 j) : op(op), first(i), second(j) { }
+
+      value_type operator*() const { return op(*first, *second); }
+
+      expr_iterator& operator++()
+      {
+        ++first;
+        ++second;
+        return *this;
+      }
+
+      expr_iterator operator++(int)
+      {
+        expr_iterator tmp = *this;
+        ++*this;
+        return tmp;
+      }
+
+      bool
+      operator==(const expr_iterator& x) const
+      {
+        return first == x.first && second == x.second;
+      }
+
+      bool operator!=(const expr_iterator& x) const { return !(*this == x); }
+
+      Op op;
+      I1 first;
+      I2 second;
+    };
+
+} // namespace matrix_impl
+
+
+// -------------------------------------------------------------------------- //
+// Matrix expression                                           [matrix.expr.binary]
+//
+// A matrix expression applies the binary operation Op to corresponding
+// elements of its operands. One of the operands may be a scalar. If the
+// extents of the operands differ, they are broadcast against each other
+// (see matrix_impl::broadcast_extents). An operand of lesser order must be
+// a strided matrix.
+//
+// Template parameters:
+//    Op -- A binary function on the value type of the operands.
+//    E1 -- The stored type of the left operand.
+//    E2 -- The stored type of the right operand.
+template <typename Op, typename E1, typename E2>
+  class matrix_expr
+  {
+    using Left = Decay<E1>;
+    using Right = Decay<E2>;
+
+  public:
+    static constexpr std::size_t order =
+      Left::order < Right::order ? Right::order : Left::order;
+
+  private:
+    using Slice = matrix_slice<order>;
+    using Left_iterator = decltype(
+      matrix_impl::expr_begin(std::declval<const Left&>(), std::declval<const Slice&>())
+    );
+    using Right_iterator = decltype(
+      matrix_impl::expr_begin(std::declval<const Right&>(), std::declval<const Slice&>())
+    );
+
+  public:
+    using value_type = Value_type<Left>;
+    using iterator = matrix_impl::expr_iterator<Op, Left_iterator, Right_iterator>;
+    using const_iterator = iterator;
+
+    template <typename A, typename B>
+      matrix_expr(A&& a, B&& b)
+        : left(std::forward<A>(a)), right(std::forward<B>(b)),
+          desc(matrix_impl::expr_extents<order>(left, right)),
+          lslice(matrix_impl::expr_slice(left, desc)),
+          rslice(matrix_impl::expr_slice(right, desc))
+      { }
+
+
+    // Properties
+
+    // Returns the slice describing the result of the expression. The
+    // result is indexed in row-major order.
+    const matrix_slice<order>& descriptor() const { return desc; }
+
+    // Returns the extent of the expression in the nth dimension.
+    std::size_t extent(std::size_t n) const { return desc.extents[n]; }
+
+    // Returns the number of rows (0th extent) in the expression.
+    std::size_t rows() const { return extent(0); }
+
+    // Returns the number of columns (1st extent) in the expression.
+    std::size_t cols() const { return extent(1); }
+
+    // Returns the total number of elements computed by the expression.
+    std::size_t size() const { return desc.size; }
+
+
+    // Subscripting
+    //
+    // Computes the element at the index given by the sequence of indexes,
+    // args.
+    template <typename... Args>
+      Requires<matrix_impl::Index_sequence<Args...>(), value_type>
+      operator()(Args... args) const
+      {
+        return op(matrix_impl::expr_at(left, lslice, args...),
+                  matrix_impl::expr_at(right, rslice, args...));
+      }
+
+
+    // Computes the element at the array of indexes.
+    value_type
+    at(const std::size_t (&indexes)[order]) const
+    {
+      return op(matrix_impl::expr_index(left, lslice, indexes),
+                matrix_impl::expr_index(right, rslice, indexes));
+    }
+
+
+    // Returns the left operand of the expression.
+    const Left& left_operand() const { return left; }
+
+    // Returns the right operand of the expression.
+    const Right& right_operand() const { return right; }
+
+
+    // Flat element access
+    //
+    // If contiguous() is true, element(i) computes the ith element of the
+    // expression in row-major order. The elements of a contiguous expression
+    // can be computed in any order.
+    //
+    // An expression with a broadcast operand is not contiguous.
+    bool
+    contiguous() const
+    {
+      return matrix_impl::expr_conforms(left, desc)
+          && matrix_impl::expr_conforms(right, desc)
+          && matrix_impl::expr_contiguous(left)
+          && matrix_impl::expr_contiguous(right);
+    }
+
+    value_type
+    element(std::size_t i) const
+    {
+      return op(matrix_impl::expr_element(left, i),
+                matrix_impl::expr_element(right, i));
+    }
+
+
+    // Aliasing
+    //
+    // Returns true if the result cannot be stored in the slice d of the
+    // array p as it is computed, because that could overwrite elements of
+    // an operand before they are read (see matrix_impl::expr_aliases). The
+    // result must be computed into a temporary in that case.
+    template <typename U>
+      bool
+      aliases(const U* p, const matrix_slice<order>& d,
+              bool broadcast = false) const
+      {
+        return matrix_impl::expr_aliases(left, lslice, p, d, broadcast)
+            || matrix_impl::expr_aliases(right, rslice, p, d, broadcast);
+      }
+
+
+    // Temporary storage
+    //
+    // Returns a pointer to a temporary matrix of type M that was moved into
+    // the expression (as an operand of this expression or of one of its
+    // subexpressions), or nullptr if there is none. If M has the value type
+    // of the expression, each element of the result can be stored in the
+    // corresponding element of the temporary as soon as it is computed, so
+    // the temporary's storage can be reused for the result.
+    template <typename M>
+      M*
+      temporary()
+      {
+        M* p = matrix_impl::expr_temporary<M>(left);
+        if (p && same_extents(p->descriptor(), desc))
+          return p;
+        p = matrix_impl::expr_temporary<M>(right);
+        if (p && same_extents(p->descriptor(), desc))
+          return p;
+        return nullptr;
+      }
+
+
+    // Iterators
+    //
+    // The iterators compute the elements of the expression in row-major
+    // order.
+    iterator
+    begin() const
+    {
+      return {op, matrix_impl::expr_begin(left, lslice),
+                  matrix_impl::expr_begin(right, rslice)};
+    }
+
+    iterator
+    end() const
+    {
+      return {op, matrix_impl::expr_begin(left, lslice, true),
+                  matrix_impl::expr_begin(right, rslice, true)};
+    }
+
+  private:
+    E1 left;
+    E2 right;
+    Op op;
+    Slice desc;
+    Slice lslice;   // Broadcasts the left operand to desc
+    Slice rslice;   // Broadcasts the right operand to desc
+  };
+
+
+namespace matrix_impl
+{
+  // The matrix operand trait is true for the types that can be used as
+  // operands of the elementwise arithmetic operators.
+  template <typename M>
+    struct is_matrix_operand : std::false_type { };
+
+  template <typename T, std::size_t N, typename A>
+    struct is_matrix_operand<matrix<T, N, A>> : std::true_type { };
+
+  template <typename T, std::size_t N>
+    struct is_matrix_operand<matrix_ref<T, N>> : std::true_type { };
+
+  template <typename Op, typename E1, typename E2>
+    struct is_matrix_operand<matrix_expr<Op, E1, E2>> : std::true_type { };
+
+  // Returns true if M (after removing references and qualifiers) is a
+  // matrix operand.
+  template <typename M>
+    constexpr bool Matrix_operand()
+    {
+      return is_matrix_operand<Decay<M>>::value;
+    }
+
+  // Returns true if M is a matrix expression.
+  template <typename M>
+    constexpr bool Matrix_expression()
+    {
+      return Matrix_operand<M>() && !Strided_matrix<Decay<M>>();
+    }
+
+
+  // Returns true if the matrix operands M1 and M2 have the same order, or if
+  // the operand of lesser order is a strided matrix, which can be broadcast
+  // to the order of the other.
+  template <typename M1, typename M2>
+    constexpr bool Broadcast_operands()
+    {
+      return Decay<M1>::order == Decay<M2>::order
+          || (Decay<M1>::order < Decay<M2>::order
+                ? Strided_matrix<Decay<M1>>()
+                : Strided_matrix<Decay<M2>>());
+    }
+
+
+  // The binary expression trait computes the result of applying the
+  // elementwise operation Op to two matrix operands. The operands must have
+  // the same value type and be broadcast operands. There is no result type
+  // otherwise.
+  template <template <typename> class Op, typename M1, typename M2,
+            bool = Matrix_operand<M1>() && Matrix_operand<M2>()>
+    struct binary_expr
+    { };
+
+  template <template <typename> class Op, typename M1, typename M2>
+    struct binary_expr<Op, M1, M2, true>
+      : std::enable_if<
+          Broadcast_operands<M1, M2>()
+            && Same<Value_type<Decay<M1>>, Value_type<Decay<M2>>>(),
+          matrix_expr<
+            Op<Value_type<Decay<M1>>>, Expr_operand<M1>, Expr_operand<M2>
+          >
+        >
+    { };
+
+
+  // The scalar expression traits compute the result of applying the
+  // elementwise operation Op to a matrix operand and a scalar. The scalar
+  // is the right operand of the scalar_expr result and the left operand of
+  // the scalar_left_expr result. The value_type is the type of the scalar.
+  template <template <typename> class Op, typename M,
+            bool = Matrix_operand<M>()>
+    struct scalar_expr
+    { };
+
+  template <template <typename> class Op, typename M>
+    struct scalar_expr<Op, M, true>
+    {
+      using value_type = Value_type<Decay<M>>;
+      using type = matrix_expr<
+        Op<value_type>, Expr_operand<M>, expr_scalar<value_type>
+      >;
+    };
+
+  template <template <typename> class Op, typename M,
+            bool = Matrix_operand<M>()>
+    struct scalar_left_expr
+    { };
+
+  template <template <typename> class Op, typename M>
+    struct scalar_left_expr<Op, M, true>
+    {
+      using value_type = Value_type<Decay<M>>;
+      using type = matrix_expr<
+        Op<value_type>, expr_scalar<value_type>, Expr_operand<M>
+      >;
+    };
+
+
+  // Evaluate
+  //
+  // Compute the elements of the expression e, storing them in row-major
+  // order in the array pointed to by out. When all of the operands are
+  // contiguous, the elements are computed by a simple indexed loop, which
+  // the compiler can vectorize.
+  template <typename T, typename E>
+    void
+    evaluate(const E& e, T* out)
+    {
+      const std::size_t n = e.size();
+      if (e.contiguous()) {
+        for (std::size_t i = 0; i < n; ++i)
+          out[i] = e.element(i);
+      } else {
+        auto j = e.begin();
+        for (std::size_t i = 0; i < n; ++i, ++j)
+          out[i] = *j;
+      }
+    }
+
+  // Compute the elements of the expression e, storing them in the
+  // elements of the matrix_ref, out.
+  template <typename T, std::size_t N, typename E>
+    void
+    evaluate(const E& e, matrix_ref<T, N>& out)
+    {
+      assert(same_extents(e, out));
+      const auto& d = out.descriptor();
+      if (is_contiguous(d)) {
+        evaluate(e, out.data() + d.start);
+      } else {
+        auto j = e.begin();
+        for (auto c : row_chunks(out))
+          for (T* p = c.first; p != c.last; ++p, ++j)
+            *p = *j;
+      }
+    }
+
+} // namespace matrix_impl
+
+
+// Eval
+//
+// Returns a matrix containing the elements computed by the expression e.
+template <typename Op, typename E1, typename E2>
+  inline matrix<Value_type<matrix_expr<Op, E1, E2>>, matrix_expr<Op, E1, E2>::order>
+  eval(const matrix_expr<Op, E1, E2>& e)
+  {
+    return e;
+  }
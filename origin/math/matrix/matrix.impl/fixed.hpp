@@ -0,0 +1,555 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Fixed Matrix                                                   [matrix.fixed]
+//
+// The fixed matrix template is an N-dimensional array of elements of type T
+// whose extents are given as template arguments. For example:
+//
+//    fixed_matrix<double, 4, 4> m;   // A 4x4 matrix of doubles
+//
+// The elements are stored inside the object, so a fixed matrix does not
+// allocate, and the strides are compile-time constants, so indexing is a
+// constant expression of the indexes. Products of fixed matrices are
+// computed by fully unrolled kernels and return fixed matrices.
+//
+// A fixed matrix is a strided matrix. It can be used as an operand of the
+// arithmetic operators in operations.hpp, where it behaves like a matrix with
+// the same extents, and it converts to a matrix_ref referring to its
+// elements.
+//
+// Template Parameters:
+//    T       -- The element type stored by the matrix.
+//    Extents -- The extent of each dimension. All extents must be non-zero.
+
+namespace matrix_impl
+{
+  // The fixed size trait is the product of the extents.
+  template <std::size_t... Extents>
+    struct fixed_size;
+
+  template <>
+    struct fixed_size<> : size_constant<1> { };
+
+  template <std::size_t N, std::size_t... Extents>
+    struct fixed_size<N, Extents...>
+      : size_constant<N * fixed_size<Extents...>::value>
+    { };
+
+
+  // The fixed offset trait computes the offset of an element from its
+  // indexes. The stride of each dimension is the product of the extents
+  // that follow it.
+  template <std::size_t... Extents>
+    struct fixed_offset;
+
+  template <>
+    struct fixed_offset<>
+    {
+      static constexpr std::size_t get() { return 0; }
+    };
+
+  template <std::size_t N, std::size_t... Extents>
+    struct fixed_offset<N, Extents...>
+    {
+      template <typename... Args>
+        static constexpr std::size_t
+        get(std::size_t i, Args... args)
+        {
+          return i * fixed_size<Extents...>::value
+               + fixed_offset<Extents...>::get(args...);
+        }
+    };
+
+
+  // Copies the "leaf" elements of an initializer list nesting to out. This
+  // is used with insert_flattened.
+  template <typename T>
+    struct flat_writer
+    {
+      void append(const T* first, const T* last) { out = std::copy(first, last, out); }
+
+      T* out;
+    };
+
+
+  // Products of fixed matrices with at most this many elements in the result
+  // are fully unrolled. Larger products use loops with constant bounds.
+  constexpr std::size_t fixed_unroll_limit = 64;
+
+  // Returns the dot product of the first K elements of a and the elements
+  // of b at stride S.
+  template <std::size_t S, typename T>
+    inline T
+    fixed_dot(const T* a, const T* b, size_constant<1>)
+    {
+      return a[0] * b[0];
+    }
+
+  template <std::size_t S, typename T, std::size_t K>
+    inline T
+    fixed_dot(const T* a, const T* b, size_constant<K>)
+    {
+      return fixed_dot<S>(a, b, size_constant<K - 1>()) + a[K - 1] * b[(K - 1) * S];
+    }
+
+  // Compute the first L elements of the product c (M x N) of the row-major
+  // matrices a (M x P) and b (P x N).
+  template <std::size_t P, std::size_t N, typename T>
+    inline void
+    fixed_product(const T*, const T*, T*, size_constant<0>)
+    { }
+
+  template <std::size_t P, std::size_t N, typename T, std::size_t L>
+    inline void
+    fixed_product(const T* a, const T* b, T* c, size_constant<L>)
+    {
+      fixed_product<P, N>(a, b, c, size_constant<L - 1>());
+      c[L - 1] = fixed_dot<N>(a + (L - 1) / N * P, b + (L - 1) % N, size_constant<P>());
+    }
+
+  // Compute the product c (M x N) of a (M x P) and b (P x N), unrolling the
+  // computation if the result is small enough.
+  template <std::size_t M, std::size_t P, std::size_t N, typename T>
+    inline void
+    fixed_product(const T* a, const T* b, T* c, std::true_type)
+    {
+      fixed_product<P, N>(a, b, c, size_constant<M * N>());
+    }
+
+  template <std::size_t M, std::size_t P, std::size_t N, typename T>
+    inline void
+    fixed_product(const T* a, const T* b, T* c, std::false_type)
+    {
+      for (std::size_t i = 0; i < M; ++i) {
+        for (std::size_t j = 0; j < N; ++j) {
+          T sum = T(0);
+          for (std::size_t k = 0; k < P; ++k)
+            sum += a[i * P + k] * b[k * N + j];
+          c[i * N + j] = sum;
+        }
+      }
+    }
+
+  template <std::size_t M, std::size_t P, std::size_t N, typename T>
+    inline void
+    fixed_product(const T* a, const T* b, T* c)
+    {
+      using Unroll = std::integral_constant<bool, M * N <= fixed_unroll_limit>;
+      fixed_product<M, P, N>(a, b, c, Unroll());
+    }
+} // namespace matrix_impl
+
+
+template <typename T, std::size_t... Extents>
+  class fixed_matrix
+  {
+    static_assert(sizeof...(Extents) > 0, "");
+    static_assert(matrix_impl::fixed_size<Extents...>::value > 0, "");
+
+    static constexpr std::size_t N = sizeof...(Extents);
+    static constexpr std::size_t exts[N] = {Extents...};
+  public:
+    static constexpr std::size_t order = N;
+
+    using value_type     = T;
+    using iterator       = T*;
+    using const_iterator = const T*;
+
+
+    // Default construction
+    //
+    // Initialize a matrix whose elements are value initialized.
+    fixed_matrix() : elems() { }
+
+
+    // Matrix initialization
+    //
+    // Initialize or assign this matrix by copying the elements of the matrix
+    // (or matrix expression) x. The extents of x must be the same as those
+    // of this matrix.
+    template <typename M, typename = Requires<Matrix<M>()>>
+      fixed_matrix(const M& x);
+
+    template <typename M, typename = Requires<Matrix<M>()>>
+      fixed_matrix& operator=(const M& x);
+
+
+    // Value initialization
+    //
+    // Initialize the matrix over a nesting of initializer lists. The
+    // structure of the list must match the extents of the matrix.
+    fixed_matrix(matrix_initializer<T, N> init);
+    fixed_matrix& operator=(matrix_initializer<T, N> init);
+
+    template <typename U>
+      fixed_matrix(std::initializer_list<U> list) = delete;
+
+
+    // Properties
+
+    // Returns a slice describing the matrix. The elements are indexed in
+    // row-major order.
+    static const matrix_slice<N>& descriptor();
+
+    // Returns the extent of the matrix in the nth dimension.
+    static constexpr std::size_t extent(std::size_t n) { return exts[n]; }
+
+    // Returns the number of rows (0th extent) in the matrix.
+    static constexpr std::size_t rows() { return exts[0]; }
+
+    // Returns the number of columns (1st extent) in the matrix.
+    static constexpr std::size_t cols() { return exts[1]; }
+
+    // Returns the total number of elements in the matrix.
+    static constexpr std::size_t size() { return matrix_impl::fixed_size<Extents...>::value; }
+
+
+    // Subscripting
+    //
+    // Returns a reference to the element at the index given by the sequence
+    // of indexes, args. A sequence of slices returns a matrix_ref.
+    template <typename... Args>
+      Requires<matrix_impl::Index_sequence<Args...>(), T&>
+      operator()(Args... args)
+      {
+        static_assert(sizeof...(Args) == N, "");
+        return elems[matrix_impl::fixed_offset<Extents...>::get(args...)];
+      }
+
+    template <typename... Args>
+      Requires<matrix_impl::Index_sequence<Args...>(), const T&>
+      operator()(Args... args) const
+      {
+        static_assert(sizeof...(Args) == N, "");
+        return elems[matrix_impl::fixed_offset<Extents...>::get(args...)];
+      }
+
+    template <typename... Args>
+      Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<T, N>>
+      operator()(const Args&... args) { return ref()(args...); }
+
+    template <typename... Args>
+      Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<const T, N>>
+      operator()(const Args&... args) const { return ref()(args...); }
+
+
+    // Row subscripting
+    matrix_ref<T, N-1>       operator[](std::size_t n)       { return row(n); }
+    matrix_ref<const T, N-1> operator[](std::size_t n) const { return row(n); }
+
+    // Row
+    matrix_ref<T, N-1>       row(std::size_t n);
+    matrix_ref<const T, N-1> row(std::size_t n) const;
+
+    // Column
+    matrix_ref<T, N-1>       col(std::size_t n);
+    matrix_ref<const T, N-1> col(std::size_t n) const;
+
+
+    // Reference
+    //
+    // Returns a matrix_ref referring to the elements of the matrix.
+    matrix_ref<T, N>       ref()       { return {descriptor(), elems}; }
+    matrix_ref<const T, N> ref() const { return {descriptor(), elems}; }
+
+    operator matrix_ref<T, N>()             { return ref(); }
+    operator matrix_ref<const T, N>() const { return ref(); }
+
+
+    // Data access
+    T*       data()       { return elems; }
+    const T* data() const { return elems; }
+
+
+    // Flat element access
+    //
+    // The elements are always contiguous. These are used in the evaluation
+    // of matrix expressions.
+    const T& element(std::size_t i) const { return elems[i]; }
+    bool contiguous() const { return true; }
+
+
+    // Scalar arithmetic
+    fixed_matrix& operator=(const T& x);
+    fixed_matrix& operator+=(const T& x);
+    fixed_matrix& operator-=(const T& x);
+    fixed_matrix& operator*=(const T& x);
+    fixed_matrix& operator/=(const T& x);
+
+    // Matrix arithmetic
+    template <typename M>
+      fixed_matrix& operator+=(const M& m);
+
+    template <typename M>
+      fixed_matrix& operator-=(const M& m);
+
+
+    // Iterators
+    iterator begin() { return elems; }
+    iterator end()   { return elems + size(); }
+
+    const_iterator begin() const { return elems; }
+    const_iterator end() const   { return elems + size(); }
+
+  private:
+    template <typename M>
+      void assign(const M& x, std::true_type);
+
+    template <typename M>
+      void assign(const M& x, std::false_type);
+
+    T elems[matrix_impl::fixed_size<Extents...>::value];
+  };
+
+template <typename T, std::size_t... Extents>
+  constexpr std::size_t fixed_matrix<T, Extents...>::exts[];
+
+
+template <typename T, std::size_t... Extents>
+  template <typename M, typename X>
+    inline
+    fixed_matrix<T, Extents...>::fixed_matrix(const M& x)
+    {
+      *this = x;
+    }
+
+template <typename T, std::size_t... Extents>
+  template <typename M, typename X>
+    inline fixed_matrix<T, Extents...>&
+    fixed_matrix<T, Extents...>::operator=(const M& x)
+    {
+      static_assert(M::order == N, "");
+      assert(same_extents(descriptor(), x.descriptor()));
+      assign(x, std::integral_constant<bool, matrix_impl::Matrix_expression<M>()>());
+      return *this;
+    }
+
+// Expressions are evaluated directly into the elements. If x overlaps the
+// elements through a different slice (e.g., a transposed view of this
+// matrix), it is evaluated into a temporary first, as for matrix.
+template <typename T, std::size_t... Extents>
+  template <typename M>
+    inline void
+    fixed_matrix<T, Extents...>::assign(const M& x, std::true_type)
+    {
+      if (x.aliases(elems, descriptor())) {
+        fixed_matrix tmp;
+        matrix_impl::evaluate(x, tmp.elems);
+        *this = tmp;
+      } else {
+        matrix_impl::evaluate(x, elems);
+      }
+    }
+
+template <typename T, std::size_t... Extents>
+  template <typename M>
+    inline void
+    fixed_matrix<T, Extents...>::assign(const M& x, std::false_type)
+    {
+      if (matrix_impl::operand_aliases(x, elems, descriptor())) {
+        fixed_matrix tmp;
+        std::copy_n(x.begin(), size(), tmp.elems);
+        *this = tmp;
+      } else {
+        std::copy_n(x.begin(), size(), elems);
+      }
+    }
+
+template <typename T, std::size_t... Extents>
+  inline
+  fixed_matrix<T, Extents...>::fixed_matrix(matrix_initializer<T, N> init)
+  {
+    assert(matrix_impl::derive_extents<N>(init) == (std::array<std::size_t, N> {{Extents...}}));
+    matrix_impl::flat_writer<T> w {elems};
+    matrix_impl::insert_flattened(init, w);
+  }
+
+template <typename T, std::size_t... Extents>
+  inline fixed_matrix<T, Extents...>&
+  fixed_matrix<T, Extents...>::operator=(matrix_initializer<T, N> init)
+  {
+    return *this = fixed_matrix(init);
+  }
+
+
+template <typename T, std::size_t... Extents>
+  auto
+  fixed_matrix<T, Extents...>::descriptor() -> const matrix_slice<N>&
+  {
+    static const matrix_slice<N> desc(0, {Extents...});
+    return desc;
+  }
+
+
+// Row and column
+
+template <typename T, std::size_t... Extents>
+  inline auto
+  fixed_matrix<T, Extents...>::row(std::size_t n) -> matrix_ref<T, N-1>
+  {
+    assert(n < rows());
+    matrix_slice<N-1> row(descriptor(), size_constant<0>(), n);
+    return {row, data()};
+  }
+
+template <typename T, std::size_t... Extents>
+  inline auto
+  fixed_matrix<T, Extents...>::row(std::size_t n) const -> matrix_ref<const T, N-1>
+  {
+    assert(n < rows());
+    matrix_slice<N-1> row(descriptor(), size_constant<0>(), n);
+    return {row, data()};
+  }
+
+template <typename T, std::size_t... Extents>
+  inline auto
+  fixed_matrix<T, Extents...>::col(std::size_t n) -> matrix_ref<T, N-1>
+  {
+    assert(n < cols());
+    matrix_slice<N-1> col(descriptor(), size_constant<1>(), n);
+    return {col, data()};
+  }
+
+template <typename T, std::size_t... Extents>
+  inline auto
+  fixed_matrix<T, Extents...>::col(std::size_t n) const -> matrix_ref<const T, N-1>
+  {
+    assert(n < cols());
+    matrix_slice<N-1> col(descriptor(), size_constant<1>(), n);
+    return {col, data()};
+  }
+
+
+// Scalar arithmetic
+
+template <typename T, std::size_t... Extents>
+  inline fixed_matrix<T, Extents...>&
+  fixed_matrix<T, Extents...>::operator=(const T& x)
+  {
+    std::fill_n(elems, size(), x);
+    return *this;
+  }
+
+template <typename T, std::size_t... Extents>
+  inline fixed_matrix<T, Extents...>&
+  fixed_matrix<T, Extents...>::operator+=(const T& x)
+  {
+    for (std::size_t i = 0; i < size(); ++i)
+      elems[i] += x;
+    return *this;
+  }
+
+template <typename T, std::size_t... Extents>
+  inline fixed_matrix<T, Extents...>&
+  fixed_matrix<T, Extents...>::operator-=(const T& x)
+  {
+    for (std::size_t i = 0; i < size(); ++i)
+      elems[i] -= x;
+    return *this;
+  }
+
+template <typename T, std::size_t... Extents>
+  inline fixed_matrix<T, Extents...>&
+  fixed_matrix<T, Extents...>::operator*=(const T& x)
+  {
+    for (std::size_t i = 0; i < size(); ++i)
+      elems[i] *= x;
+    return *this;
+  }
+
+template <typename T, std::size_t... Extents>
+  inline fixed_matrix<T, Extents...>&
+  fixed_matrix<T, Extents...>::operator/=(const T& x)
+  {
+    for (std::size_t i = 0; i < size(); ++i)
+      elems[i] /= x;
+    return *this;
+  }
+
+
+// Matrix arithmetic
+
+template <typename T, std::size_t... Extents>
+  template <typename M>
+    inline fixed_matrix<T, Extents...>&
+    fixed_matrix<T, Extents...>::operator+=(const M& m)
+    {
+      static_assert(M::order == N, "");
+      assert(same_extents(descriptor(), m.descriptor()));
+      auto j = m.begin();
+      for (std::size_t i = 0; i < size(); ++i, ++j)
+        elems[i] += *j;
+      return *this;
+    }
+
+template <typename T, std::size_t... Extents>
+  template <typename M>
+    inline fixed_matrix<T, Extents...>&
+    fixed_matrix<T, Extents...>::operator-=(const M& m)
+    {
+      static_assert(M::order == N, "");
+      assert(same_extents(descriptor(), m.descriptor()));
+      auto j = m.begin();
+      for (std::size_t i = 0; i < size(); ++i, ++j)
+        elems[i] -= *j;
+      return *this;
+    }
+
+
+// Fixed matrix product
+//
+// The product of fixed matrices a (M x P) and b (P x N) is the fixed matrix
+// c (M x N). The product of a and the fixed vector x (P) is the fixed vector
+// y (M). The result is computed by an unrolled kernel.
+template <typename T, std::size_t M, std::size_t P, std::size_t N>
+  inline fixed_matrix<T, M, N>
+  operator*(const fixed_matrix<T, M, P>& a, const fixed_matrix<T, P, N>& b)
+  {
+    fixed_matrix<T, M, N> c;
+    matrix_impl::fixed_product<M, P, N>(a.data(), b.data(), c.data());
+    return c;
+  }
+
+template <typename T, std::size_t M, std::size_t P>
+  inline fixed_matrix<T, M>
+  operator*(const fixed_matrix<T, M, P>& a, const fixed_matrix<T, P>& x)
+  {
+    fixed_matrix<T, M> y;
+    matrix_impl::fixed_product<M, P, 1>(a.data(), x.data(), y.data());
+    return y;
+  }
+
+
+namespace matrix_impl
+{
+  // A fixed matrix is a strided matrix and a matrix operand. Lvalue fixed
+  // matrices are stored by reference in expressions.
+  template <typename T, std::size_t... Extents>
+    struct is_strided_matrix<fixed_matrix<T, Extents...>> : std::true_type { };
+
+  template <typename T, std::size_t... Extents>
+    struct is_matrix_operand<fixed_matrix<T, Extents...>> : std::true_type { };
+
+  template <typename T, std::size_t... Extents>
+    struct expr_operand<fixed_matrix<T, Extents...>&>
+    {
+      using type = const fixed_matrix<T, Extents...>&;
+    };
+
+  template <typename T, std::size_t... Extents>
+    struct expr_operand<const fixed_matrix<T, Extents...>&>
+    {
+      using type = const fixed_matrix<T, Extents...>&;
+    };
+} // namespace matrix_impl
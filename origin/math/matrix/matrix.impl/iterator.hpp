@@ -14,23 +14,33 @@
 //                             Slice Iterator
 //
 // A slice iterator ranges over the elements of a submatrix specified by a
-// slice.
+// slice. The elements are visited in row-major order.
 //
-// A slice iterator is a forward iterator. Note that it may be possible to make
-// this bidirectional or random access, but we reserve that for future work.
+// A slice iterator is a random access iterator. Incrementing the iterator
+// only updates the index of the innermost dimension except at the end of a
+// row. Advancing the iterator by n elements computes the indexes of the new
+// position directly.
+//
+// A slice iterator refers to the slice of the matrix (or matrix_ref) over
+// which it iterates. The iterator is invalidated when that object is
+// destroyed.
 template <typename T, std::size_t N>
-  struct slice_iterator
+  class slice_iterator
   {
+  public:
     using value_type = Remove_const<T>;
     using reference = T&;
     using pointer = T*;
     using difference_type = std::ptrdiff_t;
-    using iterator_category = std::forward_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
 
     slice_iterator(const matrix_slice<N>& s, T* base, bool limit = false);
 
-    // Returns the iterators describing slice.
-    const matrix_slice<N>& descriptor() const { return desc; }
+    // Returns the slice describing the iterator range.
+    const matrix_slice<N>& descriptor() const { return *desc; }
+
+    // Returns the position of the iterator in the sequence of elements.
+    std::ptrdiff_t position() const { return pos; }
 
     // Readable
     T& operator*() const { return *ptr; }
@@ -40,13 +50,46 @@ template <typename T, std::size_t N>
     slice_iterator& operator++();
     slice_iterator operator++(int);
 
+    // Bidirectional Iterator
+    slice_iterator& operator--();
+    slice_iterator operator--(int);
+
+    // Random Access Iterator
+    slice_iterator& operator+=(difference_type n);
+    slice_iterator& operator-=(difference_type n) { return *this += -n; }
+
+    T& operator[](difference_type n) const { return *(*this + n); }
+
+    // Move to the start of the next row. The iterator must be at the start
+    // of a row.
+    slice_iterator& next_row();
+
+    friend slice_iterator
+    operator+(slice_iterator i, difference_type n) { return i += n; }
+
+    friend slice_iterator
+    operator+(difference_type n, slice_iterator i) { return i += n; }
+
+    friend slice_iterator
+    operator-(slice_iterator i, difference_type n) { return i -= n; }
+
+    friend difference_type
+    operator-(const slice_iterator& a, const slice_iterator& b)
+    {
+      return a.pos - b.pos;
+    }
+
   private:
     void increment();
+    void decrement();
+    void seek(std::ptrdiff_t n);
 
   private:
-    const matrix_slice<N>& desc; // Describes the iterator range
-    std::size_t indexes[N];       // Counting indexes
+    const matrix_slice<N>* desc;  // Describes the iterator range
+    T* base;                      // The base of the matrix
     T* ptr;                       // The current element
+    std::ptrdiff_t pos;           // The row-major position of the element
+    std::size_t indexes[N];       // Counting indexes
   };
 
 
@@ -54,14 +97,16 @@ template <typename T, std::size_t N>
   slice_iterator<T, N>::slice_iterator(const matrix_slice<N>& s, 
                                        T* base, 
                                        bool limit)
-    : desc(s)
+    : desc(&s), base(base)
   {
     std::fill_n(indexes, N, 0);
     if (limit) {
-      indexes[0] = desc.extents[0];
-      ptr = base + desc.offset(indexes);
+      indexes[0] = desc->extents[0];
+      ptr = base + desc->offset(indexes);
+      pos = desc->size;
     } else {
       ptr = base + s.start;
+      pos = 0;
     }
   }
 
@@ -82,33 +127,115 @@ template <typename T, std::size_t N>
     return x;
   }
 
+template <typename T, std::size_t N>
+  inline slice_iterator<T, N>&
+  slice_iterator<T, N>::operator--()
+  {
+    decrement();
+    return *this;
+  }
+
+template <typename T, std::size_t N>
+  inline slice_iterator<T, N>
+  slice_iterator<T, N>::operator--(int)
+  {
+    slice_iterator x = *this;
+    decrement();
+    return x;
+  }
+
+template <typename T, std::size_t N>
+  inline slice_iterator<T, N>&
+  slice_iterator<T, N>::operator+=(difference_type n)
+  {
+    seek(pos + n);
+    return *this;
+  }
+
 
 // Move to the next element in the range.
 template <typename T, std::size_t N>
-  void
+  inline void
   slice_iterator<T, N>::increment()
   {
+    ++pos;
+
+    // The common case: move along the current row.
+    ptr += desc->strides[N - 1];
+    if (++indexes[N - 1] != desc->extents[N - 1] || N == 1)
+      return;
+
+    // Otherwise, carry into the outer dimensions. If the 0th dimension is
+    // exhausted, we have counted through the entire slice.
     std::size_t d = N - 1;
     while (true) {
-      ptr += desc.strides[d];
+      if (indexes[d] != desc->extents[d] || d == 0)
+        break;
+      ptr -= desc->strides[d] * desc->extents[d];
+      indexes[d] = 0;
+      --d;
+      ptr += desc->strides[d];
       ++indexes[d];
+    }
+  }
 
-      // If have not yet counted to the extent of the current dimension, then
-      // we will continue to do so in the next iteration.
-      if (indexes[d] != desc.extents[d])
-        break;
+// Move to the first element of the next row by carrying out of the
+// innermost dimension, as if it had been incremented through the row.
+template <typename T, std::size_t N>
+  inline slice_iterator<T, N>&
+  slice_iterator<T, N>::next_row()
+  {
+    assert(indexes[N - 1] == 0);
+    std::size_t d = N - 1;
+    pos += desc->extents[d];
+    ptr += desc->strides[d] * desc->extents[d];
+    indexes[d] = desc->extents[d];
+    while (d != 0 && indexes[d] == desc->extents[d]) {
+      ptr -= desc->strides[d] * desc->extents[d];
+      indexes[d] = 0;
+      --d;
+      ptr += desc->strides[d];
+      ++indexes[d];
+    }
+    return *this;
+  }
 
-      // Otherwise, if we have not counted to the extent in the outermost
-      // dimension, move to the next dimension and try again. If d is 0, then
-      // we have counted through the entire slice.
-      if (d != 0) {
-        ptr -= desc.strides[d] * desc.extents[d];
-        indexes[d] = 0;
-        --d;
-      } else {
-        break;
+// Move to the previous element in the range.
+template <typename T, std::size_t N>
+  inline void
+  slice_iterator<T, N>::decrement()
+  {
+    --pos;
+    std::size_t d = N - 1;
+    while (indexes[d] == 0 && d != 0) {
+      indexes[d] = desc->extents[d] - 1;
+      ptr += desc->strides[d] * indexes[d];
+      --d;
+    }
+    --indexes[d];
+    ptr -= desc->strides[d];
+  }
+
+// Move to the nth element of the range, computing its indexes from n. The
+// end of the range is represented as the 0th index being equal to the 0th
+// extent.
+template <typename T, std::size_t N>
+  void
+  slice_iterator<T, N>::seek(std::ptrdiff_t n)
+  {
+    assert(0 <= n && n <= std::ptrdiff_t(desc->size));
+    pos = n;
+    if (n == std::ptrdiff_t(desc->size)) {
+      std::fill_n(indexes, N, 0);
+      indexes[0] = desc->extents[0];
+    } else {
+      std::size_t k = n;
+      for (std::size_t d = N; d != 0; --d) {
+        indexes[d - 1] = k % desc->extents[d - 1];
+        k /= desc->extents[d - 1];
       }
     }
+    ptr = base + desc->offset(indexes);
   }
 
 
@@ -124,7 +251,7 @@ template <typename T, std::size_t N>
   operator==(const slice_iterator<T, N>& a, const slice_iterator<T, N>& b)
   {
     assert(a.descriptor() == b.descriptor());
-    return &*a == &*b;
+    return a.position() == b.position();
   }
 
 template <typename T, std::size_t N>
@@ -133,3 +260,175 @@ template <typename T, std::size_t N>
   {
     return !(a == b);
   }
+
+
+// Totally_ordered
+//
+// Slice iterators are ordered by their position in the range. It is undefined
+// behavior to compare slice iterators from different slices.
+template <typename T, std::size_t N>
+  inline bool
+  operator<(const slice_iterator<T, N>& a, const slice_iterator<T, N>& b)
+  {
+    return a.position() < b.position();
+  }
+
+template <typename T, std::size_t N>
+  inline bool
+  operator>(const slice_iterator<T, N>& a, const slice_iterator<T, N>& b)
+  {
+    return b < a;
+  }
+
+template <typename T, std::size_t N>
+  inline bool
+  operator<=(const slice_iterator<T, N>& a, const slice_iterator<T, N>& b)
+  {
+    return !(b < a);
+  }
+
+template <typename T, std::size_t N>
+  inline bool
+  operator>=(const slice_iterator<T, N>& a, const slice_iterator<T, N>& b)
+  {
+    return !(a < b);
+  }
+
+
+// -------------------------------------------------------------------------- //
+//                              Row Chunks
+//
+// The row chunks of a matrix are the contiguous runs of elements in its
+// innermost dimension, visited in row-major order. Each chunk is a
+// pointer range [first, last). If the matrix is stored contiguously, the
+// entire matrix is a single chunk. If the innermost stride is not 1, each
+// element is a chunk. For example:
+//
+//    for (auto c : row_chunks(m(slice::all, slice(1, 4))))
+//      for (double* p = c.first; p != c.last; ++p)
+//        *p *= 2;
+//
+// This allows kernels to be written as tight loops over pointers while
+// still supporting arbitrary matrix_ref views.
+
+// A row chunk is a range of contiguous elements.
+template <typename T>
+  struct row_chunk
+  {
+    T* begin() const { return first; }
+    T* end() const   { return last; }
+
+    std::size_t size() const { return last - first; }
+
+    T* first;
+    T* last;
+  };
+
+
+// The row chunk iterator visits the row chunks of a slice. Each chunk
+// contains len elements, starting at the current position of the underlying
+// slice iterator. Chunks of a single element or a single row are advanced
+// incrementally; only a contiguous slice, which is one chunk, seeks.
+template <typename T, std::size_t N>
+  class row_chunk_iterator
+  {
+  public:
+    using value_type = row_chunk<T>;
+    using reference = row_chunk<T>;
+    using pointer = const row_chunk<T>*;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+
+    row_chunk_iterator(slice_iterator<T, N> i, std::ptrdiff_t n)
+      : iter(i), len(n)
+    { }
+
+    row_chunk<T>
+    operator*() const
+    {
+      T* p = &*iter;
+      return {p, p + len};
+    }
+
+    row_chunk_iterator&
+    operator++()
+    {
+      const auto& d = iter.descriptor();
+      if (len == 1)
+        ++iter;
+      else if (std::size_t(len) == d.extents[N - 1])
+        iter.next_row();
+      else
+        iter += len;
+      return *this;
+    }
+
+    row_chunk_iterator
+    operator++(int)
+    {
+      row_chunk_iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const row_chunk_iterator& x) const { return iter == x.iter; }
+    bool operator!=(const row_chunk_iterator& x) const { return iter != x.iter; }
+
+  private:
+    slice_iterator<T, N> iter;
+    std::ptrdiff_t len;
+  };
+
+
+namespace matrix_impl
+{
+  template <std::size_t N>
+    bool is_contiguous(const matrix_slice<N>& s);
+} // namespace matrix_impl
+
+
+// The row chunk range describes the row chunks of a slice. The range holds
+// a copy of the slice, so it remains valid even when the matrix_ref from
+// which it was created is destroyed.
+template <typename T, std::size_t N>
+  class row_chunk_range
+  {
+  public:
+    using iterator = row_chunk_iterator<T, N>;
+
+    row_chunk_range(const matrix_slice<N>& s, T* base)
+      : desc(s), base(base)
+    { }
+
+    iterator begin() const { return {{desc, base}, length()}; }
+    iterator end() const   { return {{desc, base, true}, length()}; }
+
+  private:
+    // Returns the number of elements in each chunk.
+    std::ptrdiff_t
+    length() const
+    {
+      if (desc.size == 0 || desc.strides[N - 1] != 1)
+        return 1;
+      if (matrix_impl::is_contiguous(desc))
+        return desc.size;
+      return desc.extents[N - 1];
+    }
+
+    matrix_slice<N> desc;
+    T* base;
+  };
+
+
+// Row chunks
+//
+// Returns the range of row chunks of the strided matrix m (a matrix or
+// matrix_ref). The chunks of a const matrix are ranges of const elements.
+template <typename M,
+          typename = Requires<matrix_impl::Strided_matrix<Decay<M>>()>>
+  inline row_chunk_range<Remove_reference<decltype(*std::declval<M&>().data())>,
+                         Decay<M>::order>
+  row_chunks(M&& m)
+  {
+    return {m.descriptor(), m.data()};
+  }
@@ -0,0 +1,419 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+// The kernels in this file operate on raw, row-major blocks of memory. A block
+// is described by a pointer to its first element and a leading dimension:
+// the distance between the first elements of consecutive rows. Matrices and
+// matrix_refs whose innermost stride is 1 can be passed to these kernels
+// directly.
+
+namespace matrix_impl
+{
+  // ------------------------------------------------------------------------ //
+  //                          Contiguous Rows
+  //
+  // Returns true if the elements of each row of the 2D slice are contiguous
+  // in memory. That is, the stride in the innermost dimension is 1.
+  inline bool
+  has_contiguous_rows(const matrix_slice<2>& s)
+  {
+    return s.strides[1] == 1;
+  }
+
+  // Returns true if the elements described by the slice are contiguous in
+  // memory and stored in row-major order. That is, the strides are those that
+  // would be computed for a matrix having the slice's extents.
+  template <std::size_t N>
+    inline bool
+    is_contiguous(const matrix_slice<N>& s)
+    {
+      std::size_t n = 1;
+      for (std::size_t i = N; i != 0; --i) {
+        if (s.extents[i - 1] != 1 && s.strides[i - 1] != n)
+          return false;
+        n *= s.extents[i - 1];
+      }
+      return true;
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Blocking Parameters
+  //
+  // The gemm blocking parameters determine the sizes of the blocks into
+  // which the operands of a matrix product are partitioned.
+  //
+  //    mr, nr -- The size of the register tile computed by the micro-kernel.
+  //    mc     -- The number of rows of a packed block of the left operand.
+  //    kc     -- The depth of packed blocks (shared inner dimension).
+  //    nc     -- The number of columns of a packed block of the right operand.
+  //
+  // An mc x kc block of the left operand is meant to stay resident in the L2
+  // cache, and a kc x nr sliver of the right operand in the L1 cache. The
+  // register tile holds mr * nr accumulators.
+  template <typename T>
+    struct gemm_blocking
+    {
+      static constexpr std::size_t mr = 4;
+      static constexpr std::size_t nr = 32 / sizeof(T) < 4 ? 4 : 32 / sizeof(T);
+      static constexpr std::size_t mc = 128;
+      static constexpr std::size_t kc = 256;
+      static constexpr std::size_t nc = 2048;
+    };
+
+
+  // Pack the m x k block of a, scaled by alpha, into consecutive panels of
+  // MR rows. The rows and columns of a have the strides rs and cs. Each
+  // panel is stored column by column so that the micro-kernel reads it
+  // sequentially. Rows past m are padded with zeros.
+  template <std::size_t MR, typename T>
+    void
+    gemm_pack_left(std::size_t m, std::size_t k,
+                   const T* a, std::size_t rs, std::size_t cs, T alpha,
+                   T* out)
+    {
+      for (std::size_t i = 0; i < m; i += MR) {
+        const std::size_t mr = std::min(MR, m - i);
+        for (std::size_t p = 0; p < k; ++p) {
+          std::size_t r = 0;
+          for ( ; r < mr; ++r)
+            *out++ = alpha * a[(i + r) * rs + p * cs];
+          for ( ; r < MR; ++r)
+            *out++ = T(0);
+        }
+      }
+    }
+
+  // Pack the k x n block of b into consecutive panels of NR columns. The
+  // rows and columns of b have the strides rs and cs. Each panel is stored
+  // row by row so that the micro-kernel reads it sequentially. Columns past
+  // n are padded with zeros.
+  template <std::size_t NR, typename T>
+    void
+    gemm_pack_right(std::size_t k, std::size_t n,
+                    const T* b, std::size_t rs, std::size_t cs,
+                    T* out)
+    {
+      for (std::size_t j = 0; j < n; j += NR) {
+        const std::size_t nr = std::min(NR, n - j);
+        for (std::size_t p = 0; p < k; ++p) {
+          const T* row = b + p * rs + j * cs;
+          std::size_t c = 0;
+          for ( ; c < nr; ++c)
+            *out++ = row[c * cs];
+          for ( ; c < NR; ++c)
+            *out++ = T(0);
+        }
+      }
+    }
+
+
+  // The micro-kernel computes the MR x NR register tile of a product of a
+  // packed panel of the left operand and a packed panel of the right operand,
+  // both having depth k. The tile is accumulated into the m x n block of c
+  // (m <= MR, n <= NR), which has the leading dimension ldc.
+  template <std::size_t MR, std::size_t NR, typename T>
+    inline void
+    gemm_micro_kernel(std::size_t k,
+                      const T* a, const T* b,
+                      T* c, std::size_t ldc,
+                      std::size_t m, std::size_t n)
+    {
+      T acc[MR][NR] = {};
+      for (std::size_t p = 0; p < k; ++p) {
+        for (std::size_t r = 0; r < MR; ++r) {
+          const T x = a[r];
+          for (std::size_t s = 0; s < NR; ++s)
+            acc[r][s] += x * b[s];
+        }
+        a += MR;
+        b += NR;
+      }
+
+      for (std::size_t r = 0; r < m; ++r)
+        for (std::size_t s = 0; s < n; ++s)
+          c[r * ldc + s] += acc[r][s];
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Gemm Workspace
+  //
+  // The workspace holds the buffers into which blocks of the operands of a
+  // product are packed. The buffers only grow, so a workspace that is reused
+  // for many products allocates memory only when a product needs larger
+  // blocks than any before it.
+  template <typename T>
+    struct gemm_workspace
+    {
+      // Ensure that the buffers can hold the blocks of an m x k by k x n
+      // product.
+      void
+      reserve(std::size_t m, std::size_t n, std::size_t k)
+      {
+        using Blocking = gemm_blocking<T>;
+        constexpr std::size_t MR = Blocking::mr;
+        constexpr std::size_t NR = Blocking::nr;
+        const std::size_t MC = Blocking::mc;
+        const std::size_t KC = Blocking::kc;
+        const std::size_t NC = Blocking::nc;
+
+        // Size the buffers for the largest blocks that can occur, rounded up
+        // to a whole number of panels.
+        const std::size_t mc = std::min(MC, m);
+        const std::size_t kc = std::min(KC, k);
+        const std::size_t nc = std::min(NC, n);
+        const std::size_t nl = ((mc + MR - 1) / MR) * MR * kc;
+        const std::size_t nr = ((nc + NR - 1) / NR) * NR * kc;
+        if (left.size() < nl)
+          left.resize(nl);
+        if (right.size() < nr)
+          right.resize(nr);
+      }
+
+      std::vector<T> left;
+      std::vector<T> right;
+    };
+
+  // Returns the calling thread's gemm workspace. The products computed by a
+  // thread share its workspace, so they allocate only when one needs larger
+  // blocks than any before it.
+  template <typename T>
+    inline gemm_workspace<T>&
+    thread_gemm_workspace()
+    {
+      static thread_local gemm_workspace<T> w;
+      return w;
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Blocked Matrix Product
+  //
+  // Accumulate the product of the m x k block a and the k x n block b into
+  // the m x n block c. That is:
+  //
+  //    c += alpha * a * b
+  //
+  // The operands are partitioned into cache-sized blocks which are packed
+  // into the buffers of the workspace before being multiplied by a
+  // register-tiled micro-kernel. Because the operands are read only when
+  // they are packed, their rows and columns may have any strides: ars and
+  // acs are the row and column strides of a, and brs and bcs those of b.
+  template <typename T>
+    void
+    gemm_strided(std::size_t m, std::size_t n, std::size_t k, T alpha,
+                 const T* a, std::size_t ars, std::size_t acs,
+                 const T* b, std::size_t brs, std::size_t bcs,
+                 T* c, std::size_t ldc,
+                 gemm_workspace<T>& w)
+    {
+      using Blocking = gemm_blocking<T>;
+      constexpr std::size_t MR = Blocking::mr;
+      constexpr std::size_t NR = Blocking::nr;
+      const std::size_t MC = Blocking::mc;
+      const std::size_t KC = Blocking::kc;
+      const std::size_t NC = Blocking::nc;
+
+      if (m == 0 || n == 0 || k == 0)
+        return;
+
+      w.reserve(m, n, k);
+      T* left = w.left.data();
+      T* right = w.right.data();
+
+      for (std::size_t jc = 0; jc < n; jc += NC) {
+        const std::size_t nb = std::min(NC, n - jc);
+
+        for (std::size_t pc = 0; pc < k; pc += KC) {
+          const std::size_t kb = std::min(KC, k - pc);
+          gemm_pack_right<NR>(kb, nb, b + pc * brs + jc * bcs, brs, bcs, right);
+
+          for (std::size_t ic = 0; ic < m; ic += MC) {
+            const std::size_t mb = std::min(MC, m - ic);
+            gemm_pack_left<MR>(mb, kb, a + ic * ars + pc * acs, ars, acs, alpha, left);
+
+            // Multiply the packed blocks one register tile at a time.
+            for (std::size_t jr = 0; jr < nb; jr += NR) {
+              const T* bp = right + jr * kb;
+              for (std::size_t ir = 0; ir < mb; ir += MR) {
+                const T* ap = left + ir * kb;
+                T* cp = c + (ic + ir) * ldc + jc + jr;
+                gemm_micro_kernel<MR, NR>(kb, ap, bp, cp, ldc,
+                                          std::min(MR, mb - ir),
+                                          std::min(NR, nb - jr));
+              }
+            }
+          }
+        }
+      }
+    }
+
+  // Accumulate the product of the m x k block a and the k x n block b into
+  // the m x n block c, each having contiguous rows. That is:
+  //
+  //    c += a * b
+  //
+  // The blocks are packed into the calling thread's workspace.
+  template <typename T>
+    void
+    gemm_blocked(std::size_t m, std::size_t n, std::size_t k,
+                 const T* a, std::size_t lda,
+                 const T* b, std::size_t ldb,
+                 T* c, std::size_t ldc)
+    {
+      gemm_strided(m, n, k, T(1), a, lda, 1, b, ldb, 1, c, ldc,
+                   thread_gemm_workspace<T>());
+    }
+
+  // The number of multiply-adds in a product below which gemm_kernel
+  // multiplies the operands directly instead of packing them.
+  constexpr std::size_t gemm_direct_threshold = 1 << 15;
+
+  // Compute y = alpha * x + y for the vectors x and y having n elements with
+  // the strides incx and incy.
+  template <typename T>
+    inline void
+    axpy_kernel(std::size_t n, T alpha,
+                const T* x, std::size_t incx,
+                T* y, std::size_t incy)
+    {
+      if (incx == 1 && incy == 1) {
+        for (std::size_t i = 0; i < n; ++i)
+          y[i] += alpha * x[i];
+      } else {
+        for (std::size_t i = 0; i < n; ++i)
+          y[i * incy] += alpha * x[i * incx];
+      }
+    }
+
+  // Compute c += alpha * a * b, where a is m x k, b is k x n and c is m x n,
+  // without packing the operands. The arguments following each pointer are
+  // its row and column strides.
+  template <typename T>
+    void
+    gemm_direct(std::size_t m, std::size_t n, std::size_t k, T alpha,
+                const T* a, std::size_t ars, std::size_t acs,
+                const T* b, std::size_t brs, std::size_t bcs,
+                T* c, std::size_t crs, std::size_t ccs)
+    {
+      for (std::size_t i = 0; i < m; ++i) {
+        T* ci = c + i * crs;
+        for (std::size_t p = 0; p < k; ++p)
+          axpy_kernel(n, alpha * a[i * ars + p * acs], b + p * brs, bcs, ci, ccs);
+      }
+    }
+
+  // Compute c += alpha * a * b. Large products are computed by the packed
+  // kernel, which requires either the rows or the columns of c to be
+  // contiguous. In the latter case, the transposed product is computed.
+  template <typename T>
+    void
+    gemm_kernel(std::size_t m, std::size_t n, std::size_t k, T alpha,
+                const T* a, std::size_t ars, std::size_t acs,
+                const T* b, std::size_t brs, std::size_t bcs,
+                T* c, std::size_t crs, std::size_t ccs)
+    {
+      if (m == 0 || n == 0 || k == 0 || alpha == T(0))
+        return;
+      if (m * n * k >= gemm_direct_threshold) {
+        if (ccs == 1) {
+          gemm_strided(m, n, k, alpha, a, ars, acs, b, brs, bcs, c, crs,
+                       thread_gemm_workspace<T>());
+          return;
+        }
+        if (crs == 1) {
+          gemm_strided(n, m, k, alpha, b, bcs, brs, a, acs, ars, c, ccs,
+                       thread_gemm_workspace<T>());
+          return;
+        }
+      }
+      gemm_direct(m, n, k, alpha, a, ars, acs, b, brs, bcs, c, crs, ccs);
+    }
+
+  // ------------------------------------------------------------------------ //
+  //                              Transpose
+  //
+  // The transpose kernels are cache-oblivious: the larger dimension of a
+  // block is recursively halved until the block is small enough that both
+  // its rows and columns fit in the cache. Unlike the other kernels, the
+  // blocks are described by a row stride and a column stride, so that
+  // arbitrary strided views can be transposed.
+
+  // The side of the largest block transposed without further subdivision.
+  constexpr std::size_t transpose_tile = 32;
+
+  // Store the transpose of the m x n block a in the n x m block b. That is,
+  // b(j, i) = a(i, j).
+  template <typename T>
+    void
+    transpose_block(std::size_t m, std::size_t n,
+                    const T* a, std::size_t ars, std::size_t acs,
+                    T* b, std::size_t brs, std::size_t bcs)
+    {
+      if (m <= transpose_tile && n <= transpose_tile) {
+        for (std::size_t i = 0; i < m; ++i)
+          for (std::size_t j = 0; j < n; ++j)
+            b[j * brs + i * bcs] = a[i * ars + j * acs];
+      } else if (m >= n) {
+        const std::size_t h = m / 2;
+        transpose_block(h, n, a, ars, acs, b, brs, bcs);
+        transpose_block(m - h, n, a + h * ars, ars, acs, b + h * bcs, brs, bcs);
+      } else {
+        const std::size_t h = n / 2;
+        transpose_block(m, h, a, ars, acs, b, brs, bcs);
+        transpose_block(m, n - h, a + h * acs, ars, acs, b + h * brs, brs, bcs);
+      }
+    }
+
+  // Exchange the m x n block a with the transpose of the n x m block b.
+  // That is, swap a(i, j) with b(j, i). Both blocks have the same strides.
+  template <typename T>
+    void
+    transpose_swap_block(std::size_t m, std::size_t n,
+                         T* a, T* b, std::size_t rs, std::size_t cs)
+    {
+      using std::swap;
+      if (m <= transpose_tile && n <= transpose_tile) {
+        for (std::size_t i = 0; i < m; ++i)
+          for (std::size_t j = 0; j < n; ++j)
+            swap(a[i * rs + j * cs], b[j * rs + i * cs]);
+      } else if (m >= n) {
+        const std::size_t h = m / 2;
+        transpose_swap_block(h, n, a, b, rs, cs);
+        transpose_swap_block(m - h, n, a + h * rs, b + h * cs, rs, cs);
+      } else {
+        const std::size_t h = n / 2;
+        transpose_swap_block(m, h, a, b, rs, cs);
+        transpose_swap_block(m, n - h, a + h * cs, b + h * rs, rs, cs);
+      }
+    }
+
+  // Transpose the n x n block a in place. The diagonal blocks are transposed
+  // recursively, and the off-diagonal blocks are exchanged.
+  template <typename T>
+    void
+    transpose_square_block(std::size_t n, T* a, std::size_t rs, std::size_t cs)
+    {
+      using std::swap;
+      if (n <= transpose_tile) {
+        for (std::size_t i = 1; i < n; ++i)
+          for (std::size_t j = 0; j < i; ++j)
+            swap(a[i * rs + j * cs], a[j * rs + i * cs]);
+        return;
+      }
+      const std::size_t h = n / 2;
+      transpose_square_block(h, a, rs, cs);
+      transpose_square_block(n - h, a + h * rs + h * cs, rs, cs);
+      transpose_swap_block(h, n - h, a + h * cs, a + h * rs, rs, cs);
+    }
+
+} // namespace matrix_impl
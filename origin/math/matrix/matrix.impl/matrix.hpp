@@ -20,27 +20,38 @@
 // Note that matrix<T, 0> is a valid type, but it is not a matrix. It contains
 // a single scalar of type T.
 //
-// TODO: Don't use vector<T> as the underlying store; just use a dynamically
-// allocated array. Certain operations will become faster (with fewer
-// assignments) and the class will take less space (2 pointers less). This
-// would also allow us to write an interesting version of reserve().
+// The elements are stored in a dynamically allocated array obtained from the
+// allocator. By default, the array is aligned on a 64 byte boundary, making it
+// suitable for vectorized kernels. A matrix can be constructed without
+// initializing its elements (see uninitialized_t), and its capacity can be
+// reserved in advance of resizing.
 //
 // Template Parameters:
 //    T -- The eleemnt type stored by the matrix
 //    N -- The matrix order (number of extents).
-template <typename T, std::size_t N>
+//    A -- The Allocator used to allocate the elements.
+template <typename T, std::size_t N, typename A>
   class matrix
   {
+    static_assert(Allocator<A>(), "");
   public:
     static constexpr std::size_t order = N;
 
     using value_type     = T;
-    using iterator       = typename std::vector<T>::iterator;
-    using const_iterator = typename std::vector<T>::const_iterator;
+    using allocator_type = A;
+    using iterator       = T*;
+    using const_iterator = const T*;
 
 
     // Default construction
-    matrix() = default;
+    //
+    // Initialize an empty matrix. All extents are 0.
+    matrix() : desc(), elems() { }
+
+    // Allocator construction
+    //
+    // Initialize an empty matrix that uses the given allocator.
+    explicit matrix(const A& alloc);
 
     // Move semantics
     matrix(matrix&&) = default;
@@ -69,12 +80,41 @@ template <typename T, std::size_t N>
       matrix& operator=(const M& x);
 
 
+    // Expression evaluation
+    //
+    // Initialize or assign this matrix with the elements computed by the
+    // matrix expression x. The elements are computed in a single pass. When
+    // assigning an expression with the same extents, the elements are
+    // computed in place, unless an operand of x is a view of this matrix
+    // that is shifted, transposed, or broadcast (see matrix_expr::aliases).
+    // The elements are then computed into a new matrix, which replaces this
+    // one.
+    //
+    // When x is a temporary expression that owns a temporary matrix of this
+    // type (e.g., the expression std::move(a) + b), the elements are
+    // computed into the storage of that matrix, which is then moved into
+    // this one. No memory is allocated in that case.
+    template <typename Op, typename E1, typename E2>
+      matrix(const matrix_expr<Op, E1, E2>& x);
+
+    template <typename Op, typename E1, typename E2>
+      matrix(matrix_expr<Op, E1, E2>&& x);
+
+    template <typename Op, typename E1, typename E2>
+      matrix& operator=(const matrix_expr<Op, E1, E2>& x);
+
+    template <typename Op, typename E1, typename E2>
+      matrix& operator=(matrix_expr<Op, E1, E2>&& x);
+
+
     // Slice initialization
     //
     // Initialize the matrix so that it has the same extents as the given
     // slice. Note that the strides are not copied. The resulting matrix
-    // indexes it's elements in row-major order.
-    explicit matrix(const matrix_slice<N>& slice);
+    // indexes it's elements in row-major order. All elements are value
+    // initialized, or default initialized if the uninitialized tag is given.
+    explicit matrix(const matrix_slice<N>& slice, const A& alloc = A());
+    matrix(uninitialized_t, const matrix_slice<N>& slice, const A& alloc = A());
 
 
     // Extent initialization
@@ -93,6 +133,14 @@ template <typename T, std::size_t N>
       explicit
       matrix(Dims... dims);
 
+    // Uninitialized extent initialization
+    //
+    // Initialize the matrix with the given dimensions. All elements are
+    // default initialized. Elements of trivial type have indeterminate
+    // values and must be assigned before they are read.
+    template <typename... Dims>
+      matrix(uninitialized_t, Dims... dims);
+
 
     // Value initialization
     //
@@ -174,6 +222,20 @@ template <typename T, std::size_t N>
     T*       data()       { return elems.data(); }
     const T* data() const { return elems.data(); }
 
+    // Returns a copy of the allocator.
+    A get_allocator() const { return elems.get_allocator(); }
+
+
+    // Capacity
+    //
+    // Returns the number of elements for which storage is allocated.
+    std::size_t capacity() const { return elems.capacity(); }
+
+    // Allocate storage for at least n elements. This does not change the
+    // extents of the matrix. Reserving storage before adding rows with
+    // resize() avoids repeated reallocation.
+    void reserve(std::size_t n) { elems.reserve(n); }
+
 
     // Apply
     template <typename F>
@@ -182,6 +244,16 @@ template <typename T, std::size_t N>
     template <typename M, typename F>
       matrix& apply(const M& m, F f);
 
+    // Parallel apply
+    //
+    // Apply f to blocks of elements in parallel. The function f may be
+    // called concurrently from different threads.
+    template <typename F>
+      matrix& apply(const parallel_policy& p, F f);
+
+    template <typename M, typename F>
+      matrix& apply(const parallel_policy& p, const M& m, F f);
+
     // Scalar arithmetic
     matrix& operator=(const T& x);
     matrix& operator+=(const T& x);
@@ -217,54 +289,157 @@ template <typename T, std::size_t N>
     void swap_rows(std::size_t m, std::size_t n);
     void clear();
 
+    // Resize
+    //
+    // Change the extents of the matrix to those given by the sequence of
+    // arguments, or those of the given slice. Elements whose indexes are
+    // within both the old and new extents keep their values, and new elements
+    // are value initialized. When only the 0th extent changes, rows are added
+    // or removed at the end without moving the other elements (unless the
+    // capacity is exceeded).
+    template <typename... Dims>
+      void resize(Dims... dims);
+
+    void resize(const matrix_slice<N>& slice);
+
   private:
+    template <typename M, typename Op>
+      matrix& assign_elements(const M& m, Op op);
+
+    template <typename M, typename Op>
+      matrix& assign_elements(const M& m, Op op, std::true_type);
+
+    template <typename M, typename Op>
+      matrix& assign_elements(const M& m, Op op, std::false_type);
+
     void make_slice(matrix_slice<N>&, std::size_t);
     void make_slice(matrix_slice<N>&, std::size_t, std::size_t);
     void make_slice(matrix_slice<N>&, std::size_t, std::size_t, std::size_t);
 
   private:
-    matrix_slice<N> desc; // Describing slice
-    std::vector<T> elems; // Underlying elements
+    matrix_slice<N> desc;                  // Describing slice
+    matrix_impl::matrix_buffer<T, A> elems; // Underlying elements
   };
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
+  inline
+  matrix<T, N, A>::matrix(const A& alloc)
+    : desc(), elems(alloc)
+  { }
+
+
+template <typename T, std::size_t N, typename A>
   template <typename M, typename X>
   inline
-  matrix<T, N>::matrix(const M& x)
-    : desc(x.descriptor()), elems(x.begin(), x.end())
+  matrix<T, N, A>::matrix(const M& x)
+    : desc(0, x.descriptor().extents), elems(desc.size, x.begin(), A())
   {
     static_assert(Convertible<Value_type<M>, T>(), "");
   }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M, typename X>
-  inline matrix<T, N>&
-  matrix<T, N>::operator=(const M& x)
+  inline matrix<T, N, A>&
+  matrix<T, N, A>::operator=(const M& x)
   {
-    desc = x.descriptor();
-    elems.assign(x.begin(), x.end());
+    // Copy the elements before replacing them, in case x refers to this
+    // matrix.
+    matrix_slice<N> d(0, x.descriptor().extents);
+    matrix_impl::matrix_buffer<T, A> tmp(d.size, x.begin(), get_allocator());
+    desc = d;
+    elems.swap(tmp);
     return*this;
   }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
+  template <typename Op, typename E1, typename E2>
+  inline
+  matrix<T, N, A>::matrix(const matrix_expr<Op, E1, E2>& x)
+    : desc(x.descriptor()), elems(x.size(), uninitialized, A())
+  {
+    static_assert(matrix_expr<Op, E1, E2>::order == N, "");
+    matrix_impl::evaluate(x, elems.data());
+  }
+
+template <typename T, std::size_t N, typename A>
+  template <typename Op, typename E1, typename E2>
   inline
-  matrix<T, N>::matrix(const matrix_slice<N>& slice)
-    : desc(0, slice.extents), elems(desc.size)
+  matrix<T, N, A>::matrix(matrix_expr<Op, E1, E2>&& x)
+    : matrix()
+  {
+    *this = std::move(x);
+  }
+
+template <typename T, std::size_t N, typename A>
+  template <typename Op, typename E1, typename E2>
+  inline matrix<T, N, A>&
+  matrix<T, N, A>::operator=(const matrix_expr<Op, E1, E2>& x)
+  {
+    static_assert(matrix_expr<Op, E1, E2>::order == N, "");
+    if (same_extents(desc, x.descriptor()) && !x.aliases(data(), desc)) {
+      matrix_impl::evaluate(x, elems.data());
+    } else {
+      matrix tmp(uninitialized, x.descriptor(), get_allocator());
+      matrix_impl::evaluate(x, tmp.data());
+      swap(tmp);
+    }
+    return *this;
+  }
+
+// If x owns a temporary matrix, the elements are computed into its storage,
+// which replaces that of this matrix. This is also the case when this matrix
+// was moved into x, as in m = std::move(m) + 1. The storage is not reused if
+// another operand is a view of it.
+template <typename T, std::size_t N, typename A>
+  template <typename Op, typename E1, typename E2>
+  inline matrix<T, N, A>&
+  matrix<T, N, A>::operator=(matrix_expr<Op, E1, E2>&& x)
+  {
+    static_assert(matrix_expr<Op, E1, E2>::order == N, "");
+    matrix* t = x.template temporary<matrix>();
+    if (t && !x.aliases(t->data(), t->descriptor())) {
+      matrix_impl::evaluate(x, t->data());
+      return *this = std::move(*t);
+    }
+    const matrix_expr<Op, E1, E2>& e = x;
+    return *this = e;
+  }
+
+
+template <typename T, std::size_t N, typename A>
+  inline
+  matrix<T, N, A>::matrix(const matrix_slice<N>& slice, const A& alloc)
+    : desc(0, slice.extents), elems(desc.size, alloc)
+  { }
+
+template <typename T, std::size_t N, typename A>
+  inline
+  matrix<T, N, A>::matrix(uninitialized_t, 
+                          const matrix_slice<N>& slice, 
+                          const A& alloc)
+    : desc(0, slice.extents), elems(desc.size, uninitialized, alloc)
   { }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Dims>
     inline
-    matrix<T, N>::matrix(Dims... dims)
-      : desc(0, {std::size_t(dims)...}), elems(desc.size)
+    matrix<T, N, A>::matrix(Dims... dims)
+      : desc(0, {std::size_t(dims)...}), elems(desc.size, A())
     { }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
+  template <typename... Dims>
+    inline
+    matrix<T, N, A>::matrix(uninitialized_t, Dims... dims)
+      : desc(0, {std::size_t(dims)...}), elems(desc.size, uninitialized, A())
+    { }
+
+template <typename T, std::size_t N, typename A>
   inline
-  matrix<T, N>::matrix(matrix_initializer<T, N> init)
+  matrix<T, N, A>::matrix(matrix_initializer<T, N> init)
     : desc(0, matrix_impl::derive_extents<N>(init))
   {
     // matrix_impl::derive_extents(desc.extents, init);
@@ -273,9 +448,9 @@ template <typename T, std::size_t N>
     assert(elems.size() == desc.size);
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>&
-  matrix<T, N>::operator=(matrix_initializer<T, N> init)
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>&
+  matrix<T, N, A>::operator=(matrix_initializer<T, N> init)
   {
     matrix tmp(init);
     swap(tmp);
@@ -285,37 +460,37 @@ template <typename T, std::size_t N>
 
 // Subscripting
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Index_sequence<Args...>(), T&>
-    matrix<T, N>::operator()(Args... args)
+    matrix<T, N, A>::operator()(Args... args)
     {
       assert(matrix_impl::check_bounds(desc, args...));
       return *(data() + desc(args...));
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Index_sequence<Args...>(), const T&>
-    matrix<T, N>::operator()(Args... args) const
+    matrix<T, N, A>::operator()(Args... args) const
     {
       assert(matrix_impl::check_bounds(desc, args...));
       return *(data() + desc(args...));
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<T, N>>
-    matrix<T, N>::operator()(const Args&... args)
+    matrix<T, N, A>::operator()(const Args&... args)
     {
       matrix_slice<N> d {desc, args...};
       return {d, data()};
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename... Args>
     inline Requires<matrix_impl::Slice_sequence<Args...>(), matrix_ref<const T, N>>
-    matrix<T, N>::operator()(const Args&... args) const
+    matrix<T, N, A>::operator()(const Args&... args) const
     {
       matrix_slice<N> d {desc, args...};
       return {d, data()};
@@ -323,18 +498,18 @@ template <typename T, std::size_t N>
 
 // Row
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<T, N-1>
-  matrix<T, N>::row(std::size_t n)
+  matrix<T, N, A>::row(std::size_t n)
   {
     assert(n < rows());
     matrix_slice<N-1> row(desc, size_constant<0>(), n);
     return {row, data()};
   }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<const T, N-1>
-  matrix<T, N>::row(std::size_t n) const
+  matrix<T, N, A>::row(std::size_t n) const
   {
     assert(n < rows());
     matrix_slice<N-1> row(desc, size_constant<0>(), n);
@@ -343,18 +518,18 @@ template <typename T, std::size_t N>
 
 // Column
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<T, N-1>
-  matrix<T, N>::col(std::size_t n)
+  matrix<T, N, A>::col(std::size_t n)
   {
     assert(n < cols());
     matrix_slice<N-1> col(desc, size_constant<1>(), n);
     return {col, data()};
   }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline matrix_ref<const T, N-1>
-  matrix<T, N>::col(std::size_t n) const
+  matrix<T, N, A>::col(std::size_t n) const
   {
     assert(n < cols());
     matrix_slice<N-1> col(desc, size_constant<1>(), n);
@@ -363,20 +538,20 @@ template <typename T, std::size_t N>
 
 
 // Scalar applicateion
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename F>
-    inline matrix<T, N>&
-    matrix<T, N>::apply(F f)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::apply(F f)
     {
       for (auto& x : elems)
         f(x);
       return *this;
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M, typename F>
-    inline matrix<T, N>&
-    matrix<T, N>::apply(const M& m, F f)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::apply(const M& m, F f)
     {
       assert(same_extents(desc, m.descriptor()));
       auto i = begin();
@@ -390,95 +565,182 @@ template <typename T, std::size_t N>
     }
 
 // Scalar assignment
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator=(const T& x) 
   { 
-    return apply([&](T& x) { x = x; });
+    return apply([&](T& y) { y = x; });
   }
 
 // Scalar addition
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator+=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator+=(const T& x) 
   { 
-    return apply([&](T& y) { y += x; });
+    matrix_impl::assign_scalar(data(), size(), x, matrix_impl::add_assign());
+    return *this;
   }
 
 // Scalar subtraction      
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator-=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator-=(const T& x) 
   {
-    return apply([&](T& y) { y -= x; });
+    matrix_impl::assign_scalar(data(), size(), x, matrix_impl::sub_assign());
+    return *this;
   }
 
 // Scalar multiplication
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator*=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator*=(const T& x) 
   { 
-    return apply([&](T& y) { y *= x; });
+    matrix_impl::assign_scalar(data(), size(), x, matrix_impl::mul_assign());
+    return *this;
   }
 
 // Scalar division
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator/=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator/=(const T& x) 
   { 
-    return apply([&](T& y) { y /= x; });
+    matrix_impl::assign_scalar(data(), size(), x, matrix_impl::div_assign());
+    return *this;
   }
 
 // Scalar remainder    
-template <typename T, std::size_t N>
-  inline matrix<T, N>& 
-  matrix<T, N>::operator%=(const T& x) 
+template <typename T, std::size_t N, typename A>
+  inline matrix<T, N, A>& 
+  matrix<T, N, A>::operator%=(const T& x) 
   { 
     return apply([&](T& y) { y %= x; });
   }
 
 // NOTE: Matrix addition and subtraction require the arguments to have the
 // same order, dimensions, and size. It must be the case that if two matrices
-// have the same dimensions, then they have the same size.
+// have the same dimensions, then they have the same size. The exception is
+// that strided matrices are broadcast to the extents of this matrix (see
+// broadcast_slice). An operand that is a view of this matrix through a
+// different slice, such as a row broadcast to every row in a += a.row(0), is
+// copied before the elements are assigned.
 
 // Matrix addition
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M>
-    inline matrix<T, N>&
-    matrix<T, N>::operator+=(const M& m)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::operator+=(const M& m)
     {
-      using U = Value_type<M>;
-      return apply(m, [&](T& t, const U& u) { t += u; });
+      return assign_elements(m, matrix_impl::add_assign());
     }
 
 // Matrix subtraction
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   template <typename M>
-    inline matrix<T, N>&
-    matrix<T, N>::operator-=(const M& m)
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::operator-=(const M& m)
+    {
+      return assign_elements(m, matrix_impl::sub_assign());
+    }
+
+// Apply the compound assignment operation to each element of this matrix and
+// the corresponding element of m. When m is stored contiguously and has the
+// same value type, the elements are processed as flat arrays.
+template <typename T, std::size_t N, typename A>
+  template <typename M, typename Op>
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::assign_elements(const M& m, Op op)
     {
-      using U = Value_type<M>;
-      return apply(m, [&](T& t, const U& u) { t -= u; });
+      if (matrix_impl::operand_aliases(m, data(), desc)) {
+        matrix<Value_type<M>, M::order> tmp = m;
+        return assign_elements(tmp, op);
+      }
+      using Flat = std::integral_constant<
+        bool, matrix_impl::Strided_matrix<M>() && Same<Value_type<M>, T>()
+      >;
+      return assign_elements(m, op, Flat());
+    }
+
+template <typename T, std::size_t N, typename A>
+  template <typename M, typename Op>
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::assign_elements(const M& m, Op op, std::true_type)
+    {
+      const auto& d = m.descriptor();
+      if (!same_extents(desc, d)) {
+        auto b = matrix_impl::broadcast_slice(d, desc.extents);
+        matrix_impl::assign_broadcast(data(), m.data(), b, op);
+      } else if (matrix_impl::is_contiguous(d))
+        matrix_impl::assign_elements(data(), m.data() + d.start, size(), op);
+      else
+        apply(m, op);
+      return *this;
     }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
+  template <typename M, typename Op>
+    inline matrix<T, N, A>&
+    matrix<T, N, A>::assign_elements(const M& m, Op op, std::false_type)
+    {
+      return apply(m, op);
+    }
+
+template <typename T, std::size_t N, typename A>
   inline void
-  matrix<T, N>::swap(matrix& x)
+  matrix<T, N, A>::swap(matrix& x)
   {
     using std::swap;
     swap(desc, x.desc);
     elems.swap(x.elems);
   }
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename A>
   inline void
-  matrix<T, N>::swap_rows(std::size_t m, std::size_t n)
+  matrix<T, N, A>::swap_rows(std::size_t m, std::size_t n)
   {
     auto a = (*this)[m];
     auto b = (*this)[n];
     std::swap_ranges(a.begin(), a.end(), b.begin());
   }
 
+template <typename T, std::size_t N, typename A>
+  inline void
+  matrix<T, N, A>::clear()
+  {
+    desc = matrix_slice<N>();
+    elems.clear();
+  }
+
+template <typename T, std::size_t N, typename A>
+  template <typename... Dims>
+    inline void
+    matrix<T, N, A>::resize(Dims... dims)
+    {
+      resize(matrix_slice<N>(0, {std::size_t(dims)...}));
+    }
+
+template <typename T, std::size_t N, typename A>
+  void
+  matrix<T, N, A>::resize(const matrix_slice<N>& slice)
+  {
+    matrix_slice<N> d(0, slice.extents);
+    if (std::equal(d.extents + 1, d.extents + N, desc.extents + 1)) {
+      // Rows are added or removed at the end.
+      elems.resize(d.size);
+      desc = d;
+      return;
+    }
+
+    // Copy the elements in the intersection of the old and new extents.
+    matrix tmp(d, get_allocator());
+    std::size_t ext[N];
+    for (std::size_t i = 0; i < N; ++i)
+      ext[i] = std::min(desc.extents[i], d.extents[i]);
+    matrix_impl::move_intersection(N, ext, 
+                                   data(), desc.strides, 
+                                   tmp.data(), d.strides);
+    swap(tmp);
+  }
+
 
 // ------------------------------------------------------------------------ //
 //                          Zero-Dimension Matrix
@@ -486,8 +748,8 @@ template <typename T, std::size_t N>
 // The type matrix<T, 0> is not really a matrix. It stores a single scalar
 // of type T and can only be converted to a reference to that type.
 
-template <typename T>
-  class matrix<T, 0>
+template <typename T, typename A>
+  class matrix<T, 0, A>
   {
   public:
     matrix() = default;
@@ -58,11 +58,17 @@ template <typename T, std::size_t N>
     // is a recipe for leaking memory.
     //
     // Assigning from a sub-matrix copies the values from x.
-    matrix_ref(matrix<value_type, N>& x);
-    matrix_ref(const matrix<value_type, N>& x);
-    matrix_ref(matrix<value_type, N>&&) = delete;
+    template <typename A>
+      matrix_ref(matrix<value_type, N, A>& x);
 
-    matrix_ref& operator=(const matrix<value_type, N>& x);
+    template <typename A>
+      matrix_ref(const matrix<value_type, N, A>& x);
+
+    template <typename A>
+      matrix_ref(matrix<value_type, N, A>&&) = delete;
+
+    template <typename A>
+      matrix_ref& operator=(const matrix<value_type, N, A>& x);
 
 
     // Submatrix conversion
@@ -76,6 +82,17 @@ template <typename T, std::size_t N>
       matrix_ref& operator=(const matrix_ref<U, N>& x);
 
 
+    // Expression evaluation
+    //
+    // Assign the elements computed by the matrix expression x to the
+    // elements of this matrix_ref. The extents of x must be the same as
+    // those of this matrix_ref. If an operand of x overlaps this matrix_ref
+    // through a different slice (see matrix_expr::aliases), the elements
+    // are computed into a temporary matrix before they are assigned.
+    template <typename Op, typename E1, typename E2>
+      matrix_ref& operator=(const matrix_expr<Op, E1, E2>& x);
+
+
     // Destruction
     ~matrix_ref() = default;
 
@@ -224,33 +241,36 @@ template <typename T, std::size_t N>
 
 
 template <typename T, std::size_t N>
-  inline
-  matrix_ref<T, N>::matrix_ref(matrix<value_type, N>& x)
-    : desc(x.descriptor()), ptr(x.data())
-  { }
+  template <typename A>
+    inline
+    matrix_ref<T, N>::matrix_ref(matrix<value_type, N, A>& x)
+      : desc(x.descriptor()), ptr(x.data())
+    { }
 
 template <typename T, std::size_t N>
-  inline
-  matrix_ref<T, N>::matrix_ref(const matrix<value_type, N>& x)
-    : desc(x.descriptor()), ptr(x.data())
-  { }
+  template <typename A>
+    inline
+    matrix_ref<T, N>::matrix_ref(const matrix<value_type, N, A>& x)
+      : desc(x.descriptor()), ptr(x.data())
+    { }
 
 template <typename T, std::size_t N>
-  inline matrix_ref<T, N>&
-  matrix_ref<T, N>::operator=(const matrix<value_type, N>& x)
-  {
+  template <typename A>
+    inline matrix_ref<T, N>&
+    matrix_ref<T, N>::operator=(const matrix<value_type, N, A>& x)
+    {
       // FIXME: Is this right? Should we just assign values or resize the
       // vector based o what x is?
-    assert(same_extents(desc, x.descriptor()));
-    apply(x, [](T& a, const T& b) { a = b; });
-    return *this;
-  }
+      assert(same_extents(desc, x.descriptor()));
+      apply(x, [](T& a, const T& b) { a = b; });
+      return *this;
+    }
 
 template <typename T, std::size_t N>
   template <typename U>
     inline
     matrix_ref<T, N>::matrix_ref(const matrix_ref<U, N>& x)
-      : desc(x.descriptor()), ptr(x.ptr)
+      : desc(x.descriptor()), ptr(x.data())
     { }
 
 template <typename T, std::size_t N>
@@ -266,6 +286,21 @@ template <typename T, std::size_t N>
     }
 
 
+template <typename T, std::size_t N>
+  template <typename Op, typename E1, typename E2>
+    inline matrix_ref<T, N>&
+    matrix_ref<T, N>::operator=(const matrix_expr<Op, E1, E2>& x)
+    {
+      static_assert(matrix_expr<Op, E1, E2>::order == N, "");
+      if (x.aliases(ptr, desc)) {
+        matrix<Remove_const<T>, N> tmp = x;
+        return *this = tmp;
+      }
+      matrix_impl::evaluate(x, *this);
+      return *this;
+    }
+
+
 template <typename T, std::size_t N>
   inline
   matrix_ref<T, N>::matrix_ref(const matrix_slice<N>& s, T* p)
@@ -312,7 +347,7 @@ template <typename T, std::size_t N>
   {
     assert(n < extent(0));
     matrix_slice<N-1> row(desc, size_constant<0>(), n);
-    return {ptr, row};
+    return {row, ptr};
   }
 
 template <typename T, std::size_t N>
@@ -331,7 +366,7 @@ template <typename T, std::size_t N>
   {
     assert(n < extent(1));
     matrix_slice<N-1> col(desc, size_constant<1>(), n);
-    return {ptr, col};
+    return {col, ptr};
   }
 
 template <typename T, std::size_t N>
@@ -340,7 +375,7 @@ template <typename T, std::size_t N>
   {
     assert(n < extent(1));
     matrix_slice<N-1> col(desc, size_constant<1>(), n);
-    return {ptr, col};
+    return {col, ptr};
   }
 
 
@@ -350,8 +385,14 @@ template <typename T, std::size_t N>
     inline matrix_ref<T, N>&
     matrix_ref<T, N>::apply(F f)
     {
-      for (auto i = begin(); i != end(); ++i)
-        f(*i);
+      if (desc.strides[N - 1] != 1) {
+        for (T& x : *this)
+          f(x);
+      } else {
+        for (auto c : row_chunks(*this))
+          for (T* p = c.first; p != c.last; ++p)
+            f(*p);
+      }
       return *this;
     }
 
@@ -372,6 +413,27 @@ template <typename T, std::size_t N>
     }
 
 
+namespace matrix_impl
+{
+  // Apply the compound assignment op with the scalar x to each element of
+  // m. Rows of unit stride are passed to the vectorized kernels. When the
+  // innermost stride is not 1, every chunk would be a single element, so
+  // the elements are visited by a scalar loop instead.
+  template <typename T, std::size_t N, typename Op>
+    inline void
+    assign_scalar(matrix_ref<T, N>& m, const T& x, Op op)
+    {
+      if (m.descriptor().strides[N - 1] != 1) {
+        for (T& y : m)
+          op(y, x);
+      } else {
+        for (auto c : row_chunks(m))
+          assign_scalar(c.first, c.size(), x, op);
+      }
+    }
+} // namespace matrix_impl
+
+
 // Scalar assignment
 template <typename T, std::size_t N>
   inline matrix_ref<T, N>& 
@@ -385,7 +447,8 @@ template <typename T, std::size_t N>
   inline matrix_ref<T, N>& 
   matrix_ref<T, N>::operator+=(const value_type& value) 
   { 
-    return apply([&](T& x) { x += value; });
+    matrix_impl::assign_scalar(*this, value, matrix_impl::add_assign());
+    return *this;
   }
 
 // Scalar subtraction
@@ -393,7 +456,8 @@ template <typename T, std::size_t N>
   inline matrix_ref<T, N>& 
   matrix_ref<T, N>::operator-=(value_type const& value) 
   { 
-    return apply([&](T& x) { x -= value; });
+    matrix_impl::assign_scalar(*this, value, matrix_impl::sub_assign());
+    return *this;
   }
 
 // Scalar multiplication
@@ -401,7 +465,8 @@ template <typename T, std::size_t N>
   inline matrix_ref<T, N>& 
   matrix_ref<T, N>::operator*=(value_type const& value) 
   { 
-    return apply([&](T& x) { x *= value; });
+    matrix_impl::assign_scalar(*this, value, matrix_impl::mul_assign());
+    return *this;
   }
 
 // Scalar division
@@ -409,7 +474,8 @@ template <typename T, std::size_t N>
   inline matrix_ref<T, N>& 
   matrix_ref<T, N>::operator/=(value_type const& value) 
   { 
-    return apply([&](T& x) { x /= value; });
+    matrix_impl::assign_scalar(*this, value, matrix_impl::div_assign());
+    return *this;
   }
 
 // Scalar modulus
@@ -422,13 +488,20 @@ template <typename T, std::size_t N>
   }
 
 // Matrix addition
+//
+// If m is a strided matrix with different extents, it is broadcast to the
+// extents of this matrix_ref. If m is a view of the elements of this
+// matrix_ref through a different slice, it is copied first.
 template <typename T, std::size_t N>
   template <typename M>
     inline matrix_ref<T, N>&
     matrix_ref<T, N>::operator+=(const M& m)
     {
+      if (matrix_impl::operand_aliases(m, ptr, desc))
+        return *this += matrix<Value_type<M>, M::order>(m);
       using U = Value_type<M>;
-      return apply(m, [&](T& t, const U& u) { t += u; });
+      return apply(matrix_impl::broadcast_operand(m, desc),
+                   [&](T& t, const U& u) { t += u; });
     }
 
 // Matrix subtraction
@@ -437,8 +510,11 @@ template <typename T, std::size_t N>
     inline matrix_ref<T, N>&
     matrix_ref<T, N>::operator-=(const M& m)
     {
+      if (matrix_impl::operand_aliases(m, ptr, desc))
+        return *this -= matrix<Value_type<M>, M::order>(m);
       using U = Value_type<M>;
-      return apply(m, [&](T& t, const U& u) { t -= u; });
+      return apply(matrix_impl::broadcast_operand(m, desc),
+                   [&](T& t, const U& u) { t -= u; });
     }
 
 
@@ -459,7 +535,7 @@ template <typename T, std::size_t N>
     {
       auto a = (*this)[m];
       auto b = (*this)[n];
-      std::swap_ranges(a.begin(). a.end(), b.begin());
+      std::swap_ranges(a.begin(), a.end(), b.begin());
     }
 
 
@@ -85,42 +85,25 @@ template <typename M1, typename M2>
 // Matrix addition
 //
 // Adding two matrices with the same shape adds corresponding elements in
-// each operatand.
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix<T, N>& a, const matrix<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result += b;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix_ref<T, N>& a, const matrix_ref<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result += b;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix<T, N>& a, const matrix_ref<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result += b;
-  }
+// each operatand. The operands may be any combination of matrices, matrix
+// refs, and matrix expressions having the same order and value type. The
+// result is a matrix expression (see expression.hpp).
+//
+// Matrices and matrix_refs with different extents are broadcast against
+// each other, as in NumPy: their extents are aligned at the end, and each
+// pair of extents must be equal or include a 1. Missing leading dimensions
+// and dimensions of extent 1 are repeated (using a stride of 0) instead of
+// being copied. For example, if m is an m x n matrix, v is a vector of n
+// elements, and c is an m x 1 matrix:
+//
+//    m + v   -- Adds v to each row of m
+//    m - c   -- Subtracts c from each column of m
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix_ref<T, N>& a, const matrix<T, N>& b)
+template <typename M1, typename M2>
+  inline typename matrix_impl::binary_expr<std::plus, M1, M2>::type
+  operator+(M1&& a, M2&& b)
   {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result += b;
+    return {std::forward<M1>(a), std::forward<M2>(b)};
   }
 
 
@@ -128,42 +111,13 @@ template <typename T, std::size_t N>
 // Matrix subtraction
 //
 // Subtracting one matrix from another with the same shape subtracts
-// corresponding elements in each operatand.
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix<T, N>& a, const matrix<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return a -= b;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix_ref<T, N>& a, const matrix_ref<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result -= b;
-  }
-
-// Cross-type subtraction
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix<T, N>& a, const matrix_ref<T, N>& b)
-  {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result -= b;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix_ref<T, N>& a, const matrix<T, N>& b)
+// corresponding elements in each operatand. As with addition, matrices with
+// different extents are broadcast.
+template <typename M1, typename M2>
+  inline typename matrix_impl::binary_expr<std::minus, M1, M2>::type
+  operator-(M1&& a, M2&& b)
   {
-    assert(same_extents(a, b));
-    matrix<T, N> result = a;
-    return result -= b;
+    return {std::forward<M1>(a), std::forward<M2>(b)};
   }
 
 
@@ -176,36 +130,18 @@ template <typename T, std::size_t N>
 //
 //    a + n
 //    n + a
-template <typename T, std::size_t N>
-  inline matrix<T, N> 
-  operator+(const matrix<T, N>& x, const T& n)
-  {
-    matrix<T, N> result = x;
-    return result += n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N> 
-  operator+(const T& n, const matrix<T, N>& x)
-  {
-    matrix<T, N> result = x;
-    return result += n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const matrix_ref<T, N>& x, const T& n)
+template <typename M>
+  inline typename matrix_impl::scalar_expr<std::plus, M>::type
+  operator+(M&& x, const typename matrix_impl::scalar_expr<std::plus, M>::value_type& n)
   {
-    matrix<T, N> result = x;
-    return result += n;
+    return {std::forward<M>(x), n};
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator+(const T& n, const matrix_ref<T, N>& x)
+template <typename M>
+  inline typename matrix_impl::scalar_left_expr<std::plus, M>::type
+  operator+(const typename matrix_impl::scalar_left_expr<std::plus, M>::value_type& n, M&& x)
   {
-    matrix<T, N> result = x;
-    return result += n;
+    return {n, std::forward<M>(x)};
   }
 
 
@@ -218,20 +154,11 @@ template <typename T, std::size_t N>
 //    a - n <=> a + -n;
 //
 // It is not possible to subtract a matrix from a scalar.
-template <typename T, std::size_t N>
-  inline matrix<T, N> 
-  operator-(const matrix<T, N>& x, const T& n)
-  {
-    matrix<T, N> result = x;
-    return result += n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator-(const matrix_ref<T, N>& x, const T& n)
+template <typename M>
+  inline typename matrix_impl::scalar_expr<std::minus, M>::type
+  operator-(M&& x, const typename matrix_impl::scalar_expr<std::minus, M>::value_type& n)
   {
-    matrix<T, N> result = x;
-    return result -= n;
+    return {std::forward<M>(x), n};
   }
 
 
@@ -245,36 +172,18 @@ template <typename T, std::size_t N>
 //    a * n
 //    n * a
 //
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator*(const matrix<T, N>& x, const T& n)
-  {
-    matrix<T, N> result = x;
-    return result *= n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator*(const T& n, const matrix<T, N>& x)
-  {
-    matrix<T, N> result = x;
-    return result *= n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator*(const matrix_ref<T, N>& x, const T& n)
+template <typename M>
+  inline typename matrix_impl::scalar_expr<std::multiplies, M>::type
+  operator*(M&& x, const typename matrix_impl::scalar_expr<std::multiplies, M>::value_type& n)
   {
-    matrix<T, N> result = x;
-    return result *= n;
+    return {std::forward<M>(x), n};
   }
 
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator*(const T& n, const matrix_ref<T, N>& x)
+template <typename M>
+  inline typename matrix_impl::scalar_left_expr<std::multiplies, M>::type
+  operator*(const typename matrix_impl::scalar_left_expr<std::multiplies, M>::value_type& n, M&& x)
   {
-    matrix<T, N> result = x;
-    return result *= n;
+    return {n, std::forward<M>(x)};
   }
 
 
@@ -287,20 +196,11 @@ template <typename T, std::size_t N>
 //    a / n <=> a * 1/n
 //
 // It is not possible to divide a scalar by a matrix.
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator/(const matrix<T, N>& a, const T& n)
-  {
-    matrix<T, N> result = a;
-    return result /= n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator/(const matrix_ref<T, N>& x, const T& n)
+template <typename M>
+  inline typename matrix_impl::scalar_expr<std::divides, M>::type
+  operator/(M&& x, const typename matrix_impl::scalar_expr<std::divides, M>::value_type& n)
   {
-    matrix<T, N> result = x;
-    return result /= n;
+    return {std::forward<M>(x), n};
   }
 
 
@@ -312,20 +212,11 @@ template <typename T, std::size_t N>
 // given scalar value.
 //
 // This operation is only available when T is an Integer type.
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator%(const matrix<T, N>& a, const T& n)
-  {
-    matrix<T, N> result = a;
-    return result %= n;
-  }
-
-template <typename T, std::size_t N>
-  inline matrix<T, N>
-  operator%(const matrix_ref<T, N>& x, const T& n)
+template <typename M>
+  inline typename matrix_impl::scalar_expr<std::modulus, M>::type
+  operator%(M&& x, const typename matrix_impl::scalar_expr<std::modulus, M>::value_type& n)
   {
-    matrix<T, N> result = x;
-    return result %= n;
+    return {std::forward<M>(x), n};
   }
 
 
@@ -344,40 +235,46 @@ template <typename M1, typename M2, typename M3>
 // Two 2D matrices a (m x p) and b (p x n) can be multiplied, resulting in a
 // matrix c (m x n). Note that the "inner" dimension of the operands must
 // be the same.
-template <typename T>
-  inline matrix<T, 2>
-  operator*(const matrix<T, 2>& a, const matrix<T, 2>& b) 
-  {
-    matrix<T, 2> result (a.rows(), b.cols());
-    matrix_product(a, b, result);
-    return result;
-  }
-
-template <typename T>
-  inline matrix<T, 2>
-  operator*(const matrix_ref<T, 2>& a, const matrix_ref<T, 2>& b) 
-  {
-    matrix<T, 2> result (a.dims());
-    matrix_product(a, b, result);
-    return result;
-  }
-
-// Cross product multiplication.
-template <typename T>
-  inline matrix<T, 2>
-  operator*(const matrix<T, 2>& a, const matrix_ref<T, 2>& b) 
-  {
-    matrix<T, 2> result (a.dims());
-    matrix_product(a, b, result);
-    return result;
-  }
+//
+// The product is not an elementwise operation, so it is computed eagerly.
+// Matrix expression operands are evaluated before the product is computed.
+
+namespace matrix_impl
+{
+  // The product result trait computes the result of multiplying two matrix
+  // operands of order 2 having the same value type.
+  template <typename M1, typename M2,
+            bool = Matrix_operand<M1>() && Matrix_operand<M2>()>
+    struct product_result
+    { };
+
+  template <typename M1, typename M2>
+    struct product_result<M1, M2, true>
+      : std::enable_if<
+          M1::order == 2 && M2::order == 2
+            && Same<Value_type<M1>, Value_type<M2>>(),
+          matrix<Value_type<M1>, 2>
+        >
+    { };
+
+  // Returns the operand of a product. Expressions are evaluated.
+  template <typename M>
+    inline const M& 
+    product_operand(const M& m) { return m; }
+
+  template <typename Op, typename E1, typename E2>
+    inline matrix<Value_type<matrix_expr<Op, E1, E2>>, 2>
+    product_operand(const matrix_expr<Op, E1, E2>& e) { return e; }
+} // namespace matrix_impl
 
-template <typename T>
-  inline matrix<T, 2>
-  operator*(const matrix_ref<T, 2>& a, const matrix<T, 2>& b) 
+template <typename M1, typename M2>
+  inline typename matrix_impl::product_result<M1, M2>::type
+  operator*(const M1& a, const M2& b) 
   {
-    matrix<T, 2> result (a.dims());
-    matrix_product(a, b, result);
+    typename matrix_impl::product_result<M1, M2>::type result(a.rows(), b.cols());
+    matrix_product(matrix_impl::product_operand(a), 
+                   matrix_impl::product_operand(b), 
+                   result);
     return result;
   }
 
@@ -386,13 +283,65 @@ template <typename T>
 //////////////////////////////////////////////////////////////////////////////
 // Matrix Product
 //
-// The usual meaning of the operation.
+// The usual meaning of the operation. The product of a and b is accumulated
+// into out, so out is typically zero-initialized.
 //
-// FIXME: This is not terribly efficient. Implement a more efficient algorithm
-// than this brute force version.
+// When the operands are strided matrices of the same arithmetic value type,
+// the product is computed by gemm_kernel, which packs blocks of the operands
+// into the per-thread workspace. Operands and results with any strides
+// (e.g., column views, strided slices, or transposed views) are read and
+// written in place, so the product allocates nothing once the workspace has
+// grown. Otherwise, the product is computed by the brute force version.
 //
 // FIXME: I'm not at all sure that this generalizes to n dimensions. It might
 // be the case that we want all M's to be 2 dimensions (as they are now!).
+
+namespace matrix_impl
+{
+  // Returns true if the product of M1 and M2 can be stored in M3 using
+  // the blocked kernel.
+  template <typename M1, typename M2, typename M3>
+    constexpr bool Blocked_product()
+    {
+      return Strided_matrix<M1>() 
+          && Strided_matrix<M2>() 
+          && Strided_matrix<M3>()
+          && Arithmetic<Value_type<M3>>()
+          && Same<Value_type<M1>, Value_type<M3>>()
+          && Same<Value_type<M2>, Value_type<M3>>();
+    }
+
+  // The brute force implementation.
+  template <typename M1, typename M2, typename M3>
+    void 
+    matrix_product(const M1& a, const M2& b, M3& out, std::false_type)
+    {
+      using Size = Size_type<M3>;
+
+      for (Size i = 0; i != rows(a); ++i) {
+        for (Size j = 0; j < cols(b); ++j) {
+          for (Size k = 0; k < rows(b); ++k)
+            out(i, j) += a(i, k) * b(k, j);
+        }
+      }
+    }
+
+  // The blocked implementation.
+  template <typename M1, typename M2, typename M3>
+    void 
+    matrix_product(const M1& a, const M2& b, M3& out, std::true_type)
+    {
+      using T = Value_type<M3>;
+      const auto& da = a.descriptor();
+      const auto& db = b.descriptor();
+      const auto& dc = out.descriptor();
+      gemm_kernel(rows(a), cols(b), cols(a), T(1),
+                  a.data() + da.start, da.strides[0], da.strides[1],
+                  b.data() + db.start, db.strides[0], db.strides[1],
+                  out.data() + dc.start, dc.strides[0], dc.strides[1]);
+    }
+} // namespace matrix_impl
+
 template <typename M1, typename M2, typename M3>
   void 
   matrix_product(const M1& a, const M2& b, M3& out)
@@ -404,14 +353,167 @@ template <typename M1, typename M2, typename M3>
     assert(rows(a) == rows(out));
     assert(cols(b) == cols(out));
 
-    using Size = Size_type<M3>;
+    using Fast = std::integral_constant<
+      bool, matrix_impl::Blocked_product<M1, M2, M3>()
+    >;
+    matrix_impl::matrix_product(a, b, out, Fast());
+  }
+
 
-    for (Size i = 0; i != rows(a); ++i) {
-      for (Size j = 0; j < cols(b); ++j) {
-        for (Size k = 0; k < rows(b); ++k)
-          out(i, j) += a(i, k) * b(k, j);
+
+// -------------------------------------------------------------------------- //
+// Strassen Product
+//
+// The Strassen product computes the same result as matrix_product, out += a
+// * b, using Strassen's recursive algorithm. Each level of the recursion
+// splits the operands into quadrants and computes the product from 7 (rather
+// than 8) products of quadrants, requiring O(n^2.81) operations.
+//
+// The quadrants are matrix_refs made by slicing the operands. When a
+// dimension is odd, the last row or column is peeled off and handled by
+// matrix_product. The recursion stops when any dimension is at most cutoff,
+// where the product is computed by the blocked kernel. The cutoff should be
+// tuned so that the kernel is faster than another level of recursion; below
+// a few hundred, the extra additions usually cost more than they save.
+//
+// Strassen's algorithm is less accurate than the classical product. The
+// error grows by a constant factor with each level of recursion.
+
+constexpr std::size_t strassen_cutoff = 256;
+
+namespace matrix_impl
+{
+  template <typename T>
+    void
+    strassen_product(const matrix_ref<const T, 2>& a,
+                     const matrix_ref<const T, 2>& b,
+                     matrix_ref<T, 2>& c,
+                     std::size_t cutoff)
+    {
+      const std::size_t m = rows(a);
+      const std::size_t k = cols(a);
+      const std::size_t n = cols(b);
+      if (m <= cutoff || k <= cutoff || n <= cutoff) {
+        matrix_product(a, b, c);
+        return;
       }
+
+      // Peel off the last row and column of odd dimensions.
+      const std::size_t m2 = m / 2;
+      const std::size_t k2 = k / 2;
+      const std::size_t n2 = n / 2;
+      const std::size_t me = 2 * m2;
+      const std::size_t ke = 2 * k2;
+      const std::size_t ne = 2 * n2;
+      if (k != ke) {
+        auto ac = a(slice(0, me), slice(ke, 1));
+        auto br = b(slice(ke, 1), slice(0, ne));
+        auto cc = c(slice(0, me), slice(0, ne));
+        matrix_product(ac, br, cc);
+      }
+      if (n != ne) {
+        auto bc = b(slice::all, slice(ne, 1));
+        auto cc = c(slice::all, slice(ne, 1));
+        matrix_product(a, bc, cc);
+      }
+      if (m != me) {
+        auto ar = a(slice(me, 1), slice::all);
+        auto br = b(slice::all, slice(0, ne));
+        auto cr = c(slice(me, 1), slice(0, ne));
+        matrix_product(ar, br, cr);
+      }
+
+      auto a11 = a(slice(0, m2), slice(0, k2));
+      auto a12 = a(slice(0, m2), slice(k2, k2));
+      auto a21 = a(slice(m2, m2), slice(0, k2));
+      auto a22 = a(slice(m2, m2), slice(k2, k2));
+      auto b11 = b(slice(0, k2), slice(0, n2));
+      auto b12 = b(slice(0, k2), slice(n2, n2));
+      auto b21 = b(slice(k2, k2), slice(0, n2));
+      auto b22 = b(slice(k2, k2), slice(n2, n2));
+      auto c11 = c(slice(0, m2), slice(0, n2));
+      auto c12 = c(slice(0, m2), slice(n2, n2));
+      auto c21 = c(slice(m2, m2), slice(0, n2));
+      auto c22 = c(slice(m2, m2), slice(n2, n2));
+
+      // The operands and result of each of the 7 products. These are reused
+      // for each product.
+      matrix<T, 2> s(uninitialized, m2, k2);
+      matrix<T, 2> t(uninitialized, k2, n2);
+      matrix<T, 2> p(uninitialized, m2, n2);
+      matrix_ref<const T, 2> rs = s;
+      matrix_ref<const T, 2> rt = t;
+      matrix_ref<T, 2> rp = p;
+
+      // M1 = (A11 + A22)(B11 + B22)
+      s = a11 + a22;
+      t = b11 + b22;
+      p = T(0);
+      strassen_product(rs, rt, rp, cutoff);
+      c11 += p;
+      c22 += p;
+
+      // M2 = (A21 + A22)B11
+      s = a21 + a22;
+      p = T(0);
+      strassen_product(rs, b11, rp, cutoff);
+      c21 += p;
+      c22 -= p;
+
+      // M3 = A11(B12 - B22)
+      t = b12 - b22;
+      p = T(0);
+      strassen_product(a11, rt, rp, cutoff);
+      c12 += p;
+      c22 += p;
+
+      // M4 = A22(B21 - B11)
+      t = b21 - b11;
+      p = T(0);
+      strassen_product(a22, rt, rp, cutoff);
+      c11 += p;
+      c21 += p;
+
+      // M5 = (A11 + A12)B22
+      s = a11 + a12;
+      p = T(0);
+      strassen_product(rs, b22, rp, cutoff);
+      c11 -= p;
+      c12 += p;
+
+      // M6 = (A21 - A11)(B11 + B12)
+      s = a21 - a11;
+      t = b11 + b12;
+      p = T(0);
+      strassen_product(rs, rt, rp, cutoff);
+      c22 += p;
+
+      // M7 = (A12 - A22)(B21 + B22)
+      s = a12 - a22;
+      t = b21 + b22;
+      p = T(0);
+      strassen_product(rs, rt, rp, cutoff);
+      c11 += p;
     }
+} // namespace matrix_impl
+
+template <typename M1, typename M2, typename M3>
+  void
+  strassen_product(const M1& a, const M2& b, M3& out,
+                   std::size_t cutoff = strassen_cutoff)
+  {
+    static_assert(matrix_impl::Blocked_product<M1, M2, M3>(), "");
+    static_assert(M1::order == 2, "");
+    assert(cols(a) == rows(b));
+    assert(rows(a) == rows(out));
+    assert(cols(b) == cols(out));
+    assert(cutoff > 0);
+
+    using T = Value_type<M3>;
+    matrix_ref<const T, 2> ra = a;
+    matrix_ref<const T, 2> rb = b;
+    matrix_ref<T, 2> rc = out;
+    matrix_impl::strassen_product(ra, rb, rc, cutoff);
   }
 
 
@@ -420,16 +522,329 @@ template <typename M1, typename M2, typename M3>
 //
 // The hadamard product can be easly generalized to N-dimensional matrices 
 // since the operation is performed elementwise. The operands only need the
-// same shape.
+// same shape. Strided operands with different extents are broadcast to the
+// extents of out (see broadcast). For example, if c is an m x 1 matrix,
+// hadamard_product(m, c, out) multiplies each column of m by c.
+//
+// When the operands are contiguous strided matrices of the same value type,
+// and that type is supported by the vectorized kernels, the product is
+// computed over the underlying arrays.
+
+namespace matrix_impl
+{
+  // Returns true if the hadamard product of M1 and M2 can be stored in M3
+  // using the vectorized kernels.
+  template <typename M1, typename M2, typename M3>
+    constexpr bool Vectorized_product()
+    {
+      return Strided_matrix<M1>() 
+          && Strided_matrix<M2>() 
+          && Strided_matrix<M3>()
+          && Simd_value<Value_type<M3>>()
+          && Same<Value_type<M1>, Value_type<M3>>()
+          && Same<Value_type<M2>, Value_type<M3>>();
+    }
+
+  // Compute out = op(a, b) elementwise, where k names the operation op. The
+  // contiguous operands of vectorized operations are computed by the
+  // elementwise kernels.
+  template <typename M1, typename M2, typename M3, typename Op>
+    void
+    elementwise(elementwise_op, Op op,
+                const M1& a, const M2& b, M3& out, std::false_type)
+    {
+      std::transform(a.begin(), a.end(), b.begin(), out.begin(), op);
+    }
+
+  template <typename M1, typename M2, typename M3, typename Op>
+    void
+    elementwise(elementwise_op k, Op op,
+                const M1& a, const M2& b, M3& out, std::true_type)
+    {
+      const auto& da = a.descriptor();
+      const auto& db = b.descriptor();
+      const auto& dc = out.descriptor();
+      if (is_contiguous(da) && is_contiguous(db) && is_contiguous(dc)) {
+        simd_elementwise(k,
+                         a.data() + da.start, 
+                         b.data() + db.start, 
+                         out.data() + dc.start, 
+                         out.size());
+      } else {
+        elementwise(k, op, a, b, out, std::false_type());
+      }
+    }
+
+  // Compute out = op(a, x) elementwise for the scalar x.
+  template <typename M1, typename M2, typename T, typename Op>
+    void
+    elementwise_scalar(elementwise_op, Op op,
+                       const M1& a, const T& x, M2& out, std::false_type)
+    {
+      std::transform(a.begin(), a.end(), out.begin(), [&](const T& y) {
+        return op(y, x);
+      });
+    }
+
+  template <typename M1, typename M2, typename T, typename Op>
+    void
+    elementwise_scalar(elementwise_op k, Op op,
+                       const M1& a, const T& x, M2& out, std::true_type)
+    {
+      const auto& da = a.descriptor();
+      const auto& dc = out.descriptor();
+      if (is_contiguous(da) && is_contiguous(dc))
+        simd_elementwise(k, a.data() + da.start, x, out.data() + dc.start, out.size());
+      else
+        elementwise_scalar(k, op, a, x, out, std::false_type());
+    }
+
+  template <typename M1, typename M2, typename M3>
+    using Vectorized_kind = std::integral_constant<
+      bool, Vectorized_product<M1, M2, M3>()
+    >;
+
+  // Compute out = op(a, b) elementwise. Strided operands whose extents
+  // differ from those of out are broadcast to them. An operand that aliases
+  // out through a different slice (see operand_aliases) is copied first.
+  template <typename M1, typename M2, typename M3, typename Op>
+    void
+    elementwise(elementwise_op k, Op op, const M1& a, const M2& b, M3& out)
+    {
+      if (operand_aliases(a, out.data(), out.descriptor())) {
+        matrix<Value_type<M1>, M1::order> tmp = a;
+        elementwise(k, op, tmp, b, out);
+      } else if (operand_aliases(b, out.data(), out.descriptor())) {
+        matrix<Value_type<M2>, M2::order> tmp = b;
+        elementwise(k, op, a, tmp, out);
+      } else if (same_extents(a, out) && same_extents(b, out)) {
+        elementwise(k, op, a, b, out, Vectorized_kind<M1, M2, M3>());
+      } else {
+        const auto& d = out.descriptor();
+        elementwise(k, op, broadcast_operand(a, d), broadcast_operand(b, d),
+                    out, std::false_type());
+      }
+    }
+
+  // Compute out = op(a, x) elementwise, broadcasting a if needed. As above,
+  // an operand that aliases out is copied first.
+  template <typename M1, typename M2, typename T, typename Op>
+    void
+    elementwise_scalar(elementwise_op k, Op op, const M1& a, const T& x, M2& out)
+    {
+      if (operand_aliases(a, out.data(), out.descriptor())) {
+        matrix<Value_type<M1>, M1::order> tmp = a;
+        elementwise_scalar(k, op, tmp, x, out);
+      } else if (same_extents(a, out)) {
+        elementwise_scalar(k, op, a, x, out, Vectorized_kind<M1, M1, M2>());
+      } else {
+        elementwise_scalar(k, op, broadcast_operand(a, out.descriptor()), x,
+                           out, std::false_type());
+      }
+    }
+} // namespace matrix_impl
+
 template <typename M1, typename M2, typename M3>
   void
   hadamard_product(const M1& a, const M2& b, M3& out)
   {
-    assert(a.shape() == b.shape());
-    assert(a.shape() == out.shape());
+    using Mul = std::multiplies<Value_type<M3>>;
+    matrix_impl::elementwise(matrix_impl::elementwise_op::mul, Mul{}, a, b, out);
+  }
+
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Elementwise Operations
+//
+// The elementwise operations compute their results into an existing matrix
+// or matrix_ref, out. The operands must have the extents of out, or be
+// strided matrices that can be broadcast to them:
+//
+//    add(a, b, out)    -- out = a + b
+//    sub(a, b, out)    -- out = a - b
+//    scale(a, x, out)  -- out = a * x
+//
+// Nothing is allocated, so these can be used to reuse buffers in loops
+// where the corresponding expressions would create a matrix each time. The
+// output may be one of the operands. An operand that overlaps the output
+// through a different slice (e.g., a row, a shifted block, or a transposed
+// view of out) is copied first, which allocates. As with the hadamard
+// product, contiguous operands are computed by the vectorized kernels.
+
+template <typename M1, typename M2, typename M3>
+  void
+  add(const M1& a, const M2& b, M3& out)
+  {
+    using Add = std::plus<Value_type<M3>>;
+    matrix_impl::elementwise(matrix_impl::elementwise_op::add, Add{}, a, b, out);
+  }
+
+template <typename M1, typename M2, typename M3>
+  void
+  sub(const M1& a, const M2& b, M3& out)
+  {
+    using Sub = std::minus<Value_type<M3>>;
+    matrix_impl::elementwise(matrix_impl::elementwise_op::sub, Sub{}, a, b, out);
+  }
+
+template <typename M1, typename M2>
+  void
+  scale(const M1& a, const Value_type<M2>& x, M2& out)
+  {
+    using Mul = std::multiplies<Value_type<M2>>;
+    matrix_impl::elementwise_scalar(matrix_impl::elementwise_op::mul, Mul{},
+                                    a, x, out);
+  }
+
+
+
+//////////////////////////////////////////////////////////////////////////////
+// Broadcast
+//
+// Returns a view of the strided matrix m with the extents of the matrix x.
+// The extents of m are aligned with the last extents of x, and each must be
+// equal to the corresponding extent of x or 1. Elements are repeated along
+// the other dimensions using a stride of 0, so nothing is copied. For
+// example, if m is a 3 x 4 matrix and v is a vector of 4 elements:
+//
+//    broadcast(v, m)   -- A 3 x 4 matrix_ref whose rows are each v
+template <typename M1, typename M2>
+  inline matrix_ref<const Value_type<M1>, M2::order>
+  broadcast(const M1& m, const M2& x)
+  {
+    static_assert(matrix_impl::Strided_matrix<M1>(), "");
+    return matrix_impl::broadcast_operand(m, x.descriptor(), std::true_type());
+  }
+
 
-    using Mul = std::multiplies<Value_type<M1>>;
-    std::transform(a.begin(), a.end(), b.begin(), out.begin(), Mul{});
+
+//////////////////////////////////////////////////////////////////////////////
+// Transpose
+//
+// The transposed view of a 2D matrix refers to the elements of the matrix
+// with its rows and columns exchanged. No elements are copied: the view is
+// a matrix_ref whose extents and strides are those of the matrix, swapped.
+// For example, the rows of transposed(m) are the columns of m.
+//
+// The transpose functions copy the transposed elements:
+//
+//    transpose(a, out)     -- Store the transpose of a in out
+//    transpose(a)          -- Returns the transpose of a
+//    transpose_in_place(a) -- Transpose the square matrix a
+//
+// The copies are computed by a cache-oblivious algorithm (see
+// transpose_block), so large matrices are transposed without a cache miss
+// on each element. A transposed view of a matrix can be materialized with
+// transpose(transposed(m)) when an algorithm prefers contiguous rows.
+//
+// The output of transpose must not overlap a; use transpose_in_place to
+// transpose a square matrix in place. A transposed view of a matrix may be
+// used in an expression assigned to that matrix, as in m = transposed(m) + b,
+// but the expression is then computed into a new matrix (see
+// matrix_expr::aliases).
+
+namespace matrix_impl
+{
+  inline matrix_slice<2>
+  transposed_slice(const matrix_slice<2>& s)
+  {
+    matrix_slice<2> t = s;
+    std::swap(t.extents[0], t.extents[1]);
+    std::swap(t.strides[0], t.strides[1]);
+    return t;
+  }
+} // namespace matrix_impl
+
+template <typename T, typename A>
+  inline matrix_ref<T, 2>
+  transposed(matrix<T, 2, A>& m)
+  {
+    return {matrix_impl::transposed_slice(m.descriptor()), m.data()};
+  }
+
+template <typename T, typename A>
+  inline matrix_ref<const T, 2>
+  transposed(const matrix<T, 2, A>& m)
+  {
+    return {matrix_impl::transposed_slice(m.descriptor()), m.data()};
+  }
+
+// Taking the transposed view of a temporary matrix is prohibited; the view
+// would refer to destroyed elements.
+template <typename T, typename A>
+  matrix_ref<T, 2> transposed(matrix<T, 2, A>&&) = delete;
+
+template <typename T>
+  inline matrix_ref<T, 2>
+  transposed(matrix_ref<T, 2>& m)
+  {
+    return {matrix_impl::transposed_slice(m.descriptor()), m.data()};
+  }
+
+template <typename T>
+  inline matrix_ref<const T, 2>
+  transposed(const matrix_ref<T, 2>& m)
+  {
+    return {matrix_impl::transposed_slice(m.descriptor()), m.data()};
+  }
+
+template <typename T>
+  inline matrix_ref<T, 2>
+  transposed(matrix_ref<T, 2>&& m)
+  {
+    return {matrix_impl::transposed_slice(m.descriptor()), m.data()};
+  }
+
+
+template <typename M1, typename M2>
+  void
+  transpose(const M1& a, M2& out)
+  {
+    static_assert(M1::order == 2, "");
+    static_assert(M2::order == 2, "");
+    static_assert(matrix_impl::Strided_matrix<M1>(), "");
+    static_assert(matrix_impl::Strided_matrix<M2>(), "");
+    assert(rows(a) == cols(out) && cols(a) == rows(out));
+
+    const auto& da = a.descriptor();
+    const auto& db = out.descriptor();
+    assert(!matrix_impl::overlapping(a.data(), da, out.data(), db));
+    matrix_impl::transpose_block(rows(a), cols(a),
+                                 a.data() + da.start, da.strides[0], da.strides[1],
+                                 out.data() + db.start, db.strides[0], db.strides[1]);
+  }
+
+template <typename M>
+  inline matrix<Value_type<M>, 2>
+  transpose(const M& a)
+  {
+    matrix<Value_type<M>, 2> r(uninitialized, a.cols(), a.rows());
+    transpose(a, r);
+    return r;
+  }
+
+// Transpose the square matrix a.
+template <typename M>
+  void
+  transpose_in_place(M& a)
+  {
+    static_assert(M::order == 2, "");
+    static_assert(matrix_impl::Strided_matrix<M>(), "");
+    assert(rows(a) == cols(a));
+
+    const auto& d = a.descriptor();
+    matrix_impl::transpose_square_block(rows(a), a.data() + d.start,
+                                        d.strides[0], d.strides[1]);
+  }
+
+// Transpose the square matrix referred to by a. This overload allows a
+// temporary matrix_ref (e.g., a submatrix) to be transposed.
+template <typename T>
+  inline void
+  transpose_in_place(matrix_ref<T, 2>&& a)
+  {
+    transpose_in_place(a);
   }
 
 
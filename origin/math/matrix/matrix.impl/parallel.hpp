@@ -0,0 +1,443 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Parallel Operations                                          [matrix.parallel]
+//
+// The operations in this file take an execution policy (see
+// origin/sequence/execution.hpp) as their first argument. With the parallel
+// policy, the work is divided into blocks of rows (or, for contiguous
+// elementwise operations, blocks of elements) that are executed on a thread
+// pool. For example:
+//
+//    matrix_product(par, a, b, c);
+//    assign(par, r, a + b * 2.0);
+//    m.apply(par, [](double& x) { x = std::sqrt(x); });
+//
+// The grain of the policy is the number of rows (or elements) per block.
+// Problems smaller than the policy's threshold are executed sequentially. The
+// default thresholds are chosen so that each parallel task does enough work
+// to amortize the cost of scheduling it.
+//
+// Each block of rows is computed by the corresponding sequential operation,
+// so the parallel operations use the same kernels as the sequential ones.
+
+namespace matrix_impl
+{
+  // The default number of multiply-adds in a matrix product below which
+  // the product is computed sequentially.
+  constexpr std::size_t parallel_product_threshold = 1 << 17;
+
+  // The default number of elements below which elementwise operations are
+  // computed sequentially.
+  constexpr std::size_t parallel_elementwise_threshold = 1 << 15;
+
+  // The minimum number of elements in each block of a parallel elementwise
+  // operation.
+  constexpr std::size_t parallel_elementwise_grain = 1 << 12;
+
+
+  // Row range
+  //
+  // Returns a slice describing rows [first, last) of the slice s. The rows
+  // are the sub-matrices in the 0th dimension.
+  template <std::size_t N>
+    inline matrix_slice<N>
+    row_range(const matrix_slice<N>& s, std::size_t first, std::size_t last)
+    {
+      assert(first <= last && last <= s.extents[0]);
+      matrix_slice<N> r = s;
+      r.start = s.start + first * s.strides[0];
+      r.extents[0] = last - first;
+      r.size = 1;
+      for (std::size_t i = 0; i < N; ++i)
+        r.size *= r.extents[i];
+      return r;
+    }
+
+
+  // The row block trait gives the type of a block of rows of a matrix
+  // operand. Blocks of matrices and matrix_refs are matrix_refs. Blocks of
+  // expressions are expressions over blocks of their operands.
+  template <typename M>
+    struct row_block_result;
+
+  template <typename T, std::size_t N, typename A>
+    struct row_block_result<matrix<T, N, A>>
+    {
+      using type = matrix_ref<const T, N>;
+    };
+
+  template <typename T, std::size_t N>
+    struct row_block_result<matrix_ref<T, N>>
+    {
+      using type = matrix_ref<const Remove_const<T>, N>;
+    };
+
+  template <typename T>
+    struct row_block_result<expr_scalar<T>>
+    {
+      using type = expr_scalar<T>;
+    };
+
+  template <typename Op, typename E1, typename E2>
+    struct row_block_result<matrix_expr<Op, E1, E2>>
+    {
+      using type = matrix_expr<
+        Op,
+        typename row_block_result<Decay<E1>>::type,
+        typename row_block_result<Decay<E2>>::type
+      >;
+    };
+
+
+  // Row block
+  //
+  // Returns a reference to rows [first, last) of the matrix operand m.
+  template <typename T, std::size_t N, typename A>
+    inline matrix_ref<T, N>
+    row_block(matrix<T, N, A>& m, std::size_t first, std::size_t last)
+    {
+      return {row_range(m.descriptor(), first, last), m.data()};
+    }
+
+  template <typename T, std::size_t N, typename A>
+    inline matrix_ref<const T, N>
+    row_block(const matrix<T, N, A>& m, std::size_t first, std::size_t last)
+    {
+      return {row_range(m.descriptor(), first, last), m.data()};
+    }
+
+  template <typename T, std::size_t N>
+    inline matrix_ref<T, N>
+    row_block(matrix_ref<T, N>& m, std::size_t first, std::size_t last)
+    {
+      return {row_range(m.descriptor(), first, last), m.data()};
+    }
+
+  template <typename T, std::size_t N>
+    inline matrix_ref<const Remove_const<T>, N>
+    row_block(const matrix_ref<T, N>& m, std::size_t first, std::size_t last)
+    {
+      return {row_range(m.descriptor(), first, last), m.data()};
+    }
+
+  template <typename T>
+    inline const expr_scalar<T>&
+    row_block(const expr_scalar<T>& s, std::size_t, std::size_t)
+    {
+      return s;
+    }
+
+  template <typename Op, typename E1, typename E2>
+    typename row_block_result<matrix_expr<Op, E1, E2>>::type
+    row_block(const matrix_expr<Op, E1, E2>& e,
+              std::size_t first, std::size_t last);
+
+  // Returns rows [first, last) of the operand x of an expression whose
+  // result has the extents d. An operand that is broadcast along the rows
+  // of the result is not divided.
+  template <typename T, std::size_t N>
+    inline const expr_scalar<T>&
+    row_block_operand(const expr_scalar<T>& x, const matrix_slice<N>&,
+                      std::size_t first, std::size_t last)
+    {
+      return row_block(x, first, last);
+    }
+
+  template <typename Op, typename E1, typename E2, std::size_t N>
+    inline typename row_block_result<matrix_expr<Op, E1, E2>>::type
+    row_block_operand(const matrix_expr<Op, E1, E2>& x, const matrix_slice<N>& d,
+                      std::size_t first, std::size_t last)
+    {
+      if (x.extent(0) == d.extents[0])
+        return row_block(x, first, last);
+      return row_block(x, 0, x.extent(0));
+    }
+
+  template <typename M, std::size_t N>
+    inline typename row_block_result<M>::type
+    row_block_operand(const M& x, const matrix_slice<N>& d,
+                      std::size_t first, std::size_t last)
+    {
+      if (M::order == N && x.extent(0) == d.extents[0])
+        return row_block(x, first, last);
+      return x;
+    }
+
+  template <typename Op, typename E1, typename E2>
+    inline typename row_block_result<matrix_expr<Op, E1, E2>>::type
+    row_block(const matrix_expr<Op, E1, E2>& e,
+              std::size_t first, std::size_t last)
+    {
+      return {row_block_operand(e.left_operand(), e.descriptor(), first, last),
+              row_block_operand(e.right_operand(), e.descriptor(), first, last)};
+    }
+
+
+  // Parallel evaluation
+  //
+  // Compute the elements of the expression e into out. When the expression
+  // and out are both contiguous, the elements are divided into blocks of
+  // elements. Otherwise, they are divided into blocks of rows.
+  template <typename T, std::size_t N, typename E>
+    void
+    evaluate(const parallel_policy& p, const E& e, matrix_ref<T, N>& out)
+    {
+      assert(same_extents(e, out));
+      const std::size_t n = out.size();
+      if (!p.parallel(n, parallel_elementwise_threshold)) {
+        evaluate(e, out);
+        return;
+      }
+
+      thread_pool& pool = p.pool();
+      const auto& d = out.descriptor();
+      if (e.contiguous() && is_contiguous(d)) {
+        T* dst = out.data() + d.start;
+        std::size_t grain = p.grain(n, parallel_elementwise_grain);
+        pool.parallel_for(0, n, grain, [&](std::size_t i, std::size_t j) {
+          for ( ; i != j; ++i)
+            dst[i] = e.element(i);
+        });
+      } else {
+        const std::size_t m = out.rows();
+        const std::size_t row = n / m;
+        std::size_t grain = p.grain(m, parallel_elementwise_grain / row + 1);
+        pool.parallel_for(0, m, grain, [&](std::size_t i, std::size_t j) {
+          matrix_ref<T, N> block = row_block(out, i, j);
+          evaluate(row_block(e, i, j), block);
+        });
+      }
+    }
+
+
+  // Parallel hadamard product
+  //
+  // Operands whose extents differ from those of out are broadcast to them
+  // before they are divided into blocks of rows. As with the sequential
+  // product, an operand that aliases out is copied first; otherwise, a block
+  // could read elements written by another block.
+  template <typename M1, typename M2, typename M3>
+    void
+    parallel_hadamard_product(const parallel_policy& p,
+                              const M1& a, const M2& b, M3& out)
+    {
+      const std::size_t n = out.size();
+      if (!p.parallel(n, parallel_elementwise_threshold)) {
+        origin::hadamard_product(a, b, out);
+        return;
+      }
+      if (operand_aliases(a, out.data(), out.descriptor())) {
+        matrix<Value_type<M1>, M1::order> tmp = a;
+        parallel_hadamard_product(p, tmp, b, out);
+        return;
+      }
+      if (operand_aliases(b, out.data(), out.descriptor())) {
+        matrix<Value_type<M2>, M2::order> tmp = b;
+        parallel_hadamard_product(p, a, tmp, out);
+        return;
+      }
+      if (!same_extents(a, out) || !same_extents(b, out)) {
+        const auto& d = out.descriptor();
+        parallel_hadamard_product(p, broadcast_operand(a, d),
+                                  broadcast_operand(b, d), out);
+        return;
+      }
+
+      const std::size_t m = out.extent(0);
+      const std::size_t row = n / m;
+      std::size_t grain = p.grain(m, parallel_elementwise_grain / row + 1);
+      p.pool().parallel_for(0, m, grain, [&](std::size_t i, std::size_t j) {
+        auto block = row_block(out, i, j);
+        origin::hadamard_product(row_block(a, i, j), row_block(b, i, j), block);
+      });
+    }
+
+
+  // Parallel matrix product
+  template <typename M1, typename M2, typename M3>
+    void
+    parallel_matrix_product(const parallel_policy& p,
+                            const M1& a, const M2& b, M3& out)
+    {
+      const std::size_t work = rows(a) * cols(a) * cols(b);
+      if (!p.parallel(work, parallel_product_threshold)) {
+        origin::matrix_product(a, b, out);
+        return;
+      }
+
+      // Each block has at least one register tile of rows.
+      const std::size_t tile = gemm_blocking<Value_type<M3>>::mr;
+      std::size_t grain = p.grain(rows(a), tile);
+      p.pool().parallel_for(0, rows(a), grain, [&](std::size_t i, std::size_t j) {
+        auto block = row_block(out, i, j);
+        origin::matrix_product(row_block(a, i, j), b, block);
+      });
+    }
+
+} // namespace matrix_impl
+
+
+// Matrix product
+//
+// Compute the matrix product using the execution policy. Blocks of rows of
+// out are computed in parallel.
+template <typename M1, typename M2, typename M3>
+  inline void
+  matrix_product(sequential_policy, const M1& a, const M2& b, M3& out)
+  {
+    matrix_product(a, b, out);
+  }
+
+template <typename M1, typename M2, typename M3>
+  inline void
+  matrix_product(const parallel_policy& p, const M1& a, const M2& b, M3& out)
+  {
+    static_assert(M3::order == 2, "");
+    assert(cols(a) == rows(b));
+    assert(rows(a) == rows(out));
+    assert(cols(b) == cols(out));
+    matrix_impl::parallel_matrix_product(p, a, b, out);
+  }
+
+
+// Hadamard product
+//
+// Compute the hadamard product using the execution policy. Blocks of rows of
+// out are computed in parallel. The operands are broadcast as for the
+// sequential hadamard product.
+template <typename M1, typename M2, typename M3>
+  inline void
+  hadamard_product(sequential_policy, const M1& a, const M2& b, M3& out)
+  {
+    hadamard_product(a, b, out);
+  }
+
+template <typename M1, typename M2, typename M3>
+  inline void
+  hadamard_product(const parallel_policy& p, const M1& a, const M2& b, M3& out)
+  {
+    matrix_impl::parallel_hadamard_product(p, a, b, out);
+  }
+
+
+// Assign
+//
+// Evaluate the matrix expression e into the matrix or matrix_ref out using
+// the execution policy. If out is a matrix, it is resized to the extents of
+// e if needed. If out is a matrix_ref, it must have the same extents as e.
+// As with assignment, an expression whose operands alias out through a
+// different slice is computed into a temporary matrix.
+template <typename T, std::size_t N, typename A, 
+          typename Op, typename E1, typename E2>
+  inline void
+  assign(sequential_policy, matrix<T, N, A>& out, const matrix_expr<Op, E1, E2>& e)
+  {
+    out = e;
+  }
+
+template <typename T, std::size_t N, typename Op, typename E1, typename E2>
+  inline void
+  assign(sequential_policy, matrix_ref<T, N> out, const matrix_expr<Op, E1, E2>& e)
+  {
+    out = e;
+  }
+
+template <typename T, std::size_t N, typename A, 
+          typename Op, typename E1, typename E2>
+  void
+  assign(const parallel_policy& p, matrix<T, N, A>& out, const matrix_expr<Op, E1, E2>& e)
+  {
+    // As with assignment, e is evaluated into a new matrix, which replaces
+    // out, when the extents differ or e aliases out; e may refer to out, so
+    // out must not change until e has been evaluated.
+    if (!same_extents(out, e) || e.aliases(out.data(), out.descriptor())) {
+      matrix<T, N, A> tmp(uninitialized, e.descriptor(), out.get_allocator());
+      matrix_ref<T, N> r = tmp;
+      matrix_impl::evaluate(p, e, r);
+      out.swap(tmp);
+    } else {
+      matrix_ref<T, N> r = out;
+      matrix_impl::evaluate(p, e, r);
+    }
+  }
+
+template <typename T, std::size_t N, typename Op, typename E1, typename E2>
+  inline void
+  assign(const parallel_policy& p, matrix_ref<T, N> out, const matrix_expr<Op, E1, E2>& e)
+  {
+    if (e.aliases(out.data(), out.descriptor())) {
+      matrix<Remove_const<T>, N> tmp;
+      assign(p, tmp, e);
+      out = tmp;
+    } else {
+      matrix_impl::evaluate(p, e, out);
+    }
+  }
+
+
+// Eval
+//
+// Returns a matrix containing the elements computed by the expression e,
+// evaluated using the execution policy.
+template <typename P, typename Op, typename E1, typename E2>
+  inline Requires<
+    Execution_policy<P>(),
+    matrix<Value_type<matrix_expr<Op, E1, E2>>, matrix_expr<Op, E1, E2>::order>
+  >
+  eval(const P& p, const matrix_expr<Op, E1, E2>& e)
+  {
+    matrix<Value_type<matrix_expr<Op, E1, E2>>, matrix_expr<Op, E1, E2>::order> r;
+    assign(p, r, e);
+    return r;
+  }
+
+
+// Parallel apply
+template <typename T, std::size_t N, typename A>
+  template <typename F>
+    matrix<T, N, A>&
+    matrix<T, N, A>::apply(const parallel_policy& p, F f)
+    {
+      const std::size_t n = size();
+      if (!p.parallel(n, matrix_impl::parallel_elementwise_threshold))
+        return apply(f);
+
+      T* first = data();
+      std::size_t grain = p.grain(n, matrix_impl::parallel_elementwise_grain);
+      p.pool().parallel_for(0, n, grain, [first, &f](std::size_t i, std::size_t j) {
+        for ( ; i != j; ++i)
+          f(first[i]);
+      });
+      return *this;
+    }
+
+template <typename T, std::size_t N, typename A>
+  template <typename M, typename F>
+    matrix<T, N, A>&
+    matrix<T, N, A>::apply(const parallel_policy& p, const M& m, F f)
+    {
+      assert(same_extents(desc, m.descriptor()));
+      const std::size_t n = size();
+      if (!p.parallel(n, matrix_impl::parallel_elementwise_threshold))
+        return apply(m, f);
+
+      const std::size_t k = rows();
+      std::size_t grain = p.grain(k, matrix_impl::parallel_elementwise_grain / (n / k) + 1);
+      p.pool().parallel_for(0, k, grain, [&](std::size_t i, std::size_t j) {
+        auto src = matrix_impl::row_block(m, i, j);
+        auto dst = matrix_impl::row_block(*this, i, j);
+        dst.apply(src, f);
+      });
+      return *this;
+    }
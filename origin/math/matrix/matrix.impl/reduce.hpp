@@ -0,0 +1,613 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Axis Reductions                                                [matrix.reduce]
+//
+// An axis reduction combines the elements of a matrix along one of its
+// dimensions (the axis), producing a matrix of order N - 1. For example, if
+// m is a 2D matrix:
+//
+//    sum(m, 0)   -- The sum of each column (a vector of cols(m) elements)
+//    sum(m, 1)   -- The sum of each row (a vector of rows(m) elements)
+//
+// The following reductions are provided for strided matrices (matrix,
+// matrix_ref and fixed_matrix) of order 2 or more:
+//
+//    sum(m, axis)       -- The sum of elements
+//    min(m, axis)       -- The least element
+//    max(m, axis)       -- The greatest element
+//    norm2(m, axis)     -- The Euclidean norm
+//    mean(m, axis)      -- The arithmetic mean
+//    variance(m, axis)  -- The population variance
+//    argmin(m, axis)    -- The index of the least element
+//    argmax(m, axis)    -- The index of the greatest element
+//
+// The results of argmin and argmax are matrices of std::size_t, holding
+// indexes along the axis. When several elements are equally least or
+// greatest, the index of the first is returned.
+//
+// Each reduction also accepts an execution policy as its first argument.
+// With the parallel policy, blocks of result elements are computed in
+// parallel.
+//
+// The result element with index (i, j, ...) combines the elements of the
+// matrix_slice row<D>(k) having that index, for each k (where D is the
+// axis). How the elements are visited depends on the layout of the matrix:
+//
+//  - When the axis is contiguous (its stride is 1), each result is computed
+//    from a contiguous run of elements. Sums use pairwise summation, whose
+//    error grows with log n.
+//
+//  - Otherwise, the slices row<D>(k) are visited in order, and each is
+//    accumulated into the result elementwise. The inner loops run over the
+//    contiguous rows of each slice, so reducing the columns of a row-major
+//    matrix reads memory sequentially. Sums use Kahan (compensated)
+//    summation.
+//
+// The variance is computed in two passes, from the deviations from the
+// mean. The norm is not scaled, so the squares of very large or very small
+// elements may overflow or underflow.
+
+namespace matrix_impl
+{
+  // The number of elements below which pairwise summation adds elements
+  // directly.
+  constexpr std::size_t pairwise_block = 32;
+
+  // Returns the sum of f(p[0]), f(p[1]), ..., f(p[n - 1]) computed by
+  // pairwise summation. Blocks are summed into four independent partial
+  // sums so that the additions are not a single dependency chain.
+  template <typename T, typename F>
+    T
+    pairwise_sum(const T* p, std::size_t n, F f)
+    {
+      if (n <= pairwise_block) {
+        T s0 = T(0), s1 = T(0), s2 = T(0), s3 = T(0);
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+          s0 += f(p[i]);
+          s1 += f(p[i + 1]);
+          s2 += f(p[i + 2]);
+          s3 += f(p[i + 3]);
+        }
+        for (; i < n; ++i)
+          s0 += f(p[i]);
+        return (s0 + s1) + (s2 + s3);
+      }
+      const std::size_t h = n / 2;
+      return pairwise_sum(p, h, f) + pairwise_sum(p + h, n - h, f);
+    }
+
+
+  // Element transforms for sums.
+  //
+  // The transform is applied to each element before summation. The index j
+  // is the (row-major) position of the result element.
+  template <typename T>
+    struct identity_transform
+    {
+      T operator()(T x, std::size_t) const { return x; }
+    };
+
+  template <typename T>
+    struct square_transform
+    {
+      T operator()(T x, std::size_t) const { return x * x; }
+    };
+
+  // The squared deviation of an element from the corresponding mean.
+  template <typename T>
+    struct deviation_transform
+    {
+      T operator()(T x, std::size_t j) const { return (x - mean[j]) * (x - mean[j]); }
+
+      const T* mean;
+    };
+
+
+  // The sum reduction computes the sum of transformed elements.
+  template <typename T, typename F>
+    struct sum_reduction
+    {
+      // Sums carry Kahan compensation terms when accumulating slices.
+      static constexpr bool compensated = true;
+
+      // Returns the sum of the n contiguous elements at p.
+      T
+      line(const T* p, std::size_t n, std::size_t j) const
+      {
+        return pairwise_sum(p, n, [&](T x) { return f(x, j); });
+      }
+
+      // Initialize the result elements at acc from the n contiguous
+      // elements at p.
+      void
+      initialize(T* acc, T*, const T* p, std::size_t n, std::size_t j) const
+      {
+        for (std::size_t i = 0; i < n; ++i)
+          acc[i] = f(p[i], j + i);
+      }
+
+      // Accumulate the n contiguous elements at p into the result elements
+      // at acc, with the compensation terms at comp.
+      void
+      accumulate(T* acc, T* comp, const T* p, std::size_t n, std::size_t j) const
+      {
+        for (std::size_t i = 0; i < n; ++i) {
+          T y = f(p[i], j + i) - comp[i];
+          T t = acc[i] + y;
+          comp[i] = (t - acc[i]) - y;
+          acc[i] = t;
+        }
+      }
+
+      F f;
+    };
+
+  // The fold reduction combines elements with the binary operation Op,
+  // which selects one of its arguments (e.g., min or max).
+  template <typename T, typename Op>
+    struct fold_reduction
+    {
+      static constexpr bool compensated = false;
+
+      T
+      line(const T* p, std::size_t n, std::size_t) const
+      {
+        T r = p[0];
+        for (std::size_t i = 1; i < n; ++i)
+          r = op(r, p[i]);
+        return r;
+      }
+
+      void
+      initialize(T* acc, T*, const T* p, std::size_t n, std::size_t) const
+      {
+        std::copy_n(p, n, acc);
+      }
+
+      void
+      accumulate(T* acc, T*, const T* p, std::size_t n, std::size_t) const
+      {
+        for (std::size_t i = 0; i < n; ++i)
+          acc[i] = op(acc[i], p[i]);
+      }
+
+      Op op;
+    };
+
+  template <typename T>
+    struct min_op
+    {
+      T operator()(T a, T b) const { return b < a ? b : a; }
+    };
+
+  template <typename T>
+    struct max_op
+    {
+      T operator()(T a, T b) const { return a < b ? b : a; }
+    };
+
+
+  // Reduce along the axis D of the slice s, computing result elements
+  // [first, last) into out. Each result is computed from a contiguous run
+  // of elements.
+  template <std::size_t D, std::size_t N, typename T, typename R>
+    void
+    reduce_lines(const matrix_slice<N>& s, const T* base, const R& r,
+                 T* out, std::size_t first, std::size_t last)
+    {
+      const std::size_t n = s.extents[D];
+      if (n == 0) {
+        std::fill(out + first, out + last, T(0));
+        return;
+      }
+
+      const matrix_slice<N-1> s0 = s.template row<D>(0);
+      slice_iterator<const T, N-1> i(s0, base);
+      i += first;
+      for (std::size_t j = first; j != last; ++j, ++i)
+        out[j] = r.line(&*i, n, j);
+    }
+
+  // Reduce along the axis D of the slice s, computing result elements
+  // [first, last) into out. Each slice row<D>(k) is accumulated in turn,
+  // in runs of contiguous elements. The first slice initializes the result.
+  // Compensation terms are allocated only for compensated reductions.
+  template <std::size_t D, std::size_t N, typename T, typename R>
+    void
+    reduce_slices(const matrix_slice<N>& s, const T* base, const R& r,
+                  T* out, std::size_t first, std::size_t last)
+    {
+      const std::size_t n = s.extents[D];
+      if (n == 0) {
+        std::fill(out + first, out + last, T(0));
+        return;
+      }
+
+      std::vector<T> comp(R::compensated ? last - first : 0, T(0));
+      for (std::size_t k = 0; k < n; ++k) {
+        const matrix_slice<N-1> sk = s.template row<D>(k);
+        const std::size_t row = sk.extents[N - 2];
+        const bool contiguous = sk.strides[N - 2] == 1;
+        slice_iterator<const T, N-1> i(sk, base);
+        i += first;
+        for (std::size_t j = first; j != last; ) {
+          std::size_t len = contiguous ? std::min(last - j, row - j % row) : 1;
+          T* acc = out + j;
+          T* c = R::compensated ? comp.data() + (j - first) : nullptr;
+          if (k == 0)
+            r.initialize(acc, c, &*i, len, j);
+          else
+            r.accumulate(acc, c, &*i, len, j);
+          i += len;
+          j += len;
+        }
+      }
+    }
+
+  template <std::size_t D, std::size_t N, typename T, typename R>
+    inline void
+    reduce_axis(const matrix_slice<N>& s, const T* base, const R& r,
+                T* out, std::size_t first, std::size_t last)
+    {
+      if (s.strides[D] == 1)
+        reduce_lines<D>(s, base, r, out, first, last);
+      else
+        reduce_slices<D>(s, base, r, out, first, last);
+    }
+
+
+  // The index reduction finds the index along the axis of the element
+  // selected by the binary predicate Comp, which is true when its second
+  // argument is preferred to its first (e.g., less for the greatest). The
+  // first of several equally preferred elements is selected.
+  template <typename T, typename Comp>
+    struct index_reduction
+    {
+      Comp comp;
+    };
+
+  // Compute the indexes of the selected elements along the axis D of the
+  // slice s for result elements [first, last) into out. As with the other
+  // reductions, each result is computed from a contiguous run of elements
+  // when the axis is contiguous. Otherwise, each slice row<D>(k) is compared
+  // in turn with the selected elements.
+  template <std::size_t D, std::size_t N, typename T, typename Comp>
+    void
+    reduce_axis(const matrix_slice<N>& s, const T* base,
+                const index_reduction<T, Comp>& r,
+                std::size_t* out, std::size_t first, std::size_t last)
+    {
+      const std::size_t n = s.extents[D];
+      assert(n != 0);
+      if (s.strides[D] == 1) {
+        slice_iterator<const T, N-1> i(s.template row<D>(0), base);
+        i += first;
+        for (std::size_t j = first; j != last; ++j, ++i) {
+          const T* p = &*i;
+          std::size_t k = 0;
+          for (std::size_t x = 1; x < n; ++x) {
+            if (r.comp(p[k], p[x]))
+              k = x;
+          }
+          out[j] = k;
+        }
+        return;
+      }
+
+      std::vector<T> best(last - first);
+      for (std::size_t k = 0; k < n; ++k) {
+        slice_iterator<const T, N-1> i(s.template row<D>(k), base);
+        i += first;
+        for (std::size_t j = first; j != last; ++j, ++i) {
+          T& b = best[j - first];
+          if (k == 0 || r.comp(b, *i)) {
+            b = *i;
+            out[j] = k;
+          }
+        }
+      }
+    }
+
+
+  // The axis reducer computes a reduction of a strided matrix along a
+  // (runtime) axis into out, using the given policy.
+  template <typename P, typename M, typename R,
+            typename O = matrix<Remove_const<Value_type<M>>, M::order - 1>>
+    struct axis_reducer
+    {
+      static constexpr std::size_t N = M::order;
+
+      // Call the reduction for the compile-time axis D.
+      template <std::size_t D>
+        void
+        operator()(size_constant<D>) const
+        {
+          const auto& s = m.descriptor();
+          reduce(policy, out.size(), [&](std::size_t i, std::size_t j) {
+            reduce_axis<D>(s, m.data(), r, out.data(), i, j);
+          });
+        }
+
+      // Sequential reduction.
+      template <typename F>
+        static void
+        reduce(sequential_policy, std::size_t n, F f)
+        {
+          f(0, n);
+        }
+
+      // Parallel reduction. Blocks of result elements are computed in
+      // parallel.
+      template <typename F>
+        void
+        reduce(const parallel_policy& p, std::size_t n, F f) const
+        {
+          if (!p.parallel(m.size(), parallel_elementwise_threshold)) {
+            f(0, n);
+            return;
+          }
+          const std::size_t work = n ? m.size() / n : 1;
+          std::size_t grain = p.grain(n, parallel_elementwise_grain / work + 1);
+          p.pool().parallel_for(0, n, grain, f);
+        }
+
+      const P& policy;
+      const M& m;
+      const R& r;
+      O& out;
+    };
+
+  // Call f(size_constant<D>()) where D == axis.
+  template <std::size_t D, std::size_t N>
+    struct axis_dispatch
+    {
+      template <typename F>
+        static void
+        apply(std::size_t axis, const F& f)
+        {
+          if (axis == D)
+            f(size_constant<D>());
+          else
+            axis_dispatch<D + 1, N>::apply(axis, f);
+        }
+    };
+
+  template <std::size_t N>
+    struct axis_dispatch<N, N>
+    {
+      template <typename F>
+        static void
+        apply(std::size_t, const F&)
+        {
+          assert(false);
+        }
+    };
+
+  // Returns the slice describing the result of reducing the slice s along
+  // the given axis.
+  template <std::size_t N>
+    matrix_slice<N - 1>
+    reduction_slice(const matrix_slice<N>& s, std::size_t axis)
+    {
+      std::size_t exts[N - 1];
+      std::copy_n(s.extents + axis + 1, N - axis - 1,
+                  std::copy_n(s.extents, axis, exts));
+      return matrix_slice<N - 1>(0, exts);
+    }
+
+  // Returns the reduction of m along the given axis. The result has the
+  // value type U.
+  template <typename U, typename P, typename M, typename R>
+    matrix<U, M::order - 1>
+    reduce_matrix(const P& p, const M& m, std::size_t axis, const R& r)
+    {
+      constexpr std::size_t N = M::order;
+      static_assert(N > 1, "");
+      static_assert(Strided_matrix<M>(), "");
+      assert(axis < N);
+
+      using O = matrix<U, N - 1>;
+      O out(uninitialized, reduction_slice(m.descriptor(), axis));
+      axis_reducer<P, M, R, O> f {p, m, r, out};
+      axis_dispatch<0, N>::apply(axis, f);
+      return out;
+    }
+
+  template <typename M>
+    using Reduction_result = matrix<Remove_const<Value_type<M>>, M::order - 1>;
+
+  // Returns the sum of transformed elements of m along the axis.
+  template <typename P, typename M, typename F>
+    inline Reduction_result<M>
+    reduce_sum(const P& p, const M& m, std::size_t axis, F f)
+    {
+      using T = Remove_const<Value_type<M>>;
+      return reduce_matrix<T>(p, m, axis, sum_reduction<T, F> {f});
+    }
+
+  // Returns the fold of the elements of m along the axis.
+  template <typename P, typename M, typename Op>
+    inline Reduction_result<M>
+    reduce_fold(const P& p, const M& m, std::size_t axis, Op op)
+    {
+      using T = Remove_const<Value_type<M>>;
+      assert(m.extent(axis) != 0);
+      return reduce_matrix<T>(p, m, axis, fold_reduction<T, Op> {op});
+    }
+
+  template <typename M>
+    using Index_result = matrix<std::size_t, M::order - 1>;
+
+  // Returns the indexes of the elements of m along the axis that are
+  // selected by comp.
+  template <typename P, typename M, typename Comp>
+    inline Index_result<M>
+    reduce_index(const P& p, const M& m, std::size_t axis, Comp comp)
+    {
+      using T = Remove_const<Value_type<M>>;
+      assert(m.extent(axis) != 0);
+      return reduce_matrix<std::size_t>(p, m, axis, index_reduction<T, Comp> {comp});
+    }
+} // namespace matrix_impl
+
+
+// Sum
+template <typename P, typename M, typename = Requires<Execution_policy<P>()>>
+  inline matrix_impl::Reduction_result<M>
+  sum(const P& p, const M& m, std::size_t axis)
+  {
+    using T = Remove_const<Value_type<M>>;
+    return matrix_impl::reduce_sum(p, m, axis, matrix_impl::identity_transform<T>());
+  }
+
+template <typename M, typename = Requires<matrix_impl::Strided_matrix<M>()>>
+  inline matrix_impl::Reduction_result<M>
+  sum(const M& m, std::size_t axis)
+  {
+    return sum(seq, m, axis);
+  }
+
+
+// Min
+template <typename P, typename M, typename = Requires<Execution_policy<P>()>>
+  inline matrix_impl::Reduction_result<M>
+  min(const P& p, const M& m, std::size_t axis)
+  {
+    using T = Remove_const<Value_type<M>>;
+    return matrix_impl::reduce_fold(p, m, axis, matrix_impl::min_op<T>());
+  }
+
+template <typename M, typename = Requires<matrix_impl::Strided_matrix<M>()>>
+  inline matrix_impl::Reduction_result<M>
+  min(const M& m, std::size_t axis)
+  {
+    return min(seq, m, axis);
+  }
+
+
+// Max
+template <typename P, typename M, typename = Requires<Execution_policy<P>()>>
+  inline matrix_impl::Reduction_result<M>
+  max(const P& p, const M& m, std::size_t axis)
+  {
+    using T = Remove_const<Value_type<M>>;
+    return matrix_impl::reduce_fold(p, m, axis, matrix_impl::max_op<T>());
+  }
+
+template <typename M, typename = Requires<matrix_impl::Strided_matrix<M>()>>
+  inline matrix_impl::Reduction_result<M>
+  max(const M& m, std::size_t axis)
+  {
+    return max(seq, m, axis);
+  }
+
+
+// Norm
+template <typename P, typename M, typename = Requires<Execution_policy<P>()>>
+  inline matrix_impl::Reduction_result<M>
+  norm2(const P& p, const M& m, std::size_t axis)
+  {
+    using T = Remove_const<Value_type<M>>;
+    auto r = matrix_impl::reduce_sum(p, m, axis, matrix_impl::square_transform<T>());
+    for (T& x : r)
+      x = std::sqrt(x);
+    return r;
+  }
+
+template <typename M, typename = Requires<matrix_impl::Strided_matrix<M>()>>
+  inline matrix_impl::Reduction_result<M>
+  norm2(const M& m, std::size_t axis)
+  {
+    return norm2(seq, m, axis);
+  }
+
+
+// Mean
+template <typename P, typename M, typename = Requires<Execution_policy<P>()>>
+  inline matrix_impl::Reduction_result<M>
+  mean(const P& p, const M& m, std::size_t axis)
+  {
+    using T = Remove_const<Value_type<M>>;
+    assert(m.extent(axis) != 0);
+    auto r = sum(p, m, axis);
+    r /= T(m.extent(axis));
+    return r;
+  }
+
+template <typename M, typename = Requires<matrix_impl::Strided_matrix<M>()>>
+  inline matrix_impl::Reduction_result<M>
+  mean(const M& m, std::size_t axis)
+  {
+    return mean(seq, m, axis);
+  }
+
+
+// Variance
+template <typename P, typename M, typename = Requires<Execution_policy<P>()>>
+  inline matrix_impl::Reduction_result<M>
+  variance(const P& p, const M& m, std::size_t axis)
+  {
+    using T = Remove_const<Value_type<M>>;
+    auto mu = mean(p, m, axis);
+    matrix_impl::deviation_transform<T> f {mu.data()};
+    auto r = matrix_impl::reduce_sum(p, m, axis, f);
+    r /= T(m.extent(axis));
+    return r;
+  }
+
+template <typename M, typename = Requires<matrix_impl::Strided_matrix<M>()>>
+  inline matrix_impl::Reduction_result<M>
+  variance(const M& m, std::size_t axis)
+  {
+    return variance(seq, m, axis);
+  }
+
+
+// Argmin
+template <typename P, typename M, typename = Requires<Execution_policy<P>()>>
+  inline matrix_impl::Index_result<M>
+  argmin(const P& p, const M& m, std::size_t axis)
+  {
+    using T = Remove_const<Value_type<M>>;
+    return matrix_impl::reduce_index(p, m, axis, [](const T& a, const T& b) {
+      return b < a;
+    });
+  }
+
+template <typename M, typename = Requires<matrix_impl::Strided_matrix<M>()>>
+  inline matrix_impl::Index_result<M>
+  argmin(const M& m, std::size_t axis)
+  {
+    return argmin(seq, m, axis);
+  }
+
+
+// Argmax
+template <typename P, typename M, typename = Requires<Execution_policy<P>()>>
+  inline matrix_impl::Index_result<M>
+  argmax(const P& p, const M& m, std::size_t axis)
+  {
+    using T = Remove_const<Value_type<M>>;
+    return matrix_impl::reduce_index(p, m, axis, [](const T& a, const T& b) {
+      return a < b;
+    });
+  }
+
+template <typename M, typename = Requires<matrix_impl::Strided_matrix<M>()>>
+  inline matrix_impl::Index_result<M>
+  argmax(const M& m, std::size_t axis)
+  {
+    return argmax(seq, m, axis);
+  }
@@ -0,0 +1,194 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_HPP
+#  error Do not include this file directly. Include matrix/matrix.hpp.
+#endif
+
+namespace matrix_impl
+{
+  // ------------------------------------------------------------------------ //
+  //                        Vectorized Elementwise Kernels
+  //
+  // The elementwise kernels compute one of the arithmetic operations over
+  // contiguous arrays of float, double, int32 or int64 values. There are two
+  // forms:
+  //
+  //    simd_elementwise(op, a, b, out, n) // out[i] = a[i] op b[i]
+  //    simd_elementwise(op, a, x, out, n) // out[i] = a[i] op x
+  //
+  // The kernels are implemented (in matrix.cpp) for each supported
+  // instruction set. The implementation is selected at runtime, based on
+  // the features of the host CPU.
+  // Operations that are not supported by an instruction set (e.g., integer
+  // division) are computed by a scalar loop.
+  //
+  // The output array may be the same as the first input array. Otherwise,
+  // the arrays must not overlap.
+
+  // The elementwise arithmetic operations.
+  enum class elementwise_op { add, sub, mul, div };
+
+  // The elementwise kernels use the instruction set selected for the
+  // vectorized sequence algorithms (see sequence/algorithm.hpp), so
+  // set_simd_level selects the kernels of both.
+  using algorithm_impl::simd_isa;
+  using algorithm_impl::simd_support;
+  using algorithm_impl::simd_level;
+  using algorithm_impl::set_simd_level;
+
+  void simd_elementwise(elementwise_op, const float*, const float*, float*, std::size_t);
+  void simd_elementwise(elementwise_op, const double*, const double*, double*, std::size_t);
+  void simd_elementwise(elementwise_op, const std::int32_t*, const std::int32_t*, std::int32_t*, std::size_t);
+  void simd_elementwise(elementwise_op, const std::int64_t*, const std::int64_t*, std::int64_t*, std::size_t);
+
+  void simd_elementwise(elementwise_op, const float*, float, float*, std::size_t);
+  void simd_elementwise(elementwise_op, const double*, double, double*, std::size_t);
+  void simd_elementwise(elementwise_op, const std::int32_t*, std::int32_t, std::int32_t*, std::size_t);
+  void simd_elementwise(elementwise_op, const std::int64_t*, std::int64_t, std::int64_t*, std::size_t);
+
+
+  // Returns true if T is one of the value types supported by the vectorized
+  // elementwise kernels.
+  template <typename T>
+    constexpr bool Simd_value()
+    {
+      return Same<T, float>()
+          || Same<T, double>()
+          || Same<T, std::int32_t>()
+          || Same<T, std::int64_t>();
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                        Compound Assignment
+  //
+  // The compound assignment function objects apply a compound assignment
+  // operator to their arguments. Each is associated with the corresponding
+  // elementwise operation code.
+
+  struct add_assign
+  {
+    static constexpr elementwise_op code = elementwise_op::add;
+
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { a += b; }
+  };
+
+  struct sub_assign
+  {
+    static constexpr elementwise_op code = elementwise_op::sub;
+
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { a -= b; }
+  };
+
+  struct mul_assign
+  {
+    static constexpr elementwise_op code = elementwise_op::mul;
+
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { a *= b; }
+  };
+
+  struct div_assign
+  {
+    static constexpr elementwise_op code = elementwise_op::div;
+
+    template <typename T, typename U>
+      void operator()(T& a, const U& b) const { a /= b; }
+  };
+
+
+  // Assign scalar
+  //
+  // Apply the compound assignment op to each of the n elements in p with
+  // the scalar value x.
+  template <typename T, typename Op>
+    inline void
+    assign_scalar(T* p, std::size_t n, const T& x, Op op, std::false_type)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        op(p[i], x);
+    }
+
+  template <typename T, typename Op>
+    inline void
+    assign_scalar(T* p, std::size_t n, const T& x, Op, std::true_type)
+    {
+      simd_elementwise(Op::code, p, x, p, n);
+    }
+
+  template <typename T, typename Op>
+    inline void
+    assign_scalar(T* p, std::size_t n, const T& x, Op op)
+    {
+      using Vectorized = std::integral_constant<bool, Simd_value<T>()>;
+      assign_scalar(p, n, x, op, Vectorized());
+    }
+
+
+  // Assign elements
+  //
+  // Apply the compound assignment op to each of the n elements of p with
+  // the corresponding element of q.
+  template <typename T, typename Op>
+    inline void
+    assign_elements(T* p, const T* q, std::size_t n, Op op, std::false_type)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        op(p[i], q[i]);
+    }
+
+  template <typename T, typename Op>
+    inline void
+    assign_elements(T* p, const T* q, std::size_t n, Op, std::true_type)
+    {
+      simd_elementwise(Op::code, p, q, p, n);
+    }
+
+  template <typename T, typename Op>
+    inline void
+    assign_elements(T* p, const T* q, std::size_t n, Op op)
+    {
+      using Vectorized = std::integral_constant<bool, Simd_value<T>()>;
+      assign_elements(p, q, n, op, Vectorized());
+    }
+
+
+  // Assign broadcast elements
+  //
+  // Apply the compound assignment op to each element of the contiguous
+  // array p, having the extents of the broadcast slice s, with the
+  // corresponding element of s over q. Each row of p (along the innermost
+  // dimension) is combined with a row of q whose stride is 1 (e.g., adding
+  // a vector to each row) or 0 (e.g., adding a column to each column), so
+  // the rows are processed by the vectorized kernels.
+  template <typename T, std::size_t N, typename Op>
+    void
+    assign_broadcast(T* p, const T* q, const matrix_slice<N>& s, Op op)
+    {
+      const std::size_t n = s.extents[N - 1];
+      if (s.size == 0)
+        return;
+      const std::size_t stride = s.strides[N - 1];
+      slice_iterator<const T, N> i(s, q);
+      for (std::size_t k = 0; k < s.size; k += n, p += n) {
+        const T* r = &*i;
+        if (stride == 1) {
+          assign_elements(p, r, n, op);
+        } else if (stride == 0) {
+          assign_scalar(p, n, *r, op);
+        } else {
+          for (std::size_t j = 0; j < n; ++j)
+            op(p[j], r[j * stride]);
+        }
+        i += n;
+      }
+    }
+
+} // namespace matrix_impl
@@ -487,6 +487,13 @@ template<std::size_t N>
         && std::equal(a.extents, a.extents + N, b.extents);
   }
 
+template<std::size_t N, std::size_t M>
+  inline bool
+  same_extents(const matrix_slice<N>&, const matrix_slice<M>&)
+  {
+    return false;
+  }
+
 template<typename M1, typename M2>
   inline bool
   same_extents(const M1& a, const M2& b)
@@ -494,3 +501,121 @@ template<typename M1, typename M2>
     return same_extents(a.descriptor(), b.descriptor());
   }
 
+
+
+// -------------------------------------------------------------------------- //
+//                              Broadcasting
+//
+// A slice of order M can be broadcast to extents of order N >= M by aligning
+// its extents with the last M extents. Each of its extents must be equal to
+// the corresponding extent or 1. The broadcast slice repeats the elements
+// along the new leading dimensions and the dimensions of extent 1 by giving
+// them a stride of 0. For example, broadcasting a vector of n elements to
+// the extents (m, n) gives a slice whose rows are each the vector, and
+// broadcasting an m x 1 matrix gives a slice whose columns are each the
+// matrix.
+//
+// Two slices are broadcast against each other by broadcasting both to the
+// extents computed by broadcast_extents.
+
+namespace matrix_impl
+{
+  // Returns true if the extents of s can be broadcast to the extents exts.
+  template<std::size_t N, std::size_t M>
+    inline bool
+    is_broadcastable(const matrix_slice<M>& s, const std::size_t (&exts)[N])
+    {
+      if (M > N)
+        return false;
+      for (std::size_t i = 0; i < M; ++i) {
+        const std::size_t e = s.extents[i];
+        if (e != 1 && e != exts[N - M + i])
+          return false;
+      }
+      return true;
+    }
+
+  // Returns the slice that presents the elements described by s with the
+  // extents exts, using zero strides for broadcast dimensions.
+  template<std::size_t N, std::size_t M>
+    matrix_slice<N>
+    broadcast_slice(const matrix_slice<M>& s, const std::size_t (&exts)[N])
+    {
+      static_assert(M <= N, "");
+      assert(is_broadcastable(s, exts));
+      matrix_slice<N> r;
+      r.start = s.start;
+      r.size = 1;
+      for (std::size_t i = 0; i < N; ++i) {
+        r.extents[i] = exts[i];
+        r.size *= exts[i];
+        r.strides[i] = 0;
+        if (i >= N - M && s.extents[i - (N - M)] == exts[i])
+          r.strides[i] = s.strides[i - (N - M)];
+      }
+      return r;
+    }
+
+  // Returns a row-major slice with the extents of the result of an
+  // elementwise operation on operands described by a and b, where N is the
+  // greater of their orders. Aligned extents must either be equal, or one of
+  // them must be 1.
+  template<std::size_t N, std::size_t M1, std::size_t M2>
+    matrix_slice<N>
+    broadcast_extents(const matrix_slice<M1>& a, const matrix_slice<M2>& b)
+    {
+      static_assert(N == (M1 < M2 ? M2 : M1), "");
+      std::size_t exts[N];
+      for (std::size_t i = 0; i < N; ++i) {
+        const std::size_t x = i + M1 < N ? 1 : a.extents[i + M1 - N];
+        const std::size_t y = i + M2 < N ? 1 : b.extents[i + M2 - N];
+        assert(x == y || x == 1 || y == 1);
+        exts[i] = x == 1 ? y : x;
+      }
+      return matrix_slice<N>(0, exts);
+    }
+} // namespace matrix_impl
+
+
+
+// -------------------------------------------------------------------------- //
+//                              Overlap
+//
+// Two slices of arrays overlap when the ranges of addresses spanned by their
+// elements intersect. This is a conservative test: the elements of strided
+// slices that interleave are not actually shared, but they overlap.
+
+namespace matrix_impl
+{
+  // Returns the offset one past the last element described by s, or s.start
+  // if s describes no elements.
+  template<std::size_t N>
+    inline std::size_t
+    slice_limit(const matrix_slice<N>& s)
+    {
+      std::size_t n = s.start;
+      for (std::size_t i = 0; i < N; ++i) {
+        if (s.extents[i] == 0)
+          return s.start;
+        n += (s.extents[i] - 1) * s.strides[i];
+      }
+      return n + 1;
+    }
+
+  // Returns true if the elements described by the slice s of the array p
+  // overlap those described by the slice t of the array q.
+  template<typename T, std::size_t N, typename U, std::size_t M>
+    bool
+    overlapping(const T* p, const matrix_slice<N>& s,
+                const U* q, const matrix_slice<M>& t)
+    {
+      if (slice_limit(s) == s.start || slice_limit(t) == t.start)
+        return false;
+      std::less<const void*> less;
+      const void* first1 = p + s.start;
+      const void* last1 = p + slice_limit(s);
+      const void* first2 = q + t.start;
+      const void* last2 = q + slice_limit(t);
+      return less(first1, last2) && less(first2, last1);
+    }
+} // namespace matrix_impl
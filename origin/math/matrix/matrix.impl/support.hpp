@@ -17,20 +17,20 @@ namespace matrix_impl
   // ------------------------------------------------------------------------ //
   //                          Insert Flattened
   //
-  // Insert the elements of a initializer list nesting into a vector such that
+  // Insert the elements of a initializer list nesting into a buffer such that
   // each subsequent set of "leaf" values are copied into a contiguous memory.
 
   // TODO: This algorithm could be generalized to flatten an arbitrary
   // initializer list structure.
 
-  // For iterators over the leaf nodes, insert elements into the back of the
-  // vector. We generally assume that the vector has sufficient capacity for
-  // all such insertions, but insert guarantees that it will resize if needed.
+  // For iterators over the leaf nodes, append elements to the back of the
+  // buffer. We generally assume that the buffer has sufficient capacity for
+  // all such insertions, but append guarantees that it will resize if needed.
   template <typename T, typename Vec>
     inline void 
     insert_flattened(const T* first, const T* last, Vec& vec)
     {
-      vec.insert(vec.end(), first, last);
+      vec.append(first, last);
     }
 
   // For iterators into nested initializer lists, recursively intiailize each
@@ -48,7 +48,7 @@ namespace matrix_impl
     }
 
   // Copy the elements from the initializer list nesting into contiguous
-  // elements in the vector.
+  // elements in the buffer.
   template <typename T, typename Vec>
     inline void 
     insert_flattened(const std::initializer_list<T>& list, Vec& vec)
@@ -101,5 +101,25 @@ namespace matrix_impl
     using Slice_result = matrix_ref<T, Count_slices<Args...>()>;
 
 
+  // The strided matrix trait is true for matrices whose elements are
+  // addressed by a matrix_slice over a pointer to the underlying data. These
+  // are the matrix and matrix_ref class templates.
+  template <typename M>
+    struct is_strided_matrix : std::false_type { };
+
+  template <typename T, std::size_t N, typename A>
+    struct is_strided_matrix<matrix<T, N, A>> : std::true_type { };
+
+  template <typename T, std::size_t N>
+    struct is_strided_matrix<matrix_ref<T, N>> : std::true_type { };
+
+  // Returns true if M is a strided matrix.
+  template <typename M>
+    constexpr bool Strided_matrix()
+    {
+      return is_strided_matrix<M>::value;
+    }
+
+
 } // namespace matrix_impl
 
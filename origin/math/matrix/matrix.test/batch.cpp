@@ -0,0 +1,163 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for batched products. When run as:
+//
+//    batch [n k...]
+//
+// the benchmark compares a loop of operator* with the sequential and
+// parallel batched products, for k products of matrices of order n.
+
+using Mat = matrix<double, 2>;
+using Batch = matrix<double, 3>;
+
+Batch random_batch(size_t k, size_t m, size_t n)
+{
+  uniform_real_distribution<double> dist(-1, 1);
+  Batch r(k, m, n);
+  for (auto& x : r)
+    x = dist(matrix_engine());
+  return r;
+}
+
+// Check that out[k] == a[k] * b[k] for each k.
+void check_products(const Batch& a, const Batch& b, const Batch& out)
+{
+  for (size_t k = 0; k < a.extent(0); ++k) {
+    Mat c = a[k] * b[k];
+    assert(max_error(out[k], c) < 1e-12);
+  }
+}
+
+void test_batch()
+{
+  // Kernels with constant bounds and the general kernel.
+  size_t sizes[][3] = {{4, 4, 4}, {8, 8, 8}, {16, 16, 16}, {32, 32, 32}, {5, 7, 3}};
+  for (auto& s : sizes) {
+    Batch a = random_batch(10, s[0], s[1]);
+    Batch b = random_batch(10, s[1], s[2]);
+    Batch c(10, s[0], s[2]);
+    batch_product(a, b, c);
+    check_products(a, b, c);
+
+    c = 0.0;
+    batch_product(par.with_threshold(1).with_grain(3), a, b, c);
+    check_products(a, b, c);
+  }
+
+  // The product accumulates.
+  Batch a = random_batch(3, 4, 4);
+  Batch b = random_batch(3, 4, 4);
+  Batch c(3, 4, 4);
+  c = 1.0;
+  batch_product(a, b, c);
+  c -= 1.0;
+  check_products(a, b, c);
+}
+
+void test_strided()
+{
+  // Every other column of each matrix in the batch.
+  Batch a = random_batch(6, 4, 8);
+  Batch b = random_batch(6, 4, 3);
+  Batch c(6, 4, 3);
+  matrix_ref<const double, 3> s = a(slice::all, slice::all, slice(0, 4, 2));
+  batch_product(s, b, c);
+  for (size_t k = 0; k < 6; ++k) {
+    Mat r(4, 3);
+    matrix_product(s[k], b[k], r);
+    assert(max_error(c[k], r) < 1e-12);
+  }
+
+  // Items large enough to be packed by the gemm kernel.
+  Batch x = random_batch(2, 40, 80);
+  Batch y = random_batch(2, 40, 40);
+  Batch z(2, 40, 40);
+  matrix_ref<const double, 3> t = x(slice::all, slice::all, slice(0, 40, 2));
+  batch_product(t, y, z);
+  for (size_t k = 0; k < 2; ++k) {
+    Mat r(40, 40);
+    matrix_product(t[k], y[k], r);
+    assert(max_error(z[k], r) < 1e-12);
+  }
+}
+
+void test_ranges()
+{
+  Batch a = random_batch(5, 6, 6);
+  Batch b = random_batch(5, 6, 6);
+  Batch c(5, 6, 6);
+  vector<matrix_ref<const double, 2>> as, bs;
+  vector<matrix_ref<double, 2>> cs;
+  for (size_t k = 0; k < 5; ++k) {
+    as.push_back(a[k]);
+    bs.push_back(b[k]);
+    cs.push_back(c[k]);
+  }
+  batch_product(as, bs, cs);
+  check_products(a, b, c);
+
+  c = 0.0;
+  batch_product(par.with_threshold(1), as, bs, cs);
+  check_products(a, b, c);
+
+  // Vectors of matrices, including transposed operands.
+  vector<Mat> ms(3, Mat(4, 4)), ns(3, Mat(4, 4)), os(3, Mat(4, 4));
+  for (size_t k = 0; k < 3; ++k) {
+    iota(ms[k].begin(), ms[k].end(), k);
+    iota(ns[k].begin(), ns[k].end(), -2.0 * k);
+  }
+  vector<matrix_ref<const double, 2>> ts;
+  for (auto& n : ns)
+    ts.push_back(transposed(n));
+  batch_product(ms, ts, os);
+  for (size_t k = 0; k < 3; ++k)
+    assert(os[k] == ms[k] * transposed(ns[k]));
+}
+
+void bench(size_t n, size_t k)
+{
+  Batch a = random_batch(k, n, n);
+  Batch b = random_batch(k, n, n);
+  Batch c1(k, n, n), c2(k, n, n), c3(k, n, n);
+
+  double loop = time_it([&]() {
+    for (size_t i = 0; i < k; ++i)
+      c1[i] = a[i] * b[i];
+  });
+  double batched = time_it([&]() { batch_product(a, b, c2); });
+  double parallel = time_it([&]() { batch_product(par, a, b, c3); });
+  cout << "batch " << k << " x " << n << "x" << n
+       << ": operator* " << loop << "ms"
+       << ", batched " << batched << "ms (" << loop / batched << "x)"
+       << ", parallel " << parallel << "ms (" << loop / parallel << "x)"
+       << ", difference " << max(max_error(c1, c2), max_error(c1, c3)) << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+  test_batch();
+  test_strided();
+  test_ranges();
+
+  for (int i = 1; i + 1 < argc; i += 2)
+    bench(strtoul(argv[i], nullptr, 10), strtoul(argv[i + 1], nullptr, 10));
+}
@@ -0,0 +1,164 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for the in-place operations. For each order n given on the command
+// line, the benchmark compares an update written as an expression (which
+// creates a temporary) with axpy, and the product c = 2 * a * b + c written
+// with operator* with gemm.
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+// Returns the product of the matrix a and the vector x.
+template <typename M>
+  Vec multiply(const M& a, const Vec& x)
+  {
+    Vec r(rows(a));
+    for (size_t i = 0; i < rows(a); ++i)
+      for (size_t j = 0; j < cols(a); ++j)
+        r(i) += a(i, j) * x(j);
+    return r;
+  }
+
+void test_axpy()
+{
+  Vec x {1.0, 2.0, 3.0};
+  Vec y {1.0, 1.0, 1.0};
+  axpy(2, x, y);
+  assert(y == (Vec {3.0, 5.0, 7.0}));
+  scal(0.5, y);
+  assert(y == (Vec {1.5, 2.5, 3.5}));
+
+  // Strided vectors and matrices.
+  Mat m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  auto c = m.col(1);
+  axpy(-1.0, x(slice(0, 2)), c);
+  assert(m == (Mat {{1, 1, 3}, {4, 3, 6}}));
+
+  Mat n = m;
+  auto t = transposed(n);
+  axpy(1.0, transposed(m), t);
+  assert(n == m * 2.0);
+}
+
+void test_gemv()
+{
+  Mat a = random_matrix(7, 5);
+  Vec x = random_vector(5);
+  Vec y = random_vector(7);
+
+  // y = 2 a x + 3 y.
+  Vec r = multiply(a, x) * 2.0 + y * 3.0;
+  gemv(2.0, a, x, 3.0, y);
+  assert(max_error(y, r) < 1e-12);
+
+  // With beta == 0, y is not read.
+  y = NAN;
+  gemv(1.0, a, x, 0.0, y);
+  assert(max_error(y, multiply(a, x)) < 1e-12);
+
+  // The transposed product updates y by columns of a.
+  Vec z(5);
+  Vec w = random_vector(7);
+  gemv(1.0, transposed(a), w, 0.0, z);
+  assert(max_error(z, multiply(transposed(a), w)) < 1e-12);
+}
+
+void test_gemm()
+{
+  // Direct and packed products, with strided and transposed operands.
+  size_t sizes[][3] = {{3, 4, 5}, {40, 50, 60}, {70, 3, 90}};
+  for (auto& s : sizes) {
+    Mat a = random_matrix(s[0], s[1]);
+    Mat b = random_matrix(s[1], s[2]);
+    Mat c = random_matrix(s[0], s[2]);
+    Mat r = a * b * 2.0 + c * -1.0;
+    gemm(2.0, a, b, -1.0, c);
+    assert(max_error(c, r) < 1e-12);
+
+    Mat at = transpose(a);
+    Mat bt = transpose(b);
+    c = NAN;
+    gemm(1.0, transposed(at), transposed(bt), 0.0, c);
+    assert(max_error(c, a * b) < 1e-12);
+
+    // The result is a transposed view.
+    Mat ct(s[2], s[0]);
+    auto v = transposed(ct);
+    gemm(1.0, a, b, 0.0, v);
+    assert(max_error(v, a * b) < 1e-12);
+  }
+
+  // The result is a submatrix.
+  Mat a = random_matrix(4, 4);
+  Mat c(6, 6);
+  c = 1.0;
+  auto v = c(slice(1, 4), slice(2, 4));
+  gemm(1.0, a, a, 1.0, v);
+  Mat r = a * a + 1.0;
+  assert(max_error(v, r) < 1e-12);
+  assert(c(0, 0) == 1 && c(5, 5) == 1 && c(1, 1) == 1);
+
+  // Fixed matrices.
+  fixed_matrix<double, 2, 2> f {{1, 2}, {3, 4}};
+  fixed_matrix<double, 2, 2> g;
+  gemm(1.0, f, f, 0.0, g);
+  assert(g == (Mat {{7, 10}, {15, 22}}));
+}
+
+void bench(size_t n)
+{
+  const size_t reps = 1000;
+  Vec x = random_vector(n * n);
+  Vec y1 = random_vector(n * n);
+  Vec y2 = y1;
+  double expr = time_it([&]() {
+    for (size_t i = 0; i < reps; ++i)
+      y1 = y1 + x * 1e-3;
+  });
+  double fused = time_it([&]() {
+    for (size_t i = 0; i < reps; ++i)
+      axpy(1e-3, x, y2);
+  });
+  cout << "axpy " << n * n << " x " << reps << ": expression " << expr << "ms"
+       << ", axpy " << fused << "ms (" << expr / fused << "x)"
+       << ", difference " << max_error(y1, y2) << '\n';
+
+  Mat a = random_matrix(n, n);
+  Mat b = random_matrix(n, n);
+  Mat c1 = random_matrix(n, n);
+  Mat c2 = c1;
+  double prod = time_it([&]() { c1 = a * b * 2.0 + c1; });
+  double gm = time_it([&]() { gemm(2.0, a, b, 1.0, c2); });
+  cout << "gemm " << n << ": operator* " << prod << "ms"
+       << ", gemm " << gm << "ms (" << prod / gm << "x)"
+       << ", difference " << max_error(c1, c2) << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+  test_axpy();
+  test_gemv();
+  test_gemm();
+
+  run_benchmarks(argc, argv, bench);
+}
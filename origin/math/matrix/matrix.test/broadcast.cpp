@@ -0,0 +1,262 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for broadcasting. For each order n given on the command line, the
+// benchmark compares adding a vector to each row of a matrix by first
+// copying the vector into a full matrix with the expression m + v and the
+// assignment m += v.
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+void test_expressions()
+{
+  Mat m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  Vec v {10.0, 20.0, 30.0};
+  Mat c {
+    {1},
+    {2}
+  };
+
+  Mat r = m + v;
+  assert(r == (Mat {{11, 22, 33}, {14, 25, 36}}));
+  r = v + m;
+  assert(r == (Mat {{11, 22, 33}, {14, 25, 36}}));
+  r = m - c;
+  assert(r == (Mat {{0, 1, 2}, {2, 3, 4}}));
+
+  // Broadcasting both operands.
+  Mat o = c + v;
+  assert(o == (Mat {{11, 21, 31}, {12, 22, 32}}));
+
+  // Strided operands and nested expressions.
+  r = m(slice::all, slice(0, 2)) + v(slice(1, 2)) + 1.0;
+  assert(r == (Mat {{22, 33}, {25, 36}}));
+  r = (m + v) - c;
+  assert(r == (Mat {{10, 21, 32}, {12, 23, 34}}));
+
+  // Broadcasting subexpressions.
+  r = (c + c) + m;
+  assert(r == (Mat {{3, 4, 5}, {8, 9, 10}}));
+  assert(((c + c) + m)(1, 2) == 10);
+  Mat row {
+    {10, 20, 30}
+  };
+  auto e = (c * 2.0) + (row - 1.0);
+  assert(e.rows() == 2 && e.cols() == 3);
+  assert(!e.contiguous());
+  assert(e == (Mat {{11, 21, 31}, {13, 23, 33}}));
+  assert(e(1, 0) == 13);
+  r = m(slice::all, slice(1, 2)) - (c + 1.0);
+  assert(r == (Mat {{0, 1}, {2, 3}}));
+
+  // The storage of an operand that is broadcast is not reused.
+  Mat t = c;
+  r = std::move(t) + m;
+  assert(r == (Mat {{2, 3, 4}, {6, 7, 8}}));
+}
+
+void test_3d()
+{
+  matrix<int, 3> m(2, 3, 4);
+  iota(m.begin(), m.end(), 0);
+  matrix<int, 1> v(4);
+  iota(v.begin(), v.end(), 100);
+  matrix<int, 3> d(2, 1, 4);
+  iota(d.begin(), d.end(), 1000);
+
+  matrix<int, 3> r = m + v;
+  matrix<int, 3> s = m - d;
+  for (size_t i = 0; i < 2; ++i) {
+    for (size_t j = 0; j < 3; ++j) {
+      for (size_t k = 0; k < 4; ++k) {
+        assert(r(i, j, k) == m(i, j, k) + v(k));
+        assert(s(i, j, k) == m(i, j, k) - d(i, 0, k));
+      }
+    }
+  }
+}
+
+void test_assignment()
+{
+  Mat m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  Vec v {10.0, 20.0, 30.0};
+  m += v;
+  assert(m == (Mat {{11, 22, 33}, {14, 25, 36}}));
+
+  auto r = m(slice::all, slice(1, 2));
+  Mat c {
+    {1},
+    {2}
+  };
+  r -= c;
+  assert(m == (Mat {{11, 21, 32}, {14, 23, 34}}));
+
+  // Operands that alias the assigned elements are copied first.
+  Mat a3 {
+    {1, 2},
+    {3, 4},
+    {5, 6}
+  };
+  Mat b3 = a3;
+  Mat s3 = a3;
+  a3 += a3.row(0);
+  assert(a3 == (Mat {{2, 4}, {4, 6}, {6, 8}}));
+  b3 = b3 + b3.row(0);
+  assert(b3 == (Mat {{2, 4}, {4, 6}, {6, 8}}));
+  auto t3 = s3(slice(1, 2), slice::all);
+  t3 -= s3(slice(1, 1), slice::all);
+  assert(s3 == (Mat {{1, 2}, {0, 0}, {2, 2}}));
+  s3 += s3(slice::all, slice(1, 1));
+  assert(s3 == (Mat {{3, 4}, {0, 0}, {4, 4}}));
+
+  // Parallel assignment.
+  Mat a = random_matrix(50, 40);
+  Mat b(50, 40);
+  Vec w = a.row(0);
+  assign(par.with_threshold(1), b, a + w);
+  Mat e = a + w;
+  assert(max_error(b, e) == 0);
+
+  // Parallel assignment of a subexpression broadcast along the rows.
+  thread_pool pool(3);
+  Mat f = a(slice(0, 1), slice::all);
+  assign(par.on(pool).with_threshold(1).with_grain(1), b, (f * 2.0) + a);
+  e = (f * 2.0) + a;
+  assert(max_error(b, e) == 0);
+  assert(b(49, 3) == 2 * a(0, 3) + a(49, 3));
+}
+
+void test_elementwise()
+{
+  Mat m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  Mat c {
+    {2},
+    {3}
+  };
+  Vec v {1.0, 0.0, -1.0};
+  Mat r(2, 3);
+  hadamard_product(m, c, r);
+  assert(r == (Mat {{2, 4, 6}, {12, 15, 18}}));
+  hadamard_product(v, m, r);
+  assert(r == (Mat {{1, 0, -3}, {4, 0, -6}}));
+  add(c, v, r);
+  assert(r == (Mat {{3, 2, 1}, {4, 3, 2}}));
+  sub(m, v, r);
+  assert(r == (Mat {{0, 2, 4}, {3, 5, 7}}));
+  scale(v, 2.0, r);
+  assert(r == (Mat {{2, 0, -2}, {2, 0, -2}}));
+
+  // Parallel hadamard products.
+  thread_pool pool(3);
+  auto p = par.on(pool).with_threshold(1).with_grain(1);
+  hadamard_product(p, m, c, r);
+  assert(r == (Mat {{2, 4, 6}, {12, 15, 18}}));
+  hadamard_product(p, v, m, r);
+  assert(r == (Mat {{1, 0, -3}, {4, 0, -6}}));
+  Mat a = random_matrix(50, 40);
+  Mat h(50, 40), hs(50, 40);
+  Vec w = a.row(1);
+  hadamard_product(p, a, w, h);
+  hadamard_product(a, w, hs);
+  assert(h == hs);
+
+  // Operands that alias the output are copied first.
+  Mat s {
+    {1, 2},
+    {3, 4},
+    {5, 6}
+  };
+  Mat s1 = s, s2 = s, s3 = s, s4 = s;
+  sub(s1, s1.row(0), s1);
+  assert(s1 == (Mat {{0, 0}, {2, 2}, {4, 4}}));
+  add(s2(slice::all, slice(1, 1)), s2, s2);
+  assert(s2 == (Mat {{3, 4}, {7, 8}, {11, 12}}));
+  hadamard_product(s3, s3.row(2), s3);
+  assert(s3 == (Mat {{5, 12}, {15, 24}, {25, 36}}));
+  hadamard_product(p, s4, s4.row(2), s4);
+  assert(s4 == (Mat {{5, 12}, {15, 24}, {25, 36}}));
+  Mat g = random_matrix(50, 40);
+  Mat gs = g, gp = g;
+  hadamard_product(gs, gs.row(7), gs);
+  hadamard_product(p, gp.row(7), gp, gp);
+  assert(gp == gs);
+  scale(s.row(1), 2.0, s);
+  assert(s == (Mat {{6, 8}, {6, 8}, {6, 8}}));
+
+  // A broadcast view repeats elements with a stride of 0.
+  auto b = broadcast(c, m);
+  assert(b.rows() == 2 && b.cols() == 3);
+  assert(b(0, 2) == 2 && b(1, 0) == 3);
+  assert(&b(1, 0) == &b(1, 2));
+}
+
+void bench(size_t n)
+{
+  const size_t reps = 100;
+  Mat m = random_matrix(n, n);
+  Vec v = m.row(0);
+
+  // Copy v into each row of a full matrix, then add.
+  Mat r1 = m;
+  double copy = time_it([&]() {
+    for (size_t i = 0; i < reps; ++i) {
+      Mat t(n, n);
+      for (size_t j = 0; j < n; ++j)
+        t.row(j) = v;
+      r1 = r1 + t;
+    }
+  });
+
+  Mat r2 = m;
+  double expr = time_it([&]() {
+    for (size_t i = 0; i < reps; ++i)
+      r2 = r2 + v;
+  });
+
+  Mat r3 = m;
+  double assign = time_it([&]() {
+    for (size_t i = 0; i < reps; ++i)
+      r3 += v;
+  });
+
+  cout << "broadcast " << n << " x " << reps << ": copied " << copy << "ms"
+       << ", expression " << expr << "ms (" << copy / expr << "x)"
+       << ", assignment " << assign << "ms (" << copy / assign << "x)"
+       << ", difference " << max(max_error(r1, r2), max_error(r1, r3)) << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+  test_expressions();
+  test_3d();
+  test_assignment();
+  test_elementwise();
+
+  run_benchmarks(argc, argv, bench);
+}
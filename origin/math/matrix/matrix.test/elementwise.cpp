@@ -0,0 +1,144 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for the elementwise operations with output arguments. For each
+// order n given on the command line, the benchmark compares a loop that
+// creates a matrix for each evaluated expression with loops that reuse
+// storage, either by moving the previous result into the expression or by
+// computing into an existing matrix.
+
+using Mat = matrix<double, 2>;
+
+void test_contiguous()
+{
+  Mat a {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  Mat b {
+    {6, 5, 4},
+    {3, 2, 1}
+  };
+  Mat r(2, 3);
+  add(a, b, r);
+  assert(r == eval(a + b));
+  sub(a, b, r);
+  assert(r == eval(a - b));
+  scale(a, 3.0, r);
+  assert(r == eval(a * 3.0));
+
+  // The output may be an operand.
+  add(r, b, r);
+  assert(r == eval(a * 3.0 + b));
+  sub(a, r, r);
+  assert(r == eval(a - (a * 3.0 + b)));
+
+  // Types without vectorized kernels.
+  matrix<short, 1> x(3);
+  iota(x.begin(), x.end(), 1);
+  matrix<short, 1> y(3);
+  scale(x, short(2), y);
+  assert(y(0) == 2 && y(1) == 4 && y(2) == 6);
+}
+
+void test_strided()
+{
+  Mat m {
+    {1, 2, 3, 4},
+    {5, 6, 7, 8}
+  };
+  auto c = m(slice::all, slice(0, 2, 2));
+  auto d = m(slice::all, slice(1, 2, 2));
+  Mat r(2, 2);
+  add(c, d, r);
+  assert(r == (Mat {{3, 7}, {11, 15}}));
+
+  // Strided output.
+  Mat n(2, 4);
+  auto o = n(slice::all, slice(1, 2, 2));
+  scale(c, -1.0, o);
+  assert(n == (Mat {{0, -1, 0, -3}, {0, -5, 0, -7}}));
+  sub(o, r, o);
+  assert(n(1, 3) == -7 - 15);
+
+  // Operands that overlap the output through a different slice.
+  Mat q {
+    {1, 2},
+    {3, 4}
+  };
+  Mat q1 = q, q2 = q;
+  add(transposed(q1), q1, q1);
+  assert(q1 == (Mat {{2, 5}, {5, 8}}));
+  hadamard_product(q2, transposed(q2), q2);
+  assert(q2 == (Mat {{1, 6}, {6, 16}}));
+  Mat k {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  auto k1 = k(slice::all, slice(1, 2));
+  sub(k(slice::all, slice(0, 2)), k1, k1);
+  assert(k == (Mat {{1, -1, -1}, {4, -1, -1}}));
+}
+
+void bench(size_t n)
+{
+  const size_t reps = 100;
+  Mat a = random_matrix(n, n);
+  Mat b = random_matrix(n, n);
+
+  // Each iteration computes a new matrix, then replaces the old one.
+  Mat r1 = a;
+  double copy = time_it([&]() {
+    for (size_t i = 0; i < reps; ++i) {
+      Mat t = r1 * 0.5 + b;
+      r1 = t - a;
+    }
+  });
+
+  // Each result reuses the storage of the previous one.
+  Mat r2 = a;
+  double moved = time_it([&]() {
+    for (size_t i = 0; i < reps; ++i) {
+      Mat t = std::move(r2) * 0.5 + b;
+      r2 = std::move(t) - a;
+    }
+  });
+
+  // Each result is computed into the same matrix.
+  Mat r3 = a;
+  double out = time_it([&]() {
+    for (size_t i = 0; i < reps; ++i) {
+      scale(r3, 0.5, r3);
+      add(r3, b, r3);
+      sub(r3, a, r3);
+    }
+  });
+
+  cout << "elementwise " << n << " x " << reps << ": temporaries " << copy << "ms"
+       << ", moved " << moved << "ms (" << copy / moved << "x)"
+       << ", output " << out << "ms (" << copy / out << "x)"
+       << ", difference " << max(max_error(r1, r2), max_error(r1, r3)) << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+  test_contiguous();
+  test_strided();
+
+  run_benchmarks(argc, argv, bench);
+}
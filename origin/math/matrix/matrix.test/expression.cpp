@@ -0,0 +1,199 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+matrix<int, 2> a {
+  {1, 2, 3},
+  {4, 5, 6}
+};
+
+matrix<int, 2> b {
+  {6, 5, 4},
+  {3, 2, 1}
+};
+
+matrix<int, 2> c {
+  {1, 1, 1},
+  {2, 2, 2}
+};
+
+// The result of a + b * 2 - c, computed elementwise.
+template <typename M1, typename M2, typename M3>
+  matrix<int, 2>
+  expected(const M1& x, const M2& y, const M3& z)
+  {
+    matrix<int, 2> r(x.rows(), x.cols());
+    for (size_t i = 0; i < r.rows(); ++i)
+      for (size_t j = 0; j < r.cols(); ++j)
+        r(i, j) = x(i, j) + y(i, j) * 2 - z(i, j);
+    return r;
+  }
+
+// Operators on matrices build expressions, which are evaluated when they are
+// assigned.
+void test_matrix()
+{
+  auto e = a + b * 2 - c;
+  static_assert(decltype(e)::order == 2, "");
+  assert(e.rows() == 2 && e.cols() == 3);
+  assert(e(1, 2) == 6 + 2 - 2);
+
+  matrix<int, 2> r = e;
+  assert(r == expected(a, b, c));
+  assert(e == expected(a, b, c));
+
+  // Assignment to a matrix with the same extents evaluates in place.
+  r = a - b;
+  assert(r(0, 0) == -5 && r(1, 2) == 5);
+
+  // Assignment to a matrix with different extents replaces it.
+  matrix<int, 2> s(5, 5);
+  s = 2 * a + 1;
+  assert(s.rows() == 2 && s.cols() == 3);
+  assert(s(1, 1) == 11);
+
+  // Scalar operations.
+  matrix<int, 2> t = (a + 10) / 2 % 4;
+  assert(t(0, 0) == 1 && t(1, 2) == 0);
+
+  // Evaluating an expression with eval.
+  assert(eval(a + b)(0, 0) == 7);
+}
+
+// Expressions over temporary matrices own their operands.
+void test_rvalue()
+{
+  auto e = matrix<int, 2>(a) + a;
+  matrix<int, 2> r = e;
+  assert(r(1, 2) == 12);
+
+  // Evaluating a temporary expression reuses the storage of a temporary
+  // operand, even when it is nested in a subexpression.
+  matrix<int, 2> m = a;
+  const int* p = m.data();
+  matrix<int, 2> s = b + std::move(m) * 2;
+  assert(s.data() == p);
+  assert(s == eval(b + a * 2));
+
+  // The same applies to assignment when the extents differ.
+  matrix<int, 2> t(4, 4);
+  t = c - std::move(s);
+  assert(t.data() == p);
+  assert(t == eval(c - b - a * 2));
+
+  // A matrix moved into an expression assigned to it keeps its storage.
+  matrix<int, 2> u = a;
+  p = u.data();
+  u = std::move(u) + 1;
+  assert(u.data() == p);
+  assert(u == eval(a + 1));
+}
+
+// Expressions over matrix_refs, including strided ones.
+void test_ref()
+{
+  matrix<int, 2> m {
+    {1, 2, 3, 4, 5, 6},
+    {7, 8, 9, 10, 11, 12}
+  };
+
+  // Contiguous and strided refs.
+  auto x = m(slice::all, slice(0, 3));
+  auto y = m(slice::all, slice(0, 3, 2));
+  matrix_ref<const int, 2> z = c;
+
+  matrix<int, 2> r = x + y * 2 - z;
+  assert(r == expected(x, y, z));
+
+  // Mixed matrix and matrix_ref operands.
+  r = a + y;
+  assert(r(1, 2) == 6 + 11);
+
+  // Assignment into a contiguous matrix_ref.
+  matrix<int, 2> u(2, 6);
+  u(slice::all, slice(0, 3)) = a + b * 2 - c;
+  assert(u(slice::all, slice(0, 3)) == expected(a, b, c));
+  assert(u(0, 3) == 0);
+
+  // Assignment into a strided matrix_ref.
+  matrix<int, 2> v(2, 6);
+  v(slice::all, slice(1, 3, 2)) = x + y * 2 - z;
+  assert(v(slice::all, slice(1, 3, 2)) == expected(x, y, z));
+  assert(v(0, 0) == 0 && v(1, 2) == 0);
+}
+
+// Operands that overlap the result through a different slice are read before
+// any element of the result is written.
+void test_aliasing()
+{
+  matrix<double, 2> c {
+    {1, 2},
+    {3, 4},
+    {5, 6}
+  };
+  c(slice(1, 2), slice::all) = c(slice(0, 2), slice::all) * 2.0;
+  assert(c == (matrix<double, 2> {{1, 2}, {2, 4}, {6, 8}}));
+
+  // The same view, or the matrix itself, is computed in place.
+  c(slice(1, 2), slice::all) = c(slice(1, 2), slice::all) + 1.0;
+  assert(c == (matrix<double, 2> {{1, 2}, {3, 5}, {7, 9}}));
+  c = c * 2.0 - c;
+  assert(c == (matrix<double, 2> {{1, 2}, {3, 5}, {7, 9}}));
+
+  // Assigning to a matrix.
+  matrix<int, 2> m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  matrix<int, 2> r = m;
+  m = m(slice::all, slice(0, 3)) + r(slice::all, slice(0, 3));
+  assert(m == 2 * r);
+  m = r;
+  m(slice::all, slice(1, 2)) = m(slice::all, slice(0, 2)) + 0;
+  assert(m == (matrix<int, 2> {{1, 1, 2}, {4, 4, 5}}));
+
+  // Parallel assignment.
+  thread_pool pool(2);
+  auto p = par.on(pool).with_threshold(1).with_grain(1);
+  matrix<double, 2> d {
+    {1, 2},
+    {3, 4},
+    {5, 6}
+  };
+  assign(p, d(slice(1, 2), slice::all), d(slice(0, 2), slice::all) * 2.0);
+  assert(d == (matrix<double, 2> {{1, 2}, {2, 4}, {6, 8}}));
+}
+
+// Products evaluate their expression operands.
+void test_product()
+{
+  matrix<int, 2> i {
+    {1, 0, 0},
+    {0, 1, 0},
+    {0, 0, 1}
+  };
+  matrix<int, 2> r = (a + b) * i;
+  assert(r == eval(a + b));
+  r = a * (i + i);
+  assert(r == eval(a * 2));
+}
+
+int main()
+{
+  test_matrix();
+  test_rvalue();
+  test_ref();
+  test_aliasing();
+  test_product();
+}
@@ -0,0 +1,169 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for fixed matrices. For each count n given on the command line, the
+// benchmark compares n products of 4x4 fixed matrices with n products of
+// 4x4 matrices.
+
+using Mat4 = fixed_matrix<double, 4, 4>;
+using Vec4 = fixed_matrix<double, 4>;
+
+void test_basic()
+{
+  static_assert(Mat4::order == 2, "");
+  static_assert(Mat4::size() == 16, "");
+  static_assert(Mat4::extent(1) == 4, "");
+  static_assert(sizeof(Mat4) == 16 * sizeof(double), "");
+  static_assert(matrix_impl::fixed_offset<2, 3, 4>::get(1, 2, 3) == 23, "");
+
+  fixed_matrix<int, 2, 3> m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  assert(m.rows() == 2 && m.cols() == 3);
+  assert(m(0, 0) == 1 && m(1, 2) == 6);
+  assert(m.descriptor().strides[0] == 3);
+
+  fixed_matrix<int, 2, 3> z;
+  assert(z(1, 1) == 0);
+
+  // Rows, columns and slices are matrix_refs.
+  assert(m[1](0) == 4);
+  assert(m.col(2)(1) == 6);
+  matrix_ref<int, 2> r = m(slice(0, 2), slice(1, 2));
+  r(1, 1) = 60;
+  assert(m(1, 2) == 60);
+
+  // Scalar arithmetic.
+  m *= 2;
+  m += 1;
+  assert(m(0, 0) == 3 && m(1, 2) == 121);
+
+  ostringstream ss;
+  ss << fixed_matrix<int, 2, 2> {{1, 2}, {3, 4}};
+  assert(ss.str() == "[[1,2],[3,4]]");
+
+  // 3D fixed matrices.
+  fixed_matrix<int, 2, 2, 2> c;
+  iota(c.begin(), c.end(), 0);
+  assert(c(1, 0, 1) == 5);
+  assert(c[1](1, 1) == 7);
+}
+
+void test_interop()
+{
+  fixed_matrix<double, 2, 2> a {
+    {1, 2},
+    {3, 4}
+  };
+  matrix<double, 2> m {
+    {5, 6},
+    {7, 8}
+  };
+
+  // Expressions mix fixed and dynamic operands.
+  fixed_matrix<double, 2, 2> s = a + m;
+  assert(s(0, 0) == 6 && s(1, 1) == 12);
+  matrix<double, 2> t = a * 2.0 - m;
+  assert(t(0, 0) == -3 && t(1, 1) == 0);
+  s = a;
+  s += m;
+  assert(s == a + m);
+
+  // Conversions.
+  matrix<double, 2> b = a;
+  assert(b == a);
+  fixed_matrix<double, 2, 2> c = m;
+  assert(c == m);
+  matrix_ref<const double, 2> r = a;
+  assert(r(1, 0) == 3);
+
+  // Products with dynamic matrices.
+  matrix<double, 2> p = a * m;
+  assert(p == (matrix<double, 2> {{19, 22}, {43, 50}}));
+  assert(m * a == (matrix<double, 2> {{23, 34}, {31, 46}}));
+
+  // Views and expressions that overlap the matrix are copied first.
+  fixed_matrix<double, 2, 2> f = a;
+  f = transposed(f.ref());
+  assert(f == (matrix<double, 2> {{1, 3}, {2, 4}}));
+  f = transposed(f.ref()) + 1.0;
+  assert(f == (matrix<double, 2> {{2, 3}, {4, 5}}));
+}
+
+void test_product()
+{
+  Mat4 a, b;
+  iota(a.begin(), a.end(), 1);
+  iota(b.begin(), b.end(), -8);
+  Mat4 c = a * b;
+
+  matrix<double, 2> da = a;
+  matrix<double, 2> db = b;
+  assert(c == da * db);
+
+  Vec4 x {1.0, 2.0, 3.0, 4.0};
+  Vec4 y = a * x;
+  assert(y(0) == 30 && y(3) == 150);
+
+  // A non-square product.
+  fixed_matrix<int, 2, 3> d {{1, 2, 3}, {4, 5, 6}};
+  fixed_matrix<int, 3, 1> e {{1}, {1}, {1}};
+  fixed_matrix<int, 2, 1> f = d * e;
+  assert(f(0, 0) == 6 && f(1, 0) == 15);
+
+  // A product that is too large to unroll.
+  fixed_matrix<double, 10, 10> g;
+  iota(g.begin(), g.end(), 0);
+  matrix<double, 2> dg = g;
+  assert(g * g == dg * dg);
+}
+
+void bench(size_t n)
+{
+  Mat4 a, b;
+  iota(a.begin(), a.end(), 0);
+  b = 0.0;
+  for (size_t i = 0; i < 4; ++i)
+    b(i, i) = 1;
+  matrix<double, 2> da = a;
+  matrix<double, 2> db = b;
+
+  double fixed = time_it([&]() {
+    for (size_t i = 0; i < n; ++i)
+      a = a * b;
+  });
+  double dynamic = time_it([&]() {
+    for (size_t i = 0; i < n; ++i)
+      da = da * db;
+  });
+  assert(a == da);
+  cout << "product 4x4 (" << n << " times): fixed " << fixed << "ms"
+       << ", matrix " << dynamic << "ms"
+       << " (" << dynamic / fixed << "x)\n";
+}
+
+int main(int argc, char* argv[])
+{
+  test_basic();
+  test_interop();
+  test_product();
+
+  run_benchmarks(argc, argv, bench);
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <iterator>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Returns a 4x5 matrix whose elements are numbered in row-major order.
+matrix<int, 2>
+make_matrix()
+{
+  matrix<int, 2> m(4, 5);
+  iota(m.begin(), m.end(), 0);
+  return m;
+}
+
+void test_random_access()
+{
+  using Iter = matrix_ref<int, 2>::iterator;
+  using Cat = iterator_traits<Iter>::iterator_category;
+  static_assert(Same<Cat, random_access_iterator_tag>(), "");
+
+  matrix<int, 2> m = make_matrix();
+  matrix_ref<int, 2> r = m(slice(1, 3), slice(1, 3));  // 3x3, rows 1..3
+
+  auto first = r.begin();
+  auto last = r.end();
+  assert(last - first == 9);
+  assert(distance(first, last) == 9);
+
+  // Random access agrees with incrementing.
+  auto i = first;
+  for (ptrdiff_t n = 0; n < 9; ++n, ++i) {
+    assert(first + n == i);
+    assert(first[n] == *i);
+    assert(i - first == n);
+    assert(&*(last - (9 - n)) == &*i);
+  }
+  assert(i == last);
+  assert(first < last && last > first && first <= first && last >= first);
+
+  // Decrementing visits the elements in reverse order.
+  assert(*--i == m(3, 3));
+  assert(*--i == m(3, 2));
+  assert(*--i == m(3, 1));
+  assert(*--i == m(2, 3));
+
+  // Reverse iteration.
+  vector<int> v(r.begin(), r.end());
+  vector<int> w(reverse_iterator<Iter>(r.end()), reverse_iterator<Iter>(r.begin()));
+  assert(equal(v.begin(), v.end(), w.rbegin()));
+}
+
+void test_sort()
+{
+  // Sort the elements of a column view. Only the column is affected.
+  matrix<int, 2> m = make_matrix();
+  matrix_ref<int, 2> c = m(slice::all, slice(2, 1));
+  sort(c.begin(), c.end(), greater<int>());
+  assert(m(0, 2) == 17 && m(1, 2) == 12 && m(2, 2) == 7 && m(3, 2) == 2);
+  assert(m(0, 1) == 1 && m(3, 3) == 18);
+
+  // Binary search in a strided view.
+  matrix_ref<int, 2> s = m(slice(0, 4), slice(0, 2));
+  sort(s.begin(), s.end());
+  assert(is_sorted(s.begin(), s.end()));
+  assert(binary_search(s.begin(), s.end(), 15));
+}
+
+void test_row_chunks()
+{
+  matrix<int, 2> m = make_matrix();
+
+  // A matrix is a single chunk.
+  int k = 0;
+  for (auto c : row_chunks(m)) {
+    assert(c.size() == 20);
+    ++k;
+  }
+  assert(k == 1);
+
+  // A block of columns has one chunk per row.
+  matrix_ref<int, 2> r = m(slice::all, slice(1, 3));
+  k = 0;
+  for (auto c : row_chunks(r)) {
+    assert(c.size() == 3);
+    assert(*c.first == m(k, 1));
+    ++k;
+  }
+  assert(k == 4);
+
+  // A column has one chunk per element.
+  const matrix<int, 2>& cm = m;
+  k = 0;
+  for (auto c : row_chunks(cm.col(4))) {
+    assert(c.size() == 1);
+    assert(*c.first == m(k, 4));
+    ++k;
+  }
+  assert(k == 4);
+
+  // Chunks of a 3D block visit the same elements as its slice iterator.
+  matrix<int, 3> t(3, 4, 5);
+  iota(t.begin(), t.end(), 0);
+  auto b = t(slice(1, 2), slice(0, 3), slice(1, 3));
+  auto i = b.begin();
+  k = 0;
+  for (auto c : row_chunks(b)) {
+    assert(c.size() == 3);
+    for (int* p = c.first; p != c.last; ++p, ++i)
+      assert(*p == *i);
+    ++k;
+  }
+  assert(k == 6 && i == b.end());
+
+  // Scalar operations on views whose rows are not contiguous.
+  auto e = t(slice::all, slice::all, slice(0, 3, 2));
+  e += 1000;
+  e *= 2;
+  assert(t(2, 3, 0) == 2 * (55 + 1000) && t(2, 3, 2) == 2 * (57 + 1000));
+  assert(t(2, 3, 4) == 2 * (59 + 1000));
+  assert(t(2, 3, 1) == 56 && t(2, 3, 3) == 58);
+  matrix<double, 2> d(3, 3);
+  d = 8.0;
+  d.col(1) /= 4.0;
+  d.col(2) -= 1.0;
+  assert(d(2, 0) == 8 && d(2, 1) == 2 && d(2, 2) == 7);
+
+  // Operations on strided views use the chunks.
+  r *= 2;
+  r += 1;
+  assert(m(0, 0) == 0 && m(0, 1) == 3 && m(2, 3) == 27 && m(3, 4) == 19);
+
+  matrix<int, 2> n(4, 3);
+  n = 1;
+  r = n + n;
+  assert(m(1, 1) == 2 && m(1, 4) == 9);
+}
+
+int main()
+{
+  test_random_access();
+  test_sort();
+  test_row_chunks();
+}
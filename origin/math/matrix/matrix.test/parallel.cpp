@@ -0,0 +1,128 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for the parallel matrix operations. For each order n given on the
+// command line, the benchmark measures the speedup of matrix_product over
+// the sequential version for pools of 1 to the number of hardware threads.
+
+// Use a threshold of 1 and a small grain so that even small problems are
+// split into many tasks.
+void test_product(thread_pool& pool)
+{
+  auto p = par.on(pool).with_threshold(1).with_grain(3);
+  for (size_t n : {1, 7, 33, 100}) {
+    matrix<int, 2> a = random_integer_matrix<int>(n, n + 1);
+    matrix<int, 2> b = random_integer_matrix<int>(n + 1, n + 2);
+    matrix<int, 2> c(n, n + 2);
+    matrix_product(p, a, b, c);
+    assert(c == a * b);
+
+    // Strided operands
+    auto as = a(slice::all, slice(0, (n + 2) / 2, 2));
+    auto bs = b(slice(0, (n + 2) / 2, 2), slice::all);
+    matrix<int, 2> d(n, n + 2);
+    matrix_product(p, as, bs, d);
+    assert(d == as * bs);
+  }
+}
+
+void test_elementwise(thread_pool& pool)
+{
+  auto p = par.on(pool).with_threshold(1).with_grain(2);
+  matrix<double, 2> a = random_integer_matrix<double>(37, 11);
+  matrix<double, 2> b = random_integer_matrix<double>(37, 11);
+
+  // Hadamard product
+  matrix<double, 2> h(37, 11);
+  hadamard_product(p, a, b, h);
+  matrix<double, 2> hs(37, 11);
+  hadamard_product(a, b, hs);
+  assert(h == hs);
+
+  // Expression evaluation into matrices and matrix_refs.
+  matrix<double, 2> r;
+  assign(p, r, a + b * 2.0 - 1.0);
+  assert(r == eval(a + b * 2.0 - 1.0));
+  assert(eval(p, a - b) == eval(a - b));
+
+  matrix<double, 2> s(37, 22);
+  auto odd = s(slice::all, slice(1, 11, 2));
+  assign(p, odd, a + b);
+  assert(odd == eval(a + b));
+  assert(s(5, 0) == 0);
+
+  // The destination may be an operand of the expression.
+  matrix<double, 2> t {
+    {1, 2},
+    {3, 4}
+  };
+  assign(p, t, t + transposed(t));
+  assert(t == (matrix<double, 2> {{2, 5}, {5, 8}}));
+  matrix<double, 2> u {
+    {1, 2, 3}
+  };
+  matrix<double, 2> col {
+    {10},
+    {20}
+  };
+  assign(p, u, u + col);
+  assert(u == (matrix<double, 2> {{11, 12, 13}, {21, 22, 23}}));
+  matrix<double, 2> v = a;
+  assign(p, v, v * 2.0 + b);
+  assert(v == eval(a * 2.0 + b));
+
+  // Apply
+  matrix<double, 2> c = a;
+  c.apply(p, [](double& x) { x *= 3; });
+  assert(c == eval(a * 3.0));
+  c.apply(p, b, [](double& x, double y) { x += y; });
+  assert(c == eval(a * 3.0 + b));
+}
+
+
+// Benchmarks
+
+void bench(size_t n)
+{
+  matrix<double, 2> a = random_integer_matrix<double>(n, n);
+  matrix<double, 2> b = random_integer_matrix<double>(n, n);
+  matrix<double, 2> c(n, n);
+
+  double base = time_it([&]() { matrix_product(a, b, c); });
+  cout << "product " << n << ": sequential " << base << "ms\n";
+
+  size_t max = thread::hardware_concurrency();
+  for (size_t t = 1; t <= max; t *= 2) {
+    thread_pool pool(t - 1);
+    c = 0.0;
+    double time = time_it([&]() { matrix_product(par.on(pool), a, b, c); });
+    cout << "  " << t << " threads " << time << "ms"
+         << " (" << base / time << "x)\n";
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  for (size_t n : {0, 1, 3}) {
+    thread_pool pool(n);
+    test_product(pool);
+    test_elementwise(pool);
+  }
+
+  run_benchmarks(argc, argv, bench);
+}
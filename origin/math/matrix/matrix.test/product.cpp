@@ -0,0 +1,83 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Compute the product using the usual definition.
+template <typename M1, typename M2>
+  matrix<Value_type<M1>, 2>
+  naive_product(const M1& a, const M2& b)
+  {
+    matrix<Value_type<M1>, 2> r(a.rows(), b.cols());
+    for (size_t i = 0; i < a.rows(); ++i)
+      for (size_t j = 0; j < b.cols(); ++j)
+        for (size_t k = 0; k < a.cols(); ++k)
+          r(i, j) += a(i, k) * b(k, j);
+    return r;
+  }
+
+// Check products whose sizes straddle the register tile and cache blocks.
+template <typename T>
+  void test_sizes()
+  {
+    const size_t sizes[] = {1, 3, 4, 7, 17, 64, 129, 300};
+    for (size_t m : sizes) {
+      for (size_t k : {1, 5, 257}) {
+        for (size_t n : {1, 9, 33}) {
+          matrix<T, 2> a = random_integer_matrix<T>(m, k);
+          matrix<T, 2> b = random_integer_matrix<T>(k, n);
+          assert(a * b == naive_product(a, b));
+        }
+      }
+    }
+  }
+
+// Products involving matrix_refs with contiguous rows use the blocked
+// kernel directly; those with strided rows are copied first.
+void test_refs()
+{
+  matrix<double, 2> a = random_integer_matrix<double>(20, 30);
+  matrix<double, 2> b = random_integer_matrix<double>(30, 25);
+
+  // Contiguous rows
+  matrix_ref<double, 2> ra = a(slice(2, 10), slice(3, 15));
+  matrix_ref<double, 2> rb = b(slice(5, 15), slice(1, 20));
+  assert(ra * rb == naive_product(ra, rb));
+  assert(a(slice(0, 10), slice::all) * b == naive_product(a(slice(0, 10), slice::all), b));
+
+  // Strided rows
+  matrix_ref<double, 2> sa = a(slice::all, slice(0, 15, 2));
+  matrix_ref<double, 2> sb = b(slice(0, 15, 2), slice::all);
+  assert(sa * sb == naive_product(sa, sb));
+
+  // Accumulation into a submatrix of a larger matrix.
+  matrix<double, 2> c(40, 40);
+  matrix_ref<double, 2> rc = c(slice(5, 10), slice(7, 20));
+  matrix_product(ra, rb, rc);
+  matrix_product(ra, rb, rc);
+  matrix<double, 2> expect = naive_product(ra, rb);
+  expect *= 2.0;
+  assert(rc == expect);
+  assert(c(0, 0) == 0 && c(4, 7) == 0 && c(15, 27) == 0);
+}
+
+int main()
+{
+  test_sizes<int>();
+  test_sizes<long long>();
+  test_sizes<float>();
+  test_sizes<double>();
+  test_refs();
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for axis reductions. For each order n given on the command line,
+// the benchmark compares column sums computed with slice iterators over
+// each column with sum(m, 0).
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+void test_2d()
+{
+  Mat m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+
+  assert(sum(m, 0) == (Vec {5.0, 7.0, 9.0}));
+  assert(sum(m, 1) == (Vec {6.0, 15.0}));
+  assert(min(m, 0) == (Vec {1.0, 2.0, 3.0}));
+  assert(max(m, 1) == (Vec {3.0, 6.0}));
+  assert(mean(m, 0) == (Vec {2.5, 3.5, 4.5}));
+  assert(mean(m, 1) == (Vec {2.0, 5.0}));
+  assert(variance(m, 0) == (Vec {2.25, 2.25, 2.25}));
+  assert(abs(variance(m, 1)(0) - 2.0 / 3.0) < 1e-15);
+  assert(norm2(m, 0)(2) == sqrt(45.0));
+  assert(norm2(m, 1)(0) == sqrt(14.0));
+
+  // Strided views, including transposed views where axis 0 is contiguous.
+  assert(sum(m(slice::all, slice(0, 2, 2)), 0) == (Vec {5.0, 9.0}));
+  assert(sum(transposed(m), 0) == sum(m, 1));
+  assert(max(transposed(m), 1) == max(m, 0));
+
+  // Fixed matrices.
+  fixed_matrix<int, 2, 2> f {{1, 2}, {3, 4}};
+  assert(sum(f, 0) == (matrix<int, 1> {4, 6}));
+
+  // Reducing an axis of extent 0.
+  Mat z(3, 0);
+  assert(sum(z, 1) == (Vec {0.0, 0.0, 0.0}));
+  assert(sum(transposed(z), 0) == (Vec {0.0, 0.0, 0.0}));
+  assert(sum(z, 0).size() == 0);
+}
+
+// Returns true if the elements of m are the indexes in list.
+bool indexes(const matrix<size_t, 1>& m, initializer_list<size_t> list)
+{
+  return m.size() == list.size() && equal(list.begin(), list.end(), m.begin());
+}
+
+void test_index()
+{
+  Mat m {
+    {3, 1, 4},
+    {1, 5, 9},
+    {2, 6, 5}
+  };
+  assert(indexes(argmax(m, 0), {0, 2, 1}));
+  assert(indexes(argmax(m, 1), {2, 2, 1}));
+  assert(indexes(argmin(m, 0), {1, 0, 0}));
+  assert(indexes(argmin(m, 1), {1, 0, 0}));
+  assert(argmax(transposed(m), 1) == argmax(m, 0));
+  assert(argmin(transposed(m), 0) == argmin(m, 1));
+
+  // Ties select the first index.
+  Mat t {
+    {1, 1},
+    {1, 1}
+  };
+  assert(indexes(argmax(t, 0), {0, 0}));
+  assert(indexes(argmin(t, 1), {0, 0}));
+
+  Mat r = random_matrix(300, 200);
+  auto p = par.with_threshold(1).with_grain(7);
+  assert(argmax(p, r, 0) == argmax(r, 0));
+  assert(argmin(p, r, 1) == argmin(r, 1));
+  matrix<size_t, 1> a = argmax(r, 1);
+  for (size_t i = 0; i < r.rows(); ++i)
+    assert(r(i, a(i)) == max(r, 1)(i));
+}
+
+void test_3d()
+{
+  matrix<int, 3> m(2, 3, 4);
+  iota(m.begin(), m.end(), 0);
+  for (size_t axis = 0; axis < 3; ++axis) {
+    matrix<int, 2> s = sum(m, axis);
+    matrix<int, 2> mx = max(m, axis);
+    for (size_t i = 0; i < s.rows(); ++i) {
+      for (size_t j = 0; j < s.cols(); ++j) {
+        int t = 0, u = -1;
+        for (size_t k = 0; k < m.extent(axis); ++k) {
+          int x = axis == 0 ? m(k, i, j) : axis == 1 ? m(i, k, j) : m(i, j, k);
+          t += x;
+          u = max(u, x);
+        }
+        assert(s(i, j) == t);
+        assert(mx(i, j) == u);
+      }
+    }
+  }
+}
+
+void test_accuracy()
+{
+  // Summing many copies of 0.1 accumulates rounding error in a naive loop.
+  const size_t n = 1 << 20;
+  Mat m(n, 2);
+  m = 0.1;
+  Vec c = sum(m, 0);
+  assert(abs(c(0) - n * 0.1) < 1e-9);
+  Mat t = transpose(m);
+  Vec r = sum(t, 1);
+  assert(abs(r(0) - n * 0.1) < 1e-9);
+}
+
+void test_parallel()
+{
+  Mat m = random_matrix(300, 200);
+  auto p = par.with_threshold(1).with_grain(7);
+  assert(max_error(sum(p, m, 0), sum(m, 0)) == 0);
+  assert(max_error(sum(p, m, 1), sum(m, 1)) == 0);
+  assert(max_error(variance(p, m, 0), variance(m, 0)) == 0);
+  assert(max_error(max(p, m, 1), max(m, 1)) == 0);
+  assert(max_error(norm2(seq, m, 1), norm2(m, 1)) == 0);
+}
+
+void bench(size_t n)
+{
+  Mat m = random_matrix(n, n);
+  Vec v1(n);
+  Vec v2, v3;
+  double naive = time_it([&]() {
+    for (size_t j = 0; j < n; ++j) {
+      auto c = m.col(j);
+      v1(j) = accumulate(c.begin(), c.end(), 0.0);
+    }
+  });
+  double seq = time_it([&]() { v2 = sum(m, 0); });
+  double parallel = time_it([&]() { v3 = sum(par, m, 0); });
+  cout << "column sums " << n << ": slice iterator " << naive << "ms"
+       << ", sum " << seq << "ms (" << naive / seq << "x)"
+       << ", parallel " << parallel << "ms (" << naive / parallel << "x)"
+       << ", difference " << max_error(v1, v2) << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+  test_2d();
+  test_3d();
+  test_index();
+  test_accuracy();
+  test_parallel();
+
+  run_benchmarks(argc, argv, bench);
+}
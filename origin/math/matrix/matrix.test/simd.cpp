@@ -0,0 +1,195 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+using namespace origin::matrix_impl;
+
+// Tests for the vectorized elementwise kernels. When run as:
+//
+//    simd n [reps]
+//
+// the benchmark compares each instruction set with the std::transform loop
+// that was used by the matrix operations, for n elements and reps
+// repetitions.
+
+const char* isa_names[] = {"scalar", "sse2", "avx2"};
+const char* op_names[] = {"add", "sub", "mul", "div"};
+const elementwise_op ops[] = {
+  elementwise_op::add, elementwise_op::sub,
+  elementwise_op::mul, elementwise_op::div
+};
+
+
+template <typename T>
+  vector<T> random_values(size_t n)
+  {
+    // Avoid zeros so that division is always defined.
+    uniform_int_distribution<int> dist(1, 50);
+    vector<T> v(n);
+    for (auto& x : v)
+      x = T(dist(matrix_engine()));
+    return v;
+  }
+
+template <typename T>
+  T reference(elementwise_op op, T a, T b)
+  {
+    switch (op) {
+    case elementwise_op::add: return a + b;
+    case elementwise_op::sub: return a - b;
+    case elementwise_op::mul: return a * b;
+    default: return a / b;
+    }
+  }
+
+// Check each operation in each available instruction set for all sizes
+// up to and including a few vector widths.
+template <typename T>
+  void test_kernels()
+  {
+    for (int l = 0; l <= int(simd_support()); ++l) {
+      set_simd_level(simd_isa(l));
+      for (size_t n = 0; n < 40; ++n) {
+        vector<T> a = random_values<T>(n);
+        vector<T> b = random_values<T>(n);
+        vector<T> c(n);
+        T x = T(7);
+        for (elementwise_op op : ops) {
+          simd_elementwise(op, a.data(), b.data(), c.data(), n);
+          for (size_t i = 0; i < n; ++i)
+            assert(c[i] == reference(op, a[i], b[i]));
+
+          simd_elementwise(op, a.data(), x, c.data(), n);
+          for (size_t i = 0; i < n; ++i)
+            assert(c[i] == reference(op, a[i], x));
+        }
+
+        // In-place operation
+        vector<T> d = a;
+        simd_elementwise(elementwise_op::add, d.data(), b.data(), d.data(), n);
+        for (size_t i = 0; i < n; ++i)
+          assert(d[i] == a[i] + b[i]);
+      }
+    }
+    set_simd_level(simd_support());
+  }
+
+// Check that the matrix operations give the same results as the elementwise
+// definitions, including on non-contiguous operands.
+void test_matrix()
+{
+  matrix<double, 2> a {
+    {1, 2, 3, 4, 5},
+    {6, 7, 8, 9, 10},
+    {11, 12, 13, 14, 15}
+  };
+  matrix<double, 2> b = a;
+
+  b += 1.0;
+  b -= 1.0;
+  b *= 4.0;
+  b /= 2.0;
+  assert(b(2, 4) == 30);
+
+  b -= a;
+  assert(b == a);
+  b += a;
+  assert(b(1, 1) == 14);
+
+  // Strided right operand.
+  matrix<double, 2> c(3, 2);
+  c += a(slice::all, slice(0, 2, 2));
+  assert(c(2, 1) == 13);
+
+  // Hadamard product
+  matrix<double, 2> h(3, 5);
+  hadamard_product(a, a, h);
+  assert(h(1, 2) == 64);
+
+  matrix<int, 1> v {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  matrix<int, 1> w(9);
+  hadamard_product(v, v, w);
+  assert(w(8) == 81);
+
+  matrix<double, 2> hs(3, 2);
+  hadamard_product(c, a(slice::all, slice(0, 2, 2)), hs);
+  assert(hs(2, 1) == 169);
+}
+
+
+// Benchmarks
+
+// Returns the average number of microseconds taken by reps calls to f().
+template <typename F>
+  double time_reps(size_t reps, F f)
+  {
+    return 1000 * time_it([&]() {
+      for (size_t i = 0; i < reps; ++i)
+        f();
+    }) / reps;
+  }
+
+template <typename T>
+  void bench(const char* name, size_t n, size_t reps)
+  {
+    vector<T> a = random_values<T>(n);
+    vector<T> b = random_values<T>(n);
+    vector<T> c(n);
+
+    for (int i = 0; i < 4; ++i) {
+      elementwise_op op = ops[i];
+      cout << name << ' ' << op_names[i] << ' ' << n << ':';
+
+      double base = time_reps(reps, [&]() {
+        transform(a.begin(), a.end(), b.begin(), c.begin(), [op](T x, T y) {
+          return reference(op, x, y);
+        });
+      });
+      cout << " transform " << base << "us";
+
+      for (int l = 0; l <= int(simd_support()); ++l) {
+        set_simd_level(simd_isa(l));
+        double t = time_reps(reps, [&]() {
+          simd_elementwise(op, a.data(), b.data(), c.data(), n);
+        });
+        cout << ' ' << isa_names[l] << ' ' << t << "us"
+             << " (" << base / t << "x)";
+      }
+      cout << '\n';
+    }
+    set_simd_level(simd_support());
+  }
+
+int main(int argc, char* argv[])
+{
+  test_kernels<float>();
+  test_kernels<double>();
+  test_kernels<int32_t>();
+  test_kernels<int64_t>();
+  test_matrix();
+
+  if (argc > 1) {
+    size_t n = strtoul(argv[1], nullptr, 10);
+    size_t reps = argc > 2 ? strtoul(argv[2], nullptr, 10) : 10;
+    cout << "host supports " << isa_names[int(simd_support())] << '\n';
+    bench<float>("float", n, reps);
+    bench<double>("double", n, reps);
+    bench<int32_t>("int32", n, reps);
+    bench<int64_t>("int64", n, reps);
+  }
+}
@@ -5,6 +5,7 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <functional>
 #include <random>
 #include <stdexcept>
 #include <chrono>
@@ -39,19 +40,6 @@ Vec random_vector(size_t n)
   return r;
 }
 
-template <typename M1, typename T, typename M2>
-  matrix<T, M1::order>
-  scale_and_add(const M1& a, const T& c, const M2& b)
-  {
-    assert(same_extents(a.descriptor(), b.descriptor()));
-
-    matrix<T, M1::order> r(a.descriptor());
-    transform(a.begin(), a.end(), b.begin(), r.begin(), [&](T x, T y) { 
-      return x * c + y; 
-    });
-    return r;
-  }
-
 // This is intended to wrok for vectors, not matrices.
 template <typename M1, typename M2>
 double
@@ -84,7 +72,8 @@ eliminate_row(Mat& A, Vec& b, size_t j)
   // Fill zeros into each element under the ith row.
   for (size_t i = j + 1; i < n; ++i) {
     double m = A(i, j) / pivot;
-    A[i](slice(j)) = scale_and_add(A[j](slice(j)), -m, A[i](slice(j)));
+    auto r = A[i](slice(j));
+    axpy(-m, A[j](slice(j)), r);
     b(i) -= m * b(j);
   }
 }
@@ -99,7 +88,7 @@ choose_row(Mat& A, Vec& b, size_t j)
   // Look for a suitable pivot.
   for (size_t k = j + 1; k < n; ++k) {
     if (abs(A(k, j)) > abs(A(r, j)))
-      r = j;
+      r = k;
   }
 
   // Swap rows if we found a better one
@@ -0,0 +1,165 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#include <origin/math/matrix/matrix.hpp>
+
+using namespace std;
+using namespace origin;
+
+// A simple arena allocator. Memory is carved from a fixed block and never
+// reused. The arena counts the allocations made from it.
+struct arena
+{
+  alignas(64) char block[1 << 16];
+  size_t used = 0;
+  size_t count = 0;
+};
+
+template <typename T>
+  struct arena_allocator
+  {
+    using value_type = T;
+
+    arena_allocator(arena& a) : pool(&a) { }
+
+    template <typename U>
+      arena_allocator(const arena_allocator<U>& x) : pool(x.pool) { }
+
+    T* allocate(size_t n)
+    {
+      size_t bytes = (n * sizeof(T) + 63) & ~size_t(63);
+      assert(pool->used + bytes <= sizeof(pool->block));
+      T* p = reinterpret_cast<T*>(pool->block + pool->used);
+      pool->used += bytes;
+      ++pool->count;
+      return p;
+    }
+
+    void deallocate(T*, size_t) { }
+
+    bool operator==(const arena_allocator& x) const { return pool == x.pool; }
+    bool operator!=(const arena_allocator& x) const { return pool != x.pool; }
+
+    arena* pool;
+  };
+
+bool aligned(const void* p)
+{
+  return reinterpret_cast<uintptr_t>(p) % 64 == 0;
+}
+
+void test_alignment()
+{
+  for (size_t n : {1, 3, 17, 100}) {
+    matrix<double, 2> m(n, n);
+    assert(aligned(m.data()));
+    matrix<float, 1> v(n);
+    assert(aligned(v.data()));
+    matrix<int, 3> c {{{1, 2}, {3, 4}}};
+    assert(aligned(c.data()));
+  }
+}
+
+void test_allocator()
+{
+  static_assert(Allocator<arena_allocator<double>>(), "");
+
+  arena a;
+  using Alloc = arena_allocator<double>;
+  matrix<double, 2, Alloc> m(matrix_slice<2>(0, {3, 4}), Alloc(a));
+  assert(a.count == 1);
+  assert(m.rows() == 3 && m.cols() == 4);
+  assert(m(2, 3) == 0);
+  assert(m.get_allocator().pool == &a);
+
+  // Operations work with any allocator.
+  m += 2.0;
+  matrix<double, 2> n = m + m;
+  assert(n(1, 1) == 4);
+  matrix_ref<double, 2> r = m;
+  r(0, 0) = 5;
+  assert(m(0, 0) == 5);
+
+  // Copies use the same allocator.
+  matrix<double, 2, Alloc> c = m;
+  assert(a.count == 2);
+  assert(c == m);
+}
+
+void test_uninitialized()
+{
+  matrix<double, 2> m(uninitialized, 5, 7);
+  assert(m.rows() == 5 && m.cols() == 7 && m.size() == 35);
+  m = 1.0;
+  assert(m(4, 6) == 1);
+
+  matrix<double, 2> n(uninitialized, m.descriptor());
+  assert(same_extents(m, n));
+}
+
+void test_resize()
+{
+  matrix<int, 2> m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+
+  // Adding rows keeps the existing elements in place.
+  m.reserve(12);
+  assert(m.capacity() == 12);
+  const int* p = m.data();
+  m.resize(4, 3);
+  assert(m.data() == p);
+  assert(m.rows() == 4 && m(1, 2) == 6 && m(3, 2) == 0);
+
+  // Changing the number of columns keeps the elements at the same indexes.
+  m.resize(2, 5);
+  assert(m.rows() == 2 && m.cols() == 5);
+  assert(m(0, 0) == 1 && m(1, 2) == 6 && m(1, 4) == 0);
+
+  m.resize(1, 2);
+  assert(m.size() == 2 && m(0, 1) == 2);
+
+  m.clear();
+  assert(m.size() == 0);
+
+  // Default construction gives an empty matrix.
+  matrix<int, 2> e;
+  assert(e.size() == 0 && e.rows() == 0);
+  e.resize(2, 2);
+  assert(e(1, 1) == 0);
+}
+
+// Matrices are moved, not copied, when a vector of matrices grows.
+void test_move()
+{
+  using Mat = matrix<double, 2>;
+  static_assert(is_nothrow_move_constructible<Mat>::value, "");
+  static_assert(is_nothrow_move_assignable<Mat>::value, "");
+
+  vector<Mat> v;
+  v.emplace_back(3, 4);
+  const double* p = v[0].data();
+  for (int i = 0; i < 100; ++i)
+    v.emplace_back(2, 2);
+  assert(v[0].data() == p);
+}
+
+int main()
+{
+  test_alignment();
+  test_allocator();
+  test_uninitialized();
+  test_resize();
+  test_move();
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for the Strassen product. For each order n given on the command
+// line, the benchmark compares strassen_product with matrix_product, using
+// a range of cutoffs, and reports the error relative to the classical
+// product.
+
+using Mat = matrix<double, 2>;
+
+// Returns the largest absolute difference between elements of a and b,
+// relative to the largest element of b.
+double relative_error(const Mat& a, const Mat& b)
+{
+  double e = 0, m = 0;
+  auto i = b.begin();
+  for (double x : a) {
+    e = max(e, abs(x - *i));
+    m = max(m, abs(*i));
+    ++i;
+  }
+  return e / m;
+}
+
+void test_sizes()
+{
+  // Square, rectangular and odd sizes with small cutoffs, so that several
+  // levels of recursion and peeling are used.
+  size_t sizes[][3] = {
+    {8, 8, 8}, {16, 16, 16}, {17, 13, 9}, {31, 32, 33}, {40, 7, 25}
+  };
+  for (auto& s : sizes) {
+    Mat a = random_matrix(s[0], s[1]);
+    Mat b = random_matrix(s[1], s[2]);
+    Mat c1(s[0], s[2]);
+    matrix_product(a, b, c1);
+    for (size_t cutoff : {1, 2, 4}) {
+      Mat c2(s[0], s[2]);
+      strassen_product(a, b, c2, cutoff);
+      assert(relative_error(c2, c1) < 1e-12);
+    }
+  }
+}
+
+void test_views()
+{
+  // The product accumulates into a submatrix of out.
+  Mat a = random_matrix(20, 20);
+  Mat b = random_matrix(20, 20);
+  Mat c1(24, 24);
+  Mat c2(24, 24);
+  c1 = 1.0;
+  c2 = 1.0;
+  auto r1 = c1(slice(2, 20), slice(3, 20));
+  auto r2 = c2(slice(2, 20), slice(3, 20));
+  matrix_product(a, transposed(b), r1);
+  strassen_product(a, transposed(b), r2, 4);
+  assert(relative_error(c2, c1) < 1e-12);
+  assert(c2(0, 0) == 1 && c2(23, 23) == 1);
+}
+
+void bench(size_t n)
+{
+  Mat a = random_matrix(n, n);
+  Mat b = random_matrix(n, n);
+  Mat c1(n, n);
+  double classical = time_it([&]() { matrix_product(a, b, c1); });
+  cout << "product " << n << ": classical " << classical << "ms\n";
+  for (size_t cutoff = 64; cutoff < n; cutoff *= 2) {
+    Mat c2(n, n);
+    double strassen = time_it([&]() { strassen_product(a, b, c2, cutoff); });
+    cout << "  strassen (cutoff " << cutoff << ") " << strassen << "ms"
+         << " (" << classical / strassen << "x)"
+         << ", relative error " << relative_error(c2, c1) << '\n';
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  test_sizes();
+  test_views();
+
+  run_benchmarks(argc, argv, bench);
+}
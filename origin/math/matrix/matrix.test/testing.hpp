@@ -0,0 +1,84 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef MATRIX_TEST_TESTING_HPP
+#define MATRIX_TEST_TESTING_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <origin/type/testing.hpp>
+#include <origin/math/matrix/matrix.hpp>
+
+namespace origin
+{
+  namespace testing
+  {
+    // -------------------------------------------------------------------------- //
+    //                              Helper Functions
+
+    // Returns the pseudo-random number generator used by the matrix tests.
+    inline std::minstd_rand&
+    matrix_engine()
+    {
+      static std::minstd_rand eng;
+      return eng;
+    }
+
+    // Returns an m x n matrix of values in [-1, 1].
+    inline matrix<double, 2>
+    random_matrix(std::size_t m, std::size_t n)
+    {
+      std::uniform_real_distribution<double> dist(-1, 1);
+      matrix<double, 2> r(m, n);
+      for (auto& x : r)
+        x = dist(matrix_engine());
+      return r;
+    }
+
+    // Returns a vector of n values in [-1, 1].
+    inline matrix<double, 1>
+    random_vector(std::size_t n)
+    {
+      std::uniform_real_distribution<double> dist(-1, 1);
+      matrix<double, 1> r(n);
+      for (auto& x : r)
+        x = dist(matrix_engine());
+      return r;
+    }
+
+    // Returns an m x n matrix of integer values in [-k, k]. Products and sums
+    // of such values are exact for floating point types, so results computed
+    // in different orders can be compared for equality.
+    template <typename T>
+      matrix<T, 2>
+      random_integer_matrix(std::size_t m, std::size_t n, int k = 9)
+      {
+        std::uniform_int_distribution<int> dist(-k, k);
+        matrix<T, 2> r(m, n);
+        for (auto& x : r)
+          x = T(dist(matrix_engine()));
+        return r;
+      }
+
+    // Returns the largest absolute difference between elements of a and b.
+    template <typename M1, typename M2>
+      double
+      max_error(const M1& a, const M2& b)
+      {
+        double e = 0;
+        auto i = b.begin();
+        for (double x : a)
+          e = std::max(e, std::abs(x - *i++));
+        return e;
+      }
+
+  } // namespace testing
+} // namespace origin
+
+#endif
@@ -0,0 +1,169 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+
+#include <origin/math/matrix/matrix.hpp>
+
+#include "testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for transposition. For each order n given on the command line, the
+// benchmark compares the cache-oblivious transpose with an element by
+// element copy of the transposed view.
+
+// Returns true if b is the transpose of a.
+template <typename M1, typename M2>
+  bool is_transpose(const M1& a, const M2& b)
+  {
+    if (a.rows() != b.cols() || a.cols() != b.rows())
+      return false;
+    for (size_t i = 0; i < a.rows(); ++i)
+      for (size_t j = 0; j < a.cols(); ++j)
+        if (a(i, j) != b(j, i))
+          return false;
+    return true;
+  }
+
+void test_view()
+{
+  matrix<int, 2> m {
+    {1, 2, 3},
+    {4, 5, 6}
+  };
+  matrix_ref<int, 2> t = transposed(m);
+  assert(t.rows() == 3 && t.cols() == 2);
+  assert(is_transpose(m, t));
+
+  // The view refers to the elements of m.
+  t(2, 0) = 9;
+  assert(m(0, 2) == 9);
+
+  // The rows of the view are the columns of m.
+  matrix<int, 1> c = t[1];
+  assert(c(0) == 2 && c(1) == 5);
+
+  // Views of views.
+  const matrix<int, 2>& cm = m;
+  matrix_ref<const int, 2> tt = transposed(transposed(cm));
+  assert(tt == m);
+  assert(is_transpose(m(slice(0, 2), slice(1, 2)), transposed(m(slice(0, 2), slice(1, 2)))));
+}
+
+void test_copy()
+{
+  for (size_t m : {1, 5, 31, 32, 33, 100}) {
+    for (size_t n : {1, 7, 64, 129}) {
+      matrix<int, 2> a = random_integer_matrix<int>(m, n, 99);
+      matrix<int, 2> b = transpose(a);
+      assert(is_transpose(a, b));
+      assert(transpose(transposed(a)) == a);
+
+      // Transposing into a strided view.
+      matrix<int, 2> c(2 * n, m);
+      matrix_ref<int, 2> r = c(slice(0, n, 2), slice::all);
+      transpose(a, r);
+      assert(is_transpose(a, r));
+      assert(c(1, 0) == 0);
+    }
+  }
+}
+
+void test_in_place()
+{
+  for (size_t n : {1, 2, 31, 33, 64, 100}) {
+    matrix<int, 2> a = random_integer_matrix<int>(n, n, 99);
+    matrix<int, 2> b = a;
+    transpose_in_place(b);
+    assert(is_transpose(a, b));
+  }
+
+  // Transposing a square submatrix leaves the others unchanged.
+  matrix<int, 2> a = random_integer_matrix<int>(50, 60, 99);
+  matrix<int, 2> b = a;
+  transpose_in_place(b(slice(5, 40), slice(10, 40)));
+  assert(is_transpose(a(slice(5, 40), slice(10, 40)), b(slice(5, 40), slice(10, 40))));
+  assert(a(slice::all, slice(50, 10)) == b(slice::all, slice(50, 10)));
+}
+
+// Expressions of the transposed view of the matrix they are assigned to.
+void test_aliasing()
+{
+  matrix<int, 2> s {
+    {1, 2},
+    {3, 4}
+  };
+  s = transposed(s) + 0;
+  assert(s == (matrix<int, 2> {{1, 3}, {2, 4}}));
+
+  auto t = s(slice::all, slice::all);
+  t = transposed(s) * 2;
+  assert(s == (matrix<int, 2> {{2, 4}, {6, 8}}));
+
+  matrix<int, 2> a = random_integer_matrix<int>(33, 33, 99);
+  matrix<int, 2> b = a;
+  b = transposed(b) - b;
+  assert(b == transpose(a) - a);
+}
+
+// Products of transposed views are computed by the blocked kernel.
+void test_product()
+{
+  matrix<int, 2> a = random_integer_matrix<int>(40, 30, 99);
+  matrix<int, 2> b = random_integer_matrix<int>(40, 20, 99);
+  matrix<int, 2> at = transpose(a);
+  assert(transposed(a) * b == at * b);
+  assert(transposed(b) * a == transpose(b) * a);
+
+  // Products into transposed and strided views.
+  for (size_t n : {5, 40}) {
+    matrix<int, 2> x = random_integer_matrix<int>(n, n + 3, 99);
+    matrix<int, 2> y = random_integer_matrix<int>(n + 3, n + 1, 99);
+    matrix<int, 2> e = x * y;
+    matrix<int, 2> c(n + 1, n);
+    matrix_ref<int, 2> ct = transposed(c);
+    matrix_product(x, y, ct);
+    assert(ct == e);
+    matrix<int, 2> d(n, 2 * n + 2);
+    matrix_ref<int, 2> ds = d(slice::all, slice(0, n + 1, 2));
+    matrix<int, 2> xt = transpose(x);
+    matrix_product(transposed(xt), y, ds);
+    assert(ds == e);
+    assert(d(0, 1) == 0);
+  }
+}
+
+
+void bench(size_t n)
+{
+  matrix<int, 2> a = random_integer_matrix<int>(n, n, 99);
+  matrix<int, 2> b(n, n);
+  double naive = time_it([&]() { 
+    matrix_ref<int, 2> t = transposed(a);
+    copy(t.begin(), t.end(), b.begin()); 
+  });
+  double blocked = time_it([&]() { transpose(a, b); });
+  double in_place = time_it([&]() { transpose_in_place(b); });
+  cout << "transpose " << n << ": naive " << naive << "ms"
+       << ", blocked " << blocked << "ms"
+       << ", in place " << in_place << "ms\n";
+}
+
+int main(int argc, char* argv[])
+{
+  test_view();
+  test_copy();
+  test_in_place();
+  test_aliasing();
+  test_product();
+
+  run_benchmarks(argc, argv, bench);
+}
@@ -0,0 +1,529 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MATH_MATRIX_SPARSE_HPP
+#define ORIGIN_MATH_MATRIX_SPARSE_HPP
+
+#include <iterator>
+#include <vector>
+
+#include <origin/math/matrix/matrix.hpp>
+
+namespace origin
+{
+  // ------------------------------------------------------------------------ //
+  //                            Sparse Matrices
+  //
+  // A sparse matrix is a 2D matrix that stores only its nonzero elements.
+  // Two compressed formats are provided:
+  //
+  //    csr_matrix<T> -- Compressed sparse row. The nonzeros of each row are
+  //                     stored contiguously, ordered by column.
+  //    csc_matrix<T> -- Compressed sparse column. The nonzeros of each column
+  //                     are stored contiguously, ordered by row.
+  //
+  // In each format, the "major" dimension is the one whose elements are
+  // stored contiguously (rows for CSR, columns for CSC), and the "minor"
+  // dimension is the other. A compressed matrix stores three arrays:
+  //
+  //    offsets -- The nonzeros of the ith major line are at positions
+  //               [offsets[i], offsets[i + 1]) of indexes and values.
+  //    indexes -- The minor index of each nonzero.
+  //    values  -- The value of each nonzero.
+  //
+  // Sparse matrices model the Matrix concept. They can be compared with
+  // and printed like other matrices, although iterating over all of the
+  // elements of a sparse matrix (including the zeros) is slow. The
+  // elements of a sparse matrix cannot be modified through its interface;
+  // a sparse matrix is built from a list of entries or from a dense matrix.
+  //
+  // Products of sparse matrices with dense vectors and matrices are computed
+  // by iterating over the nonzeros only. For example:
+  //
+  //    std::vector<sparse_entry<double>> es {{0, 0, 1.0}, {2, 1, 3.0}};
+  //    csr_matrix<double> a(3, 3, es);
+  //    matrix<double, 1> y = a * x;
+
+
+  // A sparse entry is an element of a sparse matrix: a row and column
+  // index, and a value.
+  template <typename T>
+    struct sparse_entry
+    {
+      std::size_t row;
+      std::size_t col;
+      T value;
+    };
+
+
+  // The layout of a sparse matrix.
+  enum class sparse_layout { csr, csc };
+
+  template <typename T, sparse_layout L>
+    class sparse_matrix;
+
+  template <typename T>
+    using csr_matrix = sparse_matrix<T, sparse_layout::csr>;
+
+  template <typename T>
+    using csc_matrix = sparse_matrix<T, sparse_layout::csc>;
+
+
+  namespace matrix_impl
+  {
+    // The sparse iterator visits all elements of a sparse matrix in
+    // row-major order, including the zeros. Dereferencing the iterator
+    // returns the value of an element (not a reference).
+    template <typename S>
+      class sparse_iterator
+      {
+        using T = Value_type<S>;
+      public:
+        using value_type = T;
+        using reference = T;
+        using pointer = const T*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        sparse_iterator(const S& m, std::size_t n)
+          : mat(&m), pos(n)
+        { }
+
+        T operator*() const { return (*mat)(pos / mat->cols(), pos % mat->cols()); }
+
+        sparse_iterator& operator++() { ++pos; return *this; }
+        sparse_iterator operator++(int) { sparse_iterator x = *this; ++pos; return x; }
+
+        bool operator==(const sparse_iterator& x) const { return pos == x.pos; }
+        bool operator!=(const sparse_iterator& x) const { return pos != x.pos; }
+
+      private:
+        const S* mat;
+        std::size_t pos;
+      };
+
+
+    // Sort the entries by major and minor index, sum the values of entries
+    // having the same indexes, and store the result in compressed form. The
+    // functions major and minor return the major and minor index of an
+    // entry. The number of major lines is n.
+    template <typename T, typename Major, typename Minor>
+      void
+      compress(std::vector<sparse_entry<T>>& es, std::size_t n,
+               Major major, Minor minor,
+               std::vector<std::size_t>& offsets,
+               std::vector<std::size_t>& indexes,
+               std::vector<T>& values)
+      {
+        std::sort(es.begin(), es.end(),
+          [&](const sparse_entry<T>& a, const sparse_entry<T>& b) {
+            return major(a) < major(b)
+                || (major(a) == major(b) && minor(a) < minor(b));
+          });
+
+        offsets.assign(n + 1, 0);
+        indexes.clear();
+        values.clear();
+        indexes.reserve(es.size());
+        values.reserve(es.size());
+        for (auto i = es.begin(); i != es.end(); ) {
+          const std::size_t r = major(*i);
+          const std::size_t c = minor(*i);
+          T v = i->value;
+          for (++i; i != es.end() && major(*i) == r && minor(*i) == c; ++i)
+            v += i->value;
+          indexes.push_back(c);
+          values.push_back(v);
+          ++offsets[r + 1];
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+      }
+
+    // Transpose the compressed matrix (offsets, indexes, values) having m
+    // major lines and n minor lines into (to, ti, tv). The result has n
+    // major lines and its minor indexes are sorted. This is a counting sort,
+    // and requires O(m + n + nnz) time.
+    template <typename T>
+      void
+      compressed_transpose(std::size_t m, std::size_t n,
+                           const std::vector<std::size_t>& offsets,
+                           const std::vector<std::size_t>& indexes,
+                           const std::vector<T>& values,
+                           std::vector<std::size_t>& to,
+                           std::vector<std::size_t>& ti,
+                           std::vector<T>& tv)
+      {
+        to.assign(n + 1, 0);
+        for (std::size_t c : indexes)
+          ++to[c + 1];
+        std::partial_sum(to.begin(), to.end(), to.begin());
+
+        ti.resize(indexes.size());
+        tv.resize(values.size());
+        std::vector<std::size_t> next(to.begin(), to.end() - 1);
+        for (std::size_t r = 0; r < m; ++r) {
+          for (std::size_t k = offsets[r]; k < offsets[r + 1]; ++k) {
+            const std::size_t p = next[indexes[k]]++;
+            ti[p] = r;
+            tv[p] = values[k];
+          }
+        }
+      }
+  } // namespace matrix_impl
+
+
+  // ------------------------------------------------------------------------ //
+  //                             Sparse Matrix
+  //
+  // The sparse matrix class implements both compressed formats. The layout
+  // L determines which dimension is major. Use the csr_matrix and csc_matrix
+  // aliases.
+  template <typename T, sparse_layout L>
+    class sparse_matrix
+    {
+    public:
+      static constexpr std::size_t order = 2;
+      static constexpr sparse_layout layout = L;
+
+      using value_type = T;
+      using size_type = std::size_t;
+      using iterator = matrix_impl::sparse_iterator<sparse_matrix>;
+      using const_iterator = iterator;
+
+      // Construct an empty 0 x 0 matrix.
+      sparse_matrix();
+
+      // Construct an m x n matrix with no nonzeros.
+      sparse_matrix(std::size_t m, std::size_t n);
+
+      // Construct an m x n matrix from a range of sparse entries. The entries
+      // may be in any order, and the values of entries with the same indexes
+      // are summed. This requires O(nnz log nnz) time.
+      template <typename R>
+        sparse_matrix(std::size_t m, std::size_t n, const R& entries);
+
+      sparse_matrix(std::size_t m, std::size_t n,
+                    std::initializer_list<sparse_entry<T>> entries);
+
+      // Construct a sparse matrix from the nonzero elements of the 2D dense
+      // matrix x.
+      template <typename M, typename = Requires<matrix_impl::Strided_matrix<M>()>>
+        explicit sparse_matrix(const M& x);
+
+      // Convert between layouts. This requires O(m + n + nnz) time.
+      template <sparse_layout L2, typename = Requires<L2 != L>>
+        explicit sparse_matrix(const sparse_matrix<T, L2>& x);
+
+
+      // Properties
+      const matrix_slice<2>& descriptor() const { return desc; }
+
+      std::size_t extent(std::size_t n) const { return desc.extents[n]; }
+      std::size_t rows() const { return desc.extents[0]; }
+      std::size_t cols() const { return desc.extents[1]; }
+
+      // Returns the number of elements, including zeros.
+      std::size_t size() const { return desc.size; }
+
+      // Returns the number of stored elements.
+      std::size_t nonzeros() const { return vals.size(); }
+
+
+      // Compressed storage
+      //
+      // Returns the number of major lines (rows of a CSR matrix or columns of
+      // a CSC matrix).
+      std::size_t major_size() const { return offs.size() - 1; }
+
+      const std::vector<std::size_t>& offsets() const { return offs; }
+      const std::vector<std::size_t>& indexes() const { return idxs; }
+      const std::vector<T>& values() const { return vals; }
+
+
+      // Element access
+      //
+      // Returns the element at row i and column j. If the element is not
+      // stored, this returns 0. This requires O(log k) time where k is the
+      // number of nonzeros in the major line.
+      T operator()(std::size_t i, std::size_t j) const;
+
+      // Returns a dense copy of the ith row.
+      matrix<T, 1> row(std::size_t i) const;
+      matrix<T, 1> operator[](std::size_t i) const { return row(i); }
+
+      // Returns a dense copy of the matrix.
+      matrix<T, 2> dense() const;
+
+
+      // Iterators
+      iterator begin() const { return {*this, 0}; }
+      iterator end() const   { return {*this, size()}; }
+
+    private:
+      template <typename Range>
+        void build(const Range& entries);
+
+      matrix_slice<2> desc;
+      std::vector<std::size_t> offs;
+      std::vector<std::size_t> idxs;
+      std::vector<T> vals;
+    };
+
+  template <typename T, sparse_layout L>
+    sparse_matrix<T, L>::sparse_matrix()
+      : sparse_matrix(0, 0)
+    { }
+
+  template <typename T, sparse_layout L>
+    sparse_matrix<T, L>::sparse_matrix(std::size_t m, std::size_t n)
+      : desc(0, {m, n}), offs((L == sparse_layout::csr ? m : n) + 1, 0)
+    { }
+
+  template <typename T, sparse_layout L>
+    template <typename R>
+      sparse_matrix<T, L>::sparse_matrix(std::size_t m, std::size_t n,
+                                         const R& entries)
+        : desc(0, {m, n})
+      {
+        build(entries);
+      }
+
+  template <typename T, sparse_layout L>
+    sparse_matrix<T, L>::sparse_matrix(std::size_t m, std::size_t n,
+                                       std::initializer_list<sparse_entry<T>> entries)
+      : desc(0, {m, n})
+    {
+      build(entries);
+    }
+
+  template <typename T, sparse_layout L>
+    template <typename M, typename X>
+      sparse_matrix<T, L>::sparse_matrix(const M& x)
+        : desc(0, {x.rows(), x.cols()})
+      {
+        static_assert(M::order == 2, "");
+        std::vector<sparse_entry<T>> es;
+        for (std::size_t i = 0; i < x.rows(); ++i)
+          for (std::size_t j = 0; j < x.cols(); ++j)
+            if (x(i, j) != T(0))
+              es.push_back({i, j, x(i, j)});
+        build(es);
+      }
+
+  template <typename T, sparse_layout L>
+    template <sparse_layout L2, typename X>
+      sparse_matrix<T, L>::sparse_matrix(const sparse_matrix<T, L2>& x)
+        : desc(x.descriptor())
+      {
+        const std::size_t m = x.major_size();
+        const std::size_t n = L2 == sparse_layout::csr ? x.cols() : x.rows();
+        matrix_impl::compressed_transpose(m, n, x.offsets(), x.indexes(), x.values(),
+                                          offs, idxs, vals);
+      }
+
+  template <typename T, sparse_layout L>
+    template <typename Range>
+      void
+      sparse_matrix<T, L>::build(const Range& entries)
+      {
+        using Entry = sparse_entry<T>;
+        std::vector<Entry> es(std::begin(entries), std::end(entries));
+        for (const Entry& e : es) {
+          assert(e.row < rows() && e.col < cols());
+          (void)e;
+        }
+        auto row = [](const Entry& e) { return e.row; };
+        auto col = [](const Entry& e) { return e.col; };
+        if (L == sparse_layout::csr)
+          matrix_impl::compress(es, rows(), row, col, offs, idxs, vals);
+        else
+          matrix_impl::compress(es, cols(), col, row, offs, idxs, vals);
+      }
+
+  template <typename T, sparse_layout L>
+    T
+    sparse_matrix<T, L>::operator()(std::size_t i, std::size_t j) const
+    {
+      assert(i < rows() && j < cols());
+      const std::size_t r = L == sparse_layout::csr ? i : j;
+      const std::size_t c = L == sparse_layout::csr ? j : i;
+      auto first = idxs.begin() + offs[r];
+      auto last = idxs.begin() + offs[r + 1];
+      auto p = std::lower_bound(first, last, c);
+      if (p != last && *p == c)
+        return vals[p - idxs.begin()];
+      return T(0);
+    }
+
+  template <typename T, sparse_layout L>
+    matrix<T, 1>
+    sparse_matrix<T, L>::row(std::size_t i) const
+    {
+      assert(i < rows());
+      matrix<T, 1> r(cols());
+      if (L == sparse_layout::csr) {
+        for (std::size_t k = offs[i]; k < offs[i + 1]; ++k)
+          r(idxs[k]) = vals[k];
+      } else {
+        for (std::size_t j = 0; j < cols(); ++j)
+          r(j) = (*this)(i, j);
+      }
+      return r;
+    }
+
+  template <typename T, sparse_layout L>
+    matrix<T, 2>
+    sparse_matrix<T, L>::dense() const
+    {
+      matrix<T, 2> r(rows(), cols());
+      for (std::size_t i = 0; i < major_size(); ++i) {
+        for (std::size_t k = offs[i]; k < offs[i + 1]; ++k) {
+          if (L == sparse_layout::csr)
+            r(i, idxs[k]) = vals[k];
+          else
+            r(idxs[k], i) = vals[k];
+        }
+      }
+      return r;
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                           Sparse Products
+  //
+  // The product of a sparse matrix a (m x p) and a dense vector or matrix b
+  // (p or p x n) is a dense vector or matrix. As with matrix_product, the
+  // out-parameter form accumulates the product into out:
+  //
+  //    matrix_product(a, b, out) -- Compute out += a * b
+  //    a * b                     -- Returns a * b
+  //
+  // Each nonzero of a is visited once. For a CSR matrix, each row of the
+  // result is computed from the nonzeros in the same row of a. For a CSC
+  // matrix, each nonzero scatters a scaled row of b into the result. When b
+  // is a matrix, the inner loops run over rows of b and out.
+
+  namespace matrix_impl
+  {
+    // Accumulate the product of the nonzero a(i, k) = v and the kth row of
+    // b into the ith row of out.
+    template <typename T, typename M2, typename M3>
+      inline void
+      sparse_axpy(T v, const M2& b, std::size_t k, M3& out, std::size_t i,
+                  std::integral_constant<std::size_t, 1>)
+      {
+        out(i) += v * b(k);
+      }
+
+    template <typename T, typename M2, typename M3>
+      inline void
+      sparse_axpy(T v, const M2& b, std::size_t k, M3& out, std::size_t i,
+                  std::integral_constant<std::size_t, 2>)
+      {
+        const auto& db = b.descriptor();
+        const auto& dc = out.descriptor();
+        const T* p = b.data() + db.start + k * db.strides[0];
+        T* q = out.data() + dc.start + i * dc.strides[0];
+        const std::size_t n = cols(b);
+        const std::size_t ps = db.strides[1];
+        const std::size_t qs = dc.strides[1];
+        if (ps == 1 && qs == 1) {
+          for (std::size_t j = 0; j < n; ++j)
+            q[j] += v * p[j];
+        } else {
+          for (std::size_t j = 0; j < n; ++j)
+            q[j * qs] += v * p[j * ps];
+        }
+      }
+
+    // Returns the dot product of a row of a CSR matrix with the vector b.
+    // The row is given by the n column indexes in idx and the corresponding
+    // nonzero values in val. This is the inner loop of the CSR SpMV.
+    template <typename T, typename M2>
+      inline T
+      sparse_dot(const std::size_t* idx, const T* val, std::size_t n,
+                 const M2& b)
+      {
+        const auto& db = b.descriptor();
+        const T* p = b.data() + db.start;
+        const std::size_t s = db.strides[0];
+        T sum = T(0);
+        for (std::size_t k = 0; k < n; ++k)
+          sum += val[k] * p[idx[k] * s];
+        return sum;
+      }
+
+    template <typename T, typename M2, typename M3>
+      void
+      sparse_product(const csr_matrix<T>& a, const M2& b, M3& out,
+                     std::integral_constant<std::size_t, 1>)
+      {
+        const auto& off = a.offsets();
+        const std::size_t* idx = a.indexes().data();
+        const T* val = a.values().data();
+        for (std::size_t i = 0; i < a.rows(); ++i)
+          out(i) += sparse_dot(idx + off[i], val + off[i], off[i + 1] - off[i], b);
+      }
+
+    template <typename T, std::size_t N, typename M2, typename M3>
+      void
+      sparse_product(const csr_matrix<T>& a, const M2& b, M3& out,
+                     std::integral_constant<std::size_t, N> n)
+      {
+        const auto& off = a.offsets();
+        const auto& idx = a.indexes();
+        const auto& val = a.values();
+        for (std::size_t i = 0; i < a.rows(); ++i)
+          for (std::size_t k = off[i]; k < off[i + 1]; ++k)
+            sparse_axpy(val[k], b, idx[k], out, i, n);
+      }
+
+    template <typename T, std::size_t N, typename M2, typename M3>
+      void
+      sparse_product(const csc_matrix<T>& a, const M2& b, M3& out,
+                     std::integral_constant<std::size_t, N> n)
+      {
+        const auto& off = a.offsets();
+        const auto& idx = a.indexes();
+        const auto& val = a.values();
+        for (std::size_t j = 0; j < a.cols(); ++j)
+          for (std::size_t k = off[j]; k < off[j + 1]; ++k)
+            sparse_axpy(val[k], b, j, out, idx[k], n);
+      }
+  } // namespace matrix_impl
+
+  template <typename T, sparse_layout L, typename M2, typename M3>
+    void
+    matrix_product(const sparse_matrix<T, L>& a, const M2& b, M3& out)
+    {
+      constexpr std::size_t N = M2::order;
+      static_assert(N == 1 || N == 2, "");
+      static_assert(M3::order == N, "");
+      static_assert(matrix_impl::Strided_matrix<M2>(), "");
+      static_assert(matrix_impl::Strided_matrix<M3>(), "");
+      assert(a.cols() == b.extent(0));
+      assert(a.rows() == out.extent(0));
+      assert(N == 1 || b.extent(N - 1) == out.extent(N - 1));
+
+      matrix_impl::sparse_product(a, b, out, std::integral_constant<std::size_t, N>());
+    }
+
+  template <typename T, sparse_layout L, typename M,
+            typename = Requires<matrix_impl::Strided_matrix<M>()>>
+    inline matrix<T, M::order>
+    operator*(const sparse_matrix<T, L>& a, const M& b)
+    {
+      matrix_slice<M::order> s = b.descriptor();
+      s.extents[0] = a.rows();
+      matrix<T, M::order> r(matrix_slice<M::order>(0, s.extents));
+      matrix_product(a, b, r);
+      return r;
+    }
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,127 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+#include <origin/math/matrix/sparse.hpp>
+
+using namespace std;
+using namespace origin;
+
+// The dense matrix used by most tests.
+matrix<double, 2>
+make_dense()
+{
+  return {
+    {1, 0, 0, 2},
+    {0, 0, 3, 0},
+    {0, 0, 0, 0},
+    {4, 5, 0, 6}
+  };
+}
+
+void test_entries()
+{
+  // Entries may be given in any order. Duplicates are summed.
+  csr_matrix<double> a(4, 4, {
+    {3, 3, 6.0}, {0, 3, 2.0}, {3, 0, 4.0}, {1, 2, 1.0},
+    {0, 0, 1.0}, {3, 1, 5.0}, {1, 2, 2.0}
+  });
+  static_assert(Matrix<csr_matrix<double>>(), "");
+  assert(a.rows() == 4 && a.cols() == 4);
+  assert(a.nonzeros() == 6);
+  assert(a.major_size() == 4);
+
+  vector<size_t> offs {0, 2, 3, 3, 6};
+  vector<size_t> idxs {0, 3, 2, 0, 1, 3};
+  vector<double> vals {1, 2, 3, 4, 5, 6};
+  assert(a.offsets() == offs);
+  assert(a.indexes() == idxs);
+  assert(a.values() == vals);
+
+  assert(a(1, 2) == 3 && a(3, 1) == 5 && a(2, 2) == 0 && a(0, 1) == 0);
+
+  // Sparse matrices compare and print like dense matrices.
+  matrix<double, 2> d = make_dense();
+  assert(a == d);
+  assert(a.dense() == d);
+  ostringstream s1, s2;
+  s1 << a;
+  s2 << d;
+  assert(s1.str() == s2.str());
+
+  // An empty matrix.
+  csr_matrix<double> e(3, 2);
+  assert(e.nonzeros() == 0 && e(2, 1) == 0);
+}
+
+void test_conversion()
+{
+  matrix<double, 2> d = make_dense();
+
+  // From a dense matrix and back.
+  csr_matrix<double> a(d);
+  assert(a.nonzeros() == 6);
+  assert(a.dense() == d);
+  matrix<double, 2> m = a;
+  assert(m == d);
+
+  // From a submatrix.
+  csr_matrix<double> b(d(slice(1, 3), slice(1, 3)));
+  assert(b.rows() == 3 && b.nonzeros() == 3);
+  assert(b(0, 1) == 3 && b(2, 0) == 5 && b(2, 2) == 6);
+
+  // Between layouts.
+  csc_matrix<double> c(a);
+  assert(c == d);
+  csr_matrix<double> r(c);
+  assert(r.offsets() == a.offsets());
+  assert(r.indexes() == a.indexes());
+  assert(r.values() == a.values());
+}
+
+void test_product()
+{
+  matrix<double, 2> d = make_dense();
+  csr_matrix<double> a(d);
+
+  // Sparse * vector.
+  matrix<double, 1> x {1.0, 2.0, 3.0, 4.0};
+  matrix<double, 1> y = a * x;
+  assert(y == (matrix<double, 1> {9.0, 9.0, 0.0, 38.0}));
+
+  // Sparse * matrix, including a strided operand.
+  matrix<double, 2> b {
+    {1, 2},
+    {3, 4},
+    {5, 6},
+    {7, 8}
+  };
+  assert(a * b == d * b);
+  matrix<double, 2> bt = transpose(b);
+  assert(a * transposed(bt) == d * b);
+
+  // The out-parameter form accumulates.
+  matrix<double, 2> c(4, 2);
+  c = 1;
+  matrix_product(a, b, c);
+  matrix<double, 2> e = d * b;
+  e += 1.0;
+  assert(c == e);
+
+  // A column of a matrix as the vector operand.
+  assert(a * b.col(1) == (matrix<double, 1> {18.0, 18.0, 0.0, 76.0}));
+}
+
+int main()
+{
+  test_entries();
+  test_conversion();
+  test_product();
+}
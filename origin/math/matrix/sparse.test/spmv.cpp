@@ -0,0 +1,110 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include <origin/math/matrix/sparse.hpp>
+
+#include "../matrix.test/testing.hpp"
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests of CSC products. For each order n given on the command line, the
+// benchmark times sparse matrix-vector products (SpMV) of n x n matrices
+// having 4, 16 and 64 nonzeros per row. For orders up to 4096, it also
+// times the dense matrix_product, which multiplies by an n x 1 matrix.
+
+using Mat = matrix<double, 2>;
+using Vec = matrix<double, 1>;
+
+// Returns the entries of an m x n matrix having about p * m * n nonzeros at
+// random positions. The positions are drawn directly, so the time taken
+// does not depend on m * n. Entries drawn at the same position are summed
+// by the sparse matrix constructors.
+vector<sparse_entry<double>>
+random_entries(size_t m, size_t n, double p)
+{
+  vector<sparse_entry<double>> es;
+  if (m == 0 || n == 0)
+    return es;
+  minstd_rand& eng = matrix_engine();
+  uniform_real_distribution<double> dist(-1, 1);
+  uniform_int_distribution<size_t> row(0, m - 1);
+  uniform_int_distribution<size_t> col(0, n - 1);
+  size_t k = size_t(p * m * n + 0.5);
+  es.reserve(k);
+  for (size_t i = 0; i < k; ++i)
+    es.push_back({row(eng), col(eng), dist(eng)});
+  return es;
+}
+
+void test_csc()
+{
+  auto es = random_entries(30, 20, 0.2);
+  csc_matrix<double> a(30, 20, es);
+  csr_matrix<double> r(30, 20, es);
+  Mat d = a.dense();
+  assert(a == r);
+  assert(csc_matrix<double>(d) == d);
+
+  Vec x(20);
+  iota(x.begin(), x.end(), 1);
+  Mat xm(20, 1);
+  iota(xm.begin(), xm.end(), 1);
+  Mat ym = d * xm;
+
+  assert(max_error(a * x, ym) < 1e-12);
+  assert(max_error(r * x, ym) < 1e-12);
+
+  Mat b(20, 7);
+  iota(b.begin(), b.end(), 0);
+  assert(max_error(a * b, d * b) < 1e-12);
+}
+
+void bench_density(size_t n, size_t k)
+{
+  auto es = random_entries(n, n, double(k) / n);
+  csr_matrix<double> a(n, n, es);
+  Mat x(n, 1);
+  iota(x.begin(), x.end(), 0);
+  Vec v = x.col(0);
+
+  Vec y1;
+  double sparse = time_it([&]() { y1 = a * v; });
+  cout << "spmv " << n << " (" << a.nonzeros() << " nonzeros)"
+       << ": sparse " << sparse << "ms"
+       << ", " << a.nonzeros() / sparse / 1e3 << " Mnz/s";
+
+  // The dense product needs n * n elements.
+  if (n <= 4096) {
+    Mat d = a.dense();
+    Mat y2;
+    double dense = time_it([&]() { y2 = d * x; });
+    cout << ", dense " << dense << "ms"
+         << " (" << dense / sparse << "x)"
+         << ", difference " << max_error(y1, y2);
+  }
+  cout << '\n';
+}
+
+void bench(size_t n)
+{
+  for (size_t k : {4, 16, 64})
+    bench_density(n, k);
+}
+
+int main(int argc, char* argv[])
+{
+  test_csc();
+
+  run_benchmarks(argc, argv, bench);
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+#include "allocator.hpp"
+
+namespace origin
+{
+  // The storage is over-allocated so that an aligned block of n bytes can be
+  // found within it. The address returned by operator new is stored in the
+  // word immediately preceding the aligned block.
+  void*
+  aligned_allocate(std::size_t n, std::size_t align)
+  {
+    assert((align & (align - 1)) == 0);
+    if (align < alignof(void*))
+      align = alignof(void*);
+
+    // The padding must not wrap the size around to a small value.
+    std::size_t pad = align + sizeof(void*);
+    if (n > std::size_t(-1) - pad)
+      throw std::bad_alloc();
+
+    void* base = ::operator new(n + pad);
+    std::uintptr_t p = reinterpret_cast<std::uintptr_t>(base) + sizeof(void*);
+    p = (p + align - 1) & ~std::uintptr_t(align - 1);
+    reinterpret_cast<void**>(p)[-1] = base;
+    return reinterpret_cast<void*>(p);
+  }
+
+  void
+  aligned_deallocate(void* p)
+  {
+    if (p)
+      ::operator delete(static_cast<void**>(p)[-1]);
+  }
+
+} // namespace origin
@@ -0,0 +1,100 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_MEMORY_ALLOCATOR_HPP
+#define ORIGIN_MEMORY_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "concepts.hpp"
+
+namespace origin
+{
+  // Aligned allocation
+  //
+  // Allocate n bytes of memory whose address is a multiple of align, which
+  // must be a power of 2. Memory allocated by aligned_allocate must be
+  // released by aligned_deallocate. Throws std::bad_alloc if the memory
+  // cannot be allocated.
+  void* aligned_allocate(std::size_t n, std::size_t align);
+  void aligned_deallocate(void* p);
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Aligned allocator
+  //
+  // The aligned allocator allocates objects of type T in storage aligned on
+  // an Align byte boundary. The default alignment is 64 bytes: the size of a
+  // cache line on most current processors, and sufficient for any vector
+  // instruction set. All aligned allocators having the same alignment
+  // compare equal.
+  //
+  // Template parameters:
+  //    T     -- The type of object allocated.
+  //    Align -- The alignment of allocated storage, a power of 2.
+  template <typename T, std::size_t Align = 64>
+    class aligned_allocator
+    {
+      static_assert((Align & (Align - 1)) == 0, "alignment must be a power of 2");
+      static_assert(Align >= alignof(T), "alignment is too small for T");
+    public:
+      static constexpr std::size_t alignment = Align;
+
+      using value_type = T;
+      using pointer = T*;
+      using const_pointer = const T*;
+      using reference = T&;
+      using const_reference = const T&;
+      using size_type = std::size_t;
+      using difference_type = std::ptrdiff_t;
+
+      // Aligned allocators are stateless, so storage can always be moved
+      // between containers.
+      using propagate_on_container_move_assignment = std::true_type;
+
+      template <typename U>
+        struct rebind { using other = aligned_allocator<U, Align>; };
+
+      aligned_allocator() = default;
+
+      template <typename U>
+        aligned_allocator(const aligned_allocator<U, Align>&) { }
+
+      // Allocate aligned storage for n objects of type T. Throws
+      // std::bad_array_new_length if the size of n objects overflows.
+      T*
+      allocate(std::size_t n)
+      {
+        if (n > std::size_t(-1) / sizeof(T))
+          throw std::bad_array_new_length();
+        return static_cast<T*>(aligned_allocate(n * sizeof(T), Align));
+      }
+
+      // Release the storage pointed to by p.
+      void
+      deallocate(T* p, std::size_t) { aligned_deallocate(p); }
+    };
+
+  template <typename T, typename U, std::size_t Align>
+    inline bool
+    operator==(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&)
+    {
+      return true;
+    }
+
+  template <typename T, typename U, std::size_t Align>
+    inline bool
+    operator!=(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&)
+    {
+      return false;
+    }
+
+} // namespace origin
+
+#endif
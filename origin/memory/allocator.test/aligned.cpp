@@ -0,0 +1,73 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include <origin/memory/allocator.hpp>
+
+using namespace std;
+using namespace origin;
+
+template <typename T, size_t Align>
+  void test_alignment()
+  {
+    aligned_allocator<T, Align> a;
+    for (size_t n : {0, 1, 3, 17, 1000}) {
+      T* p = a.allocate(n);
+      assert(reinterpret_cast<uintptr_t>(p) % Align == 0);
+      a.deallocate(p, n);
+    }
+  }
+
+// Requests whose size overflows std::size_t throw instead of allocating a
+// smaller block.
+void test_overflow()
+{
+  size_t max = size_t(-1);
+  for (size_t n : {max, max - 1, max - 64}) {
+    try {
+      aligned_allocate(n, 64);
+      assert(false);
+    } catch (bad_alloc&) { }
+  }
+
+  aligned_allocator<double> a;
+  for (size_t n : {max, max / 8 + 1}) {
+    try {
+      a.allocate(n);
+      assert(false);
+    } catch (bad_array_new_length&) { }
+  }
+}
+
+int main()
+{
+  using A = aligned_allocator<double>;
+  static_assert(Allocator<A>(), "");
+  static_assert(A::alignment == 64, "");
+
+  test_alignment<char, 1>();
+  test_alignment<int, 16>();
+  test_alignment<double, 64>();
+  test_alignment<float, 4096>();
+  test_overflow();
+
+  // Rebinding and comparison.
+  aligned_allocator<int> b = A();
+  assert(b == A());
+  assert(!(b != A()));
+
+  // Use with a standard container.
+  vector<double, A> v(100, 1.0);
+  assert(reinterpret_cast<uintptr_t>(v.data()) % 64 == 0);
+  v.resize(1000, 2.0);
+  assert(reinterpret_cast<uintptr_t>(v.data()) % 64 == 0);
+  assert(v[99] == 1.0 && v[999] == 2.0);
+}
@@ -5,4 +5,892 @@
 // LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
 // and conditions.
 
+#include <atomic>
+
 #include "algorithm.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define ORIGIN_SEQUENCE_X86 1
+#  include <immintrin.h>
+#endif
+
+namespace origin
+{
+  namespace algorithm_impl
+  {
+    namespace
+    {
+      // ---------------------------------------------------------------------- //
+      //                            Scalar Kernels
+      //
+      // The scalar kernels are used when no vector instructions are available.
+
+      template <typename T>
+        T
+        scalar_sum(const T* a, std::size_t n)
+        {
+          T s = T(0);
+          for (std::size_t i = 0; i < n; ++i)
+            s += a[i];
+          return s;
+        }
+
+      template <typename T>
+        void
+        scalar_scan(const T* a, T* out, std::size_t n, T init)
+        {
+          for (std::size_t i = 0; i < n; ++i) {
+            init += a[i];
+            out[i] = init;
+          }
+        }
+
+
+      // Returns the first i in [0, n) where (a[i] == x) == eq, or n.
+      template <typename T>
+        std::size_t
+        scalar_find(const T* a, std::size_t n, T x, bool eq)
+        {
+          std::size_t i = 0;
+          while (i != n && (a[i] == x) != eq)
+            ++i;
+          return i;
+        }
+
+      template <typename T>
+        std::size_t
+        scalar_count(const T* a, std::size_t n, T x)
+        {
+          std::size_t c = 0;
+          for (std::size_t i = 0; i < n; ++i)
+            c += a[i] == x;
+          return c;
+        }
+
+      template <typename T>
+        std::size_t
+        scalar_mismatch(const T* a, const T* b, std::size_t n)
+        {
+          std::size_t i = 0;
+          while (i != n && a[i] == b[i])
+            ++i;
+          return i;
+        }
+
+#if ORIGIN_SEQUENCE_X86
+      // ---------------------------------------------------------------------- //
+      //                            Vector Kernels
+      //
+      // Each vector traits class describes the vector registers of an
+      // instruction set for a value type. The traits provide load, store,
+      // broadcast (set) and add operations, and two operations used by the
+      // scans: prefix computes the inclusive prefix sum of the elements of
+      // a vector, and last broadcasts its last element. The equal operation
+      // compares two vectors and returns a mask with bit i set when the i-th
+      // elements are equal (the compare-and-movemask idiom).
+      //
+      // The prefix sums of the SSE vectors add the vector to itself shifted
+      // by one element, then by two elements, and so on. The AVX shifts only
+      // move elements within each 128-bit lane, so the prefix of an AVX vector
+      // computes the prefix of each lane and then adds the last element of
+      // the low lane to each element of the high lane.
+
+#  define ORIGIN_SSE2 __attribute__((target("sse2")))
+#  define ORIGIN_AVX2 __attribute__((target("avx2,popcnt")))
+
+      // The byte vectors are only used by the comparison kernels.
+      struct sse2_i8
+      {
+        using value_type = char;
+        using vector = __m128i;
+        static constexpr std::size_t width = 16;
+
+        ORIGIN_SSE2 static vector
+        load(const char* p)
+        {
+          return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        ORIGIN_SSE2 static vector set(char x) { return _mm_set1_epi8(x); }
+
+        ORIGIN_SSE2 static unsigned
+        equal(vector a, vector b)
+        {
+          return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+        }
+      };
+
+      struct avx2_i8
+      {
+        using value_type = char;
+        using vector = __m256i;
+        static constexpr std::size_t width = 32;
+
+        ORIGIN_AVX2 static vector
+        load(const char* p)
+        {
+          return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        ORIGIN_AVX2 static vector set(char x) { return _mm256_set1_epi8(x); }
+
+        ORIGIN_AVX2 static unsigned
+        equal(vector a, vector b)
+        {
+          return _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+        }
+      };
+
+      struct sse2_f32
+      {
+        using value_type = float;
+        using vector = __m128;
+        static constexpr std::size_t width = 4;
+
+        ORIGIN_SSE2 static vector load(const float* p) { return _mm_loadu_ps(p); }
+        ORIGIN_SSE2 static void store(float* p, vector v) { _mm_storeu_ps(p, v); }
+        ORIGIN_SSE2 static vector set(float x) { return _mm_set1_ps(x); }
+        ORIGIN_SSE2 static vector add(vector a, vector b) { return _mm_add_ps(a, b); }
+
+        ORIGIN_SSE2 static unsigned
+        equal(vector a, vector b)
+        {
+          return _mm_movemask_ps(_mm_cmpeq_ps(a, b));
+        }
+
+        ORIGIN_SSE2 static vector
+        prefix(vector x)
+        {
+          x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+          x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+          return x;
+        }
+
+        ORIGIN_SSE2 static vector last(vector x) { return _mm_shuffle_ps(x, x, 0xff); }
+      };
+
+      struct sse2_f64
+      {
+        using value_type = double;
+        using vector = __m128d;
+        static constexpr std::size_t width = 2;
+
+        ORIGIN_SSE2 static vector load(const double* p) { return _mm_loadu_pd(p); }
+        ORIGIN_SSE2 static void store(double* p, vector v) { _mm_storeu_pd(p, v); }
+        ORIGIN_SSE2 static vector set(double x) { return _mm_set1_pd(x); }
+        ORIGIN_SSE2 static vector add(vector a, vector b) { return _mm_add_pd(a, b); }
+
+        ORIGIN_SSE2 static unsigned
+        equal(vector a, vector b)
+        {
+          return _mm_movemask_pd(_mm_cmpeq_pd(a, b));
+        }
+
+        ORIGIN_SSE2 static vector
+        prefix(vector x)
+        {
+          return _mm_add_pd(x, _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(x), 8)));
+        }
+
+        ORIGIN_SSE2 static vector last(vector x) { return _mm_unpackhi_pd(x, x); }
+      };
+
+      struct sse2_i32
+      {
+        using value_type = std::int32_t;
+        using vector = __m128i;
+        static constexpr std::size_t width = 4;
+
+        ORIGIN_SSE2 static vector
+        load(const std::int32_t* p)
+        {
+          return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        ORIGIN_SSE2 static void
+        store(std::int32_t* p, vector v)
+        {
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+        }
+
+        ORIGIN_SSE2 static vector set(std::int32_t x) { return _mm_set1_epi32(x); }
+        ORIGIN_SSE2 static vector add(vector a, vector b) { return _mm_add_epi32(a, b); }
+
+        ORIGIN_SSE2 static unsigned
+        equal(vector a, vector b)
+        {
+          return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)));
+        }
+
+        ORIGIN_SSE2 static vector
+        prefix(vector x)
+        {
+          x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+          x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+          return x;
+        }
+
+        ORIGIN_SSE2 static vector last(vector x) { return _mm_shuffle_epi32(x, 0xff); }
+      };
+
+      struct sse2_i64
+      {
+        using value_type = std::int64_t;
+        using vector = __m128i;
+        static constexpr std::size_t width = 2;
+
+        ORIGIN_SSE2 static vector
+        load(const std::int64_t* p)
+        {
+          return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        ORIGIN_SSE2 static void
+        store(std::int64_t* p, vector v)
+        {
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+        }
+
+        ORIGIN_SSE2 static vector set(std::int64_t x) { return _mm_set1_epi64x(x); }
+        ORIGIN_SSE2 static vector add(vector a, vector b) { return _mm_add_epi64(a, b); }
+
+        // SSE2 has no 64-bit comparison, so the 32-bit halves are compared
+        // and each half is combined with the other.
+        ORIGIN_SSE2 static unsigned
+        equal(vector a, vector b)
+        {
+          vector e = _mm_cmpeq_epi32(a, b);
+          e = _mm_and_si128(e, _mm_shuffle_epi32(e, 0xb1));
+          return _mm_movemask_pd(_mm_castsi128_pd(e));
+        }
+
+        ORIGIN_SSE2 static vector
+        prefix(vector x)
+        {
+          return _mm_add_epi64(x, _mm_slli_si128(x, 8));
+        }
+
+        ORIGIN_SSE2 static vector last(vector x) { return _mm_shuffle_epi32(x, 0xee); }
+      };
+
+      struct avx2_f32
+      {
+        using value_type = float;
+        using vector = __m256;
+        static constexpr std::size_t width = 8;
+
+        ORIGIN_AVX2 static vector load(const float* p) { return _mm256_loadu_ps(p); }
+        ORIGIN_AVX2 static void store(float* p, vector v) { _mm256_storeu_ps(p, v); }
+        ORIGIN_AVX2 static vector set(float x) { return _mm256_set1_ps(x); }
+        ORIGIN_AVX2 static vector add(vector a, vector b) { return _mm256_add_ps(a, b); }
+
+        ORIGIN_AVX2 static unsigned
+        equal(vector a, vector b)
+        {
+          return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+        }
+
+        ORIGIN_AVX2 static vector
+        prefix(vector x)
+        {
+          x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+          x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+          vector t = _mm256_permute2f128_ps(x, x, 0x08);
+          return _mm256_add_ps(x, _mm256_shuffle_ps(t, t, 0xff));
+        }
+
+        ORIGIN_AVX2 static vector
+        last(vector x)
+        {
+          vector t = _mm256_permute2f128_ps(x, x, 0x11);
+          return _mm256_shuffle_ps(t, t, 0xff);
+        }
+      };
+
+      struct avx2_f64
+      {
+        using value_type = double;
+        using vector = __m256d;
+        static constexpr std::size_t width = 4;
+
+        ORIGIN_AVX2 static vector load(const double* p) { return _mm256_loadu_pd(p); }
+        ORIGIN_AVX2 static void store(double* p, vector v) { _mm256_storeu_pd(p, v); }
+        ORIGIN_AVX2 static vector set(double x) { return _mm256_set1_pd(x); }
+        ORIGIN_AVX2 static vector add(vector a, vector b) { return _mm256_add_pd(a, b); }
+
+        ORIGIN_AVX2 static unsigned
+        equal(vector a, vector b)
+        {
+          return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+        }
+
+        ORIGIN_AVX2 static vector
+        prefix(vector x)
+        {
+          x = _mm256_add_pd(x, _mm256_castsi256_pd(_mm256_slli_si256(_mm256_castpd_si256(x), 8)));
+          vector t = _mm256_permute2f128_pd(x, x, 0x08);
+          return _mm256_add_pd(x, _mm256_shuffle_pd(t, t, 0xf));
+        }
+
+        ORIGIN_AVX2 static vector
+        last(vector x)
+        {
+          vector t = _mm256_permute2f128_pd(x, x, 0x11);
+          return _mm256_shuffle_pd(t, t, 0xf);
+        }
+      };
+
+      struct avx2_i32
+      {
+        using value_type = std::int32_t;
+        using vector = __m256i;
+        static constexpr std::size_t width = 8;
+
+        ORIGIN_AVX2 static vector
+        load(const std::int32_t* p)
+        {
+          return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        ORIGIN_AVX2 static void
+        store(std::int32_t* p, vector v)
+        {
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+        }
+
+        ORIGIN_AVX2 static vector set(std::int32_t x) { return _mm256_set1_epi32(x); }
+        ORIGIN_AVX2 static vector add(vector a, vector b) { return _mm256_add_epi32(a, b); }
+
+        ORIGIN_AVX2 static unsigned
+        equal(vector a, vector b)
+        {
+          return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+        }
+
+        ORIGIN_AVX2 static vector
+        prefix(vector x)
+        {
+          x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+          x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+          vector t = _mm256_permute2x128_si256(x, x, 0x08);
+          return _mm256_add_epi32(x, _mm256_shuffle_epi32(t, 0xff));
+        }
+
+        ORIGIN_AVX2 static vector
+        last(vector x)
+        {
+          vector t = _mm256_permute2x128_si256(x, x, 0x11);
+          return _mm256_shuffle_epi32(t, 0xff);
+        }
+      };
+
+      struct avx2_i64
+      {
+        using value_type = std::int64_t;
+        using vector = __m256i;
+        static constexpr std::size_t width = 4;
+
+        ORIGIN_AVX2 static vector
+        load(const std::int64_t* p)
+        {
+          return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        ORIGIN_AVX2 static void
+        store(std::int64_t* p, vector v)
+        {
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+        }
+
+        ORIGIN_AVX2 static vector set(std::int64_t x) { return _mm256_set1_epi64x(x); }
+        ORIGIN_AVX2 static vector add(vector a, vector b) { return _mm256_add_epi64(a, b); }
+
+        ORIGIN_AVX2 static unsigned
+        equal(vector a, vector b)
+        {
+          return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)));
+        }
+
+        ORIGIN_AVX2 static vector
+        prefix(vector x)
+        {
+          x = _mm256_add_epi64(x, _mm256_slli_si256(x, 8));
+          vector t = _mm256_permute2x128_si256(x, x, 0x08);
+          return _mm256_add_epi64(x, _mm256_shuffle_epi32(t, 0xee));
+        }
+
+        ORIGIN_AVX2 static vector
+        last(vector x)
+        {
+          vector t = _mm256_permute2x128_si256(x, x, 0x11);
+          return _mm256_shuffle_epi32(t, 0xee);
+        }
+      };
+
+
+      // The vector kernels. Because the target attribute cannot depend on a
+      // template parameter, there is one kernel template per instruction set.
+      //
+      // The sum keeps two vectors of partial sums so that consecutive adds
+      // are independent. The scan computes the prefix sums of two vectors at
+      // a time and then adds the carry, which is the last element of the
+      // previous results, so that only one add and one broadcast depend on
+      // the previous iteration.
+      //
+      // The comparison kernels test two vectors per iteration and only look
+      // for the position of a match (by counting the trailing zeros of the
+      // mask) when either vector has one. To find an element that is not
+      // equal to x, the mask is inverted.
+#  define ORIGIN_VECTOR_KERNELS(ISA, TARGET)                                   \
+      template <typename V, typename T>                                       \
+        TARGET T                                                              \
+        ISA##_sum(const T* a, std::size_t n)                                  \
+        {                                                                     \
+          constexpr std::size_t W = V::width;                                 \
+          auto s0 = V::set(T(0));                                             \
+          auto s1 = V::set(T(0));                                             \
+          std::size_t i = 0;                                                  \
+          for ( ; i + 2 * W <= n; i += 2 * W) {                               \
+            s0 = V::add(s0, V::load(a + i));                                  \
+            s1 = V::add(s1, V::load(a + i + W));                              \
+          }                                                                   \
+          if (i + W <= n) {                                                   \
+            s0 = V::add(s0, V::load(a + i));                                  \
+            i += W;                                                           \
+          }                                                                   \
+          T r[W];                                                             \
+          V::store(r, V::add(s0, s1));                                        \
+          T s = T(0);                                                         \
+          for (std::size_t j = 0; j < W; ++j)                                 \
+            s += r[j];                                                        \
+          for ( ; i < n; ++i)                                                 \
+            s += a[i];                                                        \
+          return s;                                                           \
+        }                                                                     \
+                                                                              \
+      template <typename V, typename T>                                       \
+        TARGET void                                                           \
+        ISA##_scan(const T* a, T* out, std::size_t n, T init)                 \
+        {                                                                     \
+          constexpr std::size_t W = V::width;                                 \
+          auto carry = V::set(init);                                          \
+          std::size_t i = 0;                                                  \
+          for ( ; i + 2 * W <= n; i += 2 * W) {                               \
+            auto x0 = V::prefix(V::load(a + i));                              \
+            auto x1 = V::prefix(V::load(a + i + W));                          \
+            x1 = V::add(x1, V::last(x0));                                     \
+            x0 = V::add(x0, carry);                                           \
+            x1 = V::add(x1, carry);                                           \
+            V::store(out + i, x0);                                            \
+            V::store(out + i + W, x1);                                        \
+            carry = V::last(x1);                                              \
+          }                                                                   \
+          for ( ; i + W <= n; i += W) {                                       \
+            auto x = V::add(V::prefix(V::load(a + i)), carry);                \
+            V::store(out + i, x);                                             \
+            carry = V::last(x);                                               \
+          }                                                                   \
+          if (i != 0)                                                         \
+            init = out[i - 1];                                                \
+          scalar_scan(a + i, out + i, n - i, init);                           \
+        }                                                                     \
+                                                                              \
+      template <typename V, typename T>                                       \
+        TARGET std::size_t                                                    \
+        ISA##_find(const T* a, std::size_t n, T x, bool eq)                   \
+        {                                                                     \
+          constexpr std::size_t W = V::width;                                 \
+          const unsigned flip = eq ? 0 : unsigned(~0ull >> (64 - W));         \
+          const auto v = V::set(x);                                           \
+          std::size_t i = 0;                                                  \
+          for ( ; i + 2 * W <= n; i += 2 * W) {                               \
+            unsigned m0 = V::equal(V::load(a + i), v) ^ flip;                 \
+            unsigned m1 = V::equal(V::load(a + i + W), v) ^ flip;             \
+            if (m0 | m1) {                                                    \
+              if (m0)                                                         \
+                return i + __builtin_ctz(m0);                                 \
+              return i + W + __builtin_ctz(m1);                               \
+            }                                                                 \
+          }                                                                   \
+          for ( ; i + W <= n; i += W) {                                       \
+            if (unsigned m = V::equal(V::load(a + i), v) ^ flip)              \
+              return i + __builtin_ctz(m);                                    \
+          }                                                                   \
+          return i + scalar_find(a + i, n - i, x, eq);                        \
+        }                                                                     \
+                                                                              \
+      template <typename V, typename T>                                       \
+        TARGET std::size_t                                                    \
+        ISA##_count(const T* a, std::size_t n, T x)                           \
+        {                                                                     \
+          constexpr std::size_t W = V::width;                                 \
+          const auto v = V::set(x);                                           \
+          std::size_t c0 = 0, c1 = 0;                                         \
+          std::size_t i = 0;                                                  \
+          for ( ; i + 2 * W <= n; i += 2 * W) {                               \
+            c0 += __builtin_popcount(V::equal(V::load(a + i), v));            \
+            c1 += __builtin_popcount(V::equal(V::load(a + i + W), v));        \
+          }                                                                   \
+          for ( ; i + W <= n; i += W)                                         \
+            c0 += __builtin_popcount(V::equal(V::load(a + i), v));            \
+          return c0 + c1 + scalar_count(a + i, n - i, x);                     \
+        }                                                                     \
+                                                                              \
+      template <typename V, typename T>                                       \
+        TARGET std::size_t                                                    \
+        ISA##_mismatch(const T* a, const T* b, std::size_t n)                 \
+        {                                                                     \
+          constexpr std::size_t W = V::width;                                 \
+          const unsigned all = unsigned(~0ull >> (64 - W));                   \
+          std::size_t i = 0;                                                  \
+          for ( ; i + 2 * W <= n; i += 2 * W) {                               \
+            unsigned m0 = V::equal(V::load(a + i), V::load(b + i)) ^ all;     \
+            unsigned m1 = V::equal(V::load(a + i + W),                        \
+                                   V::load(b + i + W)) ^ all;                 \
+            if (m0 | m1) {                                                    \
+              if (m0)                                                         \
+                return i + __builtin_ctz(m0);                                 \
+              return i + W + __builtin_ctz(m1);                               \
+            }                                                                 \
+          }                                                                   \
+          for ( ; i + W <= n; i += W) {                                       \
+            if (unsigned m = V::equal(V::load(a + i), V::load(b + i)) ^ all)  \
+              return i + __builtin_ctz(m);                                    \
+          }                                                                   \
+          return i + scalar_mismatch(a + i, b + i, n - i);                    \
+        }
+
+      ORIGIN_VECTOR_KERNELS(sse2, ORIGIN_SSE2)
+      ORIGIN_VECTOR_KERNELS(avx2, ORIGIN_AVX2)
+
+#  undef ORIGIN_VECTOR_KERNELS
+#  undef ORIGIN_SSE2
+#  undef ORIGIN_AVX2
+#endif
+
+
+      // ---------------------------------------------------------------------- //
+      //                              Dispatch
+      //
+      // The selected instruction set is initialized to the most capable one
+      // supported by the host on first use. It may be changed while kernels
+      // run on other threads, so it is atomic. The kernels only need to see
+      // some valid level, so they use relaxed loads.
+
+      simd_isa
+      detect_isa()
+      {
+#if ORIGIN_SEQUENCE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+          return simd_isa::avx2;
+        if (__builtin_cpu_supports("sse2"))
+          return simd_isa::sse2;
+#endif
+        return simd_isa::scalar;
+      }
+
+      std::atomic<simd_isa>&
+      selected_isa()
+      {
+        static std::atomic<simd_isa> isa(simd_support());
+        return isa;
+      }
+
+      inline simd_isa
+      current_isa()
+      {
+        return selected_isa().load(std::memory_order_relaxed);
+      }
+
+      // Dispatch to the kernels for the selected instruction set. SSE and AVX
+      // vector traits are given by S and A, respectively.
+      template <typename S, typename A, typename T>
+        inline T
+        dispatch_sum(const T* a, std::size_t n)
+        {
+#if ORIGIN_SEQUENCE_X86
+          switch (current_isa()) {
+          case simd_isa::avx2:
+            return avx2_sum<A>(a, n);
+          case simd_isa::sse2:
+            return sse2_sum<S>(a, n);
+          default:
+            break;
+          }
+#endif
+          return scalar_sum(a, n);
+        }
+
+      template <typename S, typename A, typename T>
+        inline void
+        dispatch_scan(const T* a, T* out, std::size_t n, T init)
+        {
+#if ORIGIN_SEQUENCE_X86
+          switch (current_isa()) {
+          case simd_isa::avx2:
+            return avx2_scan<A>(a, out, n, init);
+          case simd_isa::sse2:
+            return sse2_scan<S>(a, out, n, init);
+          default:
+            break;
+          }
+#endif
+          scalar_scan(a, out, n, init);
+        }
+
+      template <typename S, typename A, typename T>
+        inline std::size_t
+        dispatch_find(const T* a, std::size_t n, T x, bool eq)
+        {
+#if ORIGIN_SEQUENCE_X86
+          switch (current_isa()) {
+          case simd_isa::avx2:
+            return avx2_find<A>(a, n, x, eq);
+          case simd_isa::sse2:
+            return sse2_find<S>(a, n, x, eq);
+          default:
+            break;
+          }
+#endif
+          return scalar_find(a, n, x, eq);
+        }
+
+      template <typename S, typename A, typename T>
+        inline std::size_t
+        dispatch_count(const T* a, std::size_t n, T x)
+        {
+#if ORIGIN_SEQUENCE_X86
+          switch (current_isa()) {
+          case simd_isa::avx2:
+            return avx2_count<A>(a, n, x);
+          case simd_isa::sse2:
+            return sse2_count<S>(a, n, x);
+          default:
+            break;
+          }
+#endif
+          return scalar_count(a, n, x);
+        }
+
+      template <typename S, typename A, typename T>
+        inline std::size_t
+        dispatch_mismatch(const T* a, const T* b, std::size_t n)
+        {
+#if ORIGIN_SEQUENCE_X86
+          switch (current_isa()) {
+          case simd_isa::avx2:
+            return avx2_mismatch<A>(a, b, n);
+          case simd_isa::sse2:
+            return sse2_mismatch<S>(a, b, n);
+          default:
+            break;
+          }
+#endif
+          return scalar_mismatch(a, b, n);
+        }
+
+    } // namespace
+
+
+    simd_isa
+    simd_support()
+    {
+      static const simd_isa isa = detect_isa();
+      return isa;
+    }
+
+    simd_isa
+    simd_level()
+    {
+      return current_isa();
+    }
+
+    simd_isa
+    set_simd_level(simd_isa isa)
+    {
+      if (isa > simd_support())
+        isa = simd_support();
+      selected_isa().store(isa, std::memory_order_relaxed);
+      return isa;
+    }
+
+#if ORIGIN_SEQUENCE_X86
+#  define ORIGIN_DISPATCH(F, S, A) dispatch_##F<S, A>
+#else
+#  define ORIGIN_DISPATCH(F, S, A) dispatch_##F<void, void>
+#endif
+
+    float
+    simd_sum(const float* a, std::size_t n)
+    {
+      return ORIGIN_DISPATCH(sum, sse2_f32, avx2_f32)(a, n);
+    }
+
+    double
+    simd_sum(const double* a, std::size_t n)
+    {
+      return ORIGIN_DISPATCH(sum, sse2_f64, avx2_f64)(a, n);
+    }
+
+    std::int32_t
+    simd_sum(const std::int32_t* a, std::size_t n)
+    {
+      return ORIGIN_DISPATCH(sum, sse2_i32, avx2_i32)(a, n);
+    }
+
+    std::int64_t
+    simd_sum(const std::int64_t* a, std::size_t n)
+    {
+      return ORIGIN_DISPATCH(sum, sse2_i64, avx2_i64)(a, n);
+    }
+
+    void
+    simd_scan(const float* a, float* out, std::size_t n, float init)
+    {
+      ORIGIN_DISPATCH(scan, sse2_f32, avx2_f32)(a, out, n, init);
+    }
+
+    void
+    simd_scan(const double* a, double* out, std::size_t n, double init)
+    {
+      ORIGIN_DISPATCH(scan, sse2_f64, avx2_f64)(a, out, n, init);
+    }
+
+    void
+    simd_scan(const std::int32_t* a, std::int32_t* out, std::size_t n,
+              std::int32_t init)
+    {
+      ORIGIN_DISPATCH(scan, sse2_i32, avx2_i32)(a, out, n, init);
+    }
+
+    void
+    simd_scan(const std::int64_t* a, std::int64_t* out, std::size_t n,
+              std::int64_t init)
+    {
+      ORIGIN_DISPATCH(scan, sse2_i64, avx2_i64)(a, out, n, init);
+    }
+
+    std::size_t
+    simd_find(const char* a, std::size_t n, char x)
+    {
+      return ORIGIN_DISPATCH(find, sse2_i8, avx2_i8)(a, n, x, true);
+    }
+
+    std::size_t
+    simd_find_not(const char* a, std::size_t n, char x)
+    {
+      return ORIGIN_DISPATCH(find, sse2_i8, avx2_i8)(a, n, x, false);
+    }
+
+    std::size_t
+    simd_count(const char* a, std::size_t n, char x)
+    {
+      return ORIGIN_DISPATCH(count, sse2_i8, avx2_i8)(a, n, x);
+    }
+
+    std::size_t
+    simd_mismatch(const char* a, const char* b, std::size_t n)
+    {
+      return ORIGIN_DISPATCH(mismatch, sse2_i8, avx2_i8)(a, b, n);
+    }
+
+    std::size_t
+    simd_find(const std::int32_t* a, std::size_t n, std::int32_t x)
+    {
+      return ORIGIN_DISPATCH(find, sse2_i32, avx2_i32)(a, n, x, true);
+    }
+
+    std::size_t
+    simd_find_not(const std::int32_t* a, std::size_t n, std::int32_t x)
+    {
+      return ORIGIN_DISPATCH(find, sse2_i32, avx2_i32)(a, n, x, false);
+    }
+
+    std::size_t
+    simd_count(const std::int32_t* a, std::size_t n, std::int32_t x)
+    {
+      return ORIGIN_DISPATCH(count, sse2_i32, avx2_i32)(a, n, x);
+    }
+
+    std::size_t
+    simd_mismatch(const std::int32_t* a, const std::int32_t* b, std::size_t n)
+    {
+      return ORIGIN_DISPATCH(mismatch, sse2_i32, avx2_i32)(a, b, n);
+    }
+
+    std::size_t
+    simd_find(const std::int64_t* a, std::size_t n, std::int64_t x)
+    {
+      return ORIGIN_DISPATCH(find, sse2_i64, avx2_i64)(a, n, x, true);
+    }
+
+    std::size_t
+    simd_find_not(const std::int64_t* a, std::size_t n, std::int64_t x)
+    {
+      return ORIGIN_DISPATCH(find, sse2_i64, avx2_i64)(a, n, x, false);
+    }
+
+    std::size_t
+    simd_count(const std::int64_t* a, std::size_t n, std::int64_t x)
+    {
+      return ORIGIN_DISPATCH(count, sse2_i64, avx2_i64)(a, n, x);
+    }
+
+    std::size_t
+    simd_mismatch(const std::int64_t* a, const std::int64_t* b, std::size_t n)
+    {
+      return ORIGIN_DISPATCH(mismatch, sse2_i64, avx2_i64)(a, b, n);
+    }
+
+    std::size_t
+    simd_find(const float* a, std::size_t n, float x)
+    {
+      return ORIGIN_DISPATCH(find, sse2_f32, avx2_f32)(a, n, x, true);
+    }
+
+    std::size_t
+    simd_find_not(const float* a, std::size_t n, float x)
+    {
+      return ORIGIN_DISPATCH(find, sse2_f32, avx2_f32)(a, n, x, false);
+    }
+
+    std::size_t
+    simd_count(const float* a, std::size_t n, float x)
+    {
+      return ORIGIN_DISPATCH(count, sse2_f32, avx2_f32)(a, n, x);
+    }
+
+    std::size_t
+    simd_mismatch(const float* a, const float* b, std::size_t n)
+    {
+      return ORIGIN_DISPATCH(mismatch, sse2_f32, avx2_f32)(a, b, n);
+    }
+
+    std::size_t
+    simd_find(const double* a, std::size_t n, double x)
+    {
+      return ORIGIN_DISPATCH(find, sse2_f64, avx2_f64)(a, n, x, true);
+    }
+
+    std::size_t
+    simd_find_not(const double* a, std::size_t n, double x)
+    {
+      return ORIGIN_DISPATCH(find, sse2_f64, avx2_f64)(a, n, x, false);
+    }
+
+    std::size_t
+    simd_count(const double* a, std::size_t n, double x)
+    {
+      return ORIGIN_DISPATCH(count, sse2_f64, avx2_f64)(a, n, x);
+    }
+
+    std::size_t
+    simd_mismatch(const double* a, const double* b, std::size_t n)
+    {
+      return ORIGIN_DISPATCH(mismatch, sse2_f64, avx2_f64)(a, b, n);
+    }
+
+#undef ORIGIN_DISPATCH
+  } // namespace algorithm_impl
+} // namespace origin
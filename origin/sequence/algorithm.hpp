@@ -9,11 +9,32 @@
 #define ORIGIN_SEQUENCE_ALGORITHM_HPP
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #include "concepts.hpp"
+#include "execution.hpp"
 
 namespace origin
 {
+#include "algorithm.impl/parallel.hpp"
+#include "algorithm.impl/sort.hpp"
+#include "algorithm.impl/radix.hpp"
+#include "algorithm.impl/simd.hpp"
+#include "algorithm.impl/numeric.hpp"
+#include "algorithm.impl/mutate.hpp"
+#include "algorithm.impl/find.hpp"
+#include "algorithm.impl/search.hpp"
+
   // ------------------------------------------------------------------------ //
   //                                                                [algo.quant]
   //                              Quantifiers
@@ -237,7 +258,41 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      std::for_each(begin(range), end(range), f);
+      return std::for_each(begin(range), end(range), f);
+    }
+
+  // Parallel mutating algorithms
+  //
+  // The for_each, range_transform, copy_if, remove_if and partition
+  // algorithms may be given an execution policy as their first argument.
+  // The sequential policy, seq, calls the sequential algorithms. The
+  // parallel policy, par, processes blocks of a random access range on a
+  // thread pool, so the function or predicate is called concurrently and
+  // must not modify shared state without synchronization.
+  //
+  // The parallel copy_if, remove_if and partition preserve the order of the
+  // elements: each counts the selected elements of every block before
+  // writing them. In particular, the parallel partition is stable. The
+  // predicate is called once for each element. remove_if and partition move
+  // the range to a buffer as large as the range.
+  //
+  // Each algorithm has its own default grain and threshold, which can be
+  // overridden by the policy.
+  template <typename R, typename F>
+    inline F
+    for_each(sequential_policy, R&& range, F f)
+    {
+      return for_each(range, f);
+    }
+
+  template <typename R, typename F>
+    inline void
+    for_each(const parallel_policy& p, R&& range, F f)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<R>>(), "");
+      algorithm_impl::parallel_for_each(p, begin(range), end(range), f);
     }
 
 
@@ -247,6 +302,11 @@ namespace origin
   //                                    Find
   //
   // The find algorithms search///
+  //
+  // When the range is contiguous (an array, vector or string) and its
+  // elements are characters, 32 or 64-bit integers, or floating point values,
+  // find, count, range_mismatch, range_equal and search_n compare many
+  // elements at once using vector instructions, if they are available.
 
   template <typename R, typename T>
     inline Iterator_of<R> 
@@ -254,7 +314,10 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::find(begin(range), end(range), value);
+      using Simd = std::integral_constant<
+        bool, algorithm_impl::Simd_find<Iterator_of<R>, T>()
+      >;
+      return algorithm_impl::find_value(begin(range), end(range), value, Simd());
     }
 
 
@@ -394,7 +457,10 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::count(begin(range), end(range), value);
+      using Simd = std::integral_constant<
+        bool, algorithm_impl::Simd_find<Iterator_of<const R>, T>()
+      >;
+      return algorithm_impl::count_value(begin(range), end(range), value, Simd());
     }
 
   template <typename R, typename P>
@@ -418,7 +484,15 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::mismatch(begin(range1), end(range1), begin(range2));
+      using I1 = Iterator_of<R1>;
+      using I2 = Iterator_of<R2>;
+      using Simd = std::integral_constant<
+        bool, algorithm_impl::Simd_comparable<I1>()
+           && algorithm_impl::Simd_comparable<I2>()
+           && Same<Value_type<I1>, Value_type<I2>>()
+      >;
+      return algorithm_impl::mismatch_values(begin(range1), end(range1),
+                                             begin(range2), Simd());
     }
 
   template <typename R1, typename R2, typename C>
@@ -443,7 +517,7 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::equal(begin(range1), end(range1), begin(range2));
+      return range_mismatch(range1, range2).first == end(range1);
     }
 
   template <typename R1, typename R2, typename C>
@@ -506,6 +580,576 @@ namespace origin
     }
 
 
+  //////////////////////////////////////////////////////////////////////////////
+  // Searcher
+  //
+  // A searcher finds the occurrences of a pattern in a text. The pattern is
+  // preprocessed when the searcher is constructed, so that searching many
+  // texts for the same pattern does not repeat that work:
+  //
+  //    searcher<char> s(pattern);
+  //    for (const string& line : log)
+  //      if (search(line, s) != line.end())
+  //        ...
+  //
+  // The searcher owns a copy of the pattern. The search method is chosen by
+  // the length of the pattern and its alphabet:
+  //
+  //    - Patterns of bytes (e.g., chars) having at most 256 elements are
+  //      searched by Horspool's variant of the Boyer-Moore algorithm. It
+  //      compares about n / m elements of random text, but n * m in the
+  //      worst case.
+  //    - Longer byte patterns, byte patterns of more than 16 elements over a
+  //      small alphabet (at most 4 distinct values, e.g., DNA), and patterns
+  //      of other totally ordered types are searched by the Two-Way
+  //      algorithm, which makes at most 2n comparisons and uses no extra
+  //      space. Byte patterns also use the Horspool shift table to skip
+  //      ahead.
+  //    - Patterns of a single element are found with find, and patterns of
+  //      types that are not totally ordered with std::search.
+  //
+  // A method may be given explicitly. A method that is not available for
+  // the type of the pattern is replaced by std::search.
+  //
+  // The fast methods are used when the text is a random access range whose
+  // value type is that of the pattern. Otherwise, the searcher uses
+  // std::search and std::find_end.
+  //////////////////////////////////////////////////////////////////////////////
+
+  enum class search_method
+  {
+    automatic,  // Chosen by the length and alphabet of the pattern
+    scan,       // std::search
+    horspool,   // Boyer-Moore-Horspool (patterns of bytes only)
+    two_way     // Two-Way (totally ordered patterns only)
+  };
+
+  template <typename T>
+    class searcher
+    {
+      using Bytes = std::integral_constant<bool, algorithm_impl::Byte_symbol<T>()>;
+      using Ordered = std::integral_constant<bool, Totally_ordered<T>()>;
+
+    public:
+      template <typename I>
+        searcher(I first, I last, search_method m = search_method::automatic)
+          : fwd(std::vector<T>(first, last), m), rev(reversed(fwd.pattern), m)
+        { }
+
+      template <typename R, typename = Requires<Range<R>()>>
+        explicit searcher(const R& pattern,
+                          search_method m = search_method::automatic)
+          : searcher(std::begin(pattern), std::end(pattern), m)
+        { }
+
+      // Returns the pattern.
+      const std::vector<T>& pattern() const { return fwd.pattern; }
+
+      // Returns the method used to search for the pattern.
+      search_method method() const { return fwd.method; }
+
+      // Returns the first occurrence [i, j) of the pattern in [first, last),
+      // or [last, last) if there is none. An empty pattern occurs at first.
+      template <typename I>
+        std::pair<I, I>
+        operator()(I first, I last) const
+        {
+          return find_first(first, last, Fast<I>());
+        }
+
+      // Returns the last occurrence [i, j) of the pattern in [first, last),
+      // or [last, last) if there is none or the pattern is empty.
+      template <typename I>
+        std::pair<I, I>
+        find_last(I first, I last) const
+        {
+          return find_last(first, last, Fast<I>());
+        }
+
+    private:
+      template <typename I>
+        using Fast = std::integral_constant<
+          bool, Random_access_iterator<I>() && Same<Value_type<I>, T>()
+        >;
+
+      // The preprocessed pattern.
+      struct plan
+      {
+        plan(std::vector<T>&& p, search_method m)
+          : pattern(std::move(p)), method(choose(pattern, m, Bytes()))
+          , last(0), suffix(0), period(0), periodic(false)
+        {
+          if (pattern.size() < 2)
+            method = search_method::scan;
+          if (method != search_method::scan)
+            prepare(Bytes(), Ordered());
+        }
+
+        // Byte patterns may use either method.
+        static search_method
+        choose(const std::vector<T>& p, search_method m, std::true_type)
+        {
+          using namespace algorithm_impl;
+          if (m != search_method::automatic)
+            return m;
+          if (p.size() > horspool_max_length
+              || (p.size() > small_alphabet_length
+                  && symbol_count(p.data(), p.size()) <= small_alphabet))
+            return search_method::two_way;
+          return search_method::horspool;
+        }
+
+        static search_method
+        choose(const std::vector<T>&, search_method m, std::false_type)
+        {
+          if (Ordered() && (m == search_method::automatic
+                            || m == search_method::two_way))
+            return search_method::two_way;
+          return search_method::scan;
+        }
+
+        void
+        prepare(std::true_type, std::true_type)
+        {
+          shift.resize(256);
+          last = algorithm_impl::make_shift_table(pattern.data(),
+                                                  pattern.size(),
+                                                  shift.data());
+          prepare(std::false_type(), std::true_type());
+        }
+
+        void
+        prepare(std::false_type, std::true_type)
+        {
+          if (method != search_method::two_way)
+            return;
+          const T* p = pattern.data();
+          suffix = algorithm_impl::critical_factorization(p, pattern.size(),
+                                                          period);
+          periodic = suffix + period <= pattern.size()
+                  && std::equal(p, p + suffix, p + period);
+        }
+
+        void prepare(std::false_type, std::false_type) { }
+
+        // Returns the position of the first occurrence of the pattern in
+        // the n elements of t, or n if there is none.
+        template <typename I>
+          std::size_t
+          find(I t, std::size_t n) const
+          {
+            using namespace algorithm_impl;
+            const T* p = pattern.data();
+            const std::size_t m = pattern.size();
+            switch (method) {
+            case search_method::horspool:
+              return horspool(t, n, Bytes());
+            case search_method::two_way:
+              return two_way(t, n, Bytes());
+            default:
+              if (m == 1) {
+                using Simd = std::integral_constant<bool, Simd_find<I, T>()>;
+                return find_value(t, t + n, p[0], Simd()) - t;
+              }
+              return std::search(t, t + n, p, p + m) - t;
+            }
+          }
+
+        template <typename I>
+          std::size_t
+          horspool(I t, std::size_t n, std::true_type) const
+          {
+            return algorithm_impl::horspool_search(
+              pattern.data(), pattern.size(), shift.data(), last, t, n
+            );
+          }
+
+        // Only patterns of bytes are searched by Horspool's method.
+        template <typename I>
+          std::size_t
+          horspool(I, std::size_t n, std::false_type) const
+          {
+            return n;
+          }
+
+        // Byte patterns skip ahead using the shift table.
+        template <typename I>
+          std::size_t
+          two_way(I t, std::size_t n, std::true_type) const
+          {
+            return algorithm_impl::two_way_search(
+              pattern.data(), pattern.size(), suffix, period, periodic,
+              shift.data(), t, n
+            );
+          }
+
+        template <typename I>
+          std::size_t
+          two_way(I t, std::size_t n, std::false_type) const
+          {
+            return algorithm_impl::two_way_search(
+              pattern.data(), pattern.size(), suffix, period, periodic,
+              nullptr, t, n
+            );
+          }
+
+        std::vector<T> pattern;
+        search_method method;
+        std::vector<std::size_t> shift;
+        std::size_t last;
+        std::size_t suffix;
+        std::size_t period;
+        bool periodic;
+      };
+
+      static std::vector<T>
+      reversed(const std::vector<T>& p)
+      {
+        return std::vector<T>(p.rbegin(), p.rend());
+      }
+
+      template <typename I>
+        std::pair<I, I>
+        find_first(I first, I last, std::true_type) const
+        {
+          const std::size_t n = last - first;
+          const std::size_t m = fwd.pattern.size();
+          const std::size_t j = fwd.find(first, n);
+          if (j == n)
+            return {last, last};
+          return {first + j, first + j + m};
+        }
+
+      template <typename I>
+        std::pair<I, I>
+        find_first(I first, I last, std::false_type) const
+        {
+          I i = std::search(first, last, fwd.pattern.begin(), fwd.pattern.end());
+          if (i == last)
+            return {last, last};
+          return {i, std::next(i, fwd.pattern.size())};
+        }
+
+      // The last occurrence is the first occurrence of the reversed pattern
+      // in the reversed text.
+      template <typename I>
+        std::pair<I, I>
+        find_last(I first, I last, std::true_type) const
+        {
+          const std::size_t n = last - first;
+          const std::size_t m = rev.pattern.size();
+          if (m == 0)
+            return {last, last};
+          const std::size_t j = rev.find(std::reverse_iterator<I>(last), n);
+          if (j == n)
+            return {last, last};
+          return {last - j - m, last - j};
+        }
+
+      template <typename I>
+        std::pair<I, I>
+        find_last(I first, I last, std::false_type) const
+        {
+          I i = std::find_end(first, last,
+                              fwd.pattern.begin(), fwd.pattern.end());
+          if (i == last)
+            return {last, last};
+          return {i, std::next(i, fwd.pattern.size())};
+        }
+
+      plan fwd;
+      plan rev;
+    };
+
+  // Returns a searcher for the pattern.
+  template <typename R>
+    inline searcher<Value_type<Iterator_of<const R>>>
+    make_searcher(const R& pattern, search_method m = search_method::automatic)
+    {
+      return searcher<Value_type<Iterator_of<const R>>>(pattern, m);
+    }
+
+  // Returns the first occurrence of the pattern of s in range, or the end
+  // of range if there is none.
+  template <typename R, typename T>
+    inline Iterator_of<R>
+    search(R&& range, const searcher<T>& s)
+    {
+      using std::begin;
+      using std::end;
+      return s(begin(range), end(range)).first;
+    }
+
+  // Returns the last occurrence of the pattern of s in range, or the end of
+  // range if there is none.
+  template <typename R, typename T>
+    inline Iterator_of<R>
+    find_end(R&& range, const searcher<T>& s)
+    {
+      using std::begin;
+      using std::end;
+      return s.find_last(begin(range), end(range)).first;
+    }
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Multi-Pattern Search
+  //
+  // An aho_corasick automaton finds the occurrences of many patterns in one
+  // pass over a text, in time proportional to the length of the text plus
+  // the number of occurrences. The text is given as a stream of chunks, and
+  // each occurrence is reported to a function as the index of the pattern
+  // and the position in the stream of its first element:
+  //
+  //    aho_corasick<char> ac(keywords);
+  //    while (read(file, buf))
+  //      ac.feed(buf, [&](size_t k, size_t pos) {
+  //        cout << keywords[k] << " at " << pos << '\n';
+  //      });
+  //
+  // Occurrences that span chunks are found. Occurrences are reported in the
+  // order of their last elements. Occurrences ending at the same element
+  // are reported from the longest pattern to the shortest, and identical
+  // patterns in the order they were given. Empty patterns are never found.
+  //
+  // The automaton is a deterministic finite automaton whose transitions are
+  // stored in a single table, having a row for each state and a column for
+  // each distinct element of the patterns (plus one for all other elements),
+  // so that each element of the text is consumed by one table lookup. Each
+  // entry is the offset of the row of the next state, whose high bit is set
+  // when that state ends an occurrence of a pattern.
+  //
+  // The elements of the patterns must be totally ordered. Bytes (e.g.,
+  // chars) are mapped to columns by a table, and other elements by binary
+  // search.
+  //////////////////////////////////////////////////////////////////////////////
+
+  template <typename T>
+    class aho_corasick
+    {
+      static_assert(Totally_ordered<T>(), "");
+
+      using Bytes = std::integral_constant<bool, algorithm_impl::Byte_symbol<T>()>;
+
+      // The high bit of a transition marks states that end an occurrence.
+      static constexpr std::uint32_t final_bit = std::uint32_t(1) << 31;
+
+    public:
+      // Construct the automaton for a range of patterns, each of which is a
+      // range of elements. Throws std::length_error if the transition table
+      // would have 2^31 or more entries.
+      template <typename R>
+        explicit aho_corasick(const R& patterns)
+          : width(1), row(0), pos(0)
+        {
+          using std::begin;
+          using std::end;
+          for (const auto& p : patterns)
+            lengths.push_back(std::distance(begin(p), end(p)));
+          make_columns(patterns, Bytes());
+          make_trie(patterns);
+          make_links();
+        }
+
+      // Returns the number of patterns.
+      std::size_t size() const { return lengths.size(); }
+
+      // Returns the length of the ith pattern.
+      std::size_t length(std::size_t i) const { return lengths[i]; }
+
+      // Returns the number of states of the automaton.
+      std::size_t states() const { return dict.size(); }
+
+      // Returns the number of elements fed since construction or the last
+      // reset.
+      std::size_t position() const { return pos; }
+
+      // Start a new stream.
+      void
+      reset()
+      {
+        row = 0;
+        pos = 0;
+      }
+
+      // Consume the elements of chunk, calling f(k, i) for each occurrence
+      // of the kth pattern that starts at position i of the stream and ends
+      // in chunk.
+      template <typename R, typename F>
+        void
+        feed(const R& chunk, F f)
+        {
+          std::uint32_t r = row;
+          std::size_t n = pos;
+          for (const auto& x : chunk) {
+            const std::uint32_t e = table[r + column(x, Bytes())];
+            r = e & ~final_bit;
+            ++n;
+            if (e & final_bit) {
+              row = r;
+              pos = n;
+              report(r / width, n, f);
+            }
+          }
+          row = r;
+          pos = n;
+        }
+
+    private:
+      // Bytes that occur in the patterns are numbered from 1 by value.
+      template <typename R>
+        void
+        make_columns(const R& patterns, std::true_type)
+        {
+          columns.assign(256, 0);
+          for (const auto& p : patterns)
+            for (const auto& x : p)
+              columns[algorithm_impl::symbol_index(T(x))] = 1;
+          for (std::uint16_t& c : columns)
+            if (c)
+              c = width++;
+        }
+
+      template <typename R>
+        void
+        make_columns(const R& patterns, std::false_type)
+        {
+          for (const auto& p : patterns)
+            symbols.insert(symbols.end(), std::begin(p), std::end(p));
+          std::sort(symbols.begin(), symbols.end());
+          symbols.erase(std::unique(symbols.begin(), symbols.end()),
+                        symbols.end());
+          width = symbols.size() + 1;
+        }
+
+      // Returns the column of x. Elements that do not occur in any pattern
+      // are in column 0.
+      template <typename U>
+        std::size_t
+        column(const U& x, std::true_type) const
+        {
+          return columns[algorithm_impl::symbol_index(T(x))];
+        }
+
+      template <typename U>
+        std::size_t
+        column(const U& x, std::false_type) const
+        {
+          auto i = std::lower_bound(symbols.begin(), symbols.end(), x);
+          if (i == symbols.end() || x < *i)
+            return 0;
+          return i - symbols.begin() + 1;
+        }
+
+      // Build the trie of the patterns, whose transitions are the indexes of
+      // the next states (0, the root, for none), and the list of patterns
+      // ending at each state.
+      template <typename R>
+        void
+        make_trie(const R& patterns)
+        {
+          std::size_t n = 1;
+          std::vector<std::uint32_t> ends;
+          table.assign(width, 0);
+          for (const auto& p : patterns) {
+            std::size_t s = 0;
+            for (const auto& x : p) {
+              std::size_t k = s * width + column(x, Bytes());
+              if (!table[k]) {
+                if ((n + 1) * width > final_bit)
+                  throw std::length_error("aho_corasick: too many states");
+                table[k] = n++;
+                table.resize(n * width, 0);
+              }
+              s = table[k];
+            }
+            ends.push_back(s);
+          }
+
+          firsts.assign(n + 1, 0);
+          for (std::size_t i = 0; i < ends.size(); ++i)
+            if (ends[i])
+              ++firsts[ends[i] + 1];
+          for (std::size_t s = 0; s < n; ++s)
+            firsts[s + 1] += firsts[s];
+          outputs.resize(firsts[n]);
+          std::vector<std::uint32_t> next(firsts.begin(), firsts.end() - 1);
+          for (std::size_t i = 0; i < ends.size(); ++i)
+            if (ends[i])
+              outputs[next[ends[i]]++] = i;
+          dict.assign(n, 0);
+        }
+
+      // Returns true if a pattern ends at state s.
+      bool accepts(std::size_t s) const { return firsts[s] != firsts[s + 1]; }
+
+      // Compute the failure link of each state (the state of its longest
+      // proper suffix) in breadth first order, and replace the missing
+      // transitions of each state by those of its failure link. The
+      // dictionary link of a state is the nearest state on its chain of
+      // failure links at which a pattern ends, or 0 if there is none.
+      // Finally, replace state indexes by row offsets, marking those that
+      // end an occurrence.
+      void
+      make_links()
+      {
+        const std::size_t n = states();
+        std::vector<std::uint32_t> fail(n, 0);
+        std::vector<std::uint32_t> queue;
+        queue.reserve(n);
+        for (std::size_t c = 0; c < width; ++c)
+          if (std::uint32_t u = table[c])
+            queue.push_back(u);
+        for (std::size_t i = 0; i < queue.size(); ++i) {
+          const std::uint32_t s = queue[i];
+          const std::uint32_t f = fail[s];
+          dict[s] = accepts(f) ? f : dict[f];
+          for (std::size_t c = 0; c < width; ++c) {
+            std::uint32_t& t = table[s * width + c];
+            if (t) {
+              fail[t] = table[f * width + c];
+              queue.push_back(t);
+            } else {
+              t = table[f * width + c];
+            }
+          }
+        }
+
+        for (std::uint32_t& t : table)
+          t = t * width | (accepts(t) || dict[t] ? final_bit : 0);
+      }
+
+      // Report the occurrences of the patterns that end at state s, which
+      // is at position n of the stream.
+      template <typename F>
+        void
+        report(std::size_t s, std::size_t n, F& f) const
+        {
+          if (!accepts(s))
+            s = dict[s];
+          while (s) {
+            for (std::size_t i = firsts[s]; i != firsts[s + 1]; ++i)
+              f(std::size_t(outputs[i]), n - lengths[outputs[i]]);
+            s = dict[s];
+          }
+        }
+
+      std::vector<std::uint32_t> table;    // Transitions (row offsets)
+      std::vector<std::uint16_t> columns;  // Columns of bytes
+      std::vector<T> symbols;              // Columns of other elements
+      std::vector<std::uint32_t> dict;     // Dictionary links
+      std::vector<std::uint32_t> firsts;   // First output of each state
+      std::vector<std::uint32_t> outputs;  // Patterns ending at each state
+      std::vector<std::size_t> lengths;    // Pattern lengths
+      std::size_t width;                   // Columns per row
+      std::uint32_t row;                   // Current state (row offset)
+      std::size_t pos;                     // Stream position
+    };
+
+  template <typename T>
+    constexpr std::uint32_t aho_corasick<T>::final_bit;
+
+
   //////////////////////////////////////////////////////////////////////////////
   // Search N
   //
@@ -515,7 +1159,10 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return std::search_n(begin(range), end(range), n, value);
+      using Simd = std::integral_constant<
+        bool, algorithm_impl::Simd_find<Iterator_of<R>, T>()
+      >;
+      return algorithm_impl::search_run(begin(range), end(range), n, value, Simd());
     }
 
   template <typename R, typename T, typename C>
@@ -550,6 +1197,25 @@ namespace origin
       return std::copy_if(begin(range1), end(range1), begin(range2), pred);
     }
 
+  template <typename R1, typename R2, typename P>
+    inline Iterator_of<R2>
+    copy_if(sequential_policy, const R1& range1, R2&& range2, P pred)
+    {
+      return copy_if(range1, range2, pred);
+    }
+
+  template <typename R1, typename R2, typename P>
+    inline Iterator_of<R2>
+    copy_if(const parallel_policy& p, const R1& range1, R2&& range2, P pred)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<const R1>>(), "");
+      static_assert(Random_access_iterator<Iterator_of<R2>>(), "");
+      return algorithm_impl::parallel_copy_if(p, begin(range1), end(range1),
+                                              begin(range2), pred);
+    }
+
 
   //////////////////////////////////////////////////////////////////////////////
   // Move
@@ -610,7 +1276,7 @@ namespace origin
     }
 
   template <typename R1, typename R2, typename R3, typename Op>
-    inline Iterator_of<R3>
+    inline Requires<!Execution_policy<R1>(), Iterator_of<R3>>
     range_transform(const R1& range1, const R2& range2, R3&& range3, Op op)
     {
       using std::begin;
@@ -621,6 +1287,49 @@ namespace origin
                             op);
     }
 
+  template <typename R1, typename R2, typename Op>
+    inline Iterator_of<R2>
+    range_transform(sequential_policy, const R1& range1, R2&& range2, Op op)
+    {
+      return range_transform(range1, range2, op);
+    }
+
+  template <typename R1, typename R2, typename R3, typename Op>
+    inline Iterator_of<R3>
+    range_transform(sequential_policy, const R1& range1, const R2& range2,
+                    R3&& range3, Op op)
+    {
+      return range_transform(range1, range2, range3, op);
+    }
+
+  template <typename R1, typename R2, typename Op>
+    inline Iterator_of<R2>
+    range_transform(const parallel_policy& p, const R1& range1, R2&& range2,
+                    Op op)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<const R1>>(), "");
+      static_assert(Random_access_iterator<Iterator_of<R2>>(), "");
+      return algorithm_impl::parallel_transform(p, begin(range1), end(range1),
+                                                begin(range2), op);
+    }
+
+  template <typename R1, typename R2, typename R3, typename Op>
+    inline Iterator_of<R3>
+    range_transform(const parallel_policy& p, const R1& range1,
+                    const R2& range2, R3&& range3, Op op)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<const R1>>(), "");
+      static_assert(Random_access_iterator<Iterator_of<const R2>>(), "");
+      static_assert(Random_access_iterator<Iterator_of<R3>>(), "");
+      return algorithm_impl::parallel_transform(p, begin(range1), end(range1),
+                                                begin(range2), begin(range3),
+                                                op);
+    }
+
 
   //////////////////////////////////////////////////////////////////////////////
   // Replace
@@ -691,6 +1400,23 @@ namespace origin
       return std::remove_if(begin(range), end(range), pred);
     }
 
+  template <typename R, typename P>
+    inline Iterator_of<R>
+    remove_if(sequential_policy, R&& range, P pred)
+    {
+      return remove_if(range, pred);
+    }
+
+  template <typename R, typename P>
+    inline Iterator_of<R>
+    remove_if(const parallel_policy& p, R&& range, P pred)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<R>>(), "");
+      return algorithm_impl::parallel_remove_if(p, begin(range), end(range), pred);
+    }
+
   template <typename R1, typename R2, typename T>
     inline Iterator_of<R2>
     remove_copy(const R1& range1, R2&& range2, const T& value)
@@ -837,6 +1563,24 @@ namespace origin
       return std::partition(begin(range), end(range), pred);
     }
 
+  template <typename R, typename P>
+    inline Iterator_of<R>
+    partition(sequential_policy, R&& range, P pred)
+    {
+      return partition(range, pred);
+    }
+
+  // The parallel partition is stable.
+  template <typename R, typename P>
+    inline Iterator_of<R>
+    partition(const parallel_policy& p, R&& range, P pred)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<R>>(), "");
+      return algorithm_impl::parallel_partition(p, begin(range), end(range), pred);
+    }
+
   template <typename R, typename P>
     inline Iterator_of<R>
     stable_partition(R&& range, P pred)
@@ -888,7 +1632,7 @@ namespace origin
   // that iterators must the same, then this won't work without a lot of
   // enable-if'ing.
   template <typename R, typename C>
-    inline void
+    inline Requires<!Execution_policy<R>()>
     sort(R&& range, C comp)
     {
       using std::begin;
@@ -906,7 +1650,7 @@ namespace origin
     }
 
   template <typename R, typename C>
-    inline void
+    inline Requires<!Execution_policy<R>()>
     stable_sort(R&& range, C comp)
     {
       using std::begin;
@@ -915,11 +1659,96 @@ namespace origin
     }
 
 
+  // Parallel sorting
+  //
+  // Each sorting algorithm may be given an execution policy as its first
+  // argument. The sequential policy, seq, calls the algorithms above. The
+  // parallel policy, par, sorts a random access range on a thread pool:
+  //
+  //    sort(par, range)               -- samplesort
+  //    stable_sort(par, range)        -- merge sort
+  //    partial_sort_copy(par, r1, r2) -- a heap of candidates for each block
+  //
+  // The parallel algorithms allocate a buffer as large as the range. Small
+  // ranges (fewer than 16K elements, by default) are sorted sequentially.
+  // If the comparison throws an exception, the range is left in an
+  // unspecified order.
+  template <typename R>
+    inline void
+    sort(sequential_policy, R&& range)
+    {
+      sort(range);
+    }
+
+  template <typename R, typename C>
+    inline void
+    sort(sequential_policy, R&& range, C comp)
+    {
+      sort(range, comp);
+    }
+
+  template <typename R>
+    inline void
+    sort(const parallel_policy& p, R&& range)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<R>>(), "");
+      algorithm_impl::sample_sort(p, begin(range), end(range),
+                                  std::less<Value_type<Iterator_of<R>>>());
+    }
+
+  template <typename R, typename C>
+    inline void
+    sort(const parallel_policy& p, R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<R>>(), "");
+      algorithm_impl::sample_sort(p, begin(range), end(range), comp);
+    }
+
+  template <typename R>
+    inline void
+    stable_sort(sequential_policy, R&& range)
+    {
+      stable_sort(range);
+    }
+
+  template <typename R, typename C>
+    inline void
+    stable_sort(sequential_policy, R&& range, C comp)
+    {
+      stable_sort(range, comp);
+    }
+
+  template <typename R>
+    inline void
+    stable_sort(const parallel_policy& p, R&& range)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<R>>(), "");
+      algorithm_impl::merge_sort(p, begin(range), end(range),
+                                 std::less<Value_type<Iterator_of<R>>>());
+    }
+
+  template <typename R, typename C>
+    inline void
+    stable_sort(const parallel_policy& p, R&& range, C comp)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<R>>(), "");
+      algorithm_impl::merge_sort(p, begin(range), end(range), comp);
+    }
+
+
   // NOTE: We don't provide a range-based partial_sort for the same reason that
   // we don't provide a range-based rotate: a middle iterator.
 
   template <typename R1, typename R2>
-    inline Iterator_of<R2>
+    inline Requires<!Execution_policy<R1>(), Iterator_of<R2>>
     partial_sort_copy(const R1& range1, R2&& range2)
     {
       using std::begin;
@@ -930,7 +1759,7 @@ namespace origin
 
 
   template <typename R1, typename R2, typename C>
-    inline Iterator_of<R2>
+    inline Requires<!Execution_policy<R1>(), Iterator_of<R2>>
     partial_sort_copy(const R1& range1, R2&& range2, C comp)
     {
       using std::begin;
@@ -940,6 +1769,46 @@ namespace origin
                                     comp);
     }
 
+  template <typename R1, typename R2>
+    inline Iterator_of<R2>
+    partial_sort_copy(sequential_policy, const R1& range1, R2&& range2)
+    {
+      return partial_sort_copy(range1, range2);
+    }
+
+  template <typename R1, typename R2, typename C>
+    inline Iterator_of<R2>
+    partial_sort_copy(sequential_policy, const R1& range1, R2&& range2, C comp)
+    {
+      return partial_sort_copy(range1, range2, comp);
+    }
+
+  template <typename R1, typename R2>
+    inline Iterator_of<R2>
+    partial_sort_copy(const parallel_policy& p, const R1& range1, R2&& range2)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<const R1>>(), "");
+      static_assert(Random_access_iterator<Iterator_of<R2>>(), "");
+      return algorithm_impl::top_k(p, begin(range1), end(range1),
+                                   begin(range2), end(range2),
+                                   std::less<Value_type<Iterator_of<const R1>>>());
+    }
+
+  template <typename R1, typename R2, typename C>
+    inline Iterator_of<R2>
+    partial_sort_copy(const parallel_policy& p, const R1& range1, R2&& range2,
+                      C comp)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<const R1>>(), "");
+      static_assert(Random_access_iterator<Iterator_of<R2>>(), "");
+      return algorithm_impl::top_k(p, begin(range1), end(range1),
+                                   begin(range2), end(range2), comp);
+    }
+
   template <typename R>
     inline bool
     is_sorted(const R& range)
@@ -977,6 +1846,101 @@ namespace origin
     }
 
 
+  //////////////////////////////////////////////////////////////////////////////
+  // Radix Sort
+  //
+  // The radix_sort algorithm stably sorts a random access range by the value
+  // of its elements or, when given a key function, by the value of key(x):
+  //
+  //    radix_sort(range)       -- Sort the elements by value
+  //    radix_sort(range, key)  -- Sort the elements by key(x)
+  //
+  // When the keys are integers or IEEE floating point values, the range is
+  // sorted by an LSD radix sort, which makes a pass over the elements for
+  // each byte of the key. Floating point keys are ordered by value, except
+  // that -0 precedes +0, and NaNs are placed at the ends of the range. Other
+  // keys are compared with <.
+  //
+  // The radix sort needs storage for a copy of the range. The storage can
+  // be provided by a radix_buffer so that repeated sorts do not allocate:
+  //
+  //    radix_buffer<record> buf;
+  //    for (auto& v : batches)
+  //      radix_sort(v, key, buf);
+  //
+  // The elements must be default constructible and move assignable.
+  //////////////////////////////////////////////////////////////////////////////
+
+
+  // A radix buffer is the scratch storage used by radix_sort. The storage
+  // grows to the largest range sorted with it.
+  template <typename T>
+    class radix_buffer
+    {
+    public:
+      radix_buffer()
+        : len(0)
+      { }
+
+      // Returns the number of elements that can be sorted without
+      // allocating.
+      std::size_t capacity() const { return len; }
+
+      // Returns storage for at least n elements.
+      T*
+      get(std::size_t n)
+      {
+        if (len < n) {
+          elems.reset(new T[n]);
+          len = n;
+        }
+        return elems.get();
+      }
+
+    private:
+      std::unique_ptr<T[]> elems;
+      std::size_t len;
+    };
+
+
+  template <typename R, typename K, typename T>
+    void
+    radix_sort(R&& range, K key, radix_buffer<T>& buf)
+    {
+      using std::begin;
+      using std::end;
+      using V = Value_type<Iterator_of<R>>;
+      using Key = Decay<Result_of<K(const V&)>>;
+      static_assert(Random_access_iterator<Iterator_of<R>>(), "");
+      static_assert(Same<T, V>(), "");
+      using Radix = std::integral_constant<bool, algorithm_impl::Radix_key<Key>()>;
+      algorithm_impl::radix_sort(begin(range), end(range), key, buf, Radix());
+    }
+
+  template <typename R, typename K>
+    inline void
+    radix_sort(R&& range, K key)
+    {
+      radix_buffer<Value_type<Iterator_of<R>>> buf;
+      radix_sort(range, key, buf);
+    }
+
+  template <typename R, typename T>
+    inline void
+    radix_sort(R&& range, radix_buffer<T>& buf)
+    {
+      radix_sort(range, algorithm_impl::radix_identity(), buf);
+    }
+
+  template <typename R>
+    inline void
+    radix_sort(R&& range)
+    {
+      radix_buffer<Value_type<Iterator_of<R>>> buf;
+      radix_sort(range, buf);
+    }
+
+
 
   //////////////////////////////////////////////////////////////////////////////
   // Binary Search
@@ -1377,7 +2341,9 @@ namespace origin
   // result type is const T& (although T& should be fine, too). We relax the
   // strict reference requirement so that the result is simply that of
   // dereferencing the iterator. This makes these algorithms work with 
-  // vector<bool>, for example.
+  // vector<bool>, for example. The comparison must be a relation on the
+  // range's value type so that calls like min(m, 0) are not taken to be the
+  // minimum of a range under the comparison 0.
 
   template <typename R>
     inline auto
@@ -1388,7 +2354,9 @@ namespace origin
 
   template <typename R, typename C>
     inline auto
-    min(R&& range, C comp) -> decltype(*min_element(range, comp))
+    min(R&& range, C comp)
+      -> Requires<Relation<C, Value_type<Iterator_of<R>>>(),
+                  decltype(*min_element(range, comp))>
     {
       return *min_element(range, comp);
     }
@@ -1402,9 +2370,11 @@ namespace origin
 
   template <typename R, typename C>
     inline auto
-    max(R&& range, C comp) -> decltype(*max_element(range, comp))
+    max(R&& range, C comp)
+      -> Requires<Relation<C, Value_type<Iterator_of<R>>>(),
+                  decltype(*max_element(range, comp))>
     {
-      return *max_element(range);
+      return *max_element(range, comp);
     }
 
   template <typename R>
@@ -1419,7 +2389,7 @@ namespace origin
     inline std::pair<Reference_of<R>, Reference_of<R>>
     minmax(R&& range, C comp)
     {
-      auto p = minmax_element(range);
+      auto p = minmax_element(range, comp);
       return {*p.first, *p.second};
     }
 
@@ -1490,6 +2460,343 @@ namespace origin
       return std::prev_permutation(begin(range), end(range), comp);
     }
 
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Reductions and Scans
+  //
+  // The reductions combine the elements of a range with an associative
+  // operation, which is + by default:
+  //
+  //    reduce(range, init, op)                       -- init op x0 op x1 ...
+  //    transform_reduce(range, init, op, f)          -- init op f(x0) op ...
+  //    transform_reduce(r1, r2, init, op, f)         -- init op f(x0, y0) op ...
+  //
+  // The scans write the partial results of a reduction to an output range,
+  // returning the end of the output:
+  //
+  //    inclusive_scan(in, out, op, init)  -- out[i] = init op x0 op ... op xi
+  //    exclusive_scan(in, out, init, op)  -- out[i] = init op x0 op ... op xi-1
+  //
+  // The output may be the input range. The elements may be combined in any
+  // grouping (but not any order), so the results of operations that are not
+  // associative, such as floating point addition, may differ from those of
+  // a loop. The sum of a contiguous range of float, double, int32 or int64
+  // values with std::plus is computed with vector instructions, when they
+  // are available.
+  //
+  // Each algorithm may be given an execution policy as its first argument.
+  // The parallel algorithms require random access ranges. A parallel scan
+  // makes two passes over the input: the first computes the sum of each
+  // block, and the second scans each block from the sum of the blocks before
+  // it. Small ranges (fewer than 32K elements, by default) are processed
+  // sequentially.
+  //////////////////////////////////////////////////////////////////////////////
+
+
+  template <typename R, typename T, typename Op>
+    inline Requires<!Execution_policy<R>(), T>
+    reduce(const R& range, T init, Op op)
+    {
+      using std::begin;
+      using std::end;
+      return algorithm_impl::reduce_block(begin(range), end(range), init, op);
+    }
+
+  template <typename R, typename T>
+    inline Requires<!Execution_policy<R>(), T>
+    reduce(const R& range, T init)
+    {
+      return reduce(range, init, std::plus<T>());
+    }
+
+  template <typename R>
+    inline Value_type<Iterator_of<const R>>
+    reduce(const R& range)
+    {
+      using T = Value_type<Iterator_of<const R>>;
+      return reduce(range, T(), std::plus<T>());
+    }
+
+  template <typename R, typename T, typename Op>
+    inline T
+    reduce(sequential_policy, const R& range, T init, Op op)
+    {
+      return reduce(range, init, op);
+    }
+
+  template <typename R, typename T>
+    inline T
+    reduce(sequential_policy, const R& range, T init)
+    {
+      return reduce(range, init);
+    }
+
+  template <typename R>
+    inline Value_type<Iterator_of<const R>>
+    reduce(sequential_policy, const R& range)
+    {
+      return reduce(range);
+    }
+
+  template <typename R, typename T, typename Op>
+    inline T
+    reduce(const parallel_policy& p, const R& range, T init, Op op)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<const R>>(), "");
+      return algorithm_impl::parallel_reduce(p, begin(range), end(range), init, op);
+    }
+
+  template <typename R, typename T>
+    inline T
+    reduce(const parallel_policy& p, const R& range, T init)
+    {
+      return reduce(p, range, init, std::plus<T>());
+    }
+
+  template <typename R>
+    inline Value_type<Iterator_of<const R>>
+    reduce(const parallel_policy& p, const R& range)
+    {
+      using T = Value_type<Iterator_of<const R>>;
+      return reduce(p, range, T(), std::plus<T>());
+    }
+
+
+  template <typename R, typename T, typename Op, typename F>
+    inline Requires<!Execution_policy<R>(), T>
+    transform_reduce(const R& range, T init, Op reduce_op, F transform_op)
+    {
+      using std::begin;
+      using std::end;
+      for (auto i = begin(range); i != end(range); ++i)
+        init = reduce_op(init, transform_op(*i));
+      return init;
+    }
+
+  template <typename R1, typename R2, typename T, typename Op, typename F>
+    inline Requires<!Execution_policy<R1>(), T>
+    transform_reduce(const R1& range1, const R2& range2, T init,
+                     Op reduce_op, F transform_op)
+    {
+      using std::begin;
+      using std::end;
+      auto j = begin(range2);
+      for (auto i = begin(range1); i != end(range1); ++i, ++j)
+        init = reduce_op(init, transform_op(*i, *j));
+      return init;
+    }
+
+  template <typename R1, typename R2, typename T>
+    inline Requires<!Execution_policy<R1>(), T>
+    transform_reduce(const R1& range1, const R2& range2, T init)
+    {
+      return transform_reduce(range1, range2, init, std::plus<T>(),
+                              algorithm_impl::multiply());
+    }
+
+  template <typename R, typename T, typename Op, typename F>
+    inline T
+    transform_reduce(sequential_policy, const R& range, T init,
+                     Op reduce_op, F transform_op)
+    {
+      return transform_reduce(range, init, reduce_op, transform_op);
+    }
+
+  template <typename R1, typename R2, typename T, typename Op, typename F>
+    inline T
+    transform_reduce(sequential_policy, const R1& range1, const R2& range2,
+                     T init, Op reduce_op, F transform_op)
+    {
+      return transform_reduce(range1, range2, init, reduce_op, transform_op);
+    }
+
+  template <typename R1, typename R2, typename T>
+    inline T
+    transform_reduce(sequential_policy, const R1& range1, const R2& range2, T init)
+    {
+      return transform_reduce(range1, range2, init);
+    }
+
+  template <typename R, typename T, typename Op, typename F>
+    inline T
+    transform_reduce(const parallel_policy& p, const R& range, T init,
+                     Op reduce_op, F transform_op)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<const R>>(), "");
+      return algorithm_impl::parallel_transform_reduce(p, begin(range), end(range),
+                                                       init, reduce_op, transform_op);
+    }
+
+  template <typename R1, typename R2, typename T, typename Op, typename F>
+    inline T
+    transform_reduce(const parallel_policy& p, const R1& range1, const R2& range2,
+                     T init, Op reduce_op, F transform_op)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<const R1>>(), "");
+      static_assert(Random_access_iterator<Iterator_of<const R2>>(), "");
+      return algorithm_impl::parallel_transform_reduce(p, begin(range1), end(range1),
+                                                       begin(range2), init,
+                                                       reduce_op, transform_op);
+    }
+
+  template <typename R1, typename R2, typename T>
+    inline T
+    transform_reduce(const parallel_policy& p, const R1& range1, const R2& range2,
+                     T init)
+    {
+      return transform_reduce(p, range1, range2, init, std::plus<T>(),
+                              algorithm_impl::multiply());
+    }
+
+
+  template <typename R1, typename R2, typename Op, typename T>
+    inline Requires<!Execution_policy<R1>(), Iterator_of<R2>>
+    inclusive_scan(const R1& in, R2&& out, Op op, T init)
+    {
+      using std::begin;
+      using std::end;
+      return algorithm_impl::inclusive_block(begin(in), end(in), begin(out),
+                                             init, op);
+    }
+
+  template <typename R1, typename R2, typename Op>
+    inline Requires<!Execution_policy<R1>(), Iterator_of<R2>>
+    inclusive_scan(const R1& in, R2&& out, Op op)
+    {
+      using std::begin;
+      using std::end;
+      auto i = begin(in);
+      auto o = begin(out);
+      if (i == end(in))
+        return o;
+      Value_type<Iterator_of<const R1>> init = *i;
+      *o = init;
+      return algorithm_impl::inclusive_block(++i, end(in), ++o, init, op);
+    }
+
+  template <typename R1, typename R2>
+    inline Iterator_of<R2>
+    inclusive_scan(const R1& in, R2&& out)
+    {
+      return inclusive_scan(in, out, std::plus<Value_type<Iterator_of<const R1>>>());
+    }
+
+  template <typename R1, typename R2, typename Op, typename T>
+    inline Iterator_of<R2>
+    inclusive_scan(sequential_policy, const R1& in, R2&& out, Op op, T init)
+    {
+      return inclusive_scan(in, out, op, init);
+    }
+
+  template <typename R1, typename R2, typename Op>
+    inline Iterator_of<R2>
+    inclusive_scan(sequential_policy, const R1& in, R2&& out, Op op)
+    {
+      return inclusive_scan(in, out, op);
+    }
+
+  template <typename R1, typename R2>
+    inline Iterator_of<R2>
+    inclusive_scan(sequential_policy, const R1& in, R2&& out)
+    {
+      return inclusive_scan(in, out);
+    }
+
+  template <typename R1, typename R2, typename Op, typename T>
+    inline Iterator_of<R2>
+    inclusive_scan(const parallel_policy& p, const R1& in, R2&& out,
+                   Op op, T init)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<const R1>>(), "");
+      static_assert(Random_access_iterator<Iterator_of<R2>>(), "");
+      return algorithm_impl::parallel_inclusive_scan(p, begin(in), end(in),
+                                                     begin(out), init, op);
+    }
+
+  template <typename R1, typename R2, typename Op>
+    inline Iterator_of<R2>
+    inclusive_scan(const parallel_policy& p, const R1& in, R2&& out, Op op)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<const R1>>(), "");
+      static_assert(Random_access_iterator<Iterator_of<R2>>(), "");
+      auto i = begin(in);
+      auto o = begin(out);
+      if (i == end(in))
+        return o;
+      Value_type<Iterator_of<const R1>> init = *i;
+      *o = init;
+      return algorithm_impl::parallel_inclusive_scan(p, i + 1, end(in), o + 1, init, op);
+    }
+
+  template <typename R1, typename R2>
+    inline Iterator_of<R2>
+    inclusive_scan(const parallel_policy& p, const R1& in, R2&& out)
+    {
+      return inclusive_scan(p, in, out, std::plus<Value_type<Iterator_of<const R1>>>());
+    }
+
+
+  template <typename R1, typename R2, typename T, typename Op>
+    inline Requires<!Execution_policy<R1>(), Iterator_of<R2>>
+    exclusive_scan(const R1& in, R2&& out, T init, Op op)
+    {
+      using std::begin;
+      using std::end;
+      return algorithm_impl::exclusive_block(begin(in), end(in), begin(out),
+                                             init, op);
+    }
+
+  template <typename R1, typename R2, typename T>
+    inline Requires<!Execution_policy<R1>(), Iterator_of<R2>>
+    exclusive_scan(const R1& in, R2&& out, T init)
+    {
+      return exclusive_scan(in, out, init, std::plus<T>());
+    }
+
+  template <typename R1, typename R2, typename T, typename Op>
+    inline Iterator_of<R2>
+    exclusive_scan(sequential_policy, const R1& in, R2&& out, T init, Op op)
+    {
+      return exclusive_scan(in, out, init, op);
+    }
+
+  template <typename R1, typename R2, typename T>
+    inline Iterator_of<R2>
+    exclusive_scan(sequential_policy, const R1& in, R2&& out, T init)
+    {
+      return exclusive_scan(in, out, init);
+    }
+
+  template <typename R1, typename R2, typename T, typename Op>
+    inline Iterator_of<R2>
+    exclusive_scan(const parallel_policy& p, const R1& in, R2&& out,
+                   T init, Op op)
+    {
+      using std::begin;
+      using std::end;
+      static_assert(Random_access_iterator<Iterator_of<const R1>>(), "");
+      static_assert(Random_access_iterator<Iterator_of<R2>>(), "");
+      return algorithm_impl::parallel_exclusive_scan(p, begin(in), end(in),
+                                                     begin(out), init, op);
+    }
+
+  template <typename R1, typename R2, typename T>
+    inline Iterator_of<R2>
+    exclusive_scan(const parallel_policy& p, const R1& in, R2&& out, T init)
+    {
+      return exclusive_scan(p, in, out, init, std::plus<T>());
+    }
+
 } // namespace origin
 
 #endif
@@ -0,0 +1,205 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+namespace algorithm_impl
+{
+  // The simd key of a value type is the type of the elements passed to the
+  // vectorized comparison kernels. Integers are equal exactly when their
+  // bits are, so integers of either signedness are compared as the signed
+  // kernel type of the same size. Other types have no simd key (void).
+  template <typename T>
+    struct simd_key { using type = void; };
+
+  template <> struct simd_key<char> { using type = char; };
+  template <> struct simd_key<signed char> { using type = char; };
+  template <> struct simd_key<unsigned char> { using type = char; };
+  template <> struct simd_key<std::int32_t> { using type = std::int32_t; };
+  template <> struct simd_key<std::uint32_t> { using type = std::int32_t; };
+  template <> struct simd_key<std::int64_t> { using type = std::int64_t; };
+  template <> struct simd_key<std::uint64_t> { using type = std::int64_t; };
+  template <> struct simd_key<float> { using type = float; };
+  template <> struct simd_key<double> { using type = double; };
+
+  template <typename T>
+    using Simd_key = typename simd_key<T>::type;
+
+  // The number of bytes below which the comparison algorithms use a loop,
+  // which is faster than calling a kernel for a few elements.
+  constexpr std::size_t simd_compare_threshold = 64;
+
+  // Returns true if the n elements of type T are too few for the kernels.
+  template <typename T>
+    constexpr bool
+    simd_too_short(std::size_t n)
+    {
+      return n * sizeof(T) < simd_compare_threshold;
+    }
+
+  // Returns true if the elements of I can be compared by the vectorized
+  // kernels.
+  template <typename I>
+    constexpr bool Simd_comparable()
+    {
+      return Contiguous_iterator<I>() && !Same<Simd_key<Value_type<I>>, void>();
+    }
+
+  // Returns true if the elements of I can be compared to a value of type T
+  // by the vectorized kernels. The value must have the element type, or
+  // both must be integers.
+  template <typename I, typename T>
+    constexpr bool Simd_find()
+    {
+      return Simd_comparable<I>()
+          && (Same<T, Value_type<I>>()
+              || (Integer<T>() && Integer<Value_type<I>>()));
+    }
+
+  // Returns the simd key of the element that the contiguous iterator i
+  // refers to.
+  template <typename I>
+    inline const Simd_key<Value_type<I>>*
+    simd_key_address(I i)
+    {
+      return reinterpret_cast<const Simd_key<Value_type<I>>*>(simd_address(i));
+    }
+
+  // Convert x to the element type V, storing the result in v. Returns false
+  // if no value of type V is equal to x (e.g., a NaN, or an integer that is
+  // out of the range of V).
+  //
+  // An element e is equal to x when C(e) == C(x), where C is the type to
+  // which both are converted for the comparison. The conversion of V to C
+  // is one-to-one, so v is the only value that can be equal to x.
+  template <typename V, typename T>
+    inline bool
+    simd_value(const T& x, V& v)
+    {
+      using C = decltype(v + x);
+      v = static_cast<V>(x);
+      return static_cast<C>(v) == static_cast<C>(x);
+    }
+
+
+  // Each algorithm is selected by a tag that is true_type when the kernels
+  // can be used. Otherwise, the standard algorithm is used.
+
+  template <typename I, typename T>
+    inline I
+    find_value(I first, I last, const T& value, std::false_type)
+    {
+      return std::find(first, last, value);
+    }
+
+  template <typename I, typename T>
+    inline I
+    find_value(I first, I last, const T& value, std::true_type)
+    {
+      using V = Value_type<I>;
+      if (simd_too_short<V>(last - first))
+        return std::find(first, last, value);
+      V v;
+      if (!simd_value(value, v))
+        return last;
+      return first + simd_find(simd_key_address(first), last - first,
+                               Simd_key<V>(v));
+    }
+
+  template <typename I, typename T>
+    inline std::size_t
+    count_value(I first, I last, const T& value, std::false_type)
+    {
+      return std::count(first, last, value);
+    }
+
+  template <typename I, typename T>
+    inline std::size_t
+    count_value(I first, I last, const T& value, std::true_type)
+    {
+      using V = Value_type<I>;
+      if (simd_too_short<V>(last - first))
+        return std::count(first, last, value);
+      V v;
+      if (!simd_value(value, v))
+        return 0;
+      return simd_count(simd_key_address(first), last - first, Simd_key<V>(v));
+    }
+
+  template <typename I1, typename I2>
+    inline std::pair<I1, I2>
+    mismatch_values(I1 first1, I1 last1, I2 first2, std::false_type)
+    {
+      return std::mismatch(first1, last1, first2);
+    }
+
+  template <typename I1, typename I2>
+    inline std::pair<I1, I2>
+    mismatch_values(I1 first1, I1 last1, I2 first2, std::true_type)
+    {
+      if (simd_too_short<Value_type<I1>>(last1 - first1))
+        return std::mismatch(first1, last1, first2);
+      std::size_t i = simd_mismatch(simd_key_address(first1),
+                                    simd_key_address(first2),
+                                    last1 - first1);
+      return {first1 + i, first2 + i};
+    }
+
+  template <typename I, typename T>
+    inline I
+    search_run(I first, I last, std::ptrdiff_t count, const T& value,
+               std::false_type)
+    {
+      return std::search_n(first, last, count, value);
+    }
+
+  // Returns the first of count consecutive elements equal to value.
+  //
+  // Each candidate is found by the find kernel, and the length of its run
+  // by finding the first element that is not equal to value among the next
+  // count - 1 elements (with a loop, when count is small). Elements in a run
+  // that is too short are not examined again, so each element is compared
+  // at most once.
+  template <typename I, typename T>
+    I
+    search_run(I first, I last, std::ptrdiff_t count, const T& value,
+               std::true_type)
+    {
+      using V = Value_type<I>;
+      if (simd_too_short<V>(last - first))
+        return std::search_n(first, last, count, value);
+      if (count <= 0)
+        return first;
+      V v;
+      if (!simd_value(value, v))
+        return last;
+
+      const auto* p = simd_key_address(first);
+      const Simd_key<V> x = Simd_key<V>(v);
+      const std::size_t n = last - first;
+      const std::size_t m = count;
+      std::size_t i = 0;
+      while (n - i >= m) {
+        i += simd_find(p + i, n - i, x);
+        if (n - i < m)
+          break;
+        std::size_t j = i + 1;
+        if (simd_too_short<V>(m - 1)) {
+          while (j != i + m && p[j] == x)
+            ++j;
+        } else {
+          j += simd_find_not(p + j, m - 1, x);
+        }
+        if (j == i + m)
+          return first + i;
+        i = j + 1;
+      }
+      return last;
+    }
+} // namespace algorithm_impl
@@ -0,0 +1,231 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+namespace algorithm_impl
+{
+  // Each parallel algorithm below runs sequentially on fewer elements than
+  // its threshold, and divides larger ranges into blocks of at least its
+  // minimum grain, unless the policy gives other values.
+  //
+  // The function passed to for_each may do any amount of work, so blocks
+  // are small and the range is split early. transform does little work per
+  // element and is bound by memory bandwidth, like the reductions. The
+  // filters (copy_if, remove_if and partition) make several passes over
+  // each block and allocate per-block counts, so their blocks are larger.
+  constexpr std::size_t for_each_threshold = 1 << 12;
+  constexpr std::size_t for_each_grain = 256;
+  constexpr std::size_t transform_threshold = 1 << 15;
+  constexpr std::size_t transform_grain = 4096;
+  constexpr std::size_t filter_threshold = 1 << 15;
+  constexpr std::size_t filter_grain = 1 << 14;
+
+
+  // Call f(*i) for each i in [first, last), in parallel.
+  template <typename I, typename F>
+    void
+    parallel_for_each(const parallel_policy& p, I first, I last, F& f)
+    {
+      const std::size_t n = last - first;
+      if (!p.parallel(n, for_each_threshold)) {
+        std::for_each(first, last, std::ref(f));
+        return;
+      }
+      p.pool().parallel_for(0, n, p.grain(n, for_each_grain),
+                            [&](std::size_t i, std::size_t j) {
+        std::for_each(first + i, first + j, std::ref(f));
+      });
+    }
+
+  // Write op(*i) for each i in [first, last) to out, in parallel.
+  template <typename I, typename O, typename Op>
+    O
+    parallel_transform(const parallel_policy& p, I first, I last, O out, Op op)
+    {
+      const std::size_t n = last - first;
+      if (!p.parallel(n, transform_threshold))
+        return std::transform(first, last, out, op);
+      p.pool().parallel_for(0, n, p.grain(n, transform_grain),
+                            [&](std::size_t i, std::size_t j) {
+        std::transform(first + i, first + j, out + i, op);
+      });
+      return out + n;
+    }
+
+  template <typename I1, typename I2, typename O, typename Op>
+    O
+    parallel_transform(const parallel_policy& p, I1 first1, I1 last1, I2 first2,
+                       O out, Op op)
+    {
+      const std::size_t n = last1 - first1;
+      if (!p.parallel(n, transform_threshold))
+        return std::transform(first1, last1, first2, out, op);
+      p.pool().parallel_for(0, n, p.grain(n, transform_grain),
+                            [&](std::size_t i, std::size_t j) {
+        std::transform(first1 + i, first1 + j, first2 + i, out + i, op);
+      });
+      return out + n;
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Count and Scatter
+  //
+  // The parallel filters preserve the order of the elements by counting
+  // before they write. The range is divided into blocks of g elements. The
+  // first pass evaluates the predicate on each element, recording the
+  // result in a flag, and counts the satisfying elements of each block. A
+  // sequential scan of the counts gives the position of the first output
+  // of each block, and the second pass writes the elements of each block
+  // in order from that position. The predicate is called exactly once for
+  // each element.
+
+  // The flags and block counts of a range of n elements.
+  class filter_counts
+  {
+  public:
+    filter_counts(const parallel_policy& p, std::size_t n)
+      : n(n),
+        g(p.grain(n, filter_grain)),
+        flags(new unsigned char[n]),
+        offsets(block_count(n, g) + 1)
+    { }
+
+    std::size_t blocks() const { return offsets.size() - 1; }
+
+    // Returns the first and last elements of block b.
+    std::size_t lo(std::size_t b) const { return b * g; }
+    std::size_t hi(std::size_t b) const { return std::min(n, b * g + g); }
+
+    // Count the elements of [first, first + n) that satisfy pred. After
+    // this, offsets[b] is the number of satisfying elements before block b
+    // and the result is their total.
+    template <typename I, typename P>
+      std::size_t count(const parallel_policy& p, I first, P& pred);
+
+    // Call t(i, k) for the kth satisfying element i and f(i, k) for the kth
+    // element i that does not satisfy the predicate, in parallel.
+    template <typename T, typename F>
+      void scatter(const parallel_policy& p, T t, F f) const;
+
+  private:
+    std::size_t n;
+    std::size_t g;
+    std::unique_ptr<unsigned char[]> flags;
+    std::vector<std::size_t> offsets;
+  };
+
+  template <typename I, typename P>
+    std::size_t
+    filter_counts::count(const parallel_policy& p, I first, P& pred)
+    {
+      p.pool().parallel_for(0, blocks(), 1, [&](std::size_t b, std::size_t e) {
+        for ( ; b != e; ++b) {
+          std::size_t k = 0;
+          for (std::size_t i = lo(b); i != hi(b); ++i) {
+            bool x = pred(first[i]);
+            flags[i] = x;
+            k += x;
+          }
+          offsets[b + 1] = k;
+        }
+      });
+      for (std::size_t b = 0; b < blocks(); ++b)
+        offsets[b + 1] += offsets[b];
+      return offsets.back();
+    }
+
+  template <typename T, typename F>
+    void
+    filter_counts::scatter(const parallel_policy& p, T t, F f) const
+    {
+      p.pool().parallel_for(0, blocks(), 1, [&](std::size_t b, std::size_t e) {
+        for ( ; b != e; ++b) {
+          std::size_t kt = offsets[b];
+          std::size_t kf = lo(b) - kt;
+          for (std::size_t i = lo(b); i != hi(b); ++i) {
+            if (flags[i])
+              t(i, kt++);
+            else
+              f(i, kf++);
+          }
+        }
+      });
+    }
+
+
+  // Copy the elements of [first, last) that satisfy pred to out, in
+  // parallel. The range and the output are not overlapping.
+  template <typename I, typename O, typename P>
+    O
+    parallel_copy_if(const parallel_policy& p, I first, I last, O out, P pred)
+    {
+      const std::size_t n = last - first;
+      if (!p.parallel(n, filter_threshold))
+        return std::copy_if(first, last, out, pred);
+
+      filter_counts c(p, n);
+      std::size_t k = c.count(p, first, pred);
+      c.scatter(p, [&](std::size_t i, std::size_t j) { out[j] = first[i]; },
+                   [](std::size_t, std::size_t) { });
+      return out + k;
+    }
+
+  // Move the elements of [first, last) that do not satisfy pred to the
+  // front of the range, in order, and return the end of those elements.
+  //
+  // Writing each element in place could overwrite elements of another
+  // block before they are read, so the range is first moved to a buffer.
+  // Elements that are moved back are assigned, so if a move throws, every
+  // element is still valid.
+  template <typename I, typename P>
+    I
+    parallel_remove_if(const parallel_policy& p, I first, I last, P pred)
+    {
+      using T = Value_type<I>;
+      const std::size_t n = last - first;
+      if (!p.parallel(n, filter_threshold))
+        return std::remove_if(first, last, pred);
+
+      filter_counts c(p, n);
+      std::size_t k = n - c.count(p, first, pred);
+      if (k == 0 || k == n)
+        return first + k;
+      parallel_buffer<T> buf(p, std::make_move_iterator(first), n);
+      T* b = buf.data();
+      c.scatter(p, [](std::size_t, std::size_t) { },
+                   [&](std::size_t i, std::size_t j) { first[j] = std::move(b[i]); });
+      return first + k;
+    }
+
+  // Move the elements of [first, last) that satisfy pred before those that
+  // do not, preserving the order of both, and return the end of the first
+  // group.
+  template <typename I, typename P>
+    I
+    parallel_partition(const parallel_policy& p, I first, I last, P pred)
+    {
+      using T = Value_type<I>;
+      const std::size_t n = last - first;
+      if (!p.parallel(n, filter_threshold))
+        return std::stable_partition(first, last, pred);
+
+      filter_counts c(p, n);
+      std::size_t k = c.count(p, first, pred);
+      if (k == 0 || k == n)
+        return first + k;
+      parallel_buffer<T> buf(p, std::make_move_iterator(first), n);
+      T* b = buf.data();
+      I mid = first + k;
+      c.scatter(p, [&](std::size_t i, std::size_t j) { first[j] = std::move(b[i]); },
+                   [&](std::size_t i, std::size_t j) { mid[j] = std::move(b[i]); });
+      return mid;
+    }
+} // namespace algorithm_impl
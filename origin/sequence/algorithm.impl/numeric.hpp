@@ -0,0 +1,309 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+namespace algorithm_impl
+{
+  // The number of elements below which the parallel reductions and scans
+  // run sequentially, unless the policy gives another threshold.
+  constexpr std::size_t reduce_threshold = 1 << 15;
+
+
+  // The default transformation of the binary transform_reduce, which
+  // multiplies pairs of elements.
+  struct multiply
+  {
+    template <typename T, typename U>
+      auto operator()(const T& a, const U& b) const -> decltype(a * b)
+      {
+        return a * b;
+      }
+  };
+
+  // Returns true if the sum of the elements of I, starting from a value of
+  // type T, can be computed by the vectorized kernels. This is the case
+  // when Op is std::plus<T> and I is a contiguous iterator over T.
+  template <typename I, typename T, typename Op>
+    constexpr bool Simd_sum()
+    {
+      return Same<Op, std::plus<T>>() && Simd_iterator<I, T>();
+    }
+
+  // Returns true if a scan of the elements of I into O with Op, starting
+  // from a value of type T, can be computed by the vectorized kernels.
+  template <typename I, typename O, typename T, typename Op>
+    constexpr bool Simd_scan()
+    {
+      return Simd_sum<I, T, Op>() && Simd_iterator<O, T>();
+    }
+
+  template <bool B>
+    using bool_constant = std::integral_constant<bool, B>;
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Sequential Blocks
+  //
+  // The sequential algorithms are applied to each block of a parallel
+  // algorithm, and to the whole range when the algorithm runs sequentially.
+
+  // Returns init op *first op ... op *(last - 1).
+  template <typename I, typename T, typename Op>
+    T
+    reduce_block(I first, I last, T init, Op op, std::false_type)
+    {
+      for ( ; first != last; ++first)
+        init = op(init, *first);
+      return init;
+    }
+
+  template <typename I, typename T, typename Op>
+    inline T
+    reduce_block(I first, I last, T init, Op, std::true_type)
+    {
+      if (first == last)
+        return init;
+      return init + simd_sum(simd_address(first), last - first);
+    }
+
+  template <typename I, typename T, typename Op>
+    inline T
+    reduce_block(I first, I last, T init, Op op)
+    {
+      using Simd = bool_constant<Simd_sum<I, T, Op>()>;
+      return reduce_block(first, last, init, op, Simd());
+    }
+
+  // Write the inclusive scan of [first, last), starting from init, to out
+  // and return the end of the output.
+  template <typename I, typename O, typename T, typename Op>
+    O
+    inclusive_block(I first, I last, O out, T init, Op op, std::false_type)
+    {
+      for ( ; first != last; ++first, ++out) {
+        init = op(init, *first);
+        *out = init;
+      }
+      return out;
+    }
+
+  template <typename I, typename O, typename T, typename Op>
+    inline O
+    inclusive_block(I first, I last, O out, T init, Op, std::true_type)
+    {
+      const std::size_t n = last - first;
+      if (n != 0)
+        simd_scan(simd_address(first), simd_address(out), n, init);
+      return out + n;
+    }
+
+  template <typename I, typename O, typename T, typename Op>
+    inline O
+    inclusive_block(I first, I last, O out, T init, Op op)
+    {
+      using Simd = bool_constant<Simd_scan<I, O, T, Op>()>;
+      return inclusive_block(first, last, out, init, op, Simd());
+    }
+
+  // Write the exclusive scan of [first, last), starting from init, to out
+  // and return the end of the output. Each element is read before the
+  // output is written, so the scan may be done in place.
+  template <typename I, typename O, typename T, typename Op>
+    O
+    exclusive_block(I first, I last, O out, T init, Op op, std::false_type)
+    {
+      for ( ; first != last; ++first, ++out) {
+        T x = op(init, *first);
+        *out = std::move(init);
+        init = std::move(x);
+      }
+      return out;
+    }
+
+  // The vectorized exclusive scan is the inclusive scan of all but the last
+  // element, written one position to the right. The kernel cannot shift
+  // elements in place, so an in-place scan uses the loop.
+  template <typename I, typename O, typename T, typename Op>
+    inline O
+    exclusive_block(I first, I last, O out, T init, Op op, std::true_type)
+    {
+      const std::size_t n = last - first;
+      if (n == 0)
+        return out;
+      const T* a = simd_address(first);
+      T* b = simd_address(out);
+      if (a == b)
+        return exclusive_block(first, last, out, init, op, std::false_type());
+      *b = init;
+      simd_scan(a, b + 1, n - 1, init);
+      return out + n;
+    }
+
+  template <typename I, typename O, typename T, typename Op>
+    inline O
+    exclusive_block(I first, I last, O out, T init, Op op)
+    {
+      using Simd = bool_constant<Simd_scan<I, O, T, Op>()>;
+      return exclusive_block(first, last, out, init, op, Simd());
+    }
+
+
+  // ------------------------------------------------------------------------ //
+  //                          Parallel Algorithms
+  //
+  // The parallel algorithms divide the range into blocks. The order in
+  // which the elements are combined is not the order of a loop, so op must
+  // be associative. Elements are never reordered, so op need not be
+  // commutative.
+
+  // Returns init op f(0) op ... op f(blocks - 1), where f(b) computes the
+  // partial result of block b, which is [lo, hi) for g elements per block.
+  // The partial results are computed in parallel.
+  template <typename T, typename Op, typename F>
+    T
+    reduce_blocks(const parallel_policy& p, std::size_t n, std::size_t g,
+                  T init, Op op, F f)
+    {
+      const std::size_t blocks = block_count(n, g);
+      std::vector<T> part(blocks, init);
+      p.pool().parallel_for(0, blocks, 1, [&](std::size_t b, std::size_t e) {
+        for ( ; b != e; ++b)
+          part[b] = f(b * g, std::min(n, b * g + g));
+      });
+      for (T& x : part)
+        init = op(init, std::move(x));
+      return init;
+    }
+
+  // The partial result of each block starts with the block's first
+  // element, so that init is combined only once.
+  template <typename I, typename T, typename Op>
+    T
+    parallel_reduce(const parallel_policy& p, I first, I last, T init, Op op)
+    {
+      const std::size_t n = last - first;
+      if (n == 0 || !p.parallel(n, reduce_threshold))
+        return reduce_block(first, last, init, op);
+
+      const std::size_t g = p.grain(n, 4096);
+      return reduce_blocks(p, n, g, init, op, [&](std::size_t lo, std::size_t hi) {
+        return reduce_block(first + lo + 1, first + hi, T(first[lo]), op);
+      });
+    }
+
+  template <typename I, typename T, typename R, typename F>
+    T
+    parallel_transform_reduce(const parallel_policy& p, I first, I last,
+                              T init, R reduce_op, F transform_op)
+    {
+      const std::size_t n = last - first;
+      auto block = [&](std::size_t lo, std::size_t hi, T x) {
+        for (I i = first + lo; i != first + hi; ++i)
+          x = reduce_op(x, transform_op(*i));
+        return x;
+      };
+      if (n == 0 || !p.parallel(n, reduce_threshold))
+        return block(0, n, init);
+
+      const std::size_t g = p.grain(n, 4096);
+      return reduce_blocks(p, n, g, init, reduce_op, [&](std::size_t lo, std::size_t hi) {
+        return block(lo + 1, hi, T(transform_op(first[lo])));
+      });
+    }
+
+  template <typename I1, typename I2, typename T, typename R, typename F>
+    T
+    parallel_transform_reduce(const parallel_policy& p,
+                              I1 first1, I1 last1, I2 first2,
+                              T init, R reduce_op, F transform_op)
+    {
+      const std::size_t n = last1 - first1;
+      auto block = [&](std::size_t lo, std::size_t hi, T x) {
+        for (std::size_t i = lo; i != hi; ++i)
+          x = reduce_op(x, transform_op(first1[i], first2[i]));
+        return x;
+      };
+      if (n == 0 || !p.parallel(n, reduce_threshold))
+        return block(0, n, init);
+
+      const std::size_t g = p.grain(n, 4096);
+      return reduce_blocks(p, n, g, init, reduce_op, [&](std::size_t lo, std::size_t hi) {
+        return block(lo + 1, hi, T(transform_op(first1[lo], first2[lo])));
+      });
+    }
+
+
+  // Scan [first, last) into out by a two-pass blocked scan. The first pass
+  // computes the sum of each block (except the last) in parallel. A
+  // sequential scan of the block sums gives the initial value of each
+  // block, and the second pass scans the blocks in parallel. Each element is
+  // read twice and written once.
+  //
+  // The blocks are scanned by scan(first, last, out, init), which is either
+  // the inclusive or exclusive block scan.
+  template <typename I, typename O, typename T, typename Op, typename S>
+    O
+    blocked_scan(const parallel_policy& p, I first, I last, O out,
+                 T init, Op op, S scan)
+    {
+      const std::size_t n = last - first;
+      if (n == 0 || !p.parallel(n, reduce_threshold))
+        return scan(first, last, out, init);
+
+      const std::size_t g = p.grain(n, 4096);
+      const std::size_t blocks = block_count(n, g);
+      std::vector<T> start(blocks, init);
+      thread_pool& pool = p.pool();
+      pool.parallel_for(0, blocks - 1, 1, [&](std::size_t b, std::size_t e) {
+        for ( ; b != e; ++b) {
+          I i = first + b * g;
+          start[b] = reduce_block(i + 1, i + g, T(*i), op);
+        }
+      });
+
+      for (std::size_t b = 0; b < blocks - 1; ++b) {
+        T x = op(init, start[b]);
+        start[b] = std::move(init);
+        init = std::move(x);
+      }
+      start[blocks - 1] = std::move(init);
+
+      pool.parallel_for(0, blocks, 1, [&](std::size_t b, std::size_t e) {
+        for ( ; b != e; ++b) {
+          std::size_t lo = b * g;
+          std::size_t hi = std::min(n, lo + g);
+          scan(first + lo, first + hi, out + lo, start[b]);
+        }
+      });
+      return out + n;
+    }
+
+  template <typename I, typename O, typename T, typename Op>
+    inline O
+    parallel_inclusive_scan(const parallel_policy& p, I first, I last, O out,
+                            T init, Op op)
+    {
+      return blocked_scan(p, first, last, out, init, op,
+                          [&op](I i, I j, O o, const T& x) {
+                            return inclusive_block(i, j, o, x, op);
+                          });
+    }
+
+  template <typename I, typename O, typename T, typename Op>
+    inline O
+    parallel_exclusive_scan(const parallel_policy& p, I first, I last, O out,
+                            T init, Op op)
+    {
+      return blocked_scan(p, first, last, out, init, op,
+                          [&op](I i, I j, O o, const T& x) {
+                            return exclusive_block(i, j, o, x, op);
+                          });
+    }
+} // namespace algorithm_impl
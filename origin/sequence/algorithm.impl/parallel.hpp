@@ -0,0 +1,105 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+namespace algorithm_impl
+{
+  // Returns the number of blocks of at most g elements in n elements.
+  inline std::size_t
+  block_count(std::size_t n, std::size_t g)
+  {
+    return (n + g - 1) / g;
+  }
+
+
+  // A parallel buffer is uninitialized storage for n objects of type T that
+  // is filled in parallel from a random access range. The objects are
+  // destroyed with the buffer.
+  //
+  // The buffer is filled in blocks. If constructing an object throws, the
+  // objects in the blocks that were completed are destroyed before the
+  // exception is rethrown. To move the elements of a range into the buffer,
+  // initialize it with a move_iterator.
+  template <typename T>
+    class parallel_buffer
+    {
+    public:
+      template <typename I>
+        parallel_buffer(const parallel_policy& p, I first, std::size_t n);
+
+      parallel_buffer(const parallel_buffer&) = delete;
+      parallel_buffer& operator=(const parallel_buffer&) = delete;
+
+      ~parallel_buffer();
+
+      T* data() { return buf; }
+      std::size_t size() const { return len; }
+
+    private:
+      void destroy(std::size_t first, std::size_t last);
+
+      std::allocator<T> alloc;
+      T* buf;
+      std::size_t len;
+    };
+
+  template <typename T>
+    template <typename I>
+      parallel_buffer<T>::parallel_buffer(const parallel_policy& p,
+                                          I first, std::size_t n)
+        : buf(alloc.allocate(n)), len(n)
+      {
+        const std::size_t g = p.grain(n, 4096);
+        const std::size_t blocks = block_count(n, g);
+        std::unique_ptr<bool[]> done(new bool[blocks]());
+        try {
+          p.pool().parallel_for(0, blocks, 1, [&](std::size_t i, std::size_t j) {
+            for ( ; i != j; ++i) {
+              std::size_t lo = i * g;
+              std::size_t hi = std::min(n, lo + g);
+              std::uninitialized_copy(first + lo, first + hi, buf + lo);
+              done[i] = true;
+            }
+          });
+        } catch (...) {
+          for (std::size_t i = 0; i < blocks; ++i)
+            if (done[i])
+              destroy(i * g, std::min(n, i * g + g));
+          alloc.deallocate(buf, n);
+          throw;
+        }
+      }
+
+  template <typename T>
+    parallel_buffer<T>::~parallel_buffer()
+    {
+      destroy(0, len);
+      alloc.deallocate(buf, len);
+    }
+
+  template <typename T>
+    inline void
+    parallel_buffer<T>::destroy(std::size_t first, std::size_t last)
+    {
+      for ( ; first != last; ++first)
+        buf[first].~T();
+    }
+
+
+  // Move the n elements in [first, first + n) to out in parallel.
+  template <typename I, typename O>
+    void
+    parallel_move(const parallel_policy& p, I first, std::size_t n, O out)
+    {
+      p.pool().parallel_for(0, n, p.grain(n, 4096), [&](std::size_t i, std::size_t j) {
+        std::move(first + i, first + j, out + i);
+      });
+    }
+} // namespace algorithm_impl
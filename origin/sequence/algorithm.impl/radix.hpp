@@ -0,0 +1,232 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+namespace algorithm_impl
+{
+  // The number of elements below which radix_sort uses a comparison sort.
+  constexpr std::size_t radix_threshold = 256;
+
+  // The number of elements above which radix_sort begins with an MSD pass.
+  constexpr std::size_t radix_msd_threshold = 1 << 16;
+
+
+  // The radix traits map a key to an unsigned integer whose order is the
+  // order of the keys. Unsigned integers are their own radix keys.
+  template <typename T, bool = Floating_point<T>(), bool = Signed<T>()>
+    struct radix_traits
+    {
+      using key_type = T;
+
+      static key_type key(T x) { return x; }
+    };
+
+  // The sign bit of a signed integer is flipped so that negative values
+  // precede positive values.
+  template <typename T>
+    struct radix_traits<T, false, true>
+    {
+      using key_type = Make_unsigned<T>;
+
+      static key_type
+      key(T x)
+      {
+        return key_type(x) ^ (key_type(1) << (8 * sizeof(T) - 1));
+      }
+    };
+
+  // The bits of a negative floating point value are all flipped, so that
+  // larger magnitudes come first. The sign bit of a positive value is set
+  // so that it follows the negative values. This orders -0 before +0, and
+  // NaNs before -infinity or after +infinity, depending on their sign.
+  template <typename T>
+    struct radix_traits<T, true, true>
+    {
+      using key_type = typename std::conditional<
+        sizeof(T) == 4, std::uint32_t, std::uint64_t
+      >::type;
+
+      static key_type
+      key(T x)
+      {
+        key_type u;
+        std::memcpy(&u, &x, sizeof(u));
+        const key_type sign = key_type(1) << (8 * sizeof(u) - 1);
+        return (u & sign) ? ~u : (u | sign);
+      }
+    };
+
+  // Returns true if values of type T can be sorted by radix. T must be an
+  // integer or an IEEE single or double precision floating point type.
+  template <typename T>
+    constexpr bool Radix_key()
+    {
+      return Integer<T>()
+          || (Floating_point<T>()
+              && std::numeric_limits<T>::is_iec559
+              && (sizeof(T) == 4 || sizeof(T) == 8));
+    }
+
+  // Returns the radix key of x.
+  template <typename T>
+    inline typename radix_traits<T>::key_type
+    radix_key(T x)
+    {
+      return radix_traits<T>::key(x);
+    }
+
+
+  // The identity key function used when elements are their own keys.
+  struct radix_identity
+  {
+    template <typename T>
+      const T& operator()(const T& x) const { return x; }
+  };
+
+  // Move the elements in [first, first + n) to out, placing each element
+  // at the offset of its digit, given by shifting its radix key. The
+  // offsets are copied to a local array, since the compiler cannot assume
+  // that writing to out (e.g., an array of std::size_t) does not modify
+  // them.
+  template <typename I, typename O, typename K>
+    void
+    radix_scatter(I first, std::size_t n, O out, K key,
+                  unsigned shift, const std::size_t* offset)
+    {
+      std::size_t pos[256];
+      std::copy(offset, offset + 256, pos);
+      for (std::size_t i = 0; i < n; ++i, ++first) {
+        std::size_t d = (radix_key(key(*first)) >> shift) & 0xff;
+        out[pos[d]++] = std::move(*first);
+      }
+    }
+
+  // Count the values of the digits below digits in the radix keys of the
+  // elements in [first, first + n).
+  template <typename I, typename K>
+    void
+    radix_count(I first, std::size_t n, K key,
+                std::size_t digits, std::size_t (*count)[256])
+    {
+      for (std::size_t i = 0; i < n; ++i, ++first) {
+        auto k = radix_key(key(*first));
+        for (std::size_t d = 0; d < digits; ++d)
+          ++count[d][(k >> (8 * d)) & 0xff];
+      }
+    }
+
+  // Sort the n elements of a by the digits below digits, whose values are
+  // counted in count, using b for storage. Each digit moves the elements
+  // between a and b, except for digits that are the same in every key.
+  // Returns true if the sorted elements are in b.
+  template <typename I, typename O, typename K>
+    bool
+    radix_lsd(I a, O b, std::size_t n, K key,
+              std::size_t digits, std::size_t (*count)[256])
+    {
+      bool moved = false;
+      for (std::size_t d = 0; d < digits; ++d) {
+        std::size_t* c = count[d];
+        if (std::find(c, c + 256, n) != c + 256)
+          continue;
+
+        std::size_t pos = 0;
+        for (std::size_t j = 0; j < 256; ++j) {
+          std::size_t x = c[j];
+          c[j] = pos;
+          pos += x;
+        }
+        if (moved)
+          radix_scatter(b, n, a, key, 8 * d, c);
+        else
+          radix_scatter(a, n, b, key, 8 * d, c);
+        moved = !moved;
+      }
+      return moved;
+    }
+
+  // Sort the n elements of a by the digits below digits of their radix
+  // keys, using b for storage. Returns true if the sorted elements are in b.
+  //
+  // Small ranges are sorted by an LSD radix sort, which makes a pass over
+  // the elements for each digit. The digits of every key are counted in a
+  // single pass, so digits shared by every key (e.g., the high bytes of
+  // small integers) are skipped.
+  //
+  // Scattering a large range to 256 buckets is limited by cache and TLB
+  // misses, so a large range is first partitioned into b by its most
+  // significant digit (an MSD pass). Each bucket is then sorted recursively
+  // and moved back to a, so that the LSD passes run on buckets that are
+  // likely to fit in cache.
+  template <typename I, typename O, typename K>
+    bool
+    radix_msd(I a, O b, std::size_t n, K key, std::size_t digits)
+    {
+      using Key = Decay<decltype(radix_key(key(*a)))>;
+      std::size_t count[sizeof(Key)][256] = {};
+      radix_count(a, n, key, digits, count);
+
+      // Find the most significant digit that differs between keys.
+      std::size_t h = digits;
+      while (h != 0 && std::find(count[h - 1], count[h - 1] + 256, n) != count[h - 1] + 256)
+        --h;
+      if (h == 0)
+        return false;
+      if (n < radix_msd_threshold || h == 1)
+        return radix_lsd(a, b, n, key, h, count);
+
+      std::size_t start[257];
+      std::size_t pos = 0;
+      for (std::size_t j = 0; j < 256; ++j) {
+        start[j] = pos;
+        pos += count[h - 1][j];
+      }
+      start[256] = n;
+      radix_scatter(a, n, b, key, 8 * (h - 1), start);
+
+      for (std::size_t j = 0; j < 256; ++j) {
+        std::size_t s = start[j];
+        std::size_t m = start[j + 1] - s;
+        if (!radix_msd(b + s, a + s, m, key, h - 1))
+          std::move(b + s, b + s + m, a + s);
+      }
+      return false;
+    }
+
+  // Sort [first, last) by the radix keys of key(x), using 8 bit digits.
+  // Small ranges are sorted by comparing keys.
+  template <typename I, typename K, typename B>
+    void
+    radix_sort(I first, I last, K key, B& buf, std::true_type)
+    {
+      using Key = Decay<decltype(radix_key(key(*first)))>;
+      const std::size_t n = last - first;
+      if (n < radix_threshold) {
+        std::stable_sort(first, last, [&key](const Value_type<I>& a, const Value_type<I>& b) {
+          return radix_key(key(a)) < radix_key(key(b));
+        });
+        return;
+      }
+
+      auto tmp = buf.get(n);
+      if (radix_msd(first, tmp, n, key, sizeof(Key)))
+        std::move(tmp, tmp + n, first);
+    }
+
+  // When the keys are not radix keys, sort by comparing keys.
+  template <typename I, typename K, typename B>
+    void
+    radix_sort(I first, I last, K key, B&, std::false_type)
+    {
+      std::stable_sort(first, last, [&key](const Value_type<I>& a, const Value_type<I>& b) {
+        return key(a) < key(b);
+      });
+    }
+} // namespace algorithm_impl
@@ -0,0 +1,265 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+namespace algorithm_impl
+{
+  // Byte patterns longer than horspool_max_length, or longer than
+  // small_alphabet_length with at most small_alphabet distinct values, are
+  // searched by the Two-Way algorithm instead of Horspool's. Horspool's
+  // shifts are short for small alphabets, and its worst case (n * m) is
+  // likely for periodic patterns. Shorter patterns are searched faster by
+  // Horspool, even over small alphabets.
+  constexpr std::size_t horspool_max_length = 256;
+  constexpr std::size_t small_alphabet = 4;
+  constexpr std::size_t small_alphabet_length = 16;
+
+
+  // Returns true if T is a byte, whose values index a shift table.
+  template <typename T>
+    constexpr bool Byte_symbol()
+    {
+      return Integer<T>() && sizeof(T) == 1 && !Same<T, bool>();
+    }
+
+  template <typename T>
+    inline std::size_t
+    symbol_index(T x)
+    {
+      return static_cast<unsigned char>(x);
+    }
+
+  // Initialize the shift table of a pattern of m bytes. The shift of a byte
+  // is the distance from its last occurrence in the pattern to the end of
+  // the pattern, or m if it does not occur. The shift of the last byte of
+  // the pattern is 0. Returns the distance from the previous occurrence of
+  // the last byte to the end of the pattern, or m if there is none.
+  template <typename T>
+    std::size_t
+    make_shift_table(const T* p, std::size_t m, std::size_t* shift)
+    {
+      std::fill(shift, shift + 256, m);
+      for (std::size_t i = 0; i < m - 1; ++i)
+        shift[symbol_index(p[i])] = m - i - 1;
+      std::size_t z = shift[symbol_index(p[m - 1])];
+      shift[symbol_index(p[m - 1])] = 0;
+      return z;
+    }
+
+  // Returns the shift of the text element x, or 0 when there is no table.
+  template <typename T>
+    inline std::size_t
+    table_shift(std::nullptr_t, const T&)
+    {
+      return 0;
+    }
+
+  template <typename T>
+    inline std::size_t
+    table_shift(const std::size_t* shift, T x)
+    {
+      return shift[symbol_index(x)];
+    }
+
+  // Returns the number of distinct bytes in the pattern.
+  template <typename T>
+    std::size_t
+    symbol_count(const T* p, std::size_t m)
+    {
+      bool seen[256] = {};
+      std::size_t n = 0;
+      for (std::size_t i = 0; i < m; ++i) {
+        std::size_t c = symbol_index(p[i]);
+        n += !seen[c];
+        seen[c] = true;
+      }
+      return n;
+    }
+
+
+  // Returns the position of the first occurrence of the pattern p of m
+  // elements in the n elements of the text t, or n if there is none, using
+  // the shift table of the pattern. This is Horspool's simplification of the
+  // Boyer-Moore algorithm. The text element aligned with the end of the
+  // pattern is compared first, and determines the shift when the pattern
+  // does not match. When that element matches the end of the pattern, the
+  // shift is last.
+  template <typename T, typename I>
+    std::size_t
+    horspool_search(const T* p, std::size_t m, const std::size_t* shift,
+                    std::size_t last, I t, std::size_t n)
+    {
+      if (m > n)
+        return n;
+      std::size_t j = 0;
+      while (j <= n - m) {
+        if (std::size_t s = shift[symbol_index(t[j + m - 1])]) {
+          j += s;
+        } else {
+          if (std::equal(p, p + m - 1, t + j))
+            return j;
+          j += last;
+        }
+      }
+      return n;
+    }
+
+
+  // Compute a critical factorization of the pattern p of m >= 2 elements
+  // by taking the larger of its maximal suffixes for the order < and its
+  // reverse. Returns the position of the suffix and stores the period of
+  // that suffix in period. The arithmetic on positions is modulo 2^N, so
+  // that the initial position, -1, refers to the element before the
+  // pattern.
+  template <typename T>
+    std::size_t
+    critical_factorization(const T* p, std::size_t m, std::size_t& period)
+    {
+      const std::size_t none = std::size_t(-1);
+
+      // The maximal suffix for <.
+      std::size_t s1 = none;
+      std::size_t j = 0, k = 1, p1 = 1;
+      while (j + k < m) {
+        const T& a = p[j + k];
+        const T& b = p[s1 + k];
+        if (a < b) {
+          j += k;
+          k = 1;
+          p1 = j - s1;
+        } else if (a == b) {
+          if (k != p1) {
+            ++k;
+          } else {
+            j += p1;
+            k = 1;
+          }
+        } else {
+          s1 = j++;
+          k = p1 = 1;
+        }
+      }
+
+      // The maximal suffix for the reverse order.
+      std::size_t s2 = none;
+      std::size_t p2 = 1;
+      j = 0;
+      k = 1;
+      while (j + k < m) {
+        const T& a = p[j + k];
+        const T& b = p[s2 + k];
+        if (b < a) {
+          j += k;
+          k = 1;
+          p2 = j - s2;
+        } else if (a == b) {
+          if (k != p2) {
+            ++k;
+          } else {
+            j += p2;
+            k = 1;
+          }
+        } else {
+          s2 = j++;
+          k = p2 = 1;
+        }
+      }
+
+      if (s2 + 1 < s1 + 1) {
+        period = p1;
+        return s1 + 1;
+      }
+      period = p2;
+      return s2 + 1;
+    }
+
+  // Returns the position of the first occurrence of the pattern p of m >= 2
+  // elements in the n elements of the text t, or n if there is none, using
+  // the Two-Way algorithm of Crochemore and Perrin.
+  //
+  // The pattern is split at its critical factorization, given by suffix and
+  // period. The right half of the pattern is compared first, from left to
+  // right, and a mismatch shifts the pattern past the mismatched element.
+  // If the right half matches, the left half is compared from right to
+  // left, and a mismatch shifts the pattern by the period. When the pattern
+  // is periodic, the number of elements known to match after such a shift
+  // is remembered so that they are not compared again. The search makes
+  // at most 2n comparisons and uses constant space.
+  //
+  // If shift is a shift table (of a pattern of bytes) rather than nullptr,
+  // the text element aligned with the end of the pattern is looked up first,
+  // skipping positions where the pattern cannot match.
+  template <typename T, typename S, typename I>
+    std::size_t
+    two_way_search(const T* p, std::size_t m,
+                   std::size_t suffix, std::size_t period, bool periodic,
+                   S shift, I t, std::size_t n)
+    {
+      const std::size_t none = std::size_t(-1);
+      if (m > n)
+        return n;
+
+      // With a shift table, the last element of the pattern is known to
+      // match, and is not compared again.
+      const std::size_t end = Same<S, std::nullptr_t>() ? m : m - 1;
+      std::size_t j = 0;
+      if (periodic) {
+        std::size_t memory = 0;
+        while (j <= n - m) {
+          if (std::size_t s = table_shift(shift, t[j + m - 1])) {
+            // The remembered period ended with an element that is out of
+            // place, so there is no match before that element.
+            if (memory && s < period)
+              s = m - period;
+            memory = 0;
+            j += s;
+            continue;
+          }
+          std::size_t i = std::max(suffix, memory);
+          while (i < end && p[i] == t[i + j])
+            ++i;
+          if (i >= end) {
+            i = suffix - 1;
+            while (memory < i + 1 && p[i] == t[i + j])
+              --i;
+            if (i + 1 < memory + 1)
+              return j;
+            j += period;
+            memory = m - period;
+          } else {
+            j += i - suffix + 1;
+            memory = 0;
+          }
+        }
+      } else {
+        period = std::max(suffix, m - suffix) + 1;
+        while (j <= n - m) {
+          if (std::size_t s = table_shift(shift, t[j + m - 1])) {
+            j += s;
+            continue;
+          }
+          std::size_t i = suffix;
+          while (i < end && p[i] == t[i + j])
+            ++i;
+          if (i >= end) {
+            i = suffix - 1;
+            while (i != none && p[i] == t[i + j])
+              --i;
+            if (i == none)
+              return j;
+            j += period;
+          } else {
+            j += i - suffix + 1;
+          }
+        }
+      }
+      return n;
+    }
+} // namespace algorithm_impl
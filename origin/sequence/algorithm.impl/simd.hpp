@@ -0,0 +1,138 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+namespace algorithm_impl
+{
+  // ------------------------------------------------------------------------ //
+  //                            Vectorized Kernels
+  //
+  // The vectorized kernels implement the inner loops of some algorithms over
+  // contiguous arrays of float, double, int32 or int64 values:
+  //
+  //    simd_sum(a, n)                -- Returns a[0] + ... + a[n - 1]
+  //    simd_scan(a, out, n, init)    -- out[i] = init + a[0] + ... + a[i]
+  //
+  // The comparison kernels also accept arrays of char. Each returns an index
+  // in [0, n], where n means that no element was found:
+  //
+  //    simd_find(a, n, x)            -- The first i where a[i] == x
+  //    simd_find_not(a, n, x)        -- The first i where a[i] != x
+  //    simd_count(a, n, x)           -- The number of i where a[i] == x
+  //    simd_mismatch(a, b, n)        -- The first i where a[i] != b[i]
+  //
+  // The kernels are implemented (in algorithm.cpp) for each supported
+  // instruction set. The implementation is selected at runtime, when the
+  // kernels are first used, based on the features of the host CPU.
+  //
+  // The vectorized sums of floating point values add the elements in a
+  // different order than a loop, so the results may differ by rounding.
+
+  // The instruction sets for which kernels are implemented, in order of
+  // increasing capability.
+  enum class simd_isa { scalar, sse2, avx2 };
+
+  // Returns the most capable instruction set supported by the host CPU.
+  simd_isa simd_support();
+
+  // Returns the instruction set used by the kernels. The vectorized kernels
+  // of other modules (e.g., the matrix elementwise kernels) also dispatch on
+  // this level.
+  simd_isa simd_level();
+
+  // Select the instruction set used by the kernels. If isa is not supported
+  // by the host, the most capable supported instruction set is used
+  // instead. Returns the selected instruction set.
+  //
+  // This is primarily intended for testing and benchmarking.
+  simd_isa set_simd_level(simd_isa isa);
+
+  float simd_sum(const float*, std::size_t);
+  double simd_sum(const double*, std::size_t);
+  std::int32_t simd_sum(const std::int32_t*, std::size_t);
+  std::int64_t simd_sum(const std::int64_t*, std::size_t);
+
+  // The output array may be the same as the input array. Otherwise, the
+  // arrays must not overlap.
+  void simd_scan(const float*, float*, std::size_t, float);
+  void simd_scan(const double*, double*, std::size_t, double);
+  void simd_scan(const std::int32_t*, std::int32_t*, std::size_t, std::int32_t);
+  void simd_scan(const std::int64_t*, std::int64_t*, std::size_t, std::int64_t);
+
+  std::size_t simd_find(const char*, std::size_t, char);
+  std::size_t simd_find_not(const char*, std::size_t, char);
+  std::size_t simd_count(const char*, std::size_t, char);
+  std::size_t simd_mismatch(const char*, const char*, std::size_t);
+
+  std::size_t simd_find(const std::int32_t*, std::size_t, std::int32_t);
+  std::size_t simd_find_not(const std::int32_t*, std::size_t, std::int32_t);
+  std::size_t simd_count(const std::int32_t*, std::size_t, std::int32_t);
+  std::size_t simd_mismatch(const std::int32_t*, const std::int32_t*, std::size_t);
+
+  std::size_t simd_find(const std::int64_t*, std::size_t, std::int64_t);
+  std::size_t simd_find_not(const std::int64_t*, std::size_t, std::int64_t);
+  std::size_t simd_count(const std::int64_t*, std::size_t, std::int64_t);
+  std::size_t simd_mismatch(const std::int64_t*, const std::int64_t*, std::size_t);
+
+  std::size_t simd_find(const float*, std::size_t, float);
+  std::size_t simd_find_not(const float*, std::size_t, float);
+  std::size_t simd_count(const float*, std::size_t, float);
+  std::size_t simd_mismatch(const float*, const float*, std::size_t);
+
+  std::size_t simd_find(const double*, std::size_t, double);
+  std::size_t simd_find_not(const double*, std::size_t, double);
+  std::size_t simd_count(const double*, std::size_t, double);
+  std::size_t simd_mismatch(const double*, const double*, std::size_t);
+
+
+  // Returns true if T is one of the value types supported by the vectorized
+  // kernels.
+  template <typename T>
+    constexpr bool Simd_value()
+    {
+      return Same<T, float>()
+          || Same<T, double>()
+          || Same<T, std::int32_t>()
+          || Same<T, std::int64_t>();
+    }
+
+  // Returns true if I is a pointer, a vector iterator or a string iterator,
+  // whose elements are stored contiguously. The elements of vector<bool>
+  // are not.
+  template <typename I>
+    constexpr bool Contiguous_iterator()
+    {
+      return Pointer<I>()
+          || (!Same<Value_type<I>, bool>()
+              && (Same<I, typename std::vector<Value_type<I>>::iterator>()
+                  || Same<I, typename std::vector<Value_type<I>>::const_iterator>()))
+          || Same<I, std::string::iterator>()
+          || Same<I, std::string::const_iterator>();
+    }
+
+  // Returns true if the elements of the contiguous iterator I can be read
+  // (or written) by the vectorized kernels as an array of T.
+  template <typename I, typename T>
+    constexpr bool Simd_iterator()
+    {
+      return Simd_value<T>()
+          && Contiguous_iterator<I>()
+          && Same<Value_type<I>, T>();
+    }
+
+  // Returns a pointer to the element referred to by the contiguous iterator
+  // i, which must be dereferenceable.
+  template <typename I>
+    inline auto
+    simd_address(I i) -> decltype(&*i)
+    {
+      return &*i;
+    }
+} // namespace algorithm_impl
@@ -0,0 +1,298 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_ALGORITHM_HPP
+#  error Do not include this file directly. Include sequence/algorithm.hpp.
+#endif
+
+namespace algorithm_impl
+{
+  // The number of elements below which the parallel sorting algorithms
+  // sort sequentially, unless the policy gives another threshold.
+  constexpr std::size_t sort_threshold = 1 << 14;
+
+  // The samplesort partitions a range using at most this many splitters,
+  // each chosen from this many samples. There are two buckets for each
+  // splitter, so the bucket of an element fits in a byte.
+  constexpr std::size_t max_splitters = 127;
+  constexpr std::size_t oversampling = 16;
+
+
+  // Returns the bucket of x given the sorted, distinct splitters s. Elements
+  // less than s[0] are in bucket 0, elements equivalent to s[0] are in bucket
+  // 1, elements between s[0] and s[1] are in bucket 2, and so on.
+  template <typename T, typename C>
+    inline std::size_t
+    sample_bucket(const std::vector<T>& s, const T& x, C comp)
+    {
+      std::size_t j = std::upper_bound(s.begin(), s.end(), x, comp) - s.begin();
+      if (j != 0 && !comp(s[j - 1], x))
+        return 2 * j - 1;
+      return 2 * j;
+    }
+
+  // Returns the sorted, distinct splitters for a samplesort of the n
+  // elements in [first, first + n).
+  template <typename I, typename C>
+    std::vector<Value_type<I>>
+    choose_splitters(I first, std::size_t n, C comp)
+    {
+      using T = Value_type<I>;
+      const std::size_t s = std::min(max_splitters, std::max<std::size_t>(1, n / 1024));
+      const std::size_t m = std::min(n, s * oversampling);
+
+      // The sample is chosen deterministically so that results and running
+      // times are repeatable.
+      std::minstd_rand eng;
+      std::uniform_int_distribution<std::size_t> dist(0, n - 1);
+      std::vector<T> sample;
+      sample.reserve(m);
+      for (std::size_t i = 0; i < m; ++i)
+        sample.push_back(first[dist(eng)]);
+      std::sort(sample.begin(), sample.end(), comp);
+
+      std::vector<T> r;
+      for (std::size_t i = 1; i <= s; ++i) {
+        const T& x = sample[i * m / (s + 1)];
+        if (r.empty() || comp(r.back(), x))
+          r.push_back(x);
+      }
+      return r;
+    }
+
+  // Sort [first, last) by a parallel samplesort.
+  //
+  // Each block of the range is classified by a set of splitters drawn from
+  // a sample, counting the elements in each bucket. The elements are moved
+  // to a buffer and then scattered back to the range so that each bucket is
+  // contiguous, and the buckets are sorted in parallel. Elements equivalent
+  // to a splitter have their own bucket, which needs no sorting. This keeps
+  // ranges with many equivalent elements from producing a few large
+  // buckets.
+  template <typename I, typename C>
+    void
+    sample_sort(const parallel_policy& p, I first, I last, C comp)
+    {
+      using T = Value_type<I>;
+      const std::size_t n = last - first;
+      if (n < 2 || !p.parallel(n, sort_threshold)) {
+        std::sort(first, last, comp);
+        return;
+      }
+
+      const std::vector<T> s = choose_splitters(first, n, comp);
+      const std::size_t k = 2 * s.size() + 1;
+      const std::size_t g = p.grain(n, 4096);
+      const std::size_t blocks = block_count(n, g);
+      thread_pool& pool = p.pool();
+
+      // Classify each element, counting the elements in each bucket of each
+      // block.
+      std::unique_ptr<unsigned char[]> id(new unsigned char[n]);
+      std::vector<std::size_t> count(blocks * k);
+      pool.parallel_for(0, blocks, 1, [&](std::size_t b, std::size_t e) {
+        for ( ; b != e; ++b) {
+          std::size_t* c = &count[b * k];
+          for (std::size_t i = b * g; i != std::min(n, b * g + g); ++i) {
+            std::size_t j = sample_bucket(s, first[i], comp);
+            id[i] = static_cast<unsigned char>(j);
+            ++c[j];
+          }
+        }
+      });
+
+      // Compute the position of each bucket, and of each block within the
+      // bucket.
+      std::vector<std::size_t> start(k + 1);
+      std::size_t pos = 0;
+      for (std::size_t j = 0; j < k; ++j) {
+        start[j] = pos;
+        for (std::size_t b = 0; b < blocks; ++b) {
+          std::size_t c = count[b * k + j];
+          count[b * k + j] = pos;
+          pos += c;
+        }
+      }
+      start[k] = n;
+
+      // Scatter the elements into their buckets.
+      {
+        parallel_buffer<T> buf(p, std::make_move_iterator(first), n);
+        T* src = buf.data();
+        pool.parallel_for(0, blocks, 1, [&](std::size_t b, std::size_t e) {
+          for ( ; b != e; ++b) {
+            std::size_t* c = &count[b * k];
+            for (std::size_t i = b * g; i != std::min(n, b * g + g); ++i)
+              first[c[id[i]]++] = std::move(src[i]);
+          }
+        });
+      }
+
+      // Sort the buckets between the splitters.
+      pool.parallel_for(0, s.size() + 1, 1, [&](std::size_t b, std::size_t e) {
+        for ( ; b != e; ++b)
+          std::sort(first + start[2 * b], first + start[2 * b + 1], comp);
+      });
+    }
+
+
+  // Returns the number of elements taken from a in the first k elements of
+  // the stable merge of the sorted ranges a and b, having na and nb
+  // elements.
+  template <typename I, typename C>
+    std::size_t
+    merge_split(std::size_t k, I a, std::size_t na, I b, std::size_t nb, C comp)
+    {
+      std::size_t lo = k > nb ? k - nb : 0;
+      std::size_t hi = std::min(k, na);
+      while (lo < hi) {
+        std::size_t i = lo + (hi - lo) / 2;
+        std::size_t j = k - i;
+        if (j != 0 && !comp(b[j - 1], a[i]))
+          lo = i + 1;
+        else
+          hi = i;
+      }
+      return lo;
+    }
+
+  // Merge pairs of adjacent runs of src into dst, where run t occupies
+  // [t * n / runs, (t + 1) * n / runs) and each pair covers 2 * w runs.
+  // Each merge is divided into pieces of the output that are merged in
+  // parallel. The pieces are found before any elements are moved, since
+  // the search compares elements of other pieces.
+  template <typename I, typename O, typename C>
+    void
+    merge_runs(const parallel_policy& p, I src, O dst,
+               std::size_t n, std::size_t runs, std::size_t w, C comp)
+    {
+      struct piece
+      {
+        std::size_t a0, a1;  // The elements taken from the first run
+        std::size_t b0, b1;  // The elements taken from the second run
+        std::size_t out;     // The position of the merged elements
+      };
+
+      const std::size_t g = p.grain(n, 4096);
+      std::vector<piece> pieces;
+      for (std::size_t t = 0; t < runs; t += 2 * w) {
+        std::size_t a = t * n / runs;
+        std::size_t m = (t + w) * n / runs;
+        std::size_t e = (t + 2 * w) * n / runs;
+        std::size_t i0 = 0;
+        for (std::size_t k = a; k < e; k += g) {
+          std::size_t k1 = std::min(e, k + g) - a;
+          std::size_t i1 = merge_split(k1, src + a, m - a, src + m, e - m, comp);
+          pieces.push_back({a + i0, a + i1, m + (k - a - i0), m + (k1 - i1), k});
+          i0 = i1;
+        }
+      }
+
+      p.pool().parallel_for(0, pieces.size(), 1, [&](std::size_t b, std::size_t e) {
+        for ( ; b != e; ++b) {
+          const piece& x = pieces[b];
+          std::merge(std::make_move_iterator(src + x.a0),
+                     std::make_move_iterator(src + x.a1),
+                     std::make_move_iterator(src + x.b0),
+                     std::make_move_iterator(src + x.b1),
+                     dst + x.out, comp);
+        }
+      });
+    }
+
+  // Stably sort [first, last) by a parallel merge sort.
+  //
+  // The elements are moved to a buffer, which is divided into 2^r runs that
+  // are sorted in parallel. Then r rounds of pairwise merges move the runs
+  // between the range and the buffer. Because r is odd, the last round
+  // leaves the elements in the range.
+  template <typename I, typename C>
+    void
+    merge_sort(const parallel_policy& p, I first, I last, C comp)
+    {
+      using T = Value_type<I>;
+      const std::size_t n = last - first;
+      if (n < 2 || !p.parallel(n, sort_threshold)) {
+        std::stable_sort(first, last, comp);
+        return;
+      }
+
+      const std::size_t blocks = block_count(n, p.grain(n, 4096));
+      std::size_t r = 1;
+      while ((std::size_t(1) << r) < blocks)
+        r += 2;
+      const std::size_t runs = std::size_t(1) << r;
+
+      parallel_buffer<T> buf(p, std::make_move_iterator(first), n);
+      T* tmp = buf.data();
+      p.pool().parallel_for(0, runs, 1, [&](std::size_t b, std::size_t e) {
+        for ( ; b != e; ++b)
+          std::stable_sort(tmp + b * n / runs, tmp + (b + 1) * n / runs, comp);
+      });
+
+      bool in_buffer = true;
+      for (std::size_t w = 1; w < runs; w *= 2) {
+        if (in_buffer)
+          merge_runs(p, tmp, first, n, runs, w, comp);
+        else
+          merge_runs(p, first, tmp, n, runs, w, comp);
+        in_buffer = !in_buffer;
+      }
+    }
+
+
+  // Copy the smallest elements of [first, last) into [out, out_last) in
+  // sorted order, returning the end of the copied elements.
+  //
+  // Each block of the input keeps a heap of its smallest k elements, where
+  // k is the size of the output. The smallest k elements of the combined
+  // candidates are the result. When the candidates would not be fewer than
+  // the input, the input is copied and sorted instead.
+  template <typename I, typename O, typename C>
+    O
+    top_k(const parallel_policy& p, I first, I last, O out, O out_last, C comp)
+    {
+      using T = Value_type<I>;
+      const std::size_t n = last - first;
+      const std::size_t k = std::min<std::size_t>(n, out_last - out);
+      if (k == 0 || !p.parallel(n, sort_threshold))
+        return std::partial_sort_copy(first, last, out, out_last, comp);
+
+      const std::size_t g = p.grain(n, 4096);
+      const std::size_t blocks = block_count(n, g);
+      if (k * blocks >= n) {
+        parallel_buffer<T> buf(p, first, n);
+        sample_sort(p, buf.data(), buf.data() + n, comp);
+        parallel_move(p, buf.data(), k, out);
+        return out + k;
+      }
+
+      std::vector<std::vector<T>> best(blocks);
+      p.pool().parallel_for(0, blocks, 1, [&](std::size_t b, std::size_t e) {
+        for ( ; b != e; ++b) {
+          std::vector<T>& h = best[b];
+          I i = first + b * g;
+          I j = first + std::min(n, b * g + g);
+          h.assign(i, i + std::min<std::size_t>(k, j - i));
+          std::make_heap(h.begin(), h.end(), comp);
+          for (i += h.size(); i != j; ++i) {
+            if (comp(*i, h.front())) {
+              std::pop_heap(h.begin(), h.end(), comp);
+              h.back() = *i;
+              std::push_heap(h.begin(), h.end(), comp);
+            }
+          }
+        }
+      });
+
+      std::vector<T> cand;
+      cand.reserve(blocks * k);
+      for (std::vector<T>& h : best)
+        std::move(h.begin(), h.end(), std::back_inserter(cand));
+      return std::partial_sort_copy(cand.begin(), cand.end(), out, out + k, comp);
+    }
+} // namespace algorithm_impl
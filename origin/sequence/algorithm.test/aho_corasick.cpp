@@ -0,0 +1,218 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/sequence/range.hpp>
+#include <origin/type/testing.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for the Aho-Corasick automaton. For each length n given on the
+// command line, the benchmark finds every occurrence of k keywords in a
+// random text of n chars, by searching for each keyword with a searcher and
+// by feeding the text to the automaton in chunks.
+
+minstd_rand eng;
+
+using occurrence = pair<size_t, size_t>;
+
+// Returns a random string of n letters from the first k.
+string random_string(size_t n, int k)
+{
+  string s(n, ' ');
+  for (char& c : s)
+    c = char('a' + eng() % k);
+  return s;
+}
+
+// Returns the occurrences of the patterns in the text, found by std::search,
+// in the order reported by the automaton.
+template <typename T>
+  vector<occurrence> occurrences(const vector<T>& pats, const T& text)
+  {
+    vector<pair<size_t, occurrence>> v;
+    for (size_t k = 0; k < pats.size(); ++k) {
+      const T& p = pats[k];
+      if (p.empty())
+        continue;
+      auto i = text.begin();
+      while (true) {
+        i = std::search(i, text.end(), p.begin(), p.end());
+        if (i == text.end())
+          break;
+        size_t pos = i - text.begin();
+        v.push_back({pos + p.size(), {k, pos}});
+        ++i;
+      }
+    }
+    // By last element, then by decreasing length, then by index.
+    sort(v.begin(), v.end(), [&](const pair<size_t, occurrence>& a,
+                                 const pair<size_t, occurrence>& b) {
+      if (a.first != b.first)
+        return a.first < b.first;
+      if (a.second.second != b.second.second)
+        return a.second.second < b.second.second;
+      return a.second.first < b.second.first;
+    });
+    vector<occurrence> r;
+    for (auto& x : v)
+      r.push_back(x.second);
+    return r;
+  }
+
+// Feed the text to the automaton in chunks of random sizes.
+template <typename A, typename T>
+  vector<occurrence> feed_chunks(A& ac, const T& text, size_t max)
+  {
+    vector<occurrence> r;
+    ac.reset();
+    size_t i = 0;
+    while (i < text.size()) {
+      size_t n = min<size_t>(eng() % (max + 1), text.size() - i);
+      T chunk(text.begin() + i, text.begin() + i + n);
+      ac.feed(chunk, [&](size_t k, size_t pos) { r.push_back({k, pos}); });
+      i += n;
+    }
+    assert(ac.position() == text.size());
+    return r;
+  }
+
+void test_classic()
+{
+  vector<string> pats {"he", "she", "his", "hers"};
+  aho_corasick<char> ac(pats);
+  assert(ac.size() == 4);
+  assert(ac.states() == 10);
+  vector<occurrence> r;
+  ac.feed(string("ushers"), [&](size_t k, size_t pos) {
+    r.push_back({k, pos});
+  });
+  vector<occurrence> e {{1, 1}, {0, 2}, {3, 2}};
+  assert(r == e);
+
+  // The state is kept across chunks.
+  r.clear();
+  ac.reset();
+  for (string s : {"us", "h", "", "ers", "his"})
+    ac.feed(s, [&](size_t k, size_t pos) { r.push_back({k, pos}); });
+  e.push_back({2, 6});
+  assert(r == e);
+  assert(ac.position() == 9);
+}
+
+void test_random()
+{
+  for (int k : {2, 4, 26}) {
+    for (size_t npats : {1, 2, 10, 100}) {
+      vector<string> pats;
+      string text = random_string(2000, k);
+      for (size_t i = 0; i < npats; ++i) {
+        size_t m = 1 + eng() % 8;
+        if (i % 3 == 0) {
+          size_t j = eng() % (text.size() - m);
+          pats.push_back(text.substr(j, m));
+        } else {
+          pats.push_back(random_string(m, k));
+        }
+      }
+      // Duplicate and empty patterns.
+      pats.push_back(pats.front());
+      pats.push_back("");
+
+      aho_corasick<char> ac(pats);
+      vector<occurrence> e = occurrences(pats, text);
+      assert(feed_chunks(ac, text, text.size()) == e);
+      assert(feed_chunks(ac, text, 7) == e);
+      assert(feed_chunks(ac, text, 1) == e);
+    }
+  }
+}
+
+// Patterns of other types.
+void test_types()
+{
+  vector<vector<int>> pats {{1, 2, 3}, {2, 3}, {3, 1000000}, {7}};
+  aho_corasick<int> ac(pats);
+  vector<int> text {1, 2, 3, 1000000, 5, 7, 2, 3};
+  vector<occurrence> r;
+  ac.feed(text, [&](size_t k, size_t pos) { r.push_back({k, pos}); });
+  vector<occurrence> e {{0, 0}, {1, 1}, {2, 2}, {3, 5}, {1, 6}};
+  assert(r == e);
+
+  // Negative chars are bytes too.
+  vector<string> bytes {"\xff\x80", "\x80"};
+  aho_corasick<char> b(bytes);
+  r.clear();
+  b.feed(string("\x01\xff\x80\x80"), [&](size_t k, size_t pos) {
+    r.push_back({k, pos});
+  });
+  e = {{0, 1}, {1, 2}, {1, 3}};
+  assert(r == e);
+}
+
+void bench_keywords(size_t n, size_t k)
+{
+  string text = random_string(n, 26);
+  vector<string> pats;
+  for (size_t i = 0; i < k; ++i)
+    pats.push_back(random_string(4 + eng() % 8, 26));
+  // Some keywords occur often.
+  for (size_t i = 0; i < k / 10; ++i)
+    pats[i] = random_string(3, 26);
+
+  size_t a = 0, b = 0;
+  double t1 = time_it([&]() {
+    for (const string& p : pats) {
+      searcher<char> s(p);
+      auto i = text.begin();
+      while ((i = s(i, text.end()).first) != text.end()) {
+        ++a;
+        ++i;
+      }
+    }
+  });
+  double t0 = time_it([&]() { aho_corasick<char> ac(pats); });
+  double t2 = time_it([&]() {
+    aho_corasick<char> ac(pats);
+    const size_t chunk = 1 << 16;
+    for (size_t i = 0; i < n; i += chunk) {
+      string::const_iterator f = text.begin() + i;
+      string::const_iterator l = text.begin() + min(n, i + chunk);
+      ac.feed(bounded_range<string::const_iterator>(f, l),
+              [&](size_t, size_t) { ++b; });
+    }
+  });
+  if (a != b)
+    cout << "aho_corasick " << k << ": results differ\n";
+  cout << "aho_corasick " << n << " k=" << k << ": searchers " << t1
+       << "ms, automaton " << t2 << "ms, including " << t0
+       << "ms to build (" << t1 / t2 << "x), " << b << " matches\n";
+}
+
+void bench(size_t n)
+{
+  for (size_t k : {1, 10, 100, 1000})
+    bench_keywords(n, k);
+}
+
+int main(int argc, char* argv[])
+{
+  test_classic();
+  test_random();
+  test_types();
+
+  run_benchmarks(argc, argv, bench);
+}
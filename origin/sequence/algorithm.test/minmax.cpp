@@ -64,6 +64,11 @@ int main()
   assert(&p3.first == &*p4.first);
   assert(&p3.second == &*p4.second);
 
+  std::greater<int> gt;
+  auto p5 = minmax(v, gt);
+  assert(&p5.first == &v.back());
+  assert(&p5.second == &v.front());
+
 
   // Min element
   static_assert(Same<decltype(min_element(v)), V::iterator>(), "");
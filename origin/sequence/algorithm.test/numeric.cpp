@@ -0,0 +1,246 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/type/testing.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for the reductions and scans. For each size n given on the command
+// line, the benchmark sums and scans n doubles and 32-bit integers with a
+// loop (std::accumulate and std::partial_sum), and with the sequential and
+// parallel algorithms.
+
+using algorithm_impl::simd_isa;
+
+minstd_rand eng;
+
+// Returns n random values. The values are small integers, so that sums of
+// floating point values are exact.
+template <typename T>
+  vector<T> random_values(size_t n)
+  {
+    vector<T> v(n);
+    for (T& x : v)
+      x = T(int(eng() % 201) - 100);
+    return v;
+  }
+
+// Check the reductions and scans of n values with the policy p against the
+// standard algorithms.
+template <typename T, typename P>
+  void check_values(const P& p, size_t n)
+  {
+    vector<T> v = random_values<T>(n);
+    T sum = accumulate(v.begin(), v.end(), T(5));
+    assert(reduce(v, T(5)) == sum);
+    assert(reduce(seq, v, T(5)) == sum);
+    assert(reduce(p, v, T(5)) == sum);
+    assert(reduce(p, v) == sum - T(5));
+
+    vector<T> s(n);
+    partial_sum(v.begin(), v.end(), s.begin());
+
+    vector<T> out(n);
+    assert(inclusive_scan(v, out) == out.end());
+    assert(out == s);
+    out.assign(n, T());
+    assert(inclusive_scan(p, v, out) == out.end());
+    assert(out == s);
+
+    // With an initial value.
+    vector<T> t = s;
+    for (T& x : t)
+      x += T(3);
+    inclusive_scan(p, v, out, plus<T>(), T(3));
+    assert(out == t);
+
+    // Exclusive scans.
+    vector<T> e(n);
+    if (n != 0) {
+      e[0] = T(3);
+      copy(t.begin(), t.end() - 1, e.begin() + 1);
+    }
+    exclusive_scan(v, out, T(3));
+    assert(out == e);
+    out.assign(n, T());
+    assert(exclusive_scan(p, v, out, T(3)) == out.end());
+    assert(out == e);
+
+    // In place.
+    vector<T> w = v;
+    inclusive_scan(p, w, w);
+    assert(w == s);
+    w = v;
+    exclusive_scan(p, w, w, T(3));
+    assert(w == e);
+    w = v;
+    exclusive_scan(w, w, T(3));
+    assert(w == e);
+  }
+
+void test_arithmetic(const parallel_policy& p)
+{
+  for (size_t n : {0, 1, 2, 3, 7, 8, 9, 17, 100, 1000, 12345, 100000}) {
+    check_values<int32_t>(p, n);
+    check_values<int64_t>(p, n);
+    check_values<float>(p, n);
+    check_values<double>(p, n);
+    check_values<short>(p, n);
+  }
+}
+
+void test_operations(const parallel_policy& p)
+{
+  vector<int> v = random_values<int>(10000);
+
+  // A different operation and accumulator type.
+  auto big = [](long a, long b) { return max(a, b); };
+  long m = *max_element(v.begin(), v.end());
+  assert(reduce(p, v, -1000l, big) == m);
+
+  vector<int> out(v.size());
+  inclusive_scan(p, v, out, [](int a, int b) { return max(a, b); });
+  int x = v[0];
+  for (size_t i = 0; i < v.size(); ++i) {
+    x = max(x, v[i]);
+    assert(out[i] == x);
+  }
+
+  // Transformations.
+  auto sq = [](int a) { return long(a) * a; };
+  long ss = 0;
+  for (int a : v)
+    ss += sq(a);
+  assert(transform_reduce(v, 0l, plus<long>(), sq) == ss);
+  assert(transform_reduce(p, v, 0l, plus<long>(), sq) == ss);
+  assert(transform_reduce(seq, v, 0l, plus<long>(), sq) == ss);
+  assert(transform_reduce(v, v, 0l) == ss);
+  assert(transform_reduce(p, v, v, 0l) == ss);
+  assert(transform_reduce(p, v, v, 0l, plus<long>(), multiplies<long>()) == ss);
+  vector<double> d(v.begin(), v.end());
+  assert(transform_reduce(p, v, d, 0.0) == double(ss));
+
+  // An associative operation that is not commutative.
+  vector<string> w;
+  string cat;
+  for (size_t i = 0; i < 5000; ++i) {
+    w.push_back(to_string(i % 10));
+    cat += w.back();
+  }
+  assert(reduce(p, w, string()) == cat);
+  assert(reduce(p, w, string("x")) == "x" + cat);
+  vector<string> ws(w.size());
+  exclusive_scan(p, w, ws, string());
+  for (size_t i = 0; i < w.size(); i += 997)
+    assert(ws[i] == cat.substr(0, i));
+  inclusive_scan(p, w, ws);
+  for (size_t i = 0; i < w.size(); i += 997)
+    assert(ws[i] == cat.substr(0, i + 1));
+}
+
+// Exceptions thrown by the operations are propagated.
+void test_exceptions(const parallel_policy& p)
+{
+  vector<int> v(10000, 1);
+  auto op = [](int a, int b) -> int {
+    if (b == 2)
+      throw 42;
+    return a + b;
+  };
+  v[7777] = 2;
+  vector<int> out(v.size());
+  try {
+    inclusive_scan(p, v, out, op);
+    assert(false);
+  } catch (int x) {
+    assert(x == 42);
+  }
+  try {
+    reduce(p, v, 0, op);
+    assert(false);
+  } catch (int x) {
+    assert(x == 42);
+  }
+}
+
+// The vectorized kernels agree with the scalar loops, for each supported
+// instruction set.
+void test_simd()
+{
+  for (simd_isa isa : {simd_isa::scalar, simd_isa::sse2, simd_isa::avx2}) {
+    simd_isa s = algorithm_impl::set_simd_level(isa);
+    assert(s <= isa && s == algorithm_impl::simd_level());
+    for (size_t n : {0, 1, 5, 31, 1000}) {
+      check_values<int32_t>(seq, n);
+      check_values<int64_t>(seq, n);
+      check_values<float>(seq, n);
+      check_values<double>(seq, n);
+    }
+  }
+  algorithm_impl::set_simd_level(algorithm_impl::simd_support());
+}
+
+template <typename T>
+  void bench_type(const char* name, size_t n)
+  {
+    vector<T> v = random_values<T>(n);
+    vector<T> a(n), b(n), c(n);
+    T r1 = T(), r2 = T(), r3 = T();
+    double s1 = time_it([&]() { r1 = accumulate(v.begin(), v.end(), T()); });
+    double s2 = time_it([&]() { r2 = reduce(seq, v); });
+    double s3 = time_it([&]() { r3 = reduce(par, v); });
+    if (r1 != r2 || r1 != r3)
+      cout << "reduce " << name << ": results differ\n";
+
+    double t1 = time_it([&]() { partial_sum(v.begin(), v.end(), a.begin()); });
+    double t2 = time_it([&]() { inclusive_scan(seq, v, b); });
+    double t3 = time_it([&]() { inclusive_scan(par, v, c); });
+    if (a != b || a != c)
+      cout << "inclusive_scan " << name << ": results differ\n";
+
+    cout << "reduce " << name << " " << n << ": loop " << s1 << "ms"
+         << ", sequential " << s2 << "ms (" << s1 / s2 << "x)"
+         << ", parallel " << s3 << "ms (" << s1 / s3 << "x)\n"
+         << "inclusive_scan " << name << " " << n << ": loop " << t1 << "ms"
+         << ", sequential " << t2 << "ms (" << t1 / t2 << "x)"
+         << ", parallel " << t3 << "ms (" << t1 / t3 << "x)\n";
+  }
+
+void bench(size_t n)
+{
+  bench_type<double>("double", n);
+  bench_type<int32_t>("int32", n);
+}
+
+int main(int argc, char* argv[])
+{
+  for (size_t n : {0, 1, 4}) {
+    thread_pool pool(n);
+    parallel_policy p = par.on(pool).with_threshold(1);
+    test_arithmetic(p);
+    test_arithmetic(p.with_grain(10));
+    test_operations(p);
+    test_operations(p.with_grain(100));
+    test_exceptions(p.with_grain(100));
+  }
+  test_arithmetic(par);
+  test_simd();
+
+  run_benchmarks(argc, argv, bench);
+}
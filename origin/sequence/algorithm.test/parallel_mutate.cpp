@@ -0,0 +1,244 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/type/testing.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for the parallel for_each, range_transform, copy_if, remove_if and
+// partition. For each size n given on the command line, the benchmark runs
+// each algorithm on n random integers with pools of 1 to N threads, where N
+// is the number of hardware threads, and reports the speedup over the
+// sequential algorithm.
+
+minstd_rand eng;
+
+vector<int> random_ints(size_t n)
+{
+  vector<int> v(n);
+  for (int& x : v)
+    x = eng() % 1000;
+  return v;
+}
+
+bool odd(int x) { return x % 2 != 0; }
+
+void test_for_each(const parallel_policy& p)
+{
+  for (size_t n : {0, 1, 1000, 100000}) {
+    vector<int> v = random_ints(n);
+    vector<int> w = v;
+    for_each(p, v, [](int& x) { x *= 3; });
+    for (int& x : w)
+      x *= 3;
+    assert(v == w);
+
+    atomic<long> sum(0);
+    for_each(p, v, [&](int x) { sum += x; });
+    assert(sum == accumulate(w.begin(), w.end(), 0L));
+  }
+}
+
+void test_transform(const parallel_policy& p)
+{
+  for (size_t n : {0, 1, 1000, 100000}) {
+    vector<int> a = random_ints(n);
+    vector<int> b = random_ints(n);
+    vector<long> r(n), s(n);
+    auto sq = [](int x) { return long(x) * x; };
+    assert(range_transform(p, a, r, sq) == r.end());
+    std::transform(a.begin(), a.end(), s.begin(), sq);
+    assert(r == s);
+
+    auto mul = [](int x, int y) { return long(x) * y; };
+    assert(range_transform(p, a, b, r, mul) == r.end());
+    std::transform(a.begin(), a.end(), b.begin(), s.begin(), mul);
+    assert(r == s);
+
+    // In place.
+    vector<int> c = a;
+    range_transform(p, c, c, [](int x) { return x + 1; });
+    for (size_t i = 0; i < n; ++i)
+      assert(c[i] == a[i] + 1);
+  }
+}
+
+void test_filters(const parallel_policy& p)
+{
+  for (size_t n : {0, 1, 1000, 100000}) {
+    // Mostly odd, half odd, and no odd elements.
+    for (int k : {1000, 2, 1}) {
+      vector<int> v(n);
+      for (int& x : v)
+        x = int(eng() % 1000) * 2 + (eng() % k != 0);
+
+      vector<int> r(n), s(n);
+      auto i = copy_if(p, v, r, odd);
+      auto j = std::copy_if(v.begin(), v.end(), s.begin(), odd);
+      assert(i - r.begin() == j - s.begin());
+      assert(r == s);
+
+      vector<int> a = v, b = v;
+      auto ia = remove_if(p, a, odd);
+      auto ib = std::remove_if(b.begin(), b.end(), odd);
+      assert(ia - a.begin() == ib - b.begin());
+      assert(equal(a.begin(), ia, b.begin()));
+
+      // The parallel partition is stable.
+      a = v;
+      b = v;
+      ia = partition(p, a, odd);
+      ib = std::stable_partition(b.begin(), b.end(), odd);
+      assert(ia - a.begin() == ib - b.begin());
+      assert(a == b);
+    }
+  }
+
+  // Elements that are not trivially copyable.
+  vector<string> w;
+  for (size_t i = 0; i < 20000; ++i)
+    w.push_back(to_string(eng() % 100000));
+  auto big = [](const string& x) { return x.size() > 4; };
+  vector<string> a = w, b = w;
+  auto ia = remove_if(p, a, big);
+  auto ib = std::remove_if(b.begin(), b.end(), big);
+  assert(ia - a.begin() == ib - b.begin());
+  assert(equal(a.begin(), ia, b.begin()));
+  a = w;
+  b = w;
+  partition(p, a, big);
+  std::stable_partition(b.begin(), b.end(), big);
+  assert(a == b);
+}
+
+// Exceptions thrown by the predicate are propagated.
+void test_exceptions(const parallel_policy& p)
+{
+  vector<int> v = random_ints(10000);
+  auto pred = [](int x) -> bool {
+    if (x == 500)
+      throw runtime_error("bad");
+    return odd(x);
+  };
+  v[1234] = 500;
+  vector<int> r(v.size());
+  for (int k = 0; k < 3; ++k) {
+    bool thrown = false;
+    try {
+      if (k == 0)
+        copy_if(p, v, r, pred);
+      else if (k == 1)
+        remove_if(p, v, pred);
+      else
+        partition(p, v, pred);
+    } catch (const runtime_error&) {
+      thrown = true;
+    }
+    assert(thrown);
+  }
+}
+
+void test_sequential()
+{
+  vector<int> v {1, 2, 3, 4, 5};
+  int n = 0;
+  for_each(seq, v, [&](int x) { n += x; });
+  assert(n == 15);
+  vector<int> r(5);
+  assert(range_transform(seq, v, r, [](int x) { return -x; }) == r.end());
+  assert(range_transform(seq, v, r, r, [](int x, int y) { return x + y; })
+         == r.end());
+  assert(r == (vector<int> {0, 0, 0, 0, 0}));
+  assert(copy_if(seq, v, r, odd) == r.begin() + 3);
+  assert(remove_if(seq, v, odd) == v.begin() + 2);
+  v = {1, 2, 3, 4, 5};
+  assert(partition(seq, v, odd) == v.begin() + 3);
+}
+
+// Time the sequential algorithm s and the parallel algorithm f with pools
+// of 1 to N threads. Each run starts from a copy of v.
+template <typename S, typename F>
+  void scale(const char* name, const vector<int>& v, S s, F f)
+  {
+    vector<int> a = v;
+    double t0 = time_it([&]() { s(a); });
+    cout << name << " " << v.size() << ": sequential " << t0 << "ms";
+    size_t threads = max(1u, thread::hardware_concurrency());
+    for (size_t k = 1; k <= threads; ++k) {
+      thread_pool pool(k - 1);
+      vector<int> b = v;
+      double t = time_it([&]() { f(par.on(pool), b); });
+      if (a != b)
+        cout << ", results differ";
+      cout << ", " << k << (k == 1 ? " thread " : " threads ") << t << "ms ("
+           << t0 / t << "x)";
+    }
+    cout << '\n';
+  }
+
+void bench(size_t n)
+{
+  vector<int> v = random_ints(n);
+
+  // A function that does some work for each element.
+  auto work = [](int& x) { x = int(sqrt(double(x)) * 1000.0); };
+  scale("for_each", v, [&](vector<int>& a) { std::for_each(a.begin(), a.end(), work); },
+        [&](const parallel_policy& p, vector<int>& a) { for_each(p, a, work); });
+
+  auto inc = [](int x) { return x * 3 + 1; };
+  scale("range_transform", v,
+        [&](vector<int>& a) { std::transform(a.begin(), a.end(), a.begin(), inc); },
+        [&](const parallel_policy& p, vector<int>& a) { range_transform(p, a, a, inc); });
+
+  scale("copy_if", v,
+        [&](vector<int>& a) {
+          a.erase(std::copy_if(v.begin(), v.end(), a.begin(), odd), a.end());
+        },
+        [&](const parallel_policy& p, vector<int>& a) {
+          a.erase(copy_if(p, v, a, odd), a.end());
+        });
+
+  scale("remove_if", v,
+        [&](vector<int>& a) { a.erase(std::remove_if(a.begin(), a.end(), odd), a.end()); },
+        [&](const parallel_policy& p, vector<int>& a) {
+          a.erase(remove_if(p, a, odd), a.end());
+        });
+
+  scale("partition", v,
+        [&](vector<int>& a) { std::stable_partition(a.begin(), a.end(), odd); },
+        [&](const parallel_policy& p, vector<int>& a) { partition(p, a, odd); });
+}
+
+int main(int argc, char* argv[])
+{
+  for (size_t n : {0, 1, 4}) {
+    thread_pool pool(n);
+    parallel_policy p = par.on(pool).with_threshold(1);
+    test_for_each(p);
+    test_transform(p);
+    test_filters(p);
+    test_filters(p.with_grain(100));
+    test_exceptions(p.with_grain(100));
+  }
+  test_sequential();
+
+  run_benchmarks(argc, argv, bench);
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/type/testing.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for the parallel sorting algorithms. For each size n given on the
+// command line, the benchmark sorts n records with 64-bit keys using the
+// sequential and parallel algorithms.
+
+struct record
+{
+  uint64_t key;
+  uint64_t value;
+};
+
+bool operator==(const record& a, const record& b)
+{
+  return a.key == b.key && a.value == b.value;
+}
+
+struct key_less
+{
+  bool operator()(const record& a, const record& b) const
+  {
+    return a.key < b.key;
+  }
+};
+
+minstd_rand eng;
+
+// Returns n records whose keys are drawn from [0, keys). The value of each
+// record is its original position.
+vector<record> random_records(size_t n, uint64_t keys)
+{
+  uniform_int_distribution<uint64_t> dist(0, keys - 1);
+  vector<record> v(n);
+  for (size_t i = 0; i < n; ++i)
+    v[i] = {dist(eng), i};
+  return v;
+}
+
+void test_sort(const parallel_policy& p)
+{
+  for (size_t n : {0, 1, 10, 1000, 100000}) {
+    // Distinct keys, many duplicates and a single key.
+    for (uint64_t keys : {uint64_t(1) << 40, uint64_t(7), uint64_t(1)}) {
+      vector<record> v = random_records(n, keys);
+      vector<record> s1 = v;
+      vector<record> s2 = v;
+      sort(p, s1, key_less());
+      assert(is_sorted(s1, key_less()));
+
+      // The stable sort is unique.
+      stable_sort(p, v, key_less());
+      std::stable_sort(s2.begin(), s2.end(), key_less());
+      assert(v == s2);
+    }
+  }
+
+  // Default comparison and a non-trivial value type.
+  vector<string> w;
+  for (size_t i = 0; i < 5000; ++i)
+    w.push_back(to_string(eng()));
+  vector<string> x = w;
+  sort(p, w);
+  std::sort(x.begin(), x.end());
+  assert(w == x);
+  sort(p, w, greater<string>());
+  assert(is_sorted(w, greater<string>()));
+  stable_sort(p, w);
+  assert(w == x);
+}
+
+void test_partial_sort_copy(const parallel_policy& p)
+{
+  vector<int> v(50000);
+  for (int& x : v)
+    x = eng() % 1000;
+  vector<int> s = v;
+  std::sort(s.begin(), s.end());
+  for (size_t k : {0, 1, 10, 1000, 25000, 50000, 60000}) {
+    vector<int> r(k);
+    auto i = partial_sort_copy(p, v, r);
+    size_t m = min(k, v.size());
+    assert(i == r.begin() + m);
+    assert(equal(r.begin(), i, s.begin()));
+
+    i = partial_sort_copy(p, v, r, greater<int>());
+    assert(equal(r.begin(), i, s.rbegin()));
+  }
+}
+
+void test_sequential()
+{
+  vector<int> v {3, 1, 2};
+  sort(seq, v);
+  assert(is_sorted(v));
+  stable_sort(seq, v, greater<int>());
+  assert(is_sorted(v, greater<int>()));
+  vector<int> r(2);
+  partial_sort_copy(seq, v, r);
+  assert(r == (vector<int> {1, 2}));
+}
+
+void bench(size_t n)
+{
+  vector<record> v = random_records(n, uint64_t(1) << 63);
+  vector<record> a = v, b = v, c = v, d = v;
+  double s1 = time_it([&]() { std::sort(a.begin(), a.end(), key_less()); });
+  double p1 = time_it([&]() { sort(par, b, key_less()); });
+  double s2 = time_it([&]() { std::stable_sort(c.begin(), c.end(), key_less()); });
+  double p2 = time_it([&]() { stable_sort(par, d, key_less()); });
+  assert(a == b && c == d);
+
+  vector<record> r(100);
+  double s3 = time_it([&]() {
+    std::partial_sort_copy(v.begin(), v.end(), r.begin(), r.end(), key_less());
+  });
+  double p3 = time_it([&]() { partial_sort_copy(par, v, r, key_less()); });
+
+  cout << "sort " << n << ": sequential " << s1 << "ms"
+       << ", parallel " << p1 << "ms (" << s1 / p1 << "x)\n"
+       << "stable_sort " << n << ": sequential " << s2 << "ms"
+       << ", parallel " << p2 << "ms (" << s2 / p2 << "x)\n"
+       << "partial_sort_copy " << n << " (100): sequential " << s3 << "ms"
+       << ", parallel " << p3 << "ms (" << s3 / p3 << "x)\n";
+}
+
+int main(int argc, char* argv[])
+{
+  for (size_t n : {0, 1, 4}) {
+    thread_pool pool(n);
+    parallel_policy p = par.on(pool).with_threshold(1);
+    test_sort(p);
+    test_sort(p.with_grain(100));
+    test_partial_sort_copy(p);
+    test_partial_sort_copy(p.with_grain(1000));
+  }
+  test_sequential();
+
+  run_benchmarks(argc, argv, bench);
+}
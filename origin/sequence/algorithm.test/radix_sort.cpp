@@ -0,0 +1,179 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/type/testing.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for radix_sort. For each size n given on the command line, the
+// benchmark sorts n 64-bit ids and n records keyed by a 32-bit field with
+// std::sort and radix_sort.
+
+struct record
+{
+  uint32_t key;
+  uint32_t value;
+};
+
+bool operator==(const record& a, const record& b)
+{
+  return a.key == b.key && a.value == b.value;
+}
+
+minstd_rand eng;
+
+template <typename T>
+  vector<T> random_values(size_t n, T lo, T hi)
+  {
+    using Dist = typename conditional<
+      is_floating_point<T>::value,
+      uniform_real_distribution<T>,
+      uniform_int_distribution<T>
+    >::type;
+    Dist dist(lo, hi);
+    vector<T> v(n);
+    for (T& x : v)
+      x = dist(eng);
+    return v;
+  }
+
+// Check that radix_sort agrees with std::sort for n values in [lo, hi].
+template <typename T>
+  void check_values(size_t n, T lo, T hi)
+  {
+    vector<T> v = random_values(n, lo, hi);
+    vector<T> s = v;
+    radix_sort(v);
+    std::sort(s.begin(), s.end());
+    assert(v == s);
+  }
+
+void test_integers()
+{
+  for (size_t n : {0, 1, 100, 1000, 100000}) {
+    check_values<uint32_t>(n, 0, numeric_limits<uint32_t>::max());
+    check_values<uint64_t>(n, 0, numeric_limits<uint64_t>::max());
+    check_values<int>(n, numeric_limits<int>::min(), numeric_limits<int>::max());
+    check_values<int64_t>(n, -1000, 1000);
+    check_values<short>(n, -5, 5);
+    check_values<uint64_t>(n, 42, 42);
+  }
+
+  vector<signed char> c {5, -128, 127, 0, -1, 1};
+  radix_sort(c);
+  assert(c == (vector<signed char> {-128, -1, 0, 1, 5, 127}));
+}
+
+void test_floats()
+{
+  for (size_t n : {100, 1000, 100000}) {
+    check_values<float>(n, -1e6f, 1e6f);
+    check_values<double>(n, -1e-3, 1e300);
+  }
+
+  // Special values, repeated so the radix sort is used.
+  const double inf = numeric_limits<double>::infinity();
+  vector<double> x;
+  for (int i = 0; i < 100; ++i) {
+    double y[] = {0.0, -0.0, inf, -inf, -1.5, 2.5, -1e-310, 1e-310};
+    x.insert(x.end(), begin(y), end(y));
+  }
+  radix_sort(x);
+  assert(is_sorted(x));
+  assert(x.front() == -inf && x.back() == inf);
+  auto z = find(x, 0.0);
+  assert(signbit(*z) && !signbit(*(z + 100)));
+}
+
+void test_keys()
+{
+  // The sort is stable.
+  for (size_t n : {10, 1000, 100000}) {
+    vector<record> v(n);
+    for (size_t i = 0; i < n; ++i)
+      v[i] = {uint32_t(eng() % 100), uint32_t(i)};
+    vector<record> s = v;
+    auto key = [](const record& r) { return r.key; };
+    radix_sort(v, key);
+    std::stable_sort(s.begin(), s.end(), [](const record& a, const record& b) {
+      return a.key < b.key;
+    });
+    assert(v == s);
+  }
+
+  // Negative float keys.
+  vector<int> v = random_values(1000, -1000, 1000);
+  radix_sort(v, [](int x) { return -float(x); });
+  assert(is_sorted(v, greater<int>()));
+
+  // Keys that are not numbers are compared.
+  vector<string> w {"c", "bb", "a", "ddd"};
+  radix_sort(w, [](const string& s) { return s; });
+  assert(w == (vector<string> {"a", "bb", "c", "ddd"}));
+  radix_sort(w, [](const string& s) { return s.size(); });
+  assert(w == (vector<string> {"a", "c", "bb", "ddd"}));
+}
+
+void test_buffer()
+{
+  radix_buffer<uint64_t> buf;
+  assert(buf.capacity() == 0);
+  for (size_t n : {1000, 5000, 2000}) {
+    vector<uint64_t> v = random_values<uint64_t>(n, 0, 1 << 20);
+    radix_sort(v, buf);
+    assert(is_sorted(v));
+  }
+  assert(buf.capacity() == 5000);
+}
+
+void bench(size_t n)
+{
+  vector<uint64_t> v = random_values<uint64_t>(n, 0, numeric_limits<uint64_t>::max());
+  vector<uint64_t> a = v, b = v;
+  double s1 = time_it([&]() { std::sort(a.begin(), a.end()); });
+  double r1 = time_it([&]() { radix_sort(b); });
+  assert(a == b);
+
+  vector<record> w(n);
+  for (size_t i = 0; i < n; ++i)
+    w[i] = {uint32_t(eng()), uint32_t(i)};
+  vector<record> c = w, d = w;
+  auto key = [](const record& r) { return r.key; };
+  double s2 = time_it([&]() {
+    std::stable_sort(c.begin(), c.end(), [](const record& x, const record& y) {
+      return x.key < y.key;
+    });
+  });
+  double r2 = time_it([&]() { radix_sort(d, key); });
+  assert(c == d);
+
+  cout << "uint64 " << n << ": std::sort " << s1 << "ms"
+       << ", radix_sort " << r1 << "ms (" << s1 / r1 << "x)\n"
+       << "records " << n << ": std::stable_sort " << s2 << "ms"
+       << ", radix_sort " << r2 << "ms (" << s2 / r2 << "x)\n";
+}
+
+int main(int argc, char* argv[])
+{
+  test_integers();
+  test_floats();
+  test_keys();
+  test_buffer();
+
+  run_benchmarks(argc, argv, bench);
+}
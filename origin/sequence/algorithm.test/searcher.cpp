@@ -0,0 +1,203 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/type/testing.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for searchers. For each length n given on the command line, the
+// benchmark searches a random text of n chars for patterns of several
+// lengths with std::search and with a searcher, over a large alphabet
+// (letters) and a small one (DNA).
+
+minstd_rand eng;
+
+const search_method methods[] {
+  search_method::automatic,
+  search_method::scan,
+  search_method::horspool,
+  search_method::two_way
+};
+
+// Returns n values in [0, k).
+template <typename T>
+  vector<T> random_values(size_t n, int k)
+  {
+    vector<T> v(n);
+    for (T& x : v)
+      x = T('a' + eng() % k);
+    return v;
+  }
+
+// Check the first and last occurrences found by each method against
+// std::search and std::find_end.
+template <typename T>
+  void check_search(const vector<T>& text, const vector<T>& pat)
+  {
+    auto f = std::search(text.begin(), text.end(), pat.begin(), pat.end());
+    auto l = std::find_end(text.begin(), text.end(), pat.begin(), pat.end());
+    for (search_method m : methods) {
+      searcher<T> s(pat, m);
+      assert(search(text, s) == f);
+      assert(find_end(text, s) == l);
+      auto p = s(text.begin(), text.end());
+      assert(p.first == f);
+      assert(p.second == (f == text.end() ? f : f + pat.size()));
+      p = s.find_last(text.begin(), text.end());
+      assert(p.first == l);
+      assert(p.second == (l == text.end() ? l : l + pat.size()));
+    }
+  }
+
+// Search random texts for patterns taken from the text, and for random
+// patterns, which are usually not found.
+template <typename T>
+  void test_random(int k)
+  {
+    for (size_t n : {0, 1, 2, 5, 30, 300, 3000}) {
+      vector<T> text = random_values<T>(n, k);
+      for (size_t m : {0, 1, 2, 3, 4, 7, 16, 40, 300, 1000}) {
+        check_search(text, random_values<T>(m, k));
+        if (m <= n) {
+          size_t i = eng() % (n - m + 1);
+          check_search(text, vector<T>(text.begin() + i, text.begin() + i + m));
+        }
+      }
+    }
+  }
+
+// Periodic patterns and texts are the worst cases for both methods.
+void test_periodic()
+{
+  for (string p : {"aaaa", "abab", "aab", "aaaaaaaaab", "abaabaabaab",
+                   "abcabcabd", "baaaaaaaa", "zzzzyzzzz"}) {
+    vector<char> pat(p.begin(), p.end());
+    for (string t : {string(1000, 'a'), string(1000, 'z')}) {
+      t += p;
+      t.insert(500, p);
+      vector<char> text(t.begin(), t.end());
+      check_search(text, pat);
+    }
+    string t;
+    while (t.size() < 1000)
+      t += p.substr(0, p.size() - 1);
+    t += p;
+    t += t;
+    check_search(vector<char>(t.begin(), t.end()), pat);
+  }
+}
+
+void test_methods()
+{
+  // Byte patterns use Horspool, except long patterns and longer patterns
+  // over small alphabets, which use Two-Way.
+  string s = "the quick brown fox";
+  assert(make_searcher(s).method() == search_method::horspool);
+  assert(make_searcher(string("acgt")).method() == search_method::horspool);
+  assert(make_searcher(string("acgtacgtacgtacgtacgt")).method()
+         == search_method::two_way);
+  assert(make_searcher(string(1000, 'x')).method() == search_method::two_way);
+  assert(make_searcher(string("x")).method() == search_method::scan);
+
+  // Other ordered types use Two-Way, unless another method is requested.
+  vector<int> v {1, 2, 3};
+  assert(make_searcher(v).method() == search_method::two_way);
+  searcher<int> h(v, search_method::horspool);
+  assert(h.method() == search_method::scan);
+
+  // Searchers are reusable, and do not refer to the pattern.
+  searcher<char> q(string("fox"));
+  string a = "a fox and another fox";
+  string b = "no match here";
+  assert(search(a, q) == a.begin() + 2);
+  assert(find_end(a, q) == a.begin() + 18);
+  assert(search(b, q) == b.end());
+  assert(q.pattern().size() == 3);
+
+  // Texts that are not random access, or have different value types, use
+  // the standard algorithms.
+  list<char> l(a.begin(), a.end());
+  assert(search(l, q) == std::next(l.begin(), 2));
+  assert(find_end(l, q) == std::next(l.begin(), 18));
+  vector<int> w {5, 1, 2, 3, 1, 2, 3, 4};
+  assert(search(w, make_searcher(v)) == w.begin() + 1);
+  assert(find_end(w, make_searcher(v)) == w.begin() + 4);
+  vector<long> x(w.begin(), w.end());
+  assert(search(x, make_searcher(v)) == x.begin() + 1);
+}
+
+// Time the search for a pattern of m chars that is not in the text, so that
+// the whole text is searched.
+void bench_pattern(const char* name, const vector<char>& text, size_t m, int k)
+{
+  vector<char> pat = random_values<char>(m, k);
+  pat.back() = 'A';
+  searcher<char> s(pat);
+  size_t a = 0, b = 0;
+  double t1 = time_it([&]() {
+    a = std::search(text.begin(), text.end(), pat.begin(), pat.end())
+      - text.begin();
+  });
+  double t2 = time_it([&]() { b = search(text, s) - text.begin(); });
+  if (a != b)
+    cout << "search " << name << ": results differ\n";
+  cout << "search " << name << " " << text.size() << " m=" << m
+       << (s.method() == search_method::horspool ? " (horspool)"
+                                                 : " (two-way)")
+       << ": std " << t1 << "ms, searcher " << t2 << "ms ("
+       << t1 / t2 << "x)\n";
+}
+
+void bench(size_t n)
+{
+  vector<char> text = random_values<char>(n, 26);
+  for (size_t m : {4, 16, 64, 1024})
+    bench_pattern("letters", text, m, 26);
+  vector<char> dna = random_values<char>(n, 4);
+  for (size_t m : {4, 16, 64, 1024})
+    bench_pattern("dna", dna, m, 4);
+
+  // A periodic text and a pattern that nearly matches everywhere, which is
+  // the worst case for std::search.
+  vector<char> aaa(n, 'a');
+  vector<char> pat(64, 'a');
+  pat[63] = 'b';
+  searcher<char> s(pat);
+  size_t a = 0, b = 0;
+  double t1 = time_it([&]() {
+    a = std::search(aaa.begin(), aaa.end(), pat.begin(), pat.end())
+      - aaa.begin();
+  });
+  double t2 = time_it([&]() { b = search(aaa, s) - aaa.begin(); });
+  if (a != b)
+    cout << "search periodic: results differ\n";
+  cout << "search periodic " << n << " m=64: std " << t1 << "ms, searcher "
+       << t2 << "ms (" << t1 / t2 << "x)\n";
+}
+
+int main(int argc, char* argv[])
+{
+  test_random<char>(26);
+  test_random<char>(2);
+  test_random<unsigned char>(4);
+  test_random<int>(3);
+  test_periodic();
+  test_methods();
+
+  run_benchmarks(argc, argv, bench);
+}
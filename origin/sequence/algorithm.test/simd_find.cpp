@@ -0,0 +1,243 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/type/testing.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for the vectorized find, count, range_mismatch, range_equal and
+// search_n. For each size n given on the command line, the benchmark
+// compares each algorithm to the standard algorithm for n chars, 32 and
+// 64-bit integers and floats.
+
+using algorithm_impl::simd_isa;
+
+minstd_rand eng;
+
+// A contiguous range of elements, which need not be aligned.
+template <typename T>
+  struct array_ref
+  {
+    using difference_type = ptrdiff_t;
+
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+
+    const T* first;
+    const T* last;
+  };
+
+// Returns n values in [0, k).
+template <typename T>
+  vector<T> random_values(size_t n, int k)
+  {
+    vector<T> v(n);
+    for (T& x : v)
+      x = T(eng() % k);
+    return v;
+  }
+
+// Check each algorithm against the standard algorithm for every suffix of
+// the first few elements, so that every alignment and tail is covered.
+template <typename T>
+  void check_values(size_t n, int k)
+  {
+    vector<T> v = random_values<T>(n, k);
+    for (size_t s = 0; s <= min<size_t>(n, 40); ++s) {
+      const T* f = v.data() + s;
+      const T* l = v.data() + n;
+      array_ref<T> r {f, l};
+      vector<T> w(f, l);
+      for (int x = 0; x <= k; ++x) {
+        assert(find(r, T(x)) == std::find(f, l, T(x)));
+        assert(count(r, T(x)) == std::count(f, l, T(x)));
+        for (ptrdiff_t m : {0, 1, 2, 3, 17})
+          assert(search_n(r, m, T(x)) == std::search_n(f, l, m, T(x)));
+      }
+      assert(range_equal(r, w));
+      assert(range_mismatch(r, w).first == l);
+      if (!w.empty()) {
+        size_t i = eng() % w.size();
+        w[i] = T(k + 1);
+        assert(!range_equal(r, w));
+        auto p = range_mismatch(r, w);
+        assert(p.first == f + i && p.second == w.begin() + i);
+      }
+    }
+  }
+
+void test_values()
+{
+  for (size_t n : {0, 1, 2, 15, 16, 31, 33, 64, 100, 1000}) {
+    for (int k : {1, 3, 100}) {
+      check_values<char>(n, k);
+      check_values<unsigned char>(n, k);
+      check_values<int32_t>(n, k);
+      check_values<uint32_t>(n, k);
+      check_values<int64_t>(n, k);
+      check_values<float>(n, k);
+      check_values<double>(n, k);
+    }
+  }
+}
+
+// Values of a different type are converted to the element type only when
+// the conversion preserves the value.
+void test_conversions()
+{
+  vector<int64_t> v {1, -1, 5, 1ll << 40, 0};
+  assert(find(v, 5) == v.begin() + 2);
+  assert(find(v, -1) == v.begin() + 1);
+  assert(count(v, 1u) == 1);
+
+  vector<unsigned char> b {0, 255, 1};
+  assert(find(b, 255) == b.begin() + 1);
+  assert(find(b, -1) == b.end());
+  assert(find(b, 511) == b.end());
+  assert(count(b, char(-1)) == 0);
+
+  vector<uint32_t> u {0, 0xffffffff, 1};
+  assert(find(u, -1) == u.begin() + 1);     // As std::find
+  assert(find(u, -1ll) == u.end());         // As std::find
+
+  vector<int> w(100, 7);
+  assert(find(w, 7.5) == w.end());
+  assert(find(w, 7.0) == w.begin());
+
+  const double nan = numeric_limits<double>::quiet_NaN();
+  vector<double> d(100, 0.0);
+  d[50] = -0.0;
+  d[70] = nan;
+  assert(find(d, nan) == d.end());
+  assert(count(d, 0.0) == 99);
+  assert(count(d, -0.0) == 99);
+  vector<double> e = d;
+  assert(range_mismatch(d, e).first == d.begin() + 70);
+  assert(!range_equal(d, e));
+
+  // Strings are contiguous ranges of char.
+  string s = "the quick brown fox jumps over the lazy dog, again and again";
+  assert(find(s, 'z') == s.begin() + s.find('z'));
+  assert(count(s, 'a') == std::count(s.begin(), s.end(), 'a'));
+  string t = s;
+  t[40] = '!';
+  assert(range_mismatch(s, t).first == s.begin() + 40);
+  string x = "aaabaaaaaaaaaaaaaaaaaaaaaaab";
+  assert(search_n(x, 5, 'a') == x.begin() + 4);
+  assert(search_n(x, 23, 'a') == x.begin() + 4);
+  assert(search_n(x, 24, 'a') == x.end());
+
+  // Other types use the standard algorithms.
+  vector<short> h {1, 2, 3};
+  assert(find(h, 2) == h.begin() + 1);
+  vector<bool> f {false, true};
+  assert(find(f, true) == f.begin() + 1);
+}
+
+// Each instruction set gives the same results.
+void test_simd()
+{
+  for (simd_isa isa : {simd_isa::scalar, simd_isa::sse2, simd_isa::avx2}) {
+    algorithm_impl::set_simd_level(isa);
+    for (size_t n : {0, 7, 70, 700}) {
+      check_values<char>(n, 3);
+      check_values<int32_t>(n, 3);
+      check_values<int64_t>(n, 3);
+      check_values<float>(n, 3);
+    }
+  }
+  algorithm_impl::set_simd_level(algorithm_impl::simd_support());
+}
+
+// Time each algorithm over reps searches of a range of n elements, none of
+// which matches, so that the whole range is examined.
+template <typename T>
+  void bench_type(const char* name, size_t n)
+  {
+    const size_t reps = max<size_t>(1, (1 << 24) / (n + 1));
+    vector<T> v = random_values<T>(n, 100);
+    vector<T> w = v;
+    const T x = T(200);
+    size_t a = 0, b = 0;
+
+    auto report = [&](const char* alg, double s, double o) {
+      if (a != b)
+        cout << alg << " " << name << ": results differ\n";
+      cout << alg << " " << name << " " << n << ": std " << s / reps * 1e6
+           << "ns, origin " << o / reps * 1e6 << "ns (" << s / o << "x)\n";
+      a = b = 0;
+    };
+
+    double s1 = time_it([&]() {
+      for (size_t i = 0; i < reps; ++i)
+        a += std::find(v.begin(), v.end(), x) - v.begin();
+    });
+    double o1 = time_it([&]() {
+      for (size_t i = 0; i < reps; ++i)
+        b += find(v, x) - v.begin();
+    });
+    report("find", s1, o1);
+
+    double s2 = time_it([&]() {
+      for (size_t i = 0; i < reps; ++i)
+        a += std::count(v.begin(), v.end(), T(1));
+    });
+    double o2 = time_it([&]() {
+      for (size_t i = 0; i < reps; ++i)
+        b += count(v, T(1));
+    });
+    report("count", s2, o2);
+
+    double s3 = time_it([&]() {
+      for (size_t i = 0; i < reps; ++i)
+        a += std::mismatch(v.begin(), v.end(), w.begin()).first - v.begin();
+    });
+    double o3 = time_it([&]() {
+      for (size_t i = 0; i < reps; ++i)
+        b += range_mismatch(v, w).first - v.begin();
+    });
+    report("mismatch", s3, o3);
+
+    double s4 = time_it([&]() {
+      for (size_t i = 0; i < reps; ++i)
+        a += std::search_n(v.begin(), v.end(), 4, T(1)) - v.begin();
+    });
+    double o4 = time_it([&]() {
+      for (size_t i = 0; i < reps; ++i)
+        b += search_n(v, 4, T(1)) - v.begin();
+    });
+    report("search_n", s4, o4);
+  }
+
+void bench(size_t n)
+{
+  bench_type<char>("char", n);
+  bench_type<int32_t>("int32", n);
+  bench_type<int64_t>("int64", n);
+  bench_type<float>("float", n);
+}
+
+int main(int argc, char* argv[])
+{
+  test_values();
+  test_conversions();
+  test_simd();
+
+  run_benchmarks(argc, argv, bench);
+}
@@ -0,0 +1,163 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <algorithm>
+
+#include "execution.hpp"
+
+namespace origin
+{
+  namespace
+  {
+    // The pool and queue index of the worker running on this thread, if any.
+    thread_local thread_pool* current_pool = nullptr;
+    thread_local std::size_t current_worker = 0;
+  } // namespace
+
+
+  thread_pool::thread_pool(std::size_t n)
+    : queued(0), next(0), done(false)
+  {
+    // There is always at least one queue, even when there are no workers.
+    for (std::size_t i = 0; i < (n ? n : 1); ++i)
+      queues.emplace_back(new queue);
+    for (std::size_t i = 0; i < n; ++i)
+      workers.emplace_back([this, i]() { work(i); });
+  }
+
+  thread_pool::~thread_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      done = true;
+    }
+    ready.notify_all();
+    for (std::thread& t : workers)
+      t.join();
+  }
+
+  void
+  thread_pool::submit(task t)
+  {
+    std::size_t n;
+    if (current_pool == this)
+      n = current_worker;
+    else
+      n = next++ % queues.size();
+
+    // Count the task before it is queued so that the count never drops
+    // below 0. Taking the lock ensures that a worker about to sleep sees the
+    // new count.
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++queued;
+    }
+    try {
+      std::lock_guard<std::mutex> lock(queues[n]->mutex);
+      queues[n]->tasks.push_back(std::move(t));
+    } catch (...) {
+      --queued;
+      throw;
+    }
+    ready.notify_one();
+  }
+
+  bool
+  thread_pool::pop(std::size_t n, task& t)
+  {
+    queue& q = *queues[n];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty())
+      return false;
+    t = std::move(q.tasks.back());
+    q.tasks.pop_back();
+    --queued;
+    return true;
+  }
+
+  bool
+  thread_pool::steal(std::size_t n, task& t)
+  {
+    for (std::size_t i = 1; i <= queues.size(); ++i) {
+      queue& q = *queues[(n + i) % queues.size()];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if (!q.tasks.empty()) {
+        t = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        --queued;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool
+  thread_pool::run_pending_task()
+  {
+    task t;
+    if (current_pool == this) {
+      if (!pop(current_worker, t) && !steal(current_worker, t))
+        return false;
+    } else {
+      if (!steal(0, t))
+        return false;
+    }
+    t();
+    return true;
+  }
+
+  void
+  thread_pool::wait(const std::atomic<std::size_t>& pending)
+  {
+    while (pending != 0) {
+      if (!run_pending_task())
+        std::this_thread::yield();
+    }
+  }
+
+  void
+  thread_pool::work(std::size_t n)
+  {
+    current_pool = this;
+    current_worker = n;
+    task t;
+    while (true) {
+      if (pop(n, t) || steal(n, t)) {
+        t();
+        t = nullptr;
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(mutex);
+      ready.wait(lock, [this]() { return done || queued != 0; });
+      if (done)
+        return;
+    }
+  }
+
+
+  thread_pool&
+  default_thread_pool()
+  {
+    // The calling thread also executes tasks, so use one fewer worker
+    // than there are hardware threads.
+    static thread_pool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+  }
+
+
+  std::size_t
+  parallel_policy::grain(std::size_t n, std::size_t min) const
+  {
+    if (grain_)
+      return grain_;
+    std::size_t chunks = 4 * pool().concurrency();
+    std::size_t g = (n + chunks - 1) / chunks;
+    return g < min ? min : (g ? g : 1);
+  }
+
+} // namespace origin
@@ -0,0 +1,294 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_SEQUENCE_EXECUTION_HPP
+#define ORIGIN_SEQUENCE_EXECUTION_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <origin/type/concepts.hpp>
+
+namespace origin
+{
+  class thread_pool;
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Thread pool
+  //
+  // A thread pool is a fixed set of worker threads that execute tasks. Each
+  // worker owns a queue of tasks. A worker takes tasks from the back of its
+  // own queue (most recently submitted first) and, when its queue is empty,
+  // steals tasks from the front of the other workers' queues. Tasks submitted
+  // by threads outside the pool are distributed over the workers' queues.
+  //
+  // Threads that wait for a group of tasks to finish (see wait()) execute
+  // pending tasks while they wait, so tasks may themselves submit and wait
+  // for other tasks without deadlocking the pool.
+  //
+  // A pool with no workers is valid. Tasks submitted to it are executed by
+  // the threads that wait for them.
+  class thread_pool
+  {
+  public:
+    using task = std::function<void()>;
+
+    // Construct a pool with n worker threads. By default, the pool has one
+    // worker for each hardware thread.
+    explicit thread_pool(std::size_t n = std::thread::hardware_concurrency());
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Stops and joins the workers. Pending tasks are discarded.
+    ~thread_pool();
+
+    // Returns the number of worker threads.
+    std::size_t size() const { return workers.size(); }
+
+    // Returns the number of threads that can execute tasks concurrently: the
+    // workers and the thread that waits for them.
+    std::size_t concurrency() const { return size() + 1; }
+
+    // Submit a task for execution. If the calling thread is a worker of this
+    // pool, the task is added to its own queue.
+    void submit(task t);
+
+    // Execute pending tasks until pending becomes 0.
+    void wait(const std::atomic<std::size_t>& pending);
+
+    // Execute one pending task, if there is any. Returns true if a task was
+    // executed.
+    bool run_pending_task();
+
+    // Parallel for
+    //
+    // Call f(i, j) on a partition of [first, last) into subranges [i, j) of
+    // at most grain elements. The range is split recursively so that idle
+    // workers can steal large subranges. This returns when every subrange
+    // has been processed. If f throws, the first exception is rethrown after
+    // all tasks have finished.
+    template <typename F>
+      void parallel_for(std::size_t first, std::size_t last,
+                        std::size_t grain, F f);
+
+  private:
+    struct queue
+    {
+      std::mutex mutex;
+      std::deque<task> tasks;
+    };
+
+    void work(std::size_t n);
+    bool pop(std::size_t n, task& t);
+    bool steal(std::size_t n, task& t);
+
+    std::vector<std::unique_ptr<queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;                  // Guards sleeping workers
+    std::condition_variable ready;
+    std::atomic<std::size_t> queued;   // Number of queued tasks
+    std::atomic<std::size_t> next;     // Next queue for external submissions
+    bool done;
+  };
+
+
+  // Returns the thread pool used by parallel algorithms when no other pool
+  // is given. The pool is created on first use.
+  thread_pool& default_thread_pool();
+
+
+  namespace execution_impl
+  {
+    // The range splitter recursively halves a range, submitting the upper
+    // half as a task, until the remaining range is no larger than the grain.
+    // The lower half is processed by the calling thread.
+    template <typename F>
+      struct range_splitter
+      {
+        void
+        operator()(std::size_t first, std::size_t last) const
+        {
+          try {
+            while (last - first > grain) {
+              std::size_t mid = first + (last - first) / 2;
+              range_splitter upper = *this;
+              ++*pending;
+              try {
+                pool->submit([upper, mid, last]() { upper.run(mid, last); });
+              } catch (...) {
+                // The task was never queued, so it will not be counted down.
+                --*pending;
+                throw;
+              }
+              last = mid;
+            }
+            (*fn)(first, last);
+          } catch (...) {
+            record(std::current_exception());
+          }
+        }
+
+        // Process the range [first, last) as a submitted task.
+        void
+        run(std::size_t first, std::size_t last) const
+        {
+          (*this)(first, last);
+          --*pending;
+        }
+
+        void
+        record(std::exception_ptr e) const
+        {
+          std::lock_guard<std::mutex> lock(*mutex);
+          if (!*error)
+            *error = e;
+        }
+
+        thread_pool* pool;
+        F* fn;
+        std::size_t grain;
+        std::atomic<std::size_t>* pending;
+        std::mutex* mutex;
+        std::exception_ptr* error;
+      };
+  } // namespace execution_impl
+
+
+template <typename F>
+  void
+  thread_pool::parallel_for(std::size_t first, std::size_t last,
+                            std::size_t grain, F f)
+  {
+    if (grain == 0)
+      grain = 1;
+    if (last - first <= grain) {
+      if (first != last)
+        f(first, last);
+      return;
+    }
+
+    std::atomic<std::size_t> pending(0);
+    std::mutex mutex;
+    std::exception_ptr error;
+    execution_impl::range_splitter<F> split {
+      this, &f, grain, &pending, &mutex, &error
+    };
+    split(first, last);
+    wait(pending);
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Execution policies
+  //
+  // An execution policy is passed as the first argument of an algorithm to
+  // select how the algorithm is executed. The sequential policy, seq, runs
+  // the algorithm on the calling thread. The parallel policy, par, divides
+  // the work into chunks that are executed on a thread pool.
+  //
+  // The parallel policy can be tuned for a particular call:
+  //
+  //    matrix_product(par.on(pool).with_grain(16), a, b, c);
+  //
+  // The grain is the number of units of work (e.g., rows or elements) in each
+  // chunk. The threshold is the minimum amount of work for which parallel
+  // execution is used; smaller problems are executed sequentially. When
+  // either is 0, the algorithm chooses an appropriate value.
+
+  struct sequential_policy { };
+
+  class parallel_policy
+  {
+  public:
+    constexpr parallel_policy()
+      : pool_(nullptr), grain_(0), threshold_(0)
+    { }
+
+    // Returns a copy of this policy that executes on the pool p.
+    parallel_policy
+    on(thread_pool& p) const
+    {
+      parallel_policy r = *this;
+      r.pool_ = &p;
+      return r;
+    }
+
+    // Returns a copy of this policy with the given grain size.
+    parallel_policy
+    with_grain(std::size_t n) const
+    {
+      parallel_policy r = *this;
+      r.grain_ = n;
+      return r;
+    }
+
+    // Returns a copy of this policy with the given serial threshold.
+    parallel_policy
+    with_threshold(std::size_t n) const
+    {
+      parallel_policy r = *this;
+      r.threshold_ = n;
+      return r;
+    }
+
+    // Returns the pool on which work is executed.
+    thread_pool&
+    pool() const { return pool_ ? *pool_ : default_thread_pool(); }
+
+    // Returns the requested grain size, or 0 if none was given.
+    std::size_t grain() const { return grain_; }
+
+    // Returns the requested threshold, or 0 if none was given.
+    std::size_t threshold() const { return threshold_; }
+
+    // Returns the grain size for n units of work. If no grain was given, the
+    // work is divided into about 4 chunks per thread, but no chunk is
+    // smaller than min.
+    std::size_t grain(std::size_t n, std::size_t min = 1) const;
+
+    // Returns true if work whose total cost is n should be run in parallel.
+    // The default threshold is given by def.
+    bool
+    parallel(std::size_t n, std::size_t def) const
+    {
+      return n >= (threshold_ ? threshold_ : def) && pool().size() != 0;
+    }
+
+  private:
+    thread_pool* pool_;
+    std::size_t grain_;
+    std::size_t threshold_;
+  };
+
+
+  constexpr sequential_policy seq {};
+  constexpr parallel_policy par {};
+
+
+  // Returns true if P is an execution policy type.
+  template <typename P>
+    constexpr bool Execution_policy()
+    {
+      return Same<Decay<P>, sequential_policy>()
+          || Same<Decay<P>, parallel_policy>();
+    }
+
+} // namespace origin
+
+#endif
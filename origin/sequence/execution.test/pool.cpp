@@ -0,0 +1,86 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <origin/sequence/execution.hpp>
+
+using namespace std;
+using namespace origin;
+
+// Every index is visited exactly once, in chunks no larger than the grain.
+void test_parallel_for(thread_pool& pool)
+{
+  for (size_t n : {0, 1, 7, 100, 10000}) {
+    for (size_t grain : {1, 3, 64, 20000}) {
+      vector<atomic<int>> hits(n);
+      for (auto& x : hits)
+        x = 0;
+      pool.parallel_for(0, n, grain, [&](size_t i, size_t j) {
+        assert(i < j && j - i <= grain);
+        for ( ; i != j; ++i)
+          ++hits[i];
+      });
+      for (auto& x : hits)
+        assert(x == 1);
+    }
+  }
+}
+
+// Tasks may run parallel loops of their own.
+void test_nested(thread_pool& pool)
+{
+  atomic<size_t> sum(0);
+  pool.parallel_for(0, 16, 1, [&](size_t, size_t) {
+    pool.parallel_for(0, 100, 10, [&](size_t k, size_t l) {
+      sum += l - k;
+    });
+  });
+  assert(sum == 1600);
+}
+
+// The first exception thrown by a chunk is rethrown by the caller.
+void test_exception(thread_pool& pool)
+{
+  bool caught = false;
+  try {
+    pool.parallel_for(0, 100, 1, [](size_t i, size_t) {
+      if (i == 42)
+        throw runtime_error("42");
+    });
+  } catch (runtime_error& e) {
+    caught = true;
+  }
+  assert(caught);
+}
+
+// The policy selects a pool and a grain.
+void test_policy(thread_pool& pool)
+{
+  parallel_policy p = par.on(pool);
+  assert(&p.pool() == &pool);
+  assert(p.grain(1000) == (1000 + 4 * pool.concurrency() - 1) / (4 * pool.concurrency()));
+  assert(p.grain(10, 8) == 8);
+  assert(p.with_grain(5).grain(1000) == 5);
+  assert(p.parallel(100, 50) == (pool.size() != 0));
+  assert(!p.with_threshold(1000).parallel(100, 50));
+}
+
+int main()
+{
+  for (size_t n : {0, 1, 4}) {
+    thread_pool pool(n);
+    assert(pool.size() == n);
+    test_parallel_for(pool);
+    test_nested(pool);
+    test_exception(pool);
+    test_policy(pool);
+  }
+}
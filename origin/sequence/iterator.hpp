@@ -10,15 +10,257 @@
 
 #include <cstring>
 #include <iterator>
+#include <new>
+#include <tuple>
+#include <utility>
 
 #include "algorithm.hpp"
 
 namespace origin
 {
+	namespace sequence_impl
+	{
+		// A function box holds a function object that need not be default
+		// constructible or assignable (e.g., a lambda expression), so that
+		// iterators holding one can be regular.
+		template <typename F>
+			class function_box
+			{
+			public:
+				function_box()
+					: full(false)
+				{ }
+
+				function_box(const F& f)
+					: full(true)
+				{
+					new (&fn) F(f);
+				}
+
+				function_box(const function_box& x)
+					: full(x.full)
+				{
+					if (full)
+						new (&fn) F(x.fn);
+				}
+
+				function_box&
+				operator=(const function_box& x)
+				{
+					if (this != &x) {
+						clear();
+						if (x.full) {
+							new (&fn) F(x.fn);
+							full = true;
+						}
+					}
+					return *this;
+				}
+
+				~function_box() { clear(); }
+
+				const F& get() const { return fn; }
+
+			private:
+				void
+				clear()
+				{
+					if (full) {
+						fn.~F();
+						full = false;
+					}
+				}
+
+				union { F fn; };
+				bool full;
+			};
+
+		// The weaker of the iterator categories C1 and C2.
+		template <typename C1, typename C2>
+			using Weaker_category = If<Derived<C1, C2>(), C2, C1>;
+
+		// The weakest of a list of iterator categories.
+		template <typename C, typename... Cs>
+			struct weakest_category
+			{
+				using type = C;
+			};
+
+		template <typename C1, typename C2, typename... Cs>
+			struct weakest_category<C1, C2, Cs...>
+				: weakest_category<Weaker_category<C1, C2>, Cs...>
+			{ };
+
+		// Advance i by at most n (n >= 0) elements, stopping at last. Returns
+		// the number of elements not advanced.
+		template <typename I>
+			inline auto
+			advance_within(I& i, Difference_type<I> n, I last)
+				-> Requires<!Random_access_iterator<I>(), Difference_type<I>>
+			{
+				while (n != 0 && i != last) {
+					++i;
+					--n;
+				}
+				return n;
+			}
+
+		template <typename I>
+			inline auto
+			advance_within(I& i, Difference_type<I> n, I last)
+				-> Requires<Random_access_iterator<I>(), Difference_type<I>>
+			{
+				Difference_type<I> d = last - i;
+				if (n > d) {
+					i = last;
+					return n - d;
+				}
+				i += n;
+				return 0;
+			}
+
+		// A list of indexes, used to expand a tuple.
+		template <std::size_t... N>
+			struct index_list { };
+
+		template <std::size_t K, std::size_t... N>
+			struct make_index_list : make_index_list<K - 1, K - 1, N...> { };
+
+		template <std::size_t... N>
+			struct make_index_list<0, N...>
+			{
+				using type = index_list<N...>;
+			};
+
+		// Used to evaluate an expression for each element of a pack.
+		using expand = int[];
+	} // namespace sequence_impl
+
+
+	//////////////////////////////////////////////////////////////////////////////
+	// Iterator Facade
+	//
+	// The iterator facade defines the operators of an iterator type D in terms
+	// of a few member functions of D:
+	//
+	//		x.dereference()   -- Returns *x
+	//		x.increment()     -- Moves x to the next element
+	//		x.equal(y)        -- Returns true if x == y
+	//		x.decrement()     -- Moves x to the previous element
+	//		x.advance(n)      -- Moves x by n elements
+	//		x.distance_to(y)  -- Returns y - x
+	//
+	// The last three are needed only by bidirectional and random access
+	// iterators. An operator is instantiated only when it is used, so D
+	// defines only the operations supported by its category.
+	//
+	// Template Parameters:
+	//		D -- The derived iterator type
+	//		C -- The iterator category
+	//		V -- The value type
+	//		R -- The reference type
+	//		N -- The difference type
+	template <typename D, typename C, typename V, typename R,
+						typename N = std::ptrdiff_t>
+		class iterator_facade
+		{
+		public:
+			using iterator_category = C;
+			using value_type = V;
+			using reference = R;
+			using pointer = void;
+			using difference_type = N;
+
+			// Readable
+			reference operator*() const { return self().dereference(); }
+
+			reference
+			operator[](difference_type n) const
+			{
+				D tmp = self();
+				tmp.advance(n);
+				return tmp.dereference();
+			}
+
+			// Increment
+			D&
+			operator++()
+			{
+				self().increment();
+				return self();
+			}
+
+			D
+			operator++(int)
+			{
+				D tmp = self();
+				self().increment();
+				return tmp;
+			}
+
+			// Decrement
+			D&
+			operator--()
+			{
+				self().decrement();
+				return self();
+			}
+
+			D
+			operator--(int)
+			{
+				D tmp = self();
+				self().decrement();
+				return tmp;
+			}
+
+			// Advance
+			D&
+			operator+=(difference_type n)
+			{
+				self().advance(n);
+				return self();
+			}
+
+			D&
+			operator-=(difference_type n)
+			{
+				self().advance(-n);
+				return self();
+			}
+
+			friend D operator+(D i, difference_type n) { return i += n; }
+			friend D operator+(difference_type n, D i) { return i += n; }
+			friend D operator-(D i, difference_type n) { return i -= n; }
+
+			friend difference_type
+			operator-(const D& a, const D& b)
+			{
+				return b.distance_to(a);
+			}
+
+			// Equality comparable
+			friend bool operator==(const D& a, const D& b) { return a.equal(b); }
+			friend bool operator!=(const D& a, const D& b) { return !a.equal(b); }
+
+			// Totally ordered
+			friend bool operator<(const D& a, const D& b) { return a.distance_to(b) > 0; }
+			friend bool operator>(const D& a, const D& b) { return b < a; }
+			friend bool operator<=(const D& a, const D& b) { return !(b < a); }
+			friend bool operator>=(const D& a, const D& b) { return !(a < b); }
+
+		private:
+			D&       self()       { return static_cast<D&>(*this); }
+			const D& self() const { return static_cast<const D&>(*this); }
+		};
+
+
 	//////////////////////////////////////////////////////////////////////////////
 	// Filter Iterator Adaptor
 	//
-	// A filter iterator is
+	// A filter iterator is an iterator over the elements of [first, last)
+	// that satisfy a predicate. It is a forward iterator when I is, and an
+	// input iterator otherwise.
 	//
 	// Tempate Parameters:
 	//		I -- The underlying iterator
@@ -32,9 +274,15 @@ namespace origin
 			using value_type = Value_type<I>;
 			using reference = Reference_of<I>;
 			using pointer = Pointer_of<I>;
+			using difference_type = Difference_type<I>;
+			using iterator_category = If<
+				Forward_iterator<I>(), std::forward_iterator_tag, std::input_iterator_tag
+			>;
 
 			// Constructors
 
+			filter_iterator() = default;
+
 			// Construct a filter iterator over the range [first, last).
 			filter_iterator(I first, I last, P pred = {});
 
@@ -54,7 +302,7 @@ namespace origin
 			const I& last() const { return std::get<1>(data); }
 
 			// Returns the predicate function of the filter iterator.
-			const P& pred() const { return std::get<2>(data); }
+			const P& pred() const { return std::get<2>(data).get(); }
 
 
 			// Readable
@@ -73,7 +321,7 @@ namespace origin
 			void advance();
 
 		private:
-			std::tuple<I, I, P> data;
+			std::tuple<I, I, sequence_impl::function_box<P>> data;
 		};
 
 
@@ -163,6 +411,392 @@ namespace origin
 			return {last, pred};
 		}
 
+	//////////////////////////////////////////////////////////////////////////////
+	// Transform Iterator Adaptor
+	//
+	// A transform iterator refers to the result of applying a function f to
+	// the element referred to by an underlying iterator. The function is
+	// applied each time the iterator is dereferenced. The transform iterator
+	// has the same category as the underlying iterator, but it is a proxy
+	// iterator: its reference type is the result type of f, which need not be
+	// a reference.
+	//
+	// Template Parameters:
+	//		I -- The underlying iterator
+	//		F -- A unary function on the value type of I
+	template <typename I, typename F>
+		class transform_iterator
+			: public iterator_facade<
+					transform_iterator<I, F>,
+					Iterator_category<I>,
+					Decay<Result_of<const F&(Reference_of<I>)>>,
+					Result_of<const F&(Reference_of<I>)>,
+					Difference_type<I>
+				>
+		{
+			static_assert(Input_iterator<I>(), "");
+		public:
+			using reference = Result_of<const F&(Reference_of<I>)>;
+			using difference_type = Difference_type<I>;
+
+			transform_iterator() = default;
+
+			transform_iterator(I i, F f)
+				: iter(i), fn(f)
+			{ }
+
+			// Returns the underlying iterator.
+			I base() const { return iter; }
+
+			// Returns the function.
+			const F& function() const { return fn.get(); }
+
+			// Facade operations
+			reference dereference() const { return fn.get()(*iter); }
+			void increment() { ++iter; }
+			void decrement() { --iter; }
+			void advance(difference_type n) { iter += n; }
+			bool equal(const transform_iterator& x) const { return iter == x.iter; }
+
+			difference_type
+			distance_to(const transform_iterator& x) const
+			{
+				return x.iter - iter;
+			}
+
+		private:
+			I iter;
+			sequence_impl::function_box<F> fn;
+		};
+
+
+	//////////////////////////////////////////////////////////////////////////////
+	// Stride Iterator Adaptor
+	//
+	// A stride iterator refers to every nth element of a range [first, last),
+	// starting with first. The iterator is bounded by last: incrementing past
+	// the last element moves it to last, and the number of elements that could
+	// not be advanced is kept so that decrementing it and computing distances
+	// from it are exact. The stride iterator has the same category as the
+	// underlying iterator.
+	//
+	// Template Parameters:
+	//		I -- The underlying iterator
+	template <typename I>
+		class stride_iterator
+			: public iterator_facade<
+					stride_iterator<I>,
+					Iterator_category<I>,
+					Value_type<I>,
+					Reference_of<I>,
+					Difference_type<I>
+				>
+		{
+			static_assert(Forward_iterator<I>(), "");
+		public:
+			using reference = Reference_of<I>;
+			using difference_type = Difference_type<I>;
+
+			stride_iterator()
+				: iter(), limit(), n(1), missing(0)
+			{ }
+
+			// Construct an iterator over every nth element of [i, last). If i is
+			// last, missing is the number of elements by which the previous
+			// increment overshot last.
+			stride_iterator(I i, I last, difference_type n, difference_type missing = 0)
+				: iter(i), limit(last), n(n), missing(missing)
+			{ }
+
+			// Returns the underlying iterator.
+			I base() const { return iter; }
+
+			// Returns the end of the underlying range.
+			I last() const { return limit; }
+
+			// Returns the stride.
+			difference_type stride() const { return n; }
+
+			// Facade operations
+			reference dereference() const { return *iter; }
+
+			void
+			increment()
+			{
+				missing = sequence_impl::advance_within(iter, n, limit);
+			}
+
+			void
+			decrement()
+			{
+				std::advance(iter, missing - n);
+				missing = 0;
+			}
+
+			void
+			advance(difference_type k)
+			{
+				if (k > 0) {
+					missing = sequence_impl::advance_within(iter, k * n, limit);
+				} else if (k < 0) {
+					iter += k * n + missing;
+					missing = 0;
+				}
+			}
+
+			bool equal(const stride_iterator& x) const { return iter == x.iter; }
+
+			difference_type
+			distance_to(const stride_iterator& x) const
+			{
+				return (x.iter - iter + x.missing - missing) / n;
+			}
+
+		private:
+			I iter;
+			I limit;
+			difference_type n;
+			difference_type missing;
+		};
+
+
+	//////////////////////////////////////////////////////////////////////////////
+	// Take Iterator Adaptor
+	//
+	// A take iterator refers to the elements of the first n elements of a
+	// range [first, last), or all of them if there are fewer than n. The end
+	// of that range is the take iterator (last, 0). Two take iterators are
+	// equal when they have the same number of elements left or the same
+	// underlying iterator.
+	//
+	// Take iterators are used with ranges that are not random access. A
+	// random access range is shortened by computing its new end.
+	//
+	// Template Parameters:
+	//		I -- The underlying iterator
+	template <typename I>
+		class take_iterator
+			: public iterator_facade<
+					take_iterator<I>,
+					sequence_impl::Weaker_category<
+						Iterator_category<I>, std::forward_iterator_tag
+					>,
+					Value_type<I>,
+					Reference_of<I>,
+					Difference_type<I>
+				>
+		{
+			static_assert(Input_iterator<I>(), "");
+		public:
+			using reference = Reference_of<I>;
+			using difference_type = Difference_type<I>;
+
+			take_iterator()
+				: iter(), n(0)
+			{ }
+
+			take_iterator(I i, difference_type n)
+				: iter(i), n(n)
+			{ }
+
+			// Returns the underlying iterator.
+			I base() const { return iter; }
+
+			// Returns the number of elements left.
+			difference_type count() const { return n; }
+
+			// Facade operations
+			reference dereference() const { return *iter; }
+
+			void
+			increment()
+			{
+				++iter;
+				--n;
+			}
+
+			bool
+			equal(const take_iterator& x) const
+			{
+				return n == x.n || iter == x.iter;
+			}
+
+		private:
+			I iter;
+			difference_type n;
+		};
+
+
+	//////////////////////////////////////////////////////////////////////////////
+	// Zip Iterator Adaptor
+	//
+	// A zip iterator refers to the corresponding elements of several ranges
+	// at once. Dereferencing the iterator returns a tuple of the references of
+	// the underlying iterators, and incrementing it increments each of them.
+	// Two zip iterators are equal when any of their underlying iterators are,
+	// so that iteration stops at the end of the shortest range. The category
+	// of the zip iterator is the weakest of those of the underlying iterators.
+	// The zip iterator is a proxy iterator: its reference type is a tuple of
+	// references, not a reference to its value type.
+	//
+	// Template Parameters:
+	//		Is -- The underlying iterators
+	template <typename... Is>
+		class zip_iterator
+			: public iterator_facade<
+					zip_iterator<Is...>,
+					typename sequence_impl::weakest_category<Iterator_category<Is>...>::type,
+					std::tuple<Value_type<Is>...>,
+					std::tuple<Reference_of<Is>...>,
+					Common_type<Difference_type<Is>...>
+				>
+		{
+			using Indexes = typename sequence_impl::make_index_list<sizeof...(Is)>::type;
+		public:
+			using reference = std::tuple<Reference_of<Is>...>;
+			using difference_type = Common_type<Difference_type<Is>...>;
+
+			zip_iterator() = default;
+
+			zip_iterator(Is... is)
+				: iters(is...)
+			{ }
+
+			// Returns the underlying iterators.
+			const std::tuple<Is...>& base() const { return iters; }
+
+			// Facade operations
+			reference dereference() const { return dereference(Indexes()); }
+			void increment() { increment(Indexes()); }
+			void decrement() { decrement(Indexes()); }
+			void advance(difference_type n) { advance(n, Indexes()); }
+			bool equal(const zip_iterator& x) const { return equal(x, Indexes()); }
+
+			difference_type
+			distance_to(const zip_iterator& x) const
+			{
+				return std::get<0>(x.iters) - std::get<0>(iters);
+			}
+
+		private:
+			template <std::size_t... N>
+				reference
+				dereference(sequence_impl::index_list<N...>) const
+				{
+					return reference(*std::get<N>(iters)...);
+				}
+
+			template <std::size_t... N>
+				void
+				increment(sequence_impl::index_list<N...>)
+				{
+					(void)sequence_impl::expand{0, (++std::get<N>(iters), 0)...};
+				}
+
+			template <std::size_t... N>
+				void
+				decrement(sequence_impl::index_list<N...>)
+				{
+					(void)sequence_impl::expand{0, (--std::get<N>(iters), 0)...};
+				}
+
+			template <std::size_t... N>
+				void
+				advance(difference_type n, sequence_impl::index_list<N...>)
+				{
+					(void)sequence_impl::expand{0, (std::get<N>(iters) += n, 0)...};
+				}
+
+			template <std::size_t... N>
+				bool
+				equal(const zip_iterator& x, sequence_impl::index_list<N...>) const
+				{
+					bool eq = false;
+					(void)sequence_impl::expand{
+						0, (eq = eq || std::get<N>(iters) == std::get<N>(x.iters), 0)...
+					};
+					return eq;
+				}
+
+			std::tuple<Is...> iters;
+		};
+
+
+	//////////////////////////////////////////////////////////////////////////////
+	// Enumerate Iterator Adaptor
+	//
+	// An enumerate iterator refers to the elements of a range together with
+	// their positions. Dereferencing the iterator returns a pair containing
+	// the index of the element and its reference. The enumerate iterator has
+	// the same category as the underlying iterator, and is a proxy iterator
+	// like the zip iterator.
+	//
+	// Template Parameters:
+	//		I -- The underlying iterator
+	template <typename I>
+		class enumerate_iterator
+			: public iterator_facade<
+					enumerate_iterator<I>,
+					Iterator_category<I>,
+					std::pair<Difference_type<I>, Value_type<I>>,
+					std::pair<Difference_type<I>, Reference_of<I>>,
+					Difference_type<I>
+				>
+		{
+			static_assert(Input_iterator<I>(), "");
+		public:
+			using reference = std::pair<Difference_type<I>, Reference_of<I>>;
+			using difference_type = Difference_type<I>;
+
+			enumerate_iterator()
+				: iter(), index(0)
+			{ }
+
+			enumerate_iterator(I i, difference_type n)
+				: iter(i), index(n)
+			{ }
+
+			// Returns the underlying iterator.
+			I base() const { return iter; }
+
+			// Facade operations
+			reference dereference() const { return reference(index, *iter); }
+
+			void
+			increment()
+			{
+				++iter;
+				++index;
+			}
+
+			void
+			decrement()
+			{
+				--iter;
+				--index;
+			}
+
+			void
+			advance(difference_type n)
+			{
+				iter += n;
+				index += n;
+			}
+
+			bool equal(const enumerate_iterator& x) const { return iter == x.iter; }
+
+			difference_type
+			distance_to(const enumerate_iterator& x) const
+			{
+				return x.iter - iter;
+			}
+
+		private:
+			I iter;
+			difference_type index;
+		};
+
+
 } // namespace origin
 
 #endif
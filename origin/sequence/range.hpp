@@ -8,6 +8,8 @@
 #ifndef ORIGIN_SEQUENCE_RANGE_HPP
 #define ORIGIN_SEQUENCE_RANGE_HPP
 
+#include <cassert>
+
 #include <origin/type/concepts.hpp>
 
 #include "concepts.hpp"
@@ -56,6 +58,8 @@ namespace origin
       static_assert(Equality_comparable<I>(), "");
     public:
       using iterator = I;
+      using value_type = Value_type<I>;
+      using difference_type = Difference_type<I>;
 
       // Initialize the bounded range so that both values are the same. The
       // range is initially empty.
@@ -73,6 +77,19 @@ namespace origin
       // Iterators
       iterator begin() const { return first; }
       iterator end() const   { return last; }
+
+      // Returns true if the range has no elements.
+      bool empty() const { return first == last; }
+
+      // Returns the number of elements in the range. This is only defined
+      // for random access ranges. The size of other ranges is computed by
+      // size(r).
+      template <typename J = I>
+        auto size() const
+          -> Requires<Random_access_iterator<J>(), Make_unsigned<Difference_type<J>>>
+        {
+          return last - first;
+        }
       
     private:
       I first;
@@ -118,11 +135,451 @@ namespace origin
     {
       using std::begin;
       using std::end;
-      return distance(begin(range), end(range));
+      return std::distance(begin(range), end(range));
     }
   
 
 
+  //////////////////////////////////////////////////////////////////////////////
+  // Range Adaptors
+  //
+  // A range adaptor returns a lazy view of the elements of a range. The
+  // adaptors are:
+  //
+  //    filtered(r, pred) -- The elements x of r where pred(x) is true
+  //    transformed(r, f) -- The values f(x) for each element x of r
+  //    take(r, n)        -- The first n elements of r (or all, if fewer)
+  //    drop(r, n)        -- The elements of r after the first n
+  //    stride(r, n)      -- Every nth element of r, starting with the first
+  //    chunk(r, n)       -- Consecutive subranges of n elements of r (the
+  //                         last may be shorter)
+  //    enumerate(r)      -- Pairs (i, x) of each element x of r and its index
+  //    zip(r1, r2, ...)  -- Tuples of the corresponding elements of r1, r2,
+  //                         ..., up to the end of the shortest range
+  //
+  // Except for zip, each adaptor can also be applied with the | operator, so
+  // that adaptors compose from left to right:
+  //
+  //    auto r = v | filtered(odd) | transformed(square) | take(10);
+  //    int sum = reduce(r, 0);
+  //
+  // Each adaptor returns a bounded_range over iterator adaptors, so the
+  // result is a range that can be passed to any range algorithm. Nothing is
+  // allocated and no element is accessed until the range is traversed
+  // (except that filtered and drop find their first element eagerly).
+  //
+  // The adapted range keeps the category of the underlying range when it
+  // can: transformed, stride, chunk, enumerate, and zip of random access
+  // ranges are random access ranges and have size(). take and drop of a
+  // random access range return a subrange with the same iterators, so the
+  // algorithms specialized for those (e.g., for vectors of integers) are
+  // still used. filtered ranges are forward ranges. The end of a stride,
+  // chunk, enumerate or zip range over bidirectional ranges that are not
+  // random access is found by traversing the range when the adaptor is
+  // applied, so that the end can be decremented.
+  //
+  // The transform, chunk, enumerate and zip iterators are proxy iterators:
+  // their reference type is a value (e.g., a tuple of references) rather
+  // than a reference to their value type. They satisfy the iterator
+  // concepts of this library, which are determined by the iterator
+  // category, but not the requirement of the standard library that the
+  // reference of a forward iterator is a reference. Standard algorithms
+  // that bind references to elements, or that swap them through std::swap,
+  // may not work with them.
+  //
+  // The adapted range refers to the elements of the underlying range, which
+  // must outlive it. Functions and predicates are copied into the iterators.
+  //////////////////////////////////////////////////////////////////////////////
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Chunk Iterator Adaptor
+  //
+  // A chunk iterator refers to consecutive subranges of n elements of a range
+  // [first, last), the last of which may be shorter. Dereferencing the
+  // iterator returns the subrange as a bounded range. The chunk iterator has
+  // the same category as the underlying iterator.
+  //
+  // Template Parameters:
+  //    I -- The underlying iterator
+  template <typename I>
+    class chunk_iterator
+      : public iterator_facade<
+          chunk_iterator<I>,
+          Iterator_category<I>,
+          bounded_range<I>,
+          bounded_range<I>,
+          Difference_type<I>
+        >
+    {
+    public:
+      using reference = bounded_range<I>;
+      using difference_type = Difference_type<I>;
+
+      chunk_iterator() = default;
+
+      // Construct an iterator over the chunks of n elements of [i, last).
+      // See stride_iterator for the meaning of missing.
+      chunk_iterator(I i, I last, difference_type n, difference_type missing = 0)
+        : iter(i, last, n, missing)
+      { }
+
+      // Returns the underlying iterator.
+      I base() const { return iter.base(); }
+
+      // Facade operations
+      reference
+      dereference() const
+      {
+        stride_iterator<I> next = iter;
+        ++next;
+        return {iter.base(), next.base()};
+      }
+
+      void increment() { ++iter; }
+      void decrement() { --iter; }
+      void advance(difference_type n) { iter += n; }
+      bool equal(const chunk_iterator& x) const { return iter == x.iter; }
+
+      difference_type
+      distance_to(const chunk_iterator& x) const
+      {
+        return x.iter - iter;
+      }
+
+    private:
+      stride_iterator<I> iter;
+    };
+
+
+  namespace sequence_impl
+  {
+    // Returns the distance from first to last if I is a bidirectional
+    // iterator, and 0 otherwise. The end of a stride, chunk or enumerate
+    // range is computed from this distance so that it can be decremented.
+    // Only the ends of bidirectional ranges can be decremented, so the
+    // distance of other ranges is not needed.
+    template <typename I>
+      inline auto
+      end_distance(I first, I last)
+        -> Requires<Bidirectional_iterator<I>(), Difference_type<I>>
+      {
+        return std::distance(first, last);
+      }
+
+    template <typename I>
+      inline auto
+      end_distance(I, I)
+        -> Requires<!Bidirectional_iterator<I>(), Difference_type<I>>
+      {
+        return 0;
+      }
+
+    // Returns the number of elements by which the last step of n elements
+    // over a range of size d overshoots its end.
+    template <typename N>
+      inline N
+      stride_missing(N d, N n)
+      {
+        return (n - d % n) % n;
+      }
+
+    // Returns the end of a range of zipped bidirectional ranges, which is
+    // the same distance from the beginning of each range, so that it can
+    // be decremented. The end of other zipped ranges is the end of each.
+    template <typename... Is>
+      inline zip_iterator<Is...>
+      zip_end(std::true_type, std::pair<Is, Is>... rs)
+      {
+        using N = Common_type<Difference_type<Is>...>;
+        N n = std::min({N(std::distance(rs.first, rs.second))...});
+        return zip_iterator<Is...>(std::next(rs.first, n)...);
+      }
+
+    template <typename... Is>
+      inline zip_iterator<Is...>
+      zip_end(std::false_type, std::pair<Is, Is>... rs)
+      {
+        return zip_iterator<Is...>(rs.second...);
+      }
+
+    template <bool... Bs>
+      struct all_true : std::true_type { };
+
+    template <bool... Bs>
+      struct all_true<false, Bs...> : std::false_type { };
+
+    template <bool... Bs>
+      struct all_true<true, Bs...> : all_true<Bs...> { };
+  } // namespace sequence_impl
+
+
+  // Filtered
+  template <typename R, typename P>
+    inline bounded_range<filter_iterator<Iterator_of<R>, P>>
+    filtered(R&& range, P pred)
+    {
+      using std::begin;
+      using std::end;
+      using Iter = filter_iterator<Iterator_of<R>, P>;
+      return {Iter(begin(range), end(range), pred), Iter(end(range), pred)};
+    }
+
+  // Transformed
+  template <typename R, typename F>
+    inline bounded_range<transform_iterator<Iterator_of<R>, F>>
+    transformed(R&& range, F f)
+    {
+      using std::begin;
+      using std::end;
+      using Iter = transform_iterator<Iterator_of<R>, F>;
+      return {Iter(begin(range), f), Iter(end(range), f)};
+    }
+
+  // Take
+  template <typename R>
+    inline auto
+    take(R&& range, Difference_type<Iterator_of<R>> n)
+      -> Requires<Random_access_range<R>(), bounded_range<Iterator_of<R>>>
+    {
+      using std::begin;
+      using std::end;
+      auto first = begin(range);
+      auto last = end(range);
+      return {first, first + std::max(std::min(n, last - first), decltype(n)(0))};
+    }
+
+  template <typename R>
+    inline auto
+    take(R&& range, Difference_type<Iterator_of<R>> n)
+      -> Requires<!Random_access_range<R>(),
+                  bounded_range<take_iterator<Iterator_of<R>>>>
+    {
+      using std::begin;
+      using std::end;
+      using Iter = take_iterator<Iterator_of<R>>;
+      return {Iter(begin(range), std::max(n, decltype(n)(0))), Iter(end(range), 0)};
+    }
+
+  // Drop
+  template <typename R>
+    inline bounded_range<Iterator_of<R>>
+    drop(R&& range, Difference_type<Iterator_of<R>> n)
+    {
+      using std::begin;
+      using std::end;
+      auto first = begin(range);
+      auto last = end(range);
+      if (n > 0)
+        sequence_impl::advance_within(first, n, last);
+      return {first, last};
+    }
+
+  // Stride
+  template <typename R>
+    inline bounded_range<stride_iterator<Iterator_of<R>>>
+    stride(R&& range, Difference_type<Iterator_of<R>> n)
+    {
+      using std::begin;
+      using std::end;
+      using Iter = stride_iterator<Iterator_of<R>>;
+      assert(n > 0);
+      auto first = begin(range);
+      auto last = end(range);
+      auto d = sequence_impl::end_distance(first, last);
+      return {Iter(first, last, n), 
+              Iter(last, last, n, sequence_impl::stride_missing(d, n))};
+    }
+
+  // Chunk
+  template <typename R>
+    inline bounded_range<chunk_iterator<Iterator_of<R>>>
+    chunk(R&& range, Difference_type<Iterator_of<R>> n)
+    {
+      using std::begin;
+      using std::end;
+      using Iter = chunk_iterator<Iterator_of<R>>;
+      assert(n > 0);
+      auto first = begin(range);
+      auto last = end(range);
+      auto d = sequence_impl::end_distance(first, last);
+      return {Iter(first, last, n),
+              Iter(last, last, n, sequence_impl::stride_missing(d, n))};
+    }
+
+  // Enumerate
+  template <typename R>
+    inline bounded_range<enumerate_iterator<Iterator_of<R>>>
+    enumerate(R&& range)
+    {
+      using std::begin;
+      using std::end;
+      using Iter = enumerate_iterator<Iterator_of<R>>;
+      auto first = begin(range);
+      auto last = end(range);
+      return {Iter(first, 0),
+              Iter(last, sequence_impl::end_distance(first, last))};
+    }
+
+  // Zip
+  template <typename... R>
+    inline bounded_range<zip_iterator<Iterator_of<R>...>>
+    zip(R&&... ranges)
+    {
+      using std::begin;
+      using std::end;
+      using Iter = zip_iterator<Iterator_of<R>...>;
+      using Bidi = sequence_impl::all_true<Bidirectional_range<R>()...>;
+      return {Iter(begin(ranges)...),
+              sequence_impl::zip_end(
+                Bidi(), std::make_pair(begin(ranges), end(ranges))...
+              )};
+    }
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Adaptor Objects
+  //
+  // An adaptor object holds the arguments of a range adaptor, except for the
+  // range, and applies the adaptor to a range with the | operator:
+  //
+  //    r | a   is equivalent to  a(r)
+  //
+  // The adaptor objects are returned by calling the adaptors without a
+  // range: filtered(pred), transformed(f), take(n), drop(n), stride(n),
+  // chunk(n), and enumerate().
+  //
+  // Every adaptor object derives from range_adaptor.
+  //////////////////////////////////////////////////////////////////////////////
+
+  struct range_adaptor { };
+
+  template <typename R, typename A>
+    inline auto
+    operator|(R&& range, const A& adaptor)
+      -> Requires<Derived<A, range_adaptor>() && Range<R>(),
+                  decltype(adaptor(std::forward<R>(range)))>
+    {
+      return adaptor(std::forward<R>(range));
+    }
+
+  template <typename P>
+    struct filter_adaptor : range_adaptor
+    {
+      explicit filter_adaptor(P p) : pred(p) { }
+
+      template <typename R>
+        auto operator()(R&& range) const
+          -> decltype(filtered(std::forward<R>(range), std::declval<const P&>()))
+        {
+          return filtered(std::forward<R>(range), pred);
+        }
+
+      P pred;
+    };
+
+  template <typename F>
+    struct transform_adaptor : range_adaptor
+    {
+      explicit transform_adaptor(F f) : fn(f) { }
+
+      template <typename R>
+        auto operator()(R&& range) const
+          -> decltype(transformed(std::forward<R>(range), std::declval<const F&>()))
+        {
+          return transformed(std::forward<R>(range), fn);
+        }
+
+      F fn;
+    };
+
+  struct take_adaptor : range_adaptor
+  {
+    explicit take_adaptor(std::ptrdiff_t n) : n(n) { }
+
+    template <typename R>
+      auto operator()(R&& range) const
+        -> decltype(take(std::forward<R>(range), 0))
+      {
+        return take(std::forward<R>(range), n);
+      }
+
+    std::ptrdiff_t n;
+  };
+
+  struct drop_adaptor : range_adaptor
+  {
+    explicit drop_adaptor(std::ptrdiff_t n) : n(n) { }
+
+    template <typename R>
+      auto operator()(R&& range) const
+        -> decltype(drop(std::forward<R>(range), 0))
+      {
+        return drop(std::forward<R>(range), n);
+      }
+
+    std::ptrdiff_t n;
+  };
+
+  struct stride_adaptor : range_adaptor
+  {
+    explicit stride_adaptor(std::ptrdiff_t n) : n(n) { }
+
+    template <typename R>
+      auto operator()(R&& range) const
+        -> decltype(stride(std::forward<R>(range), 1))
+      {
+        return stride(std::forward<R>(range), n);
+      }
+
+    std::ptrdiff_t n;
+  };
+
+  struct chunk_adaptor : range_adaptor
+  {
+    explicit chunk_adaptor(std::ptrdiff_t n) : n(n) { }
+
+    template <typename R>
+      auto operator()(R&& range) const
+        -> decltype(chunk(std::forward<R>(range), 1))
+      {
+        return chunk(std::forward<R>(range), n);
+      }
+
+    std::ptrdiff_t n;
+  };
+
+  struct enumerate_adaptor : range_adaptor
+  {
+    template <typename R>
+      auto operator()(R&& range) const
+        -> decltype(enumerate(std::forward<R>(range)))
+      {
+        return enumerate(std::forward<R>(range));
+      }
+  };
+
+  template <typename P>
+    inline filter_adaptor<P>
+    filtered(P pred)
+    {
+      return filter_adaptor<P>(pred);
+    }
+
+  template <typename F>
+    inline transform_adaptor<F>
+    transformed(F f)
+    {
+      return transform_adaptor<F>(f);
+    }
+
+  inline take_adaptor take(std::ptrdiff_t n) { return take_adaptor(n); }
+  inline drop_adaptor drop(std::ptrdiff_t n) { return drop_adaptor(n); }
+  inline stride_adaptor stride(std::ptrdiff_t n) { return stride_adaptor(n); }
+  inline chunk_adaptor chunk(std::ptrdiff_t n) { return chunk_adaptor(n); }
+  inline enumerate_adaptor enumerate() { return enumerate_adaptor(); }
+
+
 } // namespace origin
 
 #endif
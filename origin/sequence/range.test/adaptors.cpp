@@ -0,0 +1,261 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#include <cassert>
+#include <forward_list>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <origin/sequence/algorithm.hpp>
+#include <origin/sequence/execution.hpp>
+#include <origin/sequence/range.hpp>
+#include <origin/type/testing.hpp>
+
+using namespace std;
+using namespace origin;
+using namespace origin::testing;
+
+// Tests for range adaptors. For each size n given on the command line, the
+// benchmark sums the squares of the odd elements among the first half of n
+// random integers, by materializing each step into a vector and by
+// composing adaptors.
+
+minstd_rand eng;
+
+bool odd(int x) { return x % 2 != 0; }
+
+template <typename R>
+  vector<Decay<Value_type<Iterator_of<R>>>> to_vector(const R& range)
+  {
+    return {range.begin(), range.end()};
+  }
+
+void test_filtered_transformed()
+{
+  vector<int> v {1, 2, 3, 4, 5, 6, 7};
+  auto sq = [](int x) { return x * x; };
+
+  auto r = v | filtered(odd) | transformed(sq);
+  assert(to_vector(r) == (vector<int> {1, 9, 25, 49}));
+  assert(size(r) == 4);
+  assert(count(r, 9) == 1);
+  assert(*find(r, 25) == 25);
+
+  // Transformed ranges of random access ranges are random access.
+  auto t = transformed(v, sq);
+  static_assert(Random_access_range<decltype(t)>(), "");
+  assert(t.size() == 7);
+  assert(t.begin()[3] == 16);
+  assert(t.end() - t.begin() == 7);
+  assert(reduce(par, t, 0) == 140);
+  assert(reduce(t, 0) == 140);
+
+  // Filtered ranges are forward ranges.
+  auto f = filtered(v, odd);
+  static_assert(Forward_range<decltype(f)>(), "");
+  static_assert(!Bidirectional_range<decltype(f)>(), "");
+  assert(reduce(f, 0) == 16);
+
+  // Writing through a filtered range.
+  fill(v | filtered(odd), 0);
+  assert(v == (vector<int> {0, 2, 0, 4, 0, 6, 0}));
+
+  // An empty range.
+  vector<int> e;
+  assert((e | filtered(odd)).empty());
+  assert((e | transformed(sq)).empty());
+}
+
+void test_take_drop()
+{
+  vector<int> v {5, 4, 3, 2, 1};
+
+  // Random access ranges keep their iterators.
+  auto t = v | take(3);
+  static_assert(Same<decltype(t), bounded_range<vector<int>::iterator>>(), "");
+  assert(t.size() == 3);
+  sort(t);
+  assert(v == (vector<int> {3, 4, 5, 2, 1}));
+  assert((v | take(10)).size() == 5);
+  assert((v | take(0)).empty());
+  assert((v | drop(3)).size() == 2);
+  assert((v | drop(10)).empty());
+  assert(to_vector(v | drop(1) | take(2)) == (vector<int> {4, 5}));
+
+  // Other ranges count the elements taken.
+  forward_list<int> l {1, 2, 3, 4, 5};
+  auto lt = l | take(3);
+  assert(to_vector(lt) == (vector<int> {1, 2, 3}));
+  assert(size(lt) == 3);
+  assert(size(l | take(8)) == 5);
+  assert(to_vector(l | drop(2)) == (vector<int> {3, 4, 5}));
+  assert(search_n(l | take(3), 1, 3) != lt.end());
+  assert(search_n(l | take(2), 1, 3) == (l | take(2)).end());
+
+  // Take of a filtered range.
+  assert(to_vector(l | filtered(odd) | take(2)) == (vector<int> {1, 3}));
+}
+
+void test_stride_chunk()
+{
+  vector<int> v {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  for (int n = 1; n <= 12; ++n) {
+    vector<int> e;
+    for (int i = 0; i < 10; i += n)
+      e.push_back(i);
+    auto s = v | stride(n);
+    assert(to_vector(s) == e);
+    assert(s.size() == e.size());
+    assert(size(s) == e.size());
+
+    // Stepping backwards from the end.
+    vector<int> r(e.rbegin(), e.rend());
+    auto i = s.end();
+    vector<int> b;
+    while (i != s.begin())
+      b.push_back(*--i);
+    assert(b == r);
+    assert(*(s.end() - 1) == e.back());
+    assert(s.begin() + e.size() == s.end());
+
+    list<int> l(v.begin(), v.end());
+    assert(to_vector(l | stride(n)) == e);
+
+    auto c = v | chunk(n);
+    assert(c.size() == size_t((10 + n - 1) / n));
+    int k = 0;
+    for (auto x : c) {
+      assert(x.begin() == v.begin() + k);
+      assert(x.size() == size_t(min(n, 10 - k)));
+      k += n;
+    }
+    assert(size(l | chunk(n)) == c.size());
+  }
+
+  static_assert(Random_access_range<decltype(v | stride(2))>(), "");
+  static_assert(Random_access_range<decltype(v | chunk(2))>(), "");
+  assert(reduce(v | stride(3), 0) == 18);
+
+  // The ends of bidirectional ranges can be decremented.
+  list<int> l {0, 1, 2, 3, 4};
+  for (int n = 1; n <= 6; ++n) {
+    auto s = l | stride(n);
+    vector<int> e;
+    for (int i = 0; i < 5; i += n)
+      e.push_back(i);
+    vector<int> b;
+    auto i = s.end();
+    while (i != s.begin())
+      b.push_back(*--i);
+    assert(b == vector<int>(e.rbegin(), e.rend()));
+  }
+  assert(*std::prev(stride(l, 2).end()) == 4);
+  auto lc = chunk(l, 2);
+  auto last = std::prev(lc.end());
+  assert(*(*last).begin() == 4);
+  assert(size(*last) == 1);
+  assert(*(*std::prev(last)).begin() == 2);
+
+  // Sort every other element.
+  vector<int> w {9, 0, 7, 1, 5, 2, 3, 3};
+  sort(w | stride(2));
+  assert(w == (vector<int> {3, 0, 5, 1, 7, 2, 9, 3}));
+}
+
+void test_zip_enumerate()
+{
+  vector<int> a {1, 2, 3, 4};
+  vector<string> b {"a", "b", "c"};
+  list<char> c {'x', 'y', 'z', 'w', 'v'};
+
+  auto z = zip(a, b);
+  static_assert(Random_access_range<decltype(z)>(), "");
+  assert(z.size() == 3);
+  assert(get<1>(z.begin()[2]) == "c");
+  for (auto x : z)
+    get<0>(x) *= 10;
+  assert(a == (vector<int> {10, 20, 30, 4}));
+
+  auto z3 = zip(a, b, c);
+  static_assert(Bidirectional_range<decltype(z3)>(), "");
+  assert(size(z3) == 3);
+  auto i = find_if(z3, [](tuple<int&, string&, char&> x) {
+    return get<2>(x) == 'y';
+  });
+  assert(get<0>(*i) == 20);
+
+  auto e = a | enumerate();
+  static_assert(Random_access_range<decltype(e)>(), "");
+  assert(e.size() == 4);
+  ptrdiff_t k = 0;
+  for (auto x : e) {
+    assert(x.first == k);
+    assert(&x.second == &a[k]);
+    ++k;
+  }
+  assert((*(e.end() - 1)).first == 3);
+
+  // The ends of bidirectional ranges can be decremented.
+  list<int> l {0, 1, 2, 3, 4};
+  auto le = enumerate(l);
+  assert((*std::prev(le.end())).first == 4);
+  assert((*std::prev(le.end())).second == 4);
+  auto lz = zip(l, b);
+  auto j = std::prev(lz.end());
+  assert(get<0>(*j) == 2);
+  assert(get<1>(*j) == "c");
+  assert(get<0>(*std::prev(zip(c, l).end())) == 'v');
+
+  // Enumerate a filtered range.
+  vector<pair<ptrdiff_t, int>> r;
+  for (auto x : a | filtered([](int x) { return x > 10; }) | enumerate())
+    r.push_back(x);
+  assert(r == (vector<pair<ptrdiff_t, int>> {{0, 20}, {1, 30}}));
+}
+
+void bench(size_t n)
+{
+  vector<int> v(n);
+  for (int& x : v)
+    x = eng() % 1000;
+  auto sq = [](int x) { return long(x) * x; };
+
+  long a = 0, b = 0;
+  double t1 = time_it([&]() {
+    vector<int> h(v.begin(), v.begin() + n / 2);
+    vector<int> o;
+    for (int x : h)
+      if (odd(x))
+        o.push_back(x);
+    vector<long> s;
+    for (int x : o)
+      s.push_back(sq(x));
+    a = reduce(s, 0L);
+  });
+  double t2 = time_it([&]() {
+    b = reduce(v | take(n / 2) | filtered(odd) | transformed(sq), 0L);
+  });
+  if (a != b)
+    cout << "adaptors: results differ\n";
+  cout << "adaptors " << n << ": materialized " << t1 << "ms, lazy " << t2
+       << "ms (" << t1 / t2 << "x)\n";
+}
+
+int main(int argc, char* argv[])
+{
+  test_filtered_transformed();
+  test_take_drop();
+  test_stride_chunk();
+  test_zip_enumerate();
+
+  run_benchmarks(argc, argv, bench);
+}
@@ -8,6 +8,8 @@
 #ifndef ORIGIN_TYPE_TESTING_HPP
 #define ORIGIN_TYPE_TESTING_HPP
 
+#include <chrono>
+#include <cstdlib>
 #include <functional>
 #include <limits>
 #include <random>
@@ -39,6 +41,9 @@ namespace origin
 // The basic testing context and support functions.
 #include "testing.impl/context.hpp"
 
+// Support for benchmarks in unit tests.
+#include "testing.impl/benchmark.hpp"
+
 // Include test support for the type library.
 #include "testing.impl/properties.hpp"
 #include "testing.impl/concepts.hpp"
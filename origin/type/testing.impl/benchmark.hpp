@@ -0,0 +1,52 @@
+// Copyright (c) 2008-2010 Kent State University
+// Copyright (c) 2011-2012 Texas A&M University
+//
+// This file is distributed under the MIT License. See the accompanying file
+// LICENSE.txt or http://www.opensource.org/licenses/mit-license.php for terms
+// and conditions.
+
+#ifndef ORIGIN_TYPE_TESTING_HPP
+#  error This file cannot be included directly. Include type/testing.hpp.
+#endif
+
+namespace testing
+{
+  //////////////////////////////////////////////////////////////////////////////
+  // Benchmarks
+  //
+  // A unit test may also measure the performance of the components it tests.
+  // The benchmarks are run only when they are asked for on the command line,
+  // so running the test suite only checks correctness. For example:
+  //
+  //    int main(int argc, char* argv[])
+  //    {
+  //      test_something();
+  //      run_benchmarks(argc, argv, bench);
+  //    }
+  //
+  // runs bench(n) for each size n given as an argument.
+  //////////////////////////////////////////////////////////////////////////////
+
+
+  // Returns the number of milliseconds taken to call f().
+  template <typename F>
+    double
+    time_it(F f)
+    {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      auto stop = std::chrono::steady_clock::now();
+      return std::chrono::duration<double, std::milli>(stop - start).count();
+    }
+
+
+  // Calls bench(n) for each size n given as an argument of the program.
+  template <typename F>
+    void
+    run_benchmarks(int argc, char* argv[], F bench)
+    {
+      for (int i = 1; i < argc; ++i)
+        bench(std::strtoul(argv[i], nullptr, 10));
+    }
+
+} // namespace testing